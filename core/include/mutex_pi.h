@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    core_sync_mutex_pi Priority inheritance mutex
+ * @ingroup     core_sync
+ * @brief       Mutex that lends the priority of its waiters to its owner
+ *
+ * While a high priority thread waits for a @ref mutex_t held by a low
+ * priority thread, every thread of a priority in between can delay it
+ * (priority inversion). A mutex_pi_t raises the priority of its owner to the
+ * one of its highest priority waiter until the owner unlocks it. If the owner
+ * is itself waiting for a mutex_pi_t, the raise is passed on to the owner of
+ * that one, and so on.
+ *
+ * Enable with `USEMODULE += core_mutex_pi`. @ref rmutex_t is then based on a
+ * mutex_pi_t, too.
+ *
+ * @note    Unlike a @ref mutex_t, a mutex_pi_t can only be unlocked by the
+ *          thread that locked it, and thus not from interrupt context.
+ * @{
+ *
+ * @file
+ * @brief       Priority inheritance mutex API
+ */
+
+#ifndef MUTEX_PI_H
+#define MUTEX_PI_H
+
+#include "kernel_types.h"
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Priority inheritance mutex structure. Must never be modified by the
+ *          user.
+ */
+typedef struct mutex_pi {
+    /**
+     * @brief   The waiting threads, sorted by priority
+     * @internal
+     */
+    mutex_t mutex;
+    /**
+     * @brief   The thread holding the mutex
+     * @internal
+     */
+    kernel_pid_t owner;
+    /**
+     * @brief   Next mutex held by the same thread
+     * @internal
+     */
+    struct mutex_pi *next;
+} mutex_pi_t;
+
+/**
+ * @brief   Static initializer for mutex_pi_t
+ */
+#define MUTEX_PI_INIT { MUTEX_INIT, KERNEL_PID_UNDEF, NULL }
+
+/**
+ * @brief   Initializes a priority inheritance mutex object
+ *
+ * @param[out] mutex    pre-allocated mutex structure, must not be NULL
+ */
+static inline void mutex_pi_init(mutex_pi_t *mutex)
+{
+    mutex_pi_t empty_mutex = MUTEX_PI_INIT;
+    *mutex = empty_mutex;
+}
+
+/**
+ * @brief   Lock a priority inheritance mutex, blocking or non-blocking
+ *
+ * @param[in] mutex     Mutex object to lock, must not be NULL
+ * @param[in] blocking  if true, block until mutex is available
+ *
+ * @return  1 if mutex was unlocked, now it is locked
+ * @return  0 if the mutex was locked
+ */
+int _mutex_pi_lock(mutex_pi_t *mutex, int blocking);
+
+/**
+ * @brief   Tries to get a priority inheritance mutex, non-blocking
+ *
+ * @param[in] mutex     Mutex object to lock, must not be NULL
+ *
+ * @return  1 if mutex was unlocked, now it is locked
+ * @return  0 if the mutex was locked
+ */
+static inline int mutex_pi_trylock(mutex_pi_t *mutex)
+{
+    return _mutex_pi_lock(mutex, 0);
+}
+
+/**
+ * @brief   Locks a priority inheritance mutex, blocking
+ *
+ * Until the mutex is available, the owner runs with the priority of the
+ * calling thread, if that is higher than its own.
+ *
+ * @param[in] mutex     Mutex object to lock, must not be NULL
+ */
+static inline void mutex_pi_lock(mutex_pi_t *mutex)
+{
+    _mutex_pi_lock(mutex, 1);
+}
+
+/**
+ * @brief   Unlocks a priority inheritance mutex
+ *
+ * The calling thread falls back to its own priority, or to the highest
+ * priority of the threads waiting for other mutexes it still holds.
+ *
+ * @param[in] mutex     Mutex object to unlock, must be held by the calling
+ *                      thread
+ */
+void mutex_pi_unlock(mutex_pi_t *mutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MUTEX_PI_H */
+/** @} */
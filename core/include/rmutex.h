@@ -24,6 +24,9 @@
 #include <stdatomic.h>
 
 #include "mutex.h"
+#ifdef MODULE_CORE_MUTEX_PI
+#include "mutex_pi.h"
+#endif
 #include "kernel_types.h"
 
 #ifdef __cplusplus
@@ -38,9 +41,15 @@ typedef struct rmutex_t {
     /**
      * @brief The mutex used for locking. **Must never be changed by
      *        the user.**
+     * @details With the `core_mutex_pi` module, the owner inherits the
+     *          priority of waiting threads.
      * @internal
      */
+#ifdef MODULE_CORE_MUTEX_PI
+    mutex_pi_t mutex;
+#else
     mutex_t mutex;
+#endif
 
     /**
      * @brief   Number of locks owned by the thread owner
@@ -62,7 +71,11 @@ typedef struct rmutex_t {
  * @brief Static initializer for rmutex_t.
  * @details This initializer is preferable to rmutex_init().
  */
+#ifdef MODULE_CORE_MUTEX_PI
+#define RMUTEX_INIT { MUTEX_PI_INIT, 0, ATOMIC_VAR_INIT(KERNEL_PID_UNDEF) }
+#else
 #define RMUTEX_INIT { MUTEX_INIT, 0, ATOMIC_VAR_INIT(KERNEL_PID_UNDEF) }
+#endif
 
 /**
  * @brief Initializes a recursive mutex object.
@@ -119,6 +119,18 @@ int sched_run(void);
  */
 void sched_set_status(thread_t *process, unsigned int status);
 
+/**
+ * @brief   Change the priority of the specified thread
+ *
+ * A runnable thread is moved to the run queue of its new priority, the caller
+ * has to yield if that is appropriate.
+ *
+ * @param[in]   thread      Pointer to the thread control block of the
+ *                          targeted thread
+ * @param[in]   priority    The new priority of this thread
+ */
+void sched_change_priority(thread_t *thread, uint8_t priority);
+
 /**
  * @brief       Yield if approriate.
  *
@@ -189,6 +189,13 @@ struct _thread {
     msg_t *msg_array;               /**< memory holding messages        */
 #endif
 
+#if defined(MODULE_CORE_MUTEX_PI)
+    uint8_t base_priority;          /**< priority without inherited ones */
+    struct mutex_pi *mutex_pi_held; /**< priority inheritance mutexes held */
+    struct mutex_pi *mutex_pi_wait; /**< priority inheritance mutex waited
+                                         for                            */
+#endif
+
 #if defined(DEVELHELP) || defined(SCHED_TEST_STACK) || defined(MODULE_MPU_STACK_GUARD)
     char *stack_start;              /**< thread's stack start address   */
 #endif
@@ -41,6 +41,10 @@
 #include <auto_init.h>
 #endif
 
+#ifdef MODULE_SCHEDPROF
+#include "schedprof.h"
+#endif
+
 extern int main(void);
 static void *main_trampoline(void *arg)
 {
@@ -82,6 +86,10 @@ void kernel_init(void)
 {
     (void) irq_disable();
 
+#ifdef MODULE_SCHEDPROF
+    schedprof_init();
+#endif
+
     thread_create(idle_stack, sizeof(idle_stack),
             THREAD_PRIORITY_IDLE,
             THREAD_CREATE_WOUT_YIELD | THREAD_CREATE_STACKTEST,
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     core_sync_mutex_pi
+ * @{
+ *
+ * @file
+ * @brief       Priority inheritance mutex implementation
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+
+#include "assert.h"
+#include "irq.h"
+#include "list.h"
+#include "mutex_pi.h"
+#include "sched.h"
+#include "thread.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static thread_t *_waiter(list_node_t *node)
+{
+    return container_of((clist_node_t *)node, thread_t, rq_entry);
+}
+
+static void _take(mutex_pi_t *mutex, thread_t *thread)
+{
+    mutex->owner = thread->pid;
+    mutex->next = thread->mutex_pi_held;
+    thread->mutex_pi_held = mutex;
+}
+
+static void _give_up(mutex_pi_t *mutex, thread_t *thread)
+{
+    mutex_pi_t **it = &thread->mutex_pi_held;
+
+    while (*it != mutex) {
+        it = &(*it)->next;
+    }
+    *it = mutex->next;
+    mutex->next = NULL;
+    mutex->owner = KERNEL_PID_UNDEF;
+}
+
+/* Lends priority to the owner of mutex, and on along the mutexes it waits for */
+static void _boost(mutex_pi_t *mutex, uint8_t priority)
+{
+    while (mutex) {
+        thread_t *owner = (thread_t *)thread_get(mutex->owner);
+
+        if ((owner == NULL) || (owner->priority <= priority)) {
+            break;
+        }
+        DEBUG("mutex_pi: raising PID[%" PRIkernel_pid "] to prio %u\n",
+              owner->pid, (unsigned)priority);
+        sched_change_priority(owner, priority);
+        mutex = owner->mutex_pi_wait;
+        if (mutex) {
+            /* keep the waiters sorted by their current priority */
+            list_remove(&mutex->mutex.queue, (list_node_t *)&owner->rq_entry);
+            thread_add_to_list(&mutex->mutex.queue, owner);
+        }
+    }
+}
+
+/* Own priority, or the highest one of the waiters on the mutexes still held */
+static uint8_t _inherited_priority(const thread_t *thread)
+{
+    uint8_t priority = thread->base_priority;
+
+    for (mutex_pi_t *it = thread->mutex_pi_held; it; it = it->next) {
+        list_node_t *first = it->mutex.queue.next;
+        if ((first != NULL) && (first != MUTEX_LOCKED) &&
+            (_waiter(first)->priority < priority)) {
+            priority = _waiter(first)->priority;
+        }
+    }
+    return priority;
+}
+
+int _mutex_pi_lock(mutex_pi_t *mutex, int blocking)
+{
+    unsigned irqstate = irq_disable();
+    thread_t *me = (thread_t *)sched_active_thread;
+
+    if (mutex->mutex.queue.next == NULL) {
+        mutex->mutex.queue.next = MUTEX_LOCKED;
+        _take(mutex, me);
+        irq_restore(irqstate);
+        return 1;
+    }
+    if (!blocking) {
+        irq_restore(irqstate);
+        return 0;
+    }
+    assert(mutex->owner != me->pid);
+
+    DEBUG("PID[%" PRIkernel_pid "]: waiting for mutex_pi of PID[%"
+          PRIkernel_pid "]\n", me->pid, mutex->owner);
+    sched_set_status(me, STATUS_MUTEX_BLOCKED);
+    if (mutex->mutex.queue.next == MUTEX_LOCKED) {
+        mutex->mutex.queue.next = NULL;
+    }
+    thread_add_to_list(&mutex->mutex.queue, me);
+    me->mutex_pi_wait = mutex;
+    _boost(mutex, me->priority);
+    irq_restore(irqstate);
+    thread_yield_higher();
+    /* the unlocking thread handed the mutex over to us */
+    return 1;
+}
+
+void mutex_pi_unlock(mutex_pi_t *mutex)
+{
+    assert(!irq_is_in());
+
+    unsigned irqstate = irq_disable();
+    thread_t *me = (thread_t *)sched_active_thread;
+
+    if (mutex->mutex.queue.next == NULL) {
+        irq_restore(irqstate);
+        return;
+    }
+    assert(mutex->owner == me->pid);
+
+    _give_up(mutex, me);
+    uint8_t priority = _inherited_priority(me);
+    int lowered = (priority != me->priority);
+    if (lowered) {
+        DEBUG("mutex_pi: PID[%" PRIkernel_pid "] back to prio %u\n",
+              me->pid, (unsigned)priority);
+        sched_change_priority(me, priority);
+    }
+
+    if (mutex->mutex.queue.next == MUTEX_LOCKED) {
+        mutex->mutex.queue.next = NULL;
+        irq_restore(irqstate);
+        if (lowered) {
+            thread_yield_higher();
+        }
+        return;
+    }
+
+    thread_t *next = _waiter(list_remove_head(&mutex->mutex.queue));
+    if (mutex->mutex.queue.next == NULL) {
+        mutex->mutex.queue.next = MUTEX_LOCKED;
+    }
+    /* the remaining waiters are of lower priority, nothing to inherit */
+    next->mutex_pi_wait = NULL;
+    _take(mutex, next);
+    sched_set_status(next, STATUS_PENDING);
+
+    uint16_t next_priority = next->priority;
+    irq_restore(irqstate);
+    if (lowered) {
+        thread_yield_higher();
+    }
+    else {
+        sched_switch(next_priority);
+    }
+}
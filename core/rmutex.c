@@ -32,13 +32,23 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#ifdef MODULE_CORE_MUTEX_PI
+#define _base_trylock(m)    mutex_pi_trylock(m)
+#define _base_lock(m)       mutex_pi_lock(m)
+#define _base_unlock(m)     mutex_pi_unlock(m)
+#else
+#define _base_trylock(m)    mutex_trylock(m)
+#define _base_lock(m)       mutex_lock(m)
+#define _base_unlock(m)     mutex_unlock(m)
+#endif
+
 static int _lock(rmutex_t *rmutex, int trylock)
 {
     kernel_pid_t owner;
 
     /* try to lock the mutex */
     DEBUG("rmutex %" PRIi16" : trylock\n", thread_getpid());
-    if (mutex_trylock(&rmutex->mutex) == 0) {
+    if (_base_trylock(&rmutex->mutex) == 0) {
         DEBUG("rmutex %" PRIi16" : mutex already held\n", thread_getpid());
         /* Mutex is already held
          *
@@ -91,7 +101,7 @@ static int _lock(rmutex_t *rmutex, int trylock)
                 return 0;
             }
             else {
-                mutex_lock(&rmutex->mutex);
+                _base_lock(&rmutex->mutex);
             }
         }
         /* Case 2: Mutex is held be me (relock) */
@@ -145,6 +155,6 @@ void rmutex_unlock(rmutex_t *rmutex)
 
         DEBUG("rmutex %" PRIi16" : releasing mutex\n", thread_getpid());
 
-        mutex_unlock(&rmutex->mutex);
+        _base_unlock(&rmutex->mutex);
     }
 }
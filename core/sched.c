@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 
+#include "assert.h"
 #include "sched.h"
 #include "clist.h"
 #include "bitarithm.h"
@@ -37,6 +38,10 @@
 #include "xtimer.h"
 #endif
 
+#ifdef MODULE_SCHEDPROF
+#include "schedprof.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -132,6 +137,10 @@ int __attribute__((used)) sched_run(void)
     }
 #endif
 
+#ifdef MODULE_SCHEDPROF
+    schedprof_switch(active_thread, next_thread);
+#endif
+
     next_thread->status = STATUS_RUNNING;
     sched_active_pid = next_thread->pid;
     sched_active_thread = (volatile thread_t *) next_thread;
@@ -166,6 +175,9 @@ void sched_set_status(thread_t *process, unsigned int status)
                   process->pid, process->priority);
             clist_rpush(&sched_runqueues[process->priority], &(process->rq_entry));
             runqueue_bitcache |= 1 << process->priority;
+#ifdef MODULE_SCHEDPROF
+            schedprof_ready(process->pid);
+#endif
         }
     }
     else {
@@ -183,6 +195,31 @@ void sched_set_status(thread_t *process, unsigned int status)
     process->status = status;
 }
 
+void sched_change_priority(thread_t *thread, uint8_t priority)
+{
+    assert(priority < SCHED_PRIO_LEVELS);
+
+    unsigned irqstate = irq_disable();
+
+    if (thread->status >= STATUS_ON_RUNQUEUE) {
+        clist_remove(&sched_runqueues[thread->priority], &thread->rq_entry);
+        if (!sched_runqueues[thread->priority].next) {
+            runqueue_bitcache &= ~(1 << thread->priority);
+        }
+        /* the running thread stays first in its run queue */
+        if (thread == sched_active_thread) {
+            clist_lpush(&sched_runqueues[priority], &thread->rq_entry);
+        }
+        else {
+            clist_rpush(&sched_runqueues[priority], &thread->rq_entry);
+        }
+        runqueue_bitcache |= 1 << priority;
+    }
+    thread->priority = priority;
+
+    irq_restore(irqstate);
+}
+
 void sched_switch(uint16_t other_prio)
 {
     thread_t *active_thread = (thread_t *) sched_active_thread;
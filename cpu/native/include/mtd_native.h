@@ -12,6 +12,16 @@
  * @{
  * @brief       mtd flash emulation for native
  *
+ * The emulated flash is a file that stays mapped into memory from mtd_init()
+ * on. mtd_power() with MTD_POWER_DOWN unmaps it, accesses fail with -EIO
+ * until MTD_POWER_UP maps it again. Writes follow NOR flash semantics, they can only clear bits, only an
+ * erase sets them again.
+ *
+ * For endurance testing the erase cycles of every sector can be counted in
+ * mtd_native_dev_t::erase_count. Once a sector was erased
+ * mtd_native_dev_t::erase_limit times it is worn out: further erases and
+ * writes of it fail with -EIO and leave its contents unchanged.
+ *
  * @file
  *
  * @author      Vincent Dupont <vincent@otakeys.com>
@@ -24,12 +34,20 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+
 #include "mtd.h"
 
 /** mtd native descriptor */
 typedef struct mtd_native_dev {
-    mtd_dev_t dev;      /**< mtd generic device */
-    const char *fname;  /**< filename to use for memory emulation */
+    mtd_dev_t dev;          /**< mtd generic device */
+    const char *fname;      /**< filename to use for memory emulation */
+    uint8_t *mem;           /**< mapping of the file, set by mtd_init(),
+                             *   NULL while powered down */
+    uint32_t *erase_count;  /**< erase cycles per sector (mtd_dev_t::sector_count
+                             *   entries), NULL to not count them */
+    uint32_t erase_limit;   /**< erase cycles after which a sector is worn out,
+                             *   0 for unlimited, needs mtd_native_dev_t::erase_count */
 } mtd_native_dev_t;
 
 /**
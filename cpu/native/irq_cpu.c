@@ -41,6 +41,10 @@
 
 #include "native_internal.h"
 
+#ifdef MODULE_SCHEDPROF
+#include "schedprof.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -255,6 +259,10 @@ void native_irq_handler(void)
 {
     DEBUG("\n\n\t\tnative_irq_handler\n\n");
 
+#ifdef MODULE_SCHEDPROF
+    schedprof_isr_enter();
+#endif
+
     while (_native_sigpend > 0) {
         int sig = _native_popsig();
         _native_sigpend--;
@@ -271,6 +279,10 @@ void native_irq_handler(void)
         }
     }
 
+#ifdef MODULE_SCHEDPROF
+    schedprof_isr_exit();
+#endif
+
     DEBUG("native_irq_handler: return\n");
     cpu_switch_context_exit();
 }
@@ -18,7 +18,11 @@
 #include <stdio.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
 
 #include "mtd.h"
 #include "mtd_native.h"
@@ -28,27 +32,56 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+static size_t _size(const mtd_dev_t *dev)
+{
+    return dev->sector_count * dev->pages_per_sector * dev->page_size;
+}
+
+static size_t _sector_size(const mtd_dev_t *dev)
+{
+    return dev->pages_per_sector * dev->page_size;
+}
+
+static bool _worn_out(const mtd_native_dev_t *dev, uint32_t sector)
+{
+    return (dev->erase_count != NULL) && (dev->erase_limit != 0) &&
+           (dev->erase_count[sector] >= dev->erase_limit);
+}
+
 static int _init(mtd_dev_t *dev)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
+    size_t size = _size(dev);
 
     DEBUG("mtd_native: init, filename=%s\n", _dev->fname);
 
-    FILE *f = real_fopen(_dev->fname, "r");
+    if (_dev->mem != NULL) {
+        return 0;
+    }
 
-    if (!f) {
-        DEBUG("mtd_native: init: creating file %s\n", name);
-        f = real_fopen(_dev->fname, "w+");
-        if (!f) {
-            return -EIO;
-        }
-        size_t size = dev->sector_count * dev->pages_per_sector * dev->page_size;
-        for (size_t i = 0; i < size; i++) {
-            real_fputc(0xff, f);
-        }
+    int fd = real_open(_dev->fname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -EIO;
+    }
+    off_t old_size = real_lseek(fd, 0, SEEK_END);
+    if ((old_size < 0) || (real_ftruncate(fd, size) < 0)) {
+        real_close(fd);
+        return -EIO;
     }
+    void *mem = real_mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    /* the mapping stays valid without the file descriptor */
+    real_close(fd);
+    if (mem == MAP_FAILED) {
+        return -EIO;
+    }
+    _dev->mem = mem;
 
-    real_fclose(f);
+    /* new parts of the file are erased flash */
+    if ((size_t)old_size < size) {
+        DEBUG("mtd_native: init: erasing %u new bytes of %s\n",
+              (unsigned)(size - old_size), _dev->fname);
+        memset(_dev->mem + old_size, 0xff, size - old_size);
+    }
 
     return 0;
 }
@@ -56,21 +89,16 @@ static int _init(mtd_dev_t *dev)
 static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: read from page %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (addr + size > _size(dev)) {
         return -EOVERFLOW;
     }
-
-    FILE *f = real_fopen(_dev->fname, "r");
-    if (!f) {
+    if (_dev->mem == NULL) {
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    size = real_fread(buff, 1, size, f);
-    real_fclose(f);
+    memcpy(buff, _dev->mem + addr, size);
 
     return size;
 }
@@ -78,29 +106,43 @@ static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
 static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
-    size_t sector_size = dev->pages_per_sector * dev->page_size;
+    size_t sector_size = _sector_size(dev);
+    const uint8_t *src = buff;
+    uint8_t *dst = _dev->mem + addr;
+    uint32_t left = size;
 
     DEBUG("mtd_native: write from page %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (addr + size > _size(dev)) {
         return -EOVERFLOW;
     }
     if (((addr % sector_size) + size) > sector_size) {
         return -EOVERFLOW;
     }
-
-    FILE *f = real_fopen(_dev->fname, "r+");
-    if (!f) {
+    if ((_dev->mem == NULL) || _worn_out(_dev, addr / sector_size)) {
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    for (size_t i = 0; i < size; i++) {
-        uint8_t c = real_fgetc(f);
-        real_fseek(f, -1, SEEK_CUR);
-        real_fputc(c & ((uint8_t*)buff)[i], f);
+
+    /* programming can only clear bits: AND the data into the flash, byte
+     * wise up to the first aligned word of the flash, then word wise */
+    while ((left > 0) && ((uintptr_t)dst % sizeof(uintptr_t))) {
+        *dst++ &= *src++;
+        left--;
+    }
+    while (left >= sizeof(uintptr_t)) {
+        uintptr_t word;
+
+        /* buff does not need to be aligned */
+        memcpy(&word, src, sizeof(word));
+        *(uintptr_t *)dst &= word;
+        dst += sizeof(word);
+        src += sizeof(word);
+        left -= sizeof(word);
+    }
+    while (left > 0) {
+        *dst++ &= *src++;
+        left--;
     }
-    real_fclose(f);
 
     return size;
 }
@@ -108,37 +150,55 @@ static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size
 static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
-    size_t sector_size = dev->pages_per_sector * dev->page_size;
+    size_t sector_size = _sector_size(dev);
 
     DEBUG("mtd_native: erase from sector %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (addr + size > _size(dev)) {
         return -EOVERFLOW;
     }
     if (((addr % sector_size) != 0) || ((size % sector_size) != 0)) {
         return -EOVERFLOW;
     }
-
-    FILE *f = real_fopen(_dev->fname, "r+");
-    if (!f) {
+    if (_dev->mem == NULL) {
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    for (size_t i = 0; i < size; i++) {
-        real_fputc(0xff, f);
+
+    for (uint32_t sector = addr / sector_size; size > 0; sector++) {
+        if (_worn_out(_dev, sector)) {
+            DEBUG("mtd_native: erase: sector %" PRIu32 " is worn out\n", sector);
+            return -EIO;
+        }
+        memset(_dev->mem + (sector * sector_size), 0xff, sector_size);
+        if (_dev->erase_count != NULL) {
+            _dev->erase_count[sector]++;
+        }
+        size -= sector_size;
     }
-    real_fclose(f);
 
     return 0;
 }
 
 static int _power(mtd_dev_t *dev, enum mtd_power_state power)
 {
-    (void) dev;
-    (void) power;
+    mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
 
-    return -ENOTSUP;
+    DEBUG("mtd_native: power %s\n", (power == MTD_POWER_UP) ? "up" : "down");
+
+    switch (power) {
+        case MTD_POWER_UP:
+            return _init(dev);
+        case MTD_POWER_DOWN:
+            /* the contents were written to the file through the shared
+             * mapping, unmapping it hands them to the kernel */
+            if ((_dev->mem != NULL) && (real_munmap(_dev->mem, _size(dev)) < 0)) {
+                return -EIO;
+            }
+            _dev->mem = NULL;
+            return 0;
+        default:
+            return -ENOTSUP;
+    }
 }
 
 
@@ -66,6 +66,8 @@
 static int _init(netdev_t *netdev);
 static int _send(netdev_t *netdev, const struct iovec *vector, unsigned n);
 static int _recv(netdev_t *netdev, void *buf, size_t n, void *info);
+static int _recv_lend(netdev_t *netdev, netdev_rx_alloc_t alloc, void *arg,
+                      void *info);
 
 static inline void _get_mac_addr(netdev_t *netdev, uint8_t *dst)
 {
@@ -153,6 +155,7 @@ static int _set(netdev_t *dev, netopt_t opt, void *value, size_t value_len)
 static netdev_driver_t netdev_driver_tap = {
     .send = _send,
     .recv = _recv,
+    .recv_lend = _recv_lend,
     .init = _init,
     .isr = _isr,
     .get = _get,
@@ -199,36 +202,28 @@ static void _continue_reading(netdev_tap_t *dev)
     _native_in_syscall--;
 }
 
-static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+static void _discard(netdev_tap_t *dev)
 {
-    netdev_tap_t *dev = (netdev_tap_t*)netdev;
-    (void)info;
-
-    if (!buf) {
-        if (len > 0) {
-            /* no memory available in pktbuf, discarding the frame */
-            DEBUG("netdev_tap: discarding the frame\n");
-
-            /* repeating `real_read` for small size on tap device results in
-             * freeze for some reason. Using a large buffer for now. */
-            /*
-            uint8_t buf[4];
-            while (real_read(dev->tap_fd, buf, sizeof(buf)) > 0) {
-            }
-            */
+    /* no memory available in pktbuf, discarding the frame */
+    DEBUG("netdev_tap: discarding the frame\n");
+
+    /* repeating `real_read` for small size on tap device results in
+     * freeze for some reason. Using a large buffer for now. */
+    /*
+    uint8_t buf[4];
+    while (real_read(dev->tap_fd, buf, sizeof(buf)) > 0) {
+    }
+    */
 
-            static uint8_t buf[ETHERNET_FRAME_LEN];
+    static uint8_t buf[ETHERNET_FRAME_LEN];
 
-            real_read(dev->tap_fd, buf, sizeof(buf));
+    real_read(dev->tap_fd, buf, sizeof(buf));
 
-            _continue_reading(dev);
-        }
-
-        /* no way of figuring out packet size without racey buffering,
-         * so we return the maximum possible size */
-        return ETHERNET_FRAME_LEN;
-    }
+    _continue_reading(dev);
+}
 
+static int _read_frame(netdev_tap_t *dev, void *buf, size_t len)
+{
     int nread = real_read(dev->tap_fd, buf, len);
     DEBUG("netdev_tap: read %d bytes\n", nread);
 
@@ -250,8 +245,8 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
         _continue_reading(dev);
 
 #ifdef MODULE_NETSTATS_L2
-        netdev->stats.rx_count++;
-        netdev->stats.rx_bytes += nread;
+        ((netdev_t *)dev)->stats.rx_count++;
+        ((netdev_t *)dev)->stats.rx_bytes += nread;
 #endif
         return nread;
     }
@@ -272,6 +267,40 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
     return -1;
 }
 
+static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+{
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
+    (void)info;
+
+    if (!buf) {
+        if (len > 0) {
+            _discard(dev);
+        }
+
+        /* no way of figuring out packet size without racey buffering,
+         * so we return the maximum possible size */
+        return ETHERNET_FRAME_LEN;
+    }
+
+    return _read_frame(dev, buf, len);
+}
+
+static int _recv_lend(netdev_t *netdev, netdev_rx_alloc_t alloc, void *arg,
+                      void *info)
+{
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
+    /* packet size is unknown before reading, so borrow for the largest */
+    void *buf = alloc(arg, ETHERNET_FRAME_LEN);
+    (void)info;
+
+    if (!buf) {
+        _discard(dev);
+        return -ENOBUFS;
+    }
+
+    return _read_frame(dev, buf, ETHERNET_FRAME_LEN);
+}
+
 static int _send(netdev_t *netdev, const struct iovec *vector, unsigned n)
 {
     netdev_tap_t *dev = (netdev_tap_t*)netdev;
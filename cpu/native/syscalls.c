@@ -96,6 +96,10 @@ int (*real_fputc)(int c, FILE *stream);
 int (*real_fgetc)(FILE *stream);
 mode_t (*real_umask)(mode_t cmask);
 ssize_t (*real_writev)(int fildes, const struct iovec *iov, int iovcnt);
+off_t (*real_lseek)(int fd, off_t offset, int whence);
+int (*real_ftruncate)(int fd, off_t length);
+void* (*real_mmap)(void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+int (*real_munmap)(void *addr, size_t length);
 
 #ifdef __MACH__
 #else
@@ -478,6 +482,10 @@ void _native_init_syscalls(void)
     *(void **)(&real_clearerr) = dlsym(RTLD_NEXT, "clearerr");
     *(void **)(&real_umask) = dlsym(RTLD_NEXT, "umask");
     *(void **)(&real_writev) = dlsym(RTLD_NEXT, "writev");
+    *(void **)(&real_lseek) = dlsym(RTLD_NEXT, "lseek");
+    *(void **)(&real_ftruncate) = dlsym(RTLD_NEXT, "ftruncate");
+    *(void **)(&real_mmap) = dlsym(RTLD_NEXT, "mmap");
+    *(void **)(&real_munmap) = dlsym(RTLD_NEXT, "munmap");
     *(void **)(&real_fclose) = dlsym(RTLD_NEXT, "fclose");
     *(void **)(&real_fseek) = dlsym(RTLD_NEXT, "fseek");
     *(void **)(&real_fputc) = dlsym(RTLD_NEXT, "fputc");
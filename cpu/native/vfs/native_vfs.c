@@ -20,6 +20,7 @@
 #include <fcntl.h>
 #include <stdarg.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "vfs.h"
@@ -68,6 +69,54 @@ ssize_t write(int fd, const void *src, size_t count)
     return res;
 }
 
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t res = vfs_readv(fd, iov, iovcnt);
+
+    if (res < 0) {
+        /* vfs returns negative error codes */
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t res = vfs_writev(fd, iov, iovcnt);
+
+    if (res < 0) {
+        /* vfs returns negative error codes */
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
+ssize_t pread(int fd, void *dest, size_t count, off_t offset)
+{
+    ssize_t res = vfs_pread(fd, dest, count, offset);
+
+    if (res < 0) {
+        /* vfs returns negative error codes */
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
+ssize_t pwrite(int fd, const void *src, size_t count, off_t offset)
+{
+    ssize_t res = vfs_pwrite(fd, src, count, offset);
+
+    if (res < 0) {
+        /* vfs returns negative error codes */
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
 int close(int fd)
 {
     int res = vfs_close(fd);
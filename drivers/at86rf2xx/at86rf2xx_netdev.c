@@ -42,6 +42,8 @@
 
 static int _send(netdev_t *netdev, const struct iovec *vector, unsigned count);
 static int _recv(netdev_t *netdev, void *buf, size_t len, void *info);
+static int _recv_lend(netdev_t *netdev, netdev_rx_alloc_t alloc, void *arg,
+                      void *info);
 static int _init(netdev_t *netdev);
 static void _isr(netdev_t *netdev);
 static int _get(netdev_t *netdev, netopt_t opt, void *val, size_t max_len);
@@ -50,6 +52,7 @@ static int _set(netdev_t *netdev, netopt_t opt, void *val, size_t len);
 const netdev_driver_t at86rf2xx_driver = {
     .send = _send,
     .recv = _recv,
+    .recv_lend = _recv_lend,
     .init = _init,
     .isr = _isr,
     .get = _get,
@@ -126,11 +129,43 @@ static int _send(netdev_t *netdev, const struct iovec *vector, unsigned count)
     return (int)len;
 }
 
-static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+static int _read_frame(at86rf2xx_t *dev, uint8_t *buf, size_t pkt_len,
+                       void *info)
+{
+#ifdef MODULE_NETSTATS_L2
+    dev->netdev.netdev.stats.rx_count++;
+    dev->netdev.netdev.stats.rx_bytes += pkt_len;
+#endif
+    /* copy payload */
+    at86rf2xx_fb_read(dev, buf, pkt_len);
+
+    /* Ignore FCS but advance fb read - we must give a temporary buffer here,
+     * as we are not allowed to issue SPI transfers without any buffer */
+    uint8_t tmp[2];
+    at86rf2xx_fb_read(dev, tmp, 2);
+    (void)tmp;
+
+    if (info != NULL) {
+        netdev_ieee802154_rx_info_t *radio_info = info;
+        at86rf2xx_fb_read(dev, &(radio_info->lqi), 1);
+#ifndef MODULE_AT86RF231
+        at86rf2xx_fb_read(dev, &(radio_info->rssi), 1);
+        at86rf2xx_fb_stop(dev);
+#else
+        at86rf2xx_fb_stop(dev);
+        radio_info->rssi = at86rf2xx_reg_read(dev, AT86RF2XX_REG__PHY_ED_LEVEL);
+#endif
+    }
+    else {
+        at86rf2xx_fb_stop(dev);
+    }
+
+    return pkt_len;
+}
+
+static size_t _start_frame(at86rf2xx_t *dev)
 {
-    at86rf2xx_t *dev = (at86rf2xx_t *)netdev;
     uint8_t phr;
-    size_t pkt_len;
 
     /* frame buffer protection will be unlocked as soon as at86rf2xx_fb_stop()
      * is called*/
@@ -140,7 +175,13 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
     at86rf2xx_fb_read(dev, &phr, 1);
 
     /* ignore MSB (refer p.80) and substract length of FCS field */
-    pkt_len = (phr & 0x7f) - 2;
+    return (phr & 0x7f) - 2;
+}
+
+static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+{
+    at86rf2xx_t *dev = (at86rf2xx_t *)netdev;
+    size_t pkt_len = _start_frame(dev);
 
     /* just return length when buf == NULL */
     if (buf == NULL) {
@@ -152,35 +193,21 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
         at86rf2xx_fb_stop(dev);
         return -ENOBUFS;
     }
-    #ifdef MODULE_NETSTATS_L2
-        netdev->stats.rx_count++;
-        netdev->stats.rx_bytes += pkt_len;
-    #endif
-    /* copy payload */
-    at86rf2xx_fb_read(dev, (uint8_t *)buf, pkt_len);
+    return _read_frame(dev, buf, pkt_len, info);
+}
 
-    /* Ignore FCS but advance fb read - we must give a temporary buffer here,
-     * as we are not allowed to issue SPI transfers without any buffer */
-    uint8_t tmp[2];
-    at86rf2xx_fb_read(dev, tmp, 2);
-    (void)tmp;
+static int _recv_lend(netdev_t *netdev, netdev_rx_alloc_t alloc, void *arg,
+                      void *info)
+{
+    at86rf2xx_t *dev = (at86rf2xx_t *)netdev;
+    size_t pkt_len = _start_frame(dev);
+    uint8_t *buf = alloc(arg, pkt_len);
 
-    if (info != NULL) {
-        netdev_ieee802154_rx_info_t *radio_info = info;
-        at86rf2xx_fb_read(dev, &(radio_info->lqi), 1);
-#ifndef MODULE_AT86RF231
-        at86rf2xx_fb_read(dev, &(radio_info->rssi), 1);
-        at86rf2xx_fb_stop(dev);
-#else
-        at86rf2xx_fb_stop(dev);
-        radio_info->rssi = at86rf2xx_reg_read(dev, AT86RF2XX_REG__PHY_ED_LEVEL);
-#endif
-    }
-    else {
+    if (buf == NULL) {
         at86rf2xx_fb_stop(dev);
+        return -ENOBUFS;
     }
-
-    return pkt_len;
+    return _read_frame(dev, buf, pkt_len, info);
 }
 
 static int _set_state(at86rf2xx_t *dev, netopt_state_t state)
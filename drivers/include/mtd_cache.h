@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_mtd_cache MTD page cache
+ * @ingroup     drivers_storage
+ * @brief       Page cache stacked on top of another MTD
+ *
+ * A mtd_cache_t is a MTD itself, it has the geometry of the MTD it wraps and
+ * can be used wherever a MTD is expected (e.g. by SPIFFS or @ref mtd_vfs_ops).
+ *
+ * - Reads are served from an LRU cache of whole pages. Reads that cover
+ *   complete pages that are not cached go to the wrapped MTD directly and are
+ *   not cached. After a read that continues where the previous one ended, the
+ *   following @ref MTD_CACHE_READ_AHEAD pages are read into the cache.
+ * - Writes are applied to the cached pages (clearing bits, like NOR flash
+ *   does) and written back later. Only the pages of one sector are kept
+ *   dirty: A write to another sector, an eviction, mtd_cache_flush() and
+ *   powering the MTD down write them back. An erase drops the pending writes
+ *   to the erased sectors.
+ *
+ * The cache lines come from a static pool of @ref MTD_CACHE_NUMOF pages of
+ * @ref MTD_CACHE_PAGE_SIZE bytes that is shared by all caches.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Interface definition of the MTD page cache
+ */
+
+#ifndef MTD_CACHE_H
+#define MTD_CACHE_H
+
+#include <stdint.h>
+
+#include "mtd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of cached pages in the pool
+ */
+#ifndef MTD_CACHE_NUMOF
+#define MTD_CACHE_NUMOF         (8U)
+#endif
+
+/**
+ * @brief   Size of a cache line, the largest supported page size
+ */
+#ifndef MTD_CACHE_PAGE_SIZE
+#define MTD_CACHE_PAGE_SIZE     (256U)
+#endif
+
+/**
+ * @brief   Number of pages read ahead on sequential reads, 0 to disable
+ */
+#ifndef MTD_CACHE_READ_AHEAD
+#define MTD_CACHE_READ_AHEAD    (1U)
+#endif
+
+/**
+ * @brief   Cache statistics
+ */
+typedef struct {
+    uint32_t hits;          /**< pages read from the cache */
+    uint32_t misses;        /**< pages read from the wrapped MTD */
+    uint32_t read_ahead;    /**< pages read ahead */
+    uint32_t writes;        /**< pages written to the cache */
+    uint32_t write_backs;   /**< pages written to the wrapped MTD */
+} mtd_cache_stats_t;
+
+/**
+ * @brief   MTD page cache descriptor
+ */
+typedef struct {
+    mtd_dev_t base;             /**< mtd generic device */
+    mtd_dev_t *parent;          /**< wrapped MTD */
+    uint32_t next_read;         /**< address following the previous read */
+    uint32_t dirty_sector;      /**< sector of the dirty pages */
+    mtd_cache_stats_t stats;    /**< statistics */
+} mtd_cache_t;
+
+/**
+ * @brief   MTD page cache driver
+ */
+extern const mtd_desc_t mtd_cache_driver;
+
+/**
+ * @brief   Stacks a cache on top of a MTD
+ *
+ * The geometry of @p parent is taken over by mtd_init(), which also
+ * initializes @p parent.
+ *
+ * @param[out] dev      the cache
+ * @param[in] parent    the MTD to cache
+ */
+void mtd_cache_setup(mtd_cache_t *dev, mtd_dev_t *parent);
+
+/**
+ * @brief   Writes all pending writes back to the wrapped MTD
+ *
+ * @param[in] dev       the cache
+ *
+ * @return  0 on success
+ * @return  < 0 error of the wrapped MTD
+ */
+int mtd_cache_flush(mtd_cache_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_CACHE_H */
+/** @} */
@@ -33,6 +33,12 @@
  * 5. @ref netdev_t::event_callback "netdev->event_callback()" uses
  *    @ref netdev_driver_t::recv "netdev->driver->recv()" to fetch packet
  *
+ * Fetching a packet with @ref netdev_driver_t::recv "recv()" takes two calls:
+ * one to get the packet's size to allocate a buffer and one to copy the
+ * packet into it. Drivers may additionally implement
+ * @ref netdev_driver_t::recv_lend "recv_lend()", which is handed an allocator
+ * of the upper layer and reads the packet straight into the buffer it lends.
+ *
  * ![RX event example](riot-netdev-rx.svg)
  *
  * @file
@@ -50,6 +56,7 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/uio.h>
 
@@ -105,6 +112,19 @@ typedef struct netdev netdev_t;
  */
 typedef void (*netdev_event_cb_t)(netdev_t *dev, netdev_event_t event);
 
+/**
+ * @brief   Receive buffer allocator of an upper layer
+ *
+ * @see netdev_driver_t::recv_lend
+ *
+ * @param[in] arg   argument given to netdev_driver_t::recv_lend
+ * @param[in] len   number of bytes the driver needs
+ *
+ * @return  buffer of at least @p len bytes owned by the upper layer
+ * @return  NULL if no buffer is available
+ */
+typedef void *(*netdev_rx_alloc_t)(void *arg, size_t len);
+
 /**
  * @brief Structure to hold driver state
  *
@@ -169,6 +189,35 @@ typedef struct netdev_driver {
      */
     int (*recv)(netdev_t *dev, void *buf, size_t len, void *info);
 
+    /**
+     * @brief Get a received frame into a buffer lent by the upper layer
+     *
+     * @pre `(dev != NULL) && (alloc != NULL)`
+     *
+     * Optional, may be NULL. Supposed to be called from
+     * @ref netdev_t::event_callback() instead of the two calls to
+     * @ref netdev_driver_t::recv "recv()".
+     *
+     * The driver determines the frame size, calls @p alloc exactly once with
+     * the number of bytes it is going to write (may be an upper bound) and
+     * reads the frame straight into the returned buffer. If @p alloc
+     * returns NULL, the frame is dropped.
+     *
+     * @param[in]   dev     network device descriptor
+     * @param[in]   alloc   allocator of the upper layer
+     * @param[in]   arg     argument to pass to @p alloc
+     * @param[out] info     status information for the received packet. Might
+     *                      be of different type for different netdev devices.
+     *                      May be NULL if not needed or applicable.
+     *
+     * @return `< 0` on error (-ENOBUFS if @p alloc returned NULL)
+     * @return number of bytes written to the lent buffer. The buffer was
+     *         allocated (and is owned by the upper layer) whenever
+     *         @p alloc was called, even if 0 or an error is returned.
+     */
+    int (*recv_lend)(netdev_t *dev, netdev_rx_alloc_t alloc, void *arg,
+                     void *info);
+
     /**
      * @brief the driver's initialization function
      *
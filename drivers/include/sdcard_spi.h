@@ -193,6 +193,7 @@ struct {
     int csd_structure;              /**< version of the CSD register structure */
     cid_t cid;                      /**< CID register */
     csd_t csd;                      /**< CSD register */
+    bool write_session;             /**< true while a multi-block write session is open */
 } typedef sdcard_spi_t;
 
 /**
@@ -252,9 +253,58 @@ int sdcard_spi_read_blocks(sdcard_spi_t *card, int blockaddr, char *data, int bl
  *
  * @return                number of sucessfully written blocks (0 if no block was written).
  */
-int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, char *data, int blocksize,
+int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, const char *data, int blocksize,
                             int nblocks, sd_rw_response_t *state);
 
+/**
+ * @brief                 Opens a multi-block write session (CMD25) at the given block.
+ *
+ *                        Blocks are then written with sdcard_spi_write_next() in as many calls as
+ *                        needed, without any command overhead between them, until the session is
+ *                        closed by sdcard_spi_write_stop(). The card stays selected and the SPI
+ *                        bus stays acquired for the whole session, so the session must be handled
+ *                        by a single thread and no other device on the same bus (and no other
+ *                        operation on this card) can be accessed before it is closed.
+ *
+ * @param[in] card        Initialized sd-card struct
+ * @param[in] blockaddr   Block address of the first block to write
+ * @param[in] nblocks     Number of blocks that are going to be written, 0 if unknown. SD cards
+ *                        are told to pre-erase that many blocks (ACMD23), which speeds up the
+ *                        write. The contents of pre-erased blocks that are not written in the
+ *                        session are undefined afterwards.
+ *
+ * @return                SD_RW_OK if the session was opened
+ * @return                error state otherwise
+ */
+sd_rw_response_t sdcard_spi_write_start(sdcard_spi_t *card, int blockaddr, int nblocks);
+
+/**
+ * @brief                 Writes the next blocks of an open write session.
+ *
+ *                        If a block can't be written the session is closed.
+ *
+ * @param[in] card        sd-card struct with an open write session
+ * @param[in] data        Buffer that contains the data to be sent, nblocks * SD_HC_BLOCK_SIZE
+ *                        bytes
+ * @param[in] nblocks     Number of blocks to write
+ * @param[out] state      Contains information about the error state if something went wrong
+ *                        (if return value is lower than nblocks).
+ *
+ * @return                number of sucessfully written blocks
+ */
+int sdcard_spi_write_next(sdcard_spi_t *card, const char *data, int nblocks,
+                          sd_rw_response_t *state);
+
+/**
+ * @brief                 Closes a write session and waits for the card to finish programming.
+ *
+ * @param[in] card        sd-card struct with an open write session
+ *
+ * @return                SD_RW_OK if all data was written
+ * @return                SD_RW_TIMEOUT if the card didn't finish programming in time
+ */
+sd_rw_response_t sdcard_spi_write_stop(sdcard_spi_t *card);
+
 /**
  * @brief                 Gets the capacity of the card.
  *
@@ -36,12 +36,16 @@ static int mtd_vfs_fstat(vfs_file_t *filp, struct stat *buf);
 static off_t mtd_vfs_lseek(vfs_file_t *filp, off_t off, int whence);
 static ssize_t mtd_vfs_read(vfs_file_t *filp, void *dest, size_t nbytes);
 static ssize_t mtd_vfs_write(vfs_file_t *filp, const void *src, size_t nbytes);
+static ssize_t mtd_vfs_pread(vfs_file_t *filp, void *dest, size_t nbytes, off_t off);
+static ssize_t mtd_vfs_pwrite(vfs_file_t *filp, const void *src, size_t nbytes, off_t off);
 
 const vfs_file_ops_t mtd_vfs_ops = {
-    .fstat = mtd_vfs_fstat,
-    .lseek = mtd_vfs_lseek,
-    .read  = mtd_vfs_read,
-    .write = mtd_vfs_write,
+    .fstat  = mtd_vfs_fstat,
+    .lseek  = mtd_vfs_lseek,
+    .read   = mtd_vfs_read,
+    .write  = mtd_vfs_write,
+    .pread  = mtd_vfs_pread,
+    .pwrite = mtd_vfs_pwrite,
 };
 
 static int mtd_vfs_fstat(vfs_file_t *filp, struct stat *buf)
@@ -86,50 +90,60 @@ static off_t mtd_vfs_lseek(vfs_file_t *filp, off_t off, int whence)
 }
 
 static ssize_t mtd_vfs_read(vfs_file_t *filp, void *dest, size_t nbytes)
+{
+    ssize_t res = mtd_vfs_pread(filp, dest, nbytes, filp->pos);
+    if (res < 0) {
+        return res;
+    }
+    /* Advance file position */
+    filp->pos += res;
+    return res;
+}
+
+static ssize_t mtd_vfs_write(vfs_file_t *filp, const void *src, size_t nbytes)
+{
+    ssize_t res = mtd_vfs_pwrite(filp, src, nbytes, filp->pos);
+    if (res < 0) {
+        return res;
+    }
+    /* Advance file position */
+    filp->pos += res;
+    return res;
+}
+
+static ssize_t mtd_vfs_pread(vfs_file_t *filp, void *dest, size_t nbytes, off_t off)
 {
     mtd_dev_t *mtd = filp->private_data.ptr;
     if (mtd == NULL) {
         return -EFAULT;
     }
     uint32_t size = mtd->page_size * mtd->sector_count * mtd->pages_per_sector;
-    uint32_t src = filp->pos;
-    if (src >= size) {
+    if ((uint32_t)off >= size) {
         return 0;
     }
+    uint32_t src = off;
     if ((src + nbytes) > size) {
         nbytes = size - src;
     }
-    int res = mtd_read(mtd, dest, src, nbytes);
-    if (res < 0) {
-        return res;
-    }
-    /* Advance file position */
-    filp->pos += res;
-    return res;
+    return mtd_read(mtd, dest, src, nbytes);
 }
 
-static ssize_t mtd_vfs_write(vfs_file_t *filp, const void *src, size_t nbytes)
+static ssize_t mtd_vfs_pwrite(vfs_file_t *filp, const void *src, size_t nbytes, off_t off)
 {
     mtd_dev_t *mtd = filp->private_data.ptr;
     if (mtd == NULL) {
         return -EFAULT;
     }
     uint32_t size = mtd->page_size * mtd->sector_count * mtd->pages_per_sector;
-    uint32_t dest = filp->pos;
-    if (dest >= size) {
+    if ((uint32_t)off >= size) {
         /* attempt to write outside the device memory */
         return -ENOSPC;
     }
+    uint32_t dest = off;
     if ((dest + nbytes) > size) {
         nbytes = size - dest;
     }
-    int res = mtd_write(mtd, src, dest, nbytes);
-    if (res < 0) {
-        return res;
-    }
-    /* Advance file position */
-    filp->pos += res;
-    return res;
+    return mtd_write(mtd, src, dest, nbytes);
 }
 
 /** @} */
@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd_cache
+ * @{
+ *
+ * @file
+ * @brief       MTD page cache implementation
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mtd_cache.h"
+#include "mutex.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define NO_SECTOR       (UINT32_MAX)
+
+/**
+ * @brief   The line mirrors the page, including the pending writes
+ *
+ * A dirty line without this flag only holds the pending writes, as an AND
+ * mask over the unknown page contents.
+ */
+#define LINE_VALID      (0x01)
+
+typedef struct {
+    mtd_cache_t *owner;         /**< cache the line belongs to, NULL if free */
+    uint32_t page;              /**< cached page */
+    uint32_t used;              /**< time stamp of the last use */
+    uint32_t dirty_start;       /**< first byte not written back */
+    uint32_t dirty_end;         /**< end of the bytes not written back */
+    uint8_t flags;              /**< line flags */
+} line_t;
+
+static line_t _lines[MTD_CACHE_NUMOF];
+static uint8_t _data[MTD_CACHE_NUMOF][MTD_CACHE_PAGE_SIZE];
+static uint32_t _clock;
+static mutex_t _lock = MUTEX_INIT;
+
+static inline uint8_t *_line_data(const line_t *line)
+{
+    return _data[line - _lines];
+}
+
+static inline uint32_t _sector_size(const mtd_dev_t *dev)
+{
+    return dev->pages_per_sector * dev->page_size;
+}
+
+static inline uint32_t _size(const mtd_dev_t *dev)
+{
+    return dev->sector_count * _sector_size(dev);
+}
+
+static inline void _touch(line_t *line)
+{
+    line->used = ++_clock;
+}
+
+static line_t *_find(const mtd_cache_t *dev, uint32_t page)
+{
+    for (unsigned i = 0; i < MTD_CACHE_NUMOF; i++) {
+        if ((_lines[i].owner == dev) && (_lines[i].page == page)) {
+            return &_lines[i];
+        }
+    }
+    return NULL;
+}
+
+static int _write_back(line_t *line)
+{
+    mtd_cache_t *dev = line->owner;
+
+    if (line->dirty_start < line->dirty_end) {
+        uint32_t addr = (line->page * dev->base.page_size) + line->dirty_start;
+        uint32_t len = line->dirty_end - line->dirty_start;
+
+        DEBUG("mtd_cache: write back %" PRIu32 " bytes to %" PRIu32 "\n", len, addr);
+        int res = mtd_write(dev->parent, _line_data(line) + line->dirty_start, addr, len);
+        if (res < 0) {
+            return res;
+        }
+        dev->stats.write_backs++;
+        line->dirty_start = 0;
+        line->dirty_end = 0;
+    }
+    /* a mask is of no use once it is written */
+    if (!(line->flags & LINE_VALID)) {
+        line->owner = NULL;
+    }
+    return 0;
+}
+
+static line_t *_alloc(mtd_cache_t *dev, uint32_t page, int *res)
+{
+    line_t *victim = &_lines[0];
+
+    for (unsigned i = 0; i < MTD_CACHE_NUMOF; i++) {
+        if (_lines[i].owner == NULL) {
+            victim = &_lines[i];
+            break;
+        }
+        if ((int32_t)(_lines[i].used - victim->used) < 0) {
+            victim = &_lines[i];
+        }
+    }
+    if (victim->owner != NULL) {
+        *res = _write_back(victim);
+        if (*res < 0) {
+            return NULL;
+        }
+    }
+    victim->owner = dev;
+    victim->page = page;
+    victim->flags = 0;
+    victim->dirty_start = 0;
+    victim->dirty_end = 0;
+    _touch(victim);
+    return victim;
+}
+
+static line_t *_fill(mtd_cache_t *dev, uint32_t page, int *res)
+{
+    line_t *line = _alloc(dev, page, res);
+
+    if (line != NULL) {
+        *res = mtd_read(dev->parent, _line_data(line), page * dev->base.page_size,
+                        dev->base.page_size);
+        if (*res < 0) {
+            line->owner = NULL;
+            return NULL;
+        }
+        line->flags = LINE_VALID;
+    }
+    return line;
+}
+
+static int _flush(mtd_cache_t *dev)
+{
+    for (unsigned i = 0; i < MTD_CACHE_NUMOF; i++) {
+        if (_lines[i].owner == dev) {
+            int res = _write_back(&_lines[i]);
+            if (res < 0) {
+                return res;
+            }
+        }
+    }
+    dev->dirty_sector = NO_SECTOR;
+    return 0;
+}
+
+static void _read_ahead(mtd_cache_t *dev, uint32_t page)
+{
+    uint32_t pages = dev->base.sector_count * dev->base.pages_per_sector;
+    int res;
+
+    for (unsigned i = 0; (i < MTD_CACHE_READ_AHEAD) && (page < pages); i++, page++) {
+        if ((_find(dev, page) == NULL) && (_fill(dev, page, &res) != NULL)) {
+            dev->stats.read_ahead++;
+        }
+    }
+}
+
+static int _init(mtd_dev_t *mtd)
+{
+    mtd_cache_t *dev = (mtd_cache_t *)mtd;
+    int res = mtd_init(dev->parent);
+
+    if (res < 0) {
+        return res;
+    }
+    if (dev->parent->page_size > MTD_CACHE_PAGE_SIZE) {
+        DEBUG("mtd_cache: init: page size %" PRIu32 " too large\n", dev->parent->page_size);
+        return -ENOTSUP;
+    }
+
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < MTD_CACHE_NUMOF; i++) {
+        if (_lines[i].owner == dev) {
+            _lines[i].owner = NULL;
+        }
+    }
+    dev->base.sector_count = dev->parent->sector_count;
+    dev->base.pages_per_sector = dev->parent->pages_per_sector;
+    dev->base.page_size = dev->parent->page_size;
+    dev->next_read = NO_SECTOR;
+    dev->dirty_sector = NO_SECTOR;
+    memset(&dev->stats, 0, sizeof(dev->stats));
+    mutex_unlock(&_lock);
+    return 0;
+}
+
+static int _read(mtd_dev_t *mtd, void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *dev = (mtd_cache_t *)mtd;
+    uint32_t page_size = mtd->page_size;
+    uint8_t *dst = buff;
+    bool sequential = (addr == dev->next_read);
+    uint32_t left = size;
+    int res = 0;
+
+    if ((addr + size > _size(mtd)) || (addr + size < addr)) {
+        return -EOVERFLOW;
+    }
+
+    mutex_lock(&_lock);
+    while (left > 0) {
+        uint32_t page = addr / page_size;
+        uint32_t offset = addr % page_size;
+        uint32_t len = (left < page_size - offset) ? left : page_size - offset;
+        line_t *line = _find(dev, page);
+
+        /* pending writes to a page that was not read are written first */
+        if ((line != NULL) && !(line->flags & LINE_VALID)) {
+            if ((res = _write_back(line)) < 0) {
+                break;
+            }
+            line = NULL;
+        }
+
+        if (line != NULL) {
+            dev->stats.hits++;
+            _touch(line);
+        }
+        else if (len == page_size) {
+            /* complete pages go to the buffer directly, in one request */
+            uint32_t numof = 1;
+
+            while ((left >= (numof + 1) * page_size) && (_find(dev, page + numof) == NULL)) {
+                numof++;
+            }
+            len = numof * page_size;
+            if ((res = mtd_read(dev->parent, dst, addr, len)) < 0) {
+                break;
+            }
+            dev->stats.misses += numof;
+        }
+        else if ((line = _fill(dev, page, &res)) != NULL) {
+            dev->stats.misses++;
+        }
+        else {
+            break;
+        }
+
+        if (line != NULL) {
+            memcpy(dst, _line_data(line) + offset, len);
+        }
+        dst += len;
+        addr += len;
+        left -= len;
+    }
+
+    if (res >= 0) {
+        dev->next_read = addr;
+        if (sequential) {
+            _read_ahead(dev, (addr + page_size - 1) / page_size);
+        }
+        res = size;
+    }
+    mutex_unlock(&_lock);
+    return res;
+}
+
+static int _write(mtd_dev_t *mtd, const void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *dev = (mtd_cache_t *)mtd;
+    uint32_t page_size = mtd->page_size;
+    const uint8_t *src = buff;
+    uint32_t left = size;
+    int res = 0;
+
+    if ((addr + size > _size(mtd)) || (addr + size < addr)) {
+        return -EOVERFLOW;
+    }
+
+    mutex_lock(&_lock);
+    while (left > 0) {
+        uint32_t page = addr / page_size;
+        uint32_t offset = addr % page_size;
+        uint32_t len = (left < page_size - offset) ? left : page_size - offset;
+        uint32_t sector = page / mtd->pages_per_sector;
+        line_t *line;
+
+        /* only the pages of one sector are kept dirty */
+        if ((sector != dev->dirty_sector) && ((res = _flush(dev)) < 0)) {
+            break;
+        }
+        dev->dirty_sector = sector;
+
+        line = _find(dev, page);
+        if (line == NULL) {
+            if ((line = _alloc(dev, page, &res)) == NULL) {
+                break;
+            }
+            /* all ones leave the page as it is */
+            memset(_line_data(line), 0xff, page_size);
+        }
+
+        /* programming can only clear bits */
+        uint8_t *data = _line_data(line) + offset;
+        for (uint32_t i = 0; i < len; i++) {
+            data[i] &= src[i];
+        }
+        if (line->dirty_start >= line->dirty_end) {
+            line->dirty_start = offset;
+            line->dirty_end = offset + len;
+        }
+        else {
+            if (offset < line->dirty_start) {
+                line->dirty_start = offset;
+            }
+            if (offset + len > line->dirty_end) {
+                line->dirty_end = offset + len;
+            }
+        }
+        _touch(line);
+        dev->stats.writes++;
+
+        src += len;
+        addr += len;
+        left -= len;
+    }
+    mutex_unlock(&_lock);
+    return (res < 0) ? res : (int)size;
+}
+
+static int _erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *dev = (mtd_cache_t *)mtd;
+    uint32_t sector_size = _sector_size(mtd);
+
+    if ((addr + size > _size(mtd)) || (addr + size < addr) ||
+        ((addr % sector_size) != 0) || ((size % sector_size) != 0)) {
+        return -EOVERFLOW;
+    }
+
+    mutex_lock(&_lock);
+    /* pending writes to the erased sectors are void */
+    uint32_t first = addr / mtd->page_size;
+    uint32_t last = (addr + size) / mtd->page_size;
+    for (unsigned i = 0; i < MTD_CACHE_NUMOF; i++) {
+        if ((_lines[i].owner == dev) && (_lines[i].page >= first) && (_lines[i].page < last)) {
+            _lines[i].owner = NULL;
+        }
+    }
+    if ((dev->dirty_sector != NO_SECTOR) &&
+        (dev->dirty_sector >= addr / sector_size) &&
+        (dev->dirty_sector < (addr + size) / sector_size)) {
+        dev->dirty_sector = NO_SECTOR;
+    }
+    int res = mtd_erase(dev->parent, addr, size);
+    mutex_unlock(&_lock);
+    return res;
+}
+
+static int _power(mtd_dev_t *mtd, enum mtd_power_state power)
+{
+    mtd_cache_t *dev = (mtd_cache_t *)mtd;
+
+    if (power == MTD_POWER_DOWN) {
+        int res = mtd_cache_flush(dev);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return mtd_power(dev->parent, power);
+}
+
+const mtd_desc_t mtd_cache_driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+    .power = _power,
+};
+
+void mtd_cache_setup(mtd_cache_t *dev, mtd_dev_t *parent)
+{
+    memset(dev, 0, sizeof(*dev));
+    dev->base.driver = &mtd_cache_driver;
+    dev->parent = parent;
+    dev->next_read = NO_SECTOR;
+    dev->dirty_sector = NO_SECTOR;
+}
+
+int mtd_cache_flush(mtd_cache_t *dev)
+{
+    mutex_lock(&_lock);
+    int res = _flush(dev);
+    mutex_unlock(&_lock);
+    return res;
+}
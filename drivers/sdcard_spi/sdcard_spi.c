@@ -26,6 +26,7 @@
 #include "periph/gpio.h"
 #include "xtimer.h"
 
+#include <assert.h>
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
@@ -40,7 +41,12 @@ static sd_init_fsm_state_t _init_sd_fsm_step(sdcard_spi_t *card, sd_init_fsm_sta
 static sd_rw_response_t _read_cid(sdcard_spi_t *card);
 static sd_rw_response_t _read_csd(sdcard_spi_t *card);
 static sd_rw_response_t _read_data_packet(sdcard_spi_t *card, char token, char *data, int size);
-static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, char *data, int size);
+static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, const char *data,
+                                           int size);
+static sd_rw_response_t _write_start(sdcard_spi_t *card, int bladdr, int nbl);
+static int _write_next(sdcard_spi_t *card, const char *data, int blsz, int nbl,
+                       sd_rw_response_t *state);
+static sd_rw_response_t _write_stop(sdcard_spi_t *card);
 
 /* CRC-7 (polynomial: x^7 + x^3 + 1) LSB of CRC-7 in a 8-bit variable is always 1*/
 static char _crc_7(const char *data, int n);
@@ -49,7 +55,8 @@ static char _crc_7(const char *data, int n);
 static uint16_t _crc_16(const char *data, size_t n);
 
 /* use this transfer method instead of _transfer_bytes to force the use of 0xFF as dummy bytes */
-static inline int _transfer_bytes(sdcard_spi_t *card, char *out, char *in, unsigned int length);
+static inline int _transfer_bytes(sdcard_spi_t *card, const char *out, char *in,
+                                  unsigned int length);
 
 /* uses bitbanging for spi communication which allows to enable pull-up on the miso pin for
 greater card compatibility on platforms that don't have a hw pull up installed */
@@ -66,6 +73,7 @@ int sdcard_spi_init(sdcard_spi_t *card, const sdcard_spi_params_t *params)
     sd_init_fsm_state_t state = SD_INIT_START;
     memcpy(&card->params, params, sizeof(sdcard_spi_params_t));
     card->spi_clk = SD_CARD_SPI_SPEED_PREINIT;
+    card->write_session = false;
 
     do {
         state = _init_sd_fsm_step(card, state);
@@ -411,16 +419,49 @@ static char _crc_7(const char *data, int n)
     return (crc << 1) | 1;
 }
 
+/* CRC-16 (CRC-CCITT) of every possible byte value, computed for the topmost
+ * byte of the CRC register, so data blocks are processed a byte at a time */
+static const uint16_t _crc_16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
 static uint16_t _crc_16(const char *data, size_t n)
 {
     uint16_t crc = 0;
 
     for (size_t i = 0; i < n; i++) {
-        crc = (uint8_t)(crc >> 8) | (crc << 8);
-        crc ^= data[i];
-        crc ^= (uint8_t)(crc & 0xFF) >> 4;
-        crc ^= crc << 12;
-        crc ^= (crc & 0xFF) << 5;
+        crc = (crc << 8) ^ _crc_16_table[(uint8_t)((crc >> 8) ^ data[i])];
     }
     return crc;
 }
@@ -577,11 +618,25 @@ static inline int _hw_spi_rxtx_byte(sdcard_spi_t *card, char out, char *in){
     return 1;
 }
 
-static inline int _transfer_bytes(sdcard_spi_t *card, char *out, char *in, unsigned int length){
+static inline int _transfer_bytes(sdcard_spi_t *card, const char *out, char *in,
+                                  unsigned int length){
     int trans_ret;
     unsigned trans_bytes = 0;
     char in_temp;
 
+    /* with hardware SPI the whole buffer is handed to the peripheral driver in
+     * one call, which lets it use DMA or its FIFO for complete blocks */
+    if ((_dyn_spi_rxtx_byte == &_hw_spi_rxtx_byte) && ((out != NULL) || (in != NULL))) {
+        if (out == NULL) {
+            /* the card must see 0xFF while it sends, so the receive buffer is
+             * filled with dummy bytes and transferred in place */
+            memset(in, SD_CARD_DUMMY_BYTE, length);
+            out = in;
+        }
+        spi_transfer_bytes(card->params.spi_dev, GPIO_UNDEF, true, out, in, length);
+        return length;
+    }
+
     for (trans_bytes = 0; trans_bytes < length; trans_bytes++) {
         if (out != NULL) {
             trans_ret = _dyn_spi_rxtx_byte(card, out[trans_bytes], &in_temp);
@@ -704,7 +759,8 @@ int sdcard_spi_read_blocks(sdcard_spi_t *card, int blockaddr, char *data, int bl
     }
 }
 
-static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, char *data, int size)
+static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, const char *data,
+                                           int size)
 {
 
     spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF, true, token);
@@ -759,80 +815,153 @@ static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, char
     }
 }
 
-static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, char *data, int blsz,
-                                int nbl, sd_rw_response_t *state)
+static inline int _write_single_block(sdcard_spi_t *card, int bladdr, const char *data,
+                                      int blsz, sd_rw_response_t *state)
 {
     _select_card_spi(card);
-    int written = 0;
 
     uint32_t addr = card->use_block_addr ? bladdr : (bladdr * SD_HC_BLOCK_SIZE);
-    char cmd_r1_resu = sdcard_spi_send_cmd(card, cmd_idx, addr, SD_BLOCK_WRITE_CMD_RETRIES);
+    char cmd_r1_resu = sdcard_spi_send_cmd(card, SD_CMD_24, addr, SD_BLOCK_WRITE_CMD_RETRIES);
 
-    if (R1_VALID(cmd_r1_resu) && !R1_ERROR(cmd_r1_resu)) {
-        DEBUG("_write_blocks: send CMD%d: [OK]\n", cmd_idx);
+    if (!R1_VALID(cmd_r1_resu) || R1_ERROR(cmd_r1_resu)) {
+        DEBUG("_write_single_block: sdcard_spi_send_cmd: SD_CMD_ERROR_NO_RESP\n");
+        _unselect_card_spi(card);
+        *state = SD_RW_RX_TX_ERROR;
+        return 0;
+    }
+    DEBUG("_write_single_block: send CMD24: [OK]\n");
 
-        int token;
-        if (cmd_idx == SD_CMD_25) {
-            token = SD_DATA_TOKEN_CMD_25;
-        }
-        else {
-            token = SD_DATA_TOKEN_CMD_17_18_24;
-        }
+    *state = _write_data_packet(card, SD_DATA_TOKEN_CMD_17_18_24, data, blsz);
+    if (*state != SD_RW_OK) {
+        DEBUG("_write_single_block: _write_data_packet: [FAILED]\n");
+        _unselect_card_spi(card);
+        return 0;
+    }
+    if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+        DEBUG("_write_single_block: _wait_for_not_busy: [FAILED]\n");
+        _unselect_card_spi(card);
+        *state = SD_RW_TIMEOUT;
+        return 0;
+    }
 
-        for (int i = 0; i < nbl; i++) {
-            sd_rw_response_t write_resu = _write_data_packet(card, token, &(data[i * blsz]), blsz);
-            if (write_resu != SD_RW_OK) {
-                DEBUG("_write_blocks: _write_data_packet: [FAILED]\n");
-                _unselect_card_spi(card);
-                *state = write_resu;
-                return written;
-            }
-            if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
-                DEBUG("_write_blocks: _wait_for_not_busy: [FAILED]\n");
-                _unselect_card_spi(card);
-                *state = SD_RW_TIMEOUT;
-                return written;
-            }
-            written++;
+    DEBUG("_write_single_block: write single block: [OK]\n");
+    _unselect_card_spi(card);
+    return 1;
+}
+
+static sd_rw_response_t _write_start(sdcard_spi_t *card, int bladdr, int nbl)
+{
+    _select_card_spi(card);
+
+    /* ACMD23 lets the card erase the blocks before they are written, it only
+     * applies to the following CMD25 and is not known to MMC cards */
+    if ((nbl > 1) && (card->card_type != MMC_V3)) {
+        uint32_t count = (nbl < SD_ACMD_23_MAX_BLOCKS) ? nbl : SD_ACMD_23_MAX_BLOCKS;
+        char r1 = sdcard_spi_send_acmd(card, SD_CMD_23, count, SD_BLOCK_WRITE_CMD_RETRIES);
+
+        if (!R1_VALID(r1) || R1_ERROR(r1)) {
+            /* pre-erasing is an optimization only, so the write goes on */
+            DEBUG("_write_start: ACMD23: [FAILED] (ignored)\n");
         }
+    }
 
-        /* if this is a multi-block write it is needed to issue a stop command*/
-        if (cmd_idx == SD_CMD_25) {
-            spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF, true,
-                              SD_DATA_TOKEN_CMD_25_STOP);
-            DEBUG("_write_blocks: write multi (%d) blocks: [OK]\n", nbl);
+    uint32_t addr = card->use_block_addr ? bladdr : (bladdr * SD_HC_BLOCK_SIZE);
+    char cmd_r1_resu = sdcard_spi_send_cmd(card, SD_CMD_25, addr, SD_BLOCK_WRITE_CMD_RETRIES);
 
-            _send_dummy_byte(card); //sd card needs dummy byte before we can wait for not-busy state
-            if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
-                _unselect_card_spi(card);
-                *state = SD_RW_TIMEOUT;
-            }
+    if (!R1_VALID(cmd_r1_resu) || R1_ERROR(cmd_r1_resu)) {
+        DEBUG("_write_start: send CMD25: [RX_TX_ERROR]\n");
+        _unselect_card_spi(card);
+        return SD_RW_RX_TX_ERROR;
+    }
+
+    DEBUG("_write_start: send CMD25: [OK]\n");
+    card->write_session = true;
+    return SD_RW_OK;
+}
+
+static int _write_next(sdcard_spi_t *card, const char *data, int blsz, int nbl,
+                       sd_rw_response_t *state)
+{
+    int written = 0;
+
+    *state = SD_RW_OK;
+    for (int i = 0; i < nbl; i++) {
+        *state = _write_data_packet(card, SD_DATA_TOKEN_CMD_25, &(data[i * blsz]), blsz);
+        if (*state != SD_RW_OK) {
+            DEBUG("_write_next: _write_data_packet: [FAILED]\n");
+            break;
         }
-        else {
-            DEBUG("_write_blocks: write single block: [OK]\n");
-            *state = SD_RW_OK;
+        if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+            DEBUG("_write_next: _wait_for_not_busy: [FAILED]\n");
+            *state = SD_RW_TIMEOUT;
+            break;
         }
+        written++;
+    }
 
-        _unselect_card_spi(card);
-        return written;
+    /* a failed block ends the session */
+    if (*state != SD_RW_OK) {
+        _write_stop(card);
     }
-    else {
-        DEBUG("_write_blocks: sdcard_spi_send_cmd: SD_CMD_ERROR_NO_RESP\n");
-        _unselect_card_spi(card);
-        *state = SD_RW_RX_TX_ERROR;
-        return written;
+    return written;
+}
+
+static sd_rw_response_t _write_stop(sdcard_spi_t *card)
+{
+    sd_rw_response_t state = SD_RW_OK;
+
+    spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF, true, SD_DATA_TOKEN_CMD_25_STOP);
+    _send_dummy_byte(card); //sd card needs dummy byte before we can wait for not-busy state
+    if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+        DEBUG("_write_stop: _wait_for_not_busy: [FAILED]\n");
+        state = SD_RW_TIMEOUT;
     }
+
+    card->write_session = false;
+    _unselect_card_spi(card);
+    return state;
 }
 
-int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, char *data, int blocksize,
+int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, const char *data, int blocksize,
                             int nblocks, sd_rw_response_t *state)
 {
-    if (nblocks > 1) {
-        return _write_blocks(card, SD_CMD_25, blockaddr, data, blocksize, nblocks, state);
+    if (nblocks <= 1) {
+        return _write_single_block(card, blockaddr, data, blocksize, state);
     }
-    else {
-        return _write_blocks(card, SD_CMD_24, blockaddr, data, blocksize, nblocks, state);
+
+    int written = 0;
+
+    *state = _write_start(card, blockaddr, nblocks);
+    if (*state == SD_RW_OK) {
+        written = _write_next(card, data, blocksize, nblocks, state);
+        if (*state == SD_RW_OK) {
+            *state = _write_stop(card);
+            DEBUG("sdcard_spi_write_blocks: write multi (%d) blocks: [OK]\n", nblocks);
+        }
     }
+    return written;
+}
+
+sd_rw_response_t sdcard_spi_write_start(sdcard_spi_t *card, int blockaddr, int nblocks)
+{
+    assert(!card->write_session);
+
+    return _write_start(card, blockaddr, nblocks);
+}
+
+int sdcard_spi_write_next(sdcard_spi_t *card, const char *data, int nblocks,
+                          sd_rw_response_t *state)
+{
+    assert(card->write_session);
+
+    return _write_next(card, data, SD_HC_BLOCK_SIZE, nblocks, state);
+}
+
+sd_rw_response_t sdcard_spi_write_stop(sdcard_spi_t *card)
+{
+    assert(card->write_session);
+
+    return _write_stop(card);
 }
 
 sd_rw_response_t _read_cid(sdcard_spi_t *card)
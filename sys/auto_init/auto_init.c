@@ -32,6 +32,10 @@
 #include "xtimer.h"
 #endif
 
+#ifdef MODULE_SCHEDPROF
+#include "schedprof.h"
+#endif
+
 #ifdef MODULE_RTC
 #include "periph/rtc.h"
 #endif
@@ -99,6 +103,9 @@ void auto_init(void)
 #ifdef MODULE_XTIMER
     DEBUG("Auto init xtimer module.\n");
     xtimer_init();
+#ifdef MODULE_SCHEDPROF
+    schedprof_xtimer_init();
+#endif
 #endif
 #ifdef MODULE_RTC
     DEBUG("Auto init rtc module.\n");
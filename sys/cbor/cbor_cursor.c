@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for more
+ * details.
+ */
+
+/**
+ * @ingroup     cbor
+ * @{
+ *
+ * @file
+ * @brief       Zero-copy pull parser and container index
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include "cbor.h"
+
+#define TYPE_SHIFT          (5)
+#define INFO_MASK           (0x1f)
+#define INFO_UINT8          (24)
+#define INFO_UINT64         (27)
+#define INFO_INDEFINITE     (31)
+
+#define SIMPLE_FALSE        (0xf4)
+#define SIMPLE_TRUE         (0xf5)
+#define SIMPLE_NULL         (0xf6)
+#define SIMPLE_FLOAT16      (0xf9)
+#define SIMPLE_FLOAT32      (0xfa)
+#define SIMPLE_FLOAT64      (0xfb)
+#define BREAK               (0xff)
+
+/**
+ * @brief   Decoded initial byte and argument of an item
+ */
+typedef struct {
+    uint8_t type;           /**< major type */
+    uint8_t ib;             /**< initial byte */
+    bool indefinite;        /**< indefinite length */
+    uint64_t val;           /**< argument */
+    size_t len;             /**< length of initial byte and argument */
+} head_t;
+
+static int _head(const cbor_cursor_t *it, size_t pos, head_t *head)
+{
+    if (pos >= it->len) {
+        return -EBADMSG;
+    }
+
+    head->ib = it->data[pos];
+    head->type = head->ib >> TYPE_SHIFT;
+    head->indefinite = false;
+    head->val = head->ib & INFO_MASK;
+    head->len = 1;
+
+    if (head->val == INFO_INDEFINITE) {
+        /* only strings, containers and the break code */
+        if ((head->type < CBOR_MAJOR_BYTES) || (head->type == CBOR_MAJOR_TAG)) {
+            return -EBADMSG;
+        }
+        head->indefinite = true;
+        head->val = 0;
+    }
+    else if (head->val >= INFO_UINT8) {
+        if (head->val > INFO_UINT64) {
+            return -EBADMSG;
+        }
+        unsigned follow = 1U << (head->val - INFO_UINT8);
+        if (it->len - pos - 1 < follow) {
+            return -EBADMSG;
+        }
+        head->val = 0;
+        for (unsigned i = 1; i <= follow; i++) {
+            head->val = (head->val << 8) | it->data[pos + i];
+        }
+        head->len += follow;
+    }
+    return 0;
+}
+
+/* Moves it to pos, the item at it was consumed */
+static inline void _advance(cbor_cursor_t *it, size_t pos)
+{
+    it->pos = pos;
+    if (it->remaining != CBOR_CURSOR_INDEFINITE) {
+        it->remaining--;
+    }
+}
+
+/* Decodes the head of the next item, which must be of major type type */
+static int _next(const cbor_cursor_t *it, uint8_t type, head_t *head)
+{
+    if (cbor_cursor_at_end(it)) {
+        return -ENOENT;
+    }
+    int res = _head(it, it->pos, head);
+    if (res < 0) {
+        return res;
+    }
+    return (head->type == type) ? 0 : -EINVAL;
+}
+
+void cbor_cursor_init(cbor_cursor_t *it, const uint8_t *data, size_t len)
+{
+    it->data = data;
+    it->len = len;
+    it->pos = 0;
+    it->remaining = CBOR_CURSOR_INDEFINITE;
+}
+
+bool cbor_cursor_at_end(const cbor_cursor_t *it)
+{
+    if (it->remaining == CBOR_CURSOR_INDEFINITE) {
+        return (it->pos >= it->len) || (it->data[it->pos] == BREAK);
+    }
+    return (it->remaining == 0);
+}
+
+int cbor_cursor_type(const cbor_cursor_t *it)
+{
+    if (cbor_cursor_at_end(it)) {
+        return -ENOENT;
+    }
+    if (it->pos >= it->len) {
+        return -EBADMSG;
+    }
+    return it->data[it->pos] >> TYPE_SHIFT;
+}
+
+int cbor_get_uint(cbor_cursor_t *it, uint64_t *val)
+{
+    head_t head;
+    int res = _next(it, CBOR_MAJOR_UINT, &head);
+
+    if (res == 0) {
+        *val = head.val;
+        _advance(it, it->pos + head.len);
+    }
+    return res;
+}
+
+int cbor_get_int(cbor_cursor_t *it, int64_t *val)
+{
+    head_t head;
+    int res = _next(it, CBOR_MAJOR_UINT, &head);
+
+    if (res == -EINVAL) {
+        res = _next(it, CBOR_MAJOR_NEGINT, &head);
+    }
+    if (res < 0) {
+        return res;
+    }
+    if (head.val > INT64_MAX) {
+        return -EOVERFLOW;
+    }
+    /* -1 - n, which does not overflow for n <= INT64_MAX */
+    *val = (head.type == CBOR_MAJOR_UINT) ? (int64_t)head.val : -1 - (int64_t)head.val;
+    _advance(it, it->pos + head.len);
+    return 0;
+}
+
+static int _get_simple(cbor_cursor_t *it, uint8_t *ib)
+{
+    head_t head;
+    int res = _next(it, CBOR_MAJOR_SIMPLE, &head);
+
+    if (res == 0) {
+        *ib = head.ib;
+    }
+    return res;
+}
+
+int cbor_get_bool(cbor_cursor_t *it, bool *val)
+{
+    uint8_t ib = 0;
+    int res = _get_simple(it, &ib);
+
+    if (res < 0) {
+        return res;
+    }
+    if ((ib != SIMPLE_FALSE) && (ib != SIMPLE_TRUE)) {
+        return -EINVAL;
+    }
+    *val = (ib == SIMPLE_TRUE);
+    _advance(it, it->pos + 1);
+    return 0;
+}
+
+int cbor_get_null(cbor_cursor_t *it)
+{
+    uint8_t ib;
+    int res = _get_simple(it, &ib);
+
+    if (res < 0) {
+        return res;
+    }
+    if (ib != SIMPLE_NULL) {
+        return -EINVAL;
+    }
+    _advance(it, it->pos + 1);
+    return 0;
+}
+
+static int _get_str(cbor_cursor_t *it, uint8_t type, const uint8_t **buf, size_t *len)
+{
+    head_t head;
+    int res = _next(it, type, &head);
+
+    if (res < 0) {
+        return res;
+    }
+    if (head.indefinite) {
+        /* the chunks are not contiguous */
+        return -ENOTSUP;
+    }
+    size_t start = it->pos + head.len;
+    if (head.val > it->len - start) {
+        return -EBADMSG;
+    }
+    *buf = &it->data[start];
+    *len = head.val;
+    _advance(it, start + head.val);
+    return 0;
+}
+
+int cbor_get_bstr(cbor_cursor_t *it, const uint8_t **buf, size_t *len)
+{
+    return _get_str(it, CBOR_MAJOR_BYTES, buf, len);
+}
+
+int cbor_get_tstr(cbor_cursor_t *it, const char **buf, size_t *len)
+{
+    return _get_str(it, CBOR_MAJOR_TEXT, (const uint8_t **)buf, len);
+}
+
+int cbor_get_tag(cbor_cursor_t *it, uint64_t *tag)
+{
+    head_t head;
+    int res = _next(it, CBOR_MAJOR_TAG, &head);
+
+    if (res == 0) {
+        /* the tagged item is still to come, it is the one that is counted */
+        *tag = head.val;
+        it->pos += head.len;
+    }
+    return res;
+}
+
+#ifndef CBOR_NO_FLOAT
+int cbor_get_double(cbor_cursor_t *it, double *val)
+{
+    head_t head;
+    int res = _next(it, CBOR_MAJOR_SIMPLE, &head);
+
+    if (res < 0) {
+        return res;
+    }
+
+    switch (head.ib) {
+        case SIMPLE_FLOAT16: {
+            /* cf. RFC 7049, Appendix D */
+            int exp = (head.val >> 10) & 0x1f;
+            int mant = head.val & 0x3ff;
+
+            if (exp == 0) {
+                *val = ldexp(mant, -24);
+            }
+            else if (exp != 31) {
+                *val = ldexp(mant + 1024, exp - 25);
+            }
+            else {
+                *val = (mant == 0) ? INFINITY : NAN;
+            }
+            if (head.val & 0x8000) {
+                *val = -*val;
+            }
+            break;
+        }
+        case SIMPLE_FLOAT32: {
+            uint32_t u32 = head.val;
+            float f;
+            memcpy(&f, &u32, sizeof(f));
+            *val = f;
+            break;
+        }
+        case SIMPLE_FLOAT64:
+            memcpy(val, &head.val, sizeof(*val));
+            break;
+        default:
+            return -EINVAL;
+    }
+    _advance(it, it->pos + head.len);
+    return 0;
+}
+#endif /* CBOR_NO_FLOAT */
+
+int cbor_skip(cbor_cursor_t *it)
+{
+    /* items left on the enclosing levels, only indefinite ones need a level */
+    size_t stack[CBOR_SKIP_DEPTH];
+    unsigned depth = 0;
+    size_t left = 1;
+    size_t pos = it->pos;
+
+    if (cbor_cursor_at_end(it)) {
+        return -ENOENT;
+    }
+
+    while ((left > 0) || (depth > 0)) {
+        head_t head;
+        int res;
+
+        if (left == 0) {
+            left = stack[--depth];
+            continue;
+        }
+        if (left == CBOR_CURSOR_INDEFINITE) {
+            if (pos >= it->len) {
+                return -EBADMSG;
+            }
+            if (it->data[pos] == BREAK) {
+                pos++;
+                left = 0;
+                continue;
+            }
+        }
+        else {
+            left--;
+        }
+
+        if ((res = _head(it, pos, &head)) < 0) {
+            return res;
+        }
+        pos += head.len;
+
+        switch (head.type) {
+            case CBOR_MAJOR_BYTES:
+            case CBOR_MAJOR_TEXT:
+                if (!head.indefinite) {
+                    if (head.val > it->len - pos) {
+                        return -EBADMSG;
+                    }
+                    pos += head.val;
+                    break;
+                }
+                /* the chunks follow like the items of a container */
+                /* fall through */
+            case CBOR_MAJOR_ARRAY:
+            case CBOR_MAJOR_MAP: {
+                size_t items = CBOR_CURSOR_INDEFINITE;
+
+                if (!head.indefinite) {
+                    /* every item takes at least one byte */
+                    if ((head.val > it->len - pos) ||
+                        ((head.type == CBOR_MAJOR_MAP) && (head.val > (it->len - pos) / 2))) {
+                        return -EBADMSG;
+                    }
+                    items = (head.type == CBOR_MAJOR_MAP) ? head.val * 2 : head.val;
+                    /* definite containers only add to the count */
+                    if (left != CBOR_CURSOR_INDEFINITE) {
+                        left += items;
+                        break;
+                    }
+                }
+                if (items == 0) {
+                    break;
+                }
+                if (depth == CBOR_SKIP_DEPTH) {
+                    return -EOVERFLOW;
+                }
+                stack[depth++] = left;
+                left = items;
+                break;
+            }
+            case CBOR_MAJOR_TAG:
+                /* the tagged item belongs to the tag */
+                if (left != CBOR_CURSOR_INDEFINITE) {
+                    left++;
+                }
+                break;
+            case CBOR_MAJOR_SIMPLE:
+                if (head.indefinite) {
+                    /* break outside of an indefinite length item */
+                    return -EBADMSG;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    _advance(it, pos);
+    return 0;
+}
+
+int cbor_cursor_enter(const cbor_cursor_t *it, cbor_cursor_t *inner)
+{
+    head_t head;
+    int res = _next(it, CBOR_MAJOR_ARRAY, &head);
+
+    if (res == -EINVAL) {
+        res = _next(it, CBOR_MAJOR_MAP, &head);
+    }
+    if (res < 0) {
+        return res;
+    }
+
+    size_t start = it->pos + head.len;
+    size_t items = CBOR_CURSOR_INDEFINITE;
+    if (!head.indefinite) {
+        if ((head.val > it->len - start) ||
+            ((head.type == CBOR_MAJOR_MAP) && (head.val > (it->len - start) / 2))) {
+            return -EBADMSG;
+        }
+        items = (head.type == CBOR_MAJOR_MAP) ? head.val * 2 : head.val;
+    }
+    inner->data = it->data;
+    inner->len = it->len;
+    inner->pos = start;
+    inner->remaining = items;
+    return 0;
+}
+
+int cbor_cursor_leave(cbor_cursor_t *it, const cbor_cursor_t *inner)
+{
+    cbor_cursor_t rest = *inner;
+    bool indefinite = (rest.remaining == CBOR_CURSOR_INDEFINITE);
+
+    while (!cbor_cursor_at_end(&rest)) {
+        int res = cbor_skip(&rest);
+        if (res < 0) {
+            return res;
+        }
+    }
+    if (indefinite) {
+        if (rest.pos >= rest.len) {
+            return -EBADMSG;
+        }
+        /* step over the break */
+        rest.pos++;
+    }
+    _advance(it, rest.pos);
+    return 0;
+}
+
+/* Whether the item at it is the key, a string if str != NULL, num otherwise */
+static bool _key_matches(const cbor_cursor_t *it, const char *str, size_t len,
+                         int64_t num, size_t *end)
+{
+    cbor_cursor_t key = *it;
+
+    key.remaining = 1;
+    if (str) {
+        const char *buf;
+        size_t buf_len;
+
+        if ((cbor_get_tstr(&key, &buf, &buf_len) < 0) || (buf_len != len) ||
+            (memcmp(buf, str, len) != 0)) {
+            return false;
+        }
+    }
+    else {
+        int64_t val;
+
+        if ((cbor_get_int(&key, &val) < 0) || (val != num)) {
+            return false;
+        }
+    }
+    *end = key.pos;
+    return true;
+}
+
+static int _map_find(const cbor_cursor_t *map, const char *str, int64_t num,
+                     cbor_cursor_t *value)
+{
+    cbor_cursor_t it = *map;
+    size_t len = str ? strlen(str) : 0;
+    size_t end;
+    int res;
+
+    while (!cbor_cursor_at_end(&it)) {
+        if (_key_matches(&it, str, len, num, &end)) {
+            *value = it;
+            _advance(value, end);
+            return 0;
+        }
+        /* key and value */
+        if (((res = cbor_skip(&it)) < 0) || ((res = cbor_skip(&it)) < 0)) {
+            return res;
+        }
+    }
+    return -ENOENT;
+}
+
+int cbor_map_find(const cbor_cursor_t *map, const char *key, cbor_cursor_t *value)
+{
+    return _map_find(map, key, 0, value);
+}
+
+int cbor_map_find_int(const cbor_cursor_t *map, int64_t key, cbor_cursor_t *value)
+{
+    return _map_find(map, NULL, key, value);
+}
+
+int cbor_index_init(cbor_index_t *idx, const cbor_cursor_t *it,
+                    size_t *offsets, size_t max)
+{
+    cbor_cursor_t items;
+    int res = cbor_cursor_enter(it, &items);
+
+    if (res < 0) {
+        return res;
+    }
+
+    idx->map = (cbor_cursor_type(it) == CBOR_MAJOR_MAP);
+    idx->items = items;
+    idx->offsets = offsets;
+    idx->numof = 0;
+
+    while (!cbor_cursor_at_end(&items)) {
+        if (idx->numof == max) {
+            return -ENOBUFS;
+        }
+        offsets[idx->numof++] = items.pos;
+        if ((res = cbor_skip(&items)) < 0) {
+            return res;
+        }
+        if (idx->map && ((res = cbor_skip(&items)) < 0)) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+int cbor_index_get(const cbor_index_t *idx, size_t n, cbor_cursor_t *item)
+{
+    if (n >= idx->numof) {
+        return -ENOENT;
+    }
+    *item = idx->items;
+    item->pos = idx->offsets[n];
+    item->remaining = idx->map ? 2 : 1;
+    return 0;
+}
+
+static int _index_find(const cbor_index_t *idx, const char *str, int64_t num,
+                       cbor_cursor_t *value)
+{
+    size_t len = str ? strlen(str) : 0;
+
+    for (size_t n = 0; n < idx->numof; n++) {
+        cbor_cursor_t key;
+        size_t end;
+
+        cbor_index_get(idx, n, &key);
+        if (_key_matches(&key, str, len, num, &end)) {
+            *value = key;
+            value->pos = end;
+            value->remaining = 1;
+            return 0;
+        }
+    }
+    return -ENOENT;
+}
+
+int cbor_index_find(const cbor_index_t *idx, const char *key, cbor_cursor_t *value)
+{
+    return idx->map ? _index_find(idx, key, 0, value) : -EINVAL;
+}
+
+int cbor_index_find_int(const cbor_index_t *idx, int64_t key, cbor_cursor_t *value)
+{
+    return idx->map ? _index_find(idx, NULL, key, value) : -EINVAL;
+}
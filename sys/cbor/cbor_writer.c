@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for more
+ * details.
+ */
+
+/**
+ * @ingroup     cbor
+ * @{
+ *
+ * @file
+ * @brief       Streaming CBOR encoder
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "cbor.h"
+
+#ifdef MODULE_GNRC_PKTBUF
+#include "net/gnrc/pktbuf.h"
+#endif
+
+/* initial byte and 64 bit argument */
+#define HEAD_MAX            (CBOR_WRITER_BUF_MIN)
+
+#define INFO_UINT8          (24)
+#define INFO_INDEFINITE     (31)
+
+#define SIMPLE_FALSE        (0xf4)
+#define SIMPLE_TRUE         (0xf5)
+#define SIMPLE_NULL         (0xf6)
+#define BREAK               (0xff)
+
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, size_t size,
+                      cbor_writer_flush_t flush, void *arg)
+{
+    w->buf = buf;
+    w->size = size;
+    w->pos = 0;
+    w->flushed = 0;
+    w->flush = flush;
+    w->arg = arg;
+    /* every head has to fit into the buffer */
+    w->res = (size < HEAD_MAX) ? -EINVAL : 0;
+}
+
+int cbor_writer_flush(cbor_writer_t *w)
+{
+    if ((w->res == 0) && (w->pos > 0) && w->flush) {
+        w->res = w->flush(w->arg, w->buf, w->pos);
+        if (w->res == 0) {
+            w->flushed += w->pos;
+            w->pos = 0;
+        }
+    }
+    return w->res;
+}
+
+/* Makes room for len bytes in the buffer */
+static int _reserve(cbor_writer_t *w, size_t len)
+{
+    if (w->res < 0) {
+        return w->res;
+    }
+    if (w->size - w->pos < len) {
+        if (!w->flush) {
+            w->res = -ENOBUFS;
+        }
+        return cbor_writer_flush(w);
+    }
+    return 0;
+}
+
+static int _head(cbor_writer_t *w, uint8_t type, uint64_t val)
+{
+    int res = _reserve(w, HEAD_MAX);
+
+    if (res < 0) {
+        return res;
+    }
+
+    uint8_t *out = &w->buf[w->pos];
+    unsigned follow = 0;
+
+    if (val >= INFO_UINT8) {
+        /* 1, 2, 4 or 8 bytes */
+        unsigned info = INFO_UINT8;
+        for (follow = 1; (follow < 8) && (val >> (8 * follow)); follow *= 2) {
+            info++;
+        }
+        out[0] = (type << 5) | info;
+    }
+    else {
+        out[0] = (type << 5) | (uint8_t)val;
+    }
+    for (unsigned i = follow; i > 0; i--) {
+        out[i] = (uint8_t)val;
+        val >>= 8;
+    }
+    w->pos += follow + 1;
+    return 0;
+}
+
+static int _byte(cbor_writer_t *w, uint8_t byte)
+{
+    int res = _reserve(w, 1);
+
+    if (res == 0) {
+        w->buf[w->pos++] = byte;
+    }
+    return res;
+}
+
+static int _str(cbor_writer_t *w, uint8_t type, const void *data, size_t len)
+{
+    int res = _head(w, type, len);
+
+    if (res < 0) {
+        return res;
+    }
+    if ((res = _reserve(w, (len < w->size) ? len : w->size)) < 0) {
+        return res;
+    }
+    if (len <= w->size - w->pos) {
+        memcpy(&w->buf[w->pos], data, len);
+        w->pos += len;
+        return 0;
+    }
+    if (!w->flush) {
+        return (w->res = -ENOBUFS);
+    }
+    /* too large for the buffer: pass it on as it is */
+    if ((res = cbor_writer_flush(w)) < 0) {
+        return res;
+    }
+    if ((w->res = w->flush(w->arg, data, len)) == 0) {
+        w->flushed += len;
+    }
+    return w->res;
+}
+
+int cbor_writer_uint(cbor_writer_t *w, uint64_t val)
+{
+    return _head(w, CBOR_MAJOR_UINT, val);
+}
+
+int cbor_writer_int(cbor_writer_t *w, int64_t val)
+{
+    if (val < 0) {
+        /* -1 - val, without overflow for INT64_MIN */
+        return _head(w, CBOR_MAJOR_NEGINT, (uint64_t)(-(val + 1)));
+    }
+    return _head(w, CBOR_MAJOR_UINT, (uint64_t)val);
+}
+
+int cbor_writer_bool(cbor_writer_t *w, bool val)
+{
+    return _byte(w, val ? SIMPLE_TRUE : SIMPLE_FALSE);
+}
+
+int cbor_writer_null(cbor_writer_t *w)
+{
+    return _byte(w, SIMPLE_NULL);
+}
+
+int cbor_writer_bstr(cbor_writer_t *w, const void *data, size_t len)
+{
+    return _str(w, CBOR_MAJOR_BYTES, data, len);
+}
+
+int cbor_writer_tstr(cbor_writer_t *w, const char *str, size_t len)
+{
+    return _str(w, CBOR_MAJOR_TEXT, str, len);
+}
+
+int cbor_writer_array(cbor_writer_t *w, size_t numof)
+{
+    if (numof == CBOR_CURSOR_INDEFINITE) {
+        return _byte(w, (CBOR_MAJOR_ARRAY << 5) | INFO_INDEFINITE);
+    }
+    return _head(w, CBOR_MAJOR_ARRAY, numof);
+}
+
+int cbor_writer_map(cbor_writer_t *w, size_t numof)
+{
+    if (numof == CBOR_CURSOR_INDEFINITE) {
+        return _byte(w, (CBOR_MAJOR_MAP << 5) | INFO_INDEFINITE);
+    }
+    return _head(w, CBOR_MAJOR_MAP, numof);
+}
+
+int cbor_writer_tag(cbor_writer_t *w, uint64_t tag)
+{
+    return _head(w, CBOR_MAJOR_TAG, tag);
+}
+
+int cbor_writer_break(cbor_writer_t *w)
+{
+    return _byte(w, BREAK);
+}
+
+#ifdef MODULE_GNRC_PKTBUF
+int cbor_writer_flush_pktbuf(void *arg, const uint8_t *data, size_t len)
+{
+    cbor_writer_pktbuf_t *chain = arg;
+    gnrc_pktsnip_t *snip = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+
+    if (snip == NULL) {
+        return -ENOMEM;
+    }
+    /* the chain keeps the order the data was written in */
+    if (chain->head == NULL) {
+        chain->head = snip;
+    }
+    else {
+        chain->tail->next = snip;
+    }
+    chain->tail = snip;
+    return 0;
+}
+#endif
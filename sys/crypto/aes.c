@@ -33,6 +33,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include "crypto/aes.h"
 #include "crypto/ciphers.h"
@@ -45,10 +46,13 @@ static const cipher_interface_t aes_interface = {
     AES_KEY_SIZE,
     aes_init,
     aes_encrypt,
-    aes_decrypt
+    aes_decrypt,
+    aes_encrypt_blocks,
+    aes_decrypt_blocks
 };
 const cipher_id_t CIPHER_AES_128 = &aes_interface;
 
+#ifndef MODULE_CRYPTO_AES_BITSLICE
 static const u32 Te0[256] = {
     0xc66363a5U, 0xf87c7c84U, 0xee777799U, 0xf67b7b8dU,
     0xfff2f20dU, 0xd66b6bbdU, 0xde6f6fb1U, 0x91c5c554U,
@@ -718,6 +722,7 @@ static const u32 rcon[] = {
     0x10000000, 0x20000000, 0x40000000, 0x80000000,
     0x1B000000, 0x36000000,
 };
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
 
 
 int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
@@ -746,6 +751,7 @@ int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
     return CIPHER_INIT_SUCCESS;
 }
 
+#ifndef MODULE_CRYPTO_AES_BITSLICE
 /**
  * Expand the cipher key into the encryption key schedule.
  */
@@ -931,24 +937,13 @@ static int aes_set_decrypt_key(const unsigned char *userKey, const int bits,
     return 0;
 }
 
-#ifndef AES_ASM
 /*
  * Encrypt a single block
  * in and out can overlap
  */
-int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
-                uint8_t *cipherBlock)
+static void aes_encrypt_block(const AES_KEY *key, const uint8_t *plainBlock,
+                              uint8_t *cipherBlock)
 {
-    //setup AES_KEY
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-    res = aes_set_encrypt_key((unsigned char *)context->context,
-                                   AES_KEY_SIZE * 8, &aeskey);
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef FULL_UNROLL
@@ -1188,27 +1183,15 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         (Te4[(t2) & 0xff]       & 0x000000ff) ^
         rk[3];
     PUTU32(cipherBlock + 12, s3);
-    return 1;
 }
 
 /*
  * Decrypt a single block
  * in and out can overlap
  */
-int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
-                uint8_t *plainBlock)
+static void aes_decrypt_block(const AES_KEY *key, const uint8_t *cipherBlock,
+                              uint8_t *plainBlock)
 {
-    //setup AES_KEY
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-    res = aes_set_decrypt_key((unsigned char *)context->context,
-                              AES_KEY_SIZE * 8, &aeskey);
-
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef FULL_UNROLL
@@ -1448,7 +1431,681 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
         (Td4[(t0) & 0xff]       & 0x000000ff) ^
         rk[3];
     PUTU32(plainBlock + 12, s3);
+}
+static int _sw_encrypt_blocks(const uint8_t *key, const uint8_t *plain,
+                              uint8_t *cipher, size_t nblocks)
+{
+    AES_KEY aeskey;
+    int res = aes_set_encrypt_key(key, AES_KEY_SIZE * 8, &aeskey);
+
+    if (res < 0) {
+        return res;
+    }
+    /* the key schedule is expanded once for all blocks */
+    for (; nblocks > 0; nblocks--) {
+        aes_encrypt_block(&aeskey, plain, cipher);
+        plain += AES_BLOCK_SIZE;
+        cipher += AES_BLOCK_SIZE;
+    }
     return 1;
 }
 
-#endif /* AES_ASM */
+static int _sw_decrypt_blocks(const uint8_t *key, const uint8_t *cipher,
+                              uint8_t *plain, size_t nblocks)
+{
+    AES_KEY aeskey;
+    int res = aes_set_decrypt_key(key, AES_KEY_SIZE * 8, &aeskey);
+
+    if (res < 0) {
+        return res;
+    }
+    for (; nblocks > 0; nblocks--) {
+        aes_decrypt_block(&aeskey, cipher, plain);
+        cipher += AES_BLOCK_SIZE;
+        plain += AES_BLOCK_SIZE;
+    }
+    return 1;
+}
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
+
+#ifdef MODULE_CRYPTO_AES_BITSLICE
+/*
+ * Constant time implementation, bitsliced over two blocks: Each of the eight
+ * words of the state holds one bit of each of the 32 bytes, the S-box is
+ * computed with the circuit of Boyar and Peralta. There are no secret
+ * dependent memory accesses or branches, and the tables above are not
+ * compiled in. The layout of the state follows BearSSL's aes_ct.
+ */
+#define AES_BS_ROUNDS   (10)
+
+static inline uint32_t _dec32le(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+           ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static inline void _enc32le(uint8_t *dst, uint32_t x)
+{
+    dst[0] = (uint8_t)x;
+    dst[1] = (uint8_t)(x >> 8);
+    dst[2] = (uint8_t)(x >> 16);
+    dst[3] = (uint8_t)(x >> 24);
+}
+
+/* transposes the bits of q[], it is its own inverse */
+static void _bs_ortho(uint32_t *q)
+{
+#define SWAPN(cl, ch, s, x, y)  do { \
+        uint32_t a = (x), b = (y); \
+        (x) = (a & (uint32_t)cl) | ((b & (uint32_t)cl) << (s)); \
+        (y) = ((a & (uint32_t)ch) >> (s)) | (b & (uint32_t)ch); \
+    } while (0)
+#define SWAP2(x, y)     SWAPN(0x55555555, 0xAAAAAAAA, 1, x, y)
+#define SWAP4(x, y)     SWAPN(0x33333333, 0xCCCCCCCC, 2, x, y)
+#define SWAP8(x, y)     SWAPN(0x0F0F0F0F, 0xF0F0F0F0, 4, x, y)
+
+    SWAP2(q[0], q[1]);
+    SWAP2(q[2], q[3]);
+    SWAP2(q[4], q[5]);
+    SWAP2(q[6], q[7]);
+
+    SWAP4(q[0], q[2]);
+    SWAP4(q[1], q[3]);
+    SWAP4(q[4], q[6]);
+    SWAP4(q[5], q[7]);
+
+    SWAP8(q[0], q[4]);
+    SWAP8(q[1], q[5]);
+    SWAP8(q[2], q[6]);
+    SWAP8(q[3], q[7]);
+
+#undef SWAP8
+#undef SWAP4
+#undef SWAP2
+#undef SWAPN
+}
+
+static void _bs_sbox(uint32_t *q)
+{
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint32_t y20, y21;
+    uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/*
+ * The inverse S-box reuses the forward one: S(x) = A(I(x)) ^ 0x63 with the
+ * inversion I() and the affine map A(), so iS(x) = B(S(B(x ^ 0x63)) ^ 0x63)
+ * with B() the inverse of A().
+ */
+static void _bs_inv_affine(uint32_t *q)
+{
+    uint32_t q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3];
+    uint32_t q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+static void _bs_inv_sbox(uint32_t *q)
+{
+    _bs_inv_affine(q);
+    _bs_sbox(q);
+    _bs_inv_affine(q);
+}
+
+static inline void _bs_add_round_key(uint32_t *q, const uint32_t *sk)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] ^= sk[i];
+    }
+}
+
+static void _bs_shift_rows(uint32_t *q)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        uint32_t x = q[i];
+
+        q[i] = (x & 0x000000FF) |
+               ((x & 0x0000FC00) >> 2) | ((x & 0x00000300) << 6) |
+               ((x & 0x00F00000) >> 4) | ((x & 0x000F0000) << 4) |
+               ((x & 0xC0000000) >> 6) | ((x & 0x3F000000) << 2);
+    }
+}
+
+static void _bs_inv_shift_rows(uint32_t *q)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        uint32_t x = q[i];
+
+        q[i] = (x & 0x000000FF) |
+               ((x & 0x00003F00) << 2) | ((x & 0x0000C000) >> 6) |
+               ((x & 0x000F0000) << 4) | ((x & 0x00F00000) >> 4) |
+               ((x & 0x03000000) << 6) | ((x & 0xFC000000) >> 2);
+    }
+}
+
+static inline uint32_t _rotr8(uint32_t x)
+{
+    return (x >> 8) | (x << 24);
+}
+
+static inline uint32_t _rotr16(uint32_t x)
+{
+    return (x << 16) | (x >> 16);
+}
+
+static void _bs_mix_columns(uint32_t *q)
+{
+    uint32_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    uint32_t q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    uint32_t r0 = _rotr8(q0), r1 = _rotr8(q1), r2 = _rotr8(q2), r3 = _rotr8(q3);
+    uint32_t r4 = _rotr8(q4), r5 = _rotr8(q5), r6 = _rotr8(q6), r7 = _rotr8(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ _rotr16(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ _rotr16(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ _rotr16(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ _rotr16(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ _rotr16(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ _rotr16(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ _rotr16(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ _rotr16(q7 ^ r7);
+}
+
+/*
+ * InvMixColumns is MixColumns after multiplying each column with
+ * {04}x^2 + {05} (the row two positions further is xored in after a
+ * multiplication by {04})
+ */
+static void _bs_inv_mix_columns(uint32_t *q)
+{
+    uint32_t t[8];
+
+    for (unsigned i = 0; i < 8; i++) {
+        t[i] = q[i] ^ _rotr16(q[i]);
+    }
+    /* q ^= {04} * t */
+    q[0] ^= t[6];
+    q[1] ^= t[6] ^ t[7];
+    q[2] ^= t[0] ^ t[7];
+    q[3] ^= t[1] ^ t[6];
+    q[4] ^= t[2] ^ t[6] ^ t[7];
+    q[5] ^= t[3] ^ t[7];
+    q[6] ^= t[4];
+    q[7] ^= t[5];
+    _bs_mix_columns(q);
+}
+
+static uint32_t _bs_sub_word(uint32_t x)
+{
+    uint32_t q[8] = { x };
+
+    _bs_ortho(q);
+    _bs_sbox(q);
+    _bs_ortho(q);
+    return q[0];
+}
+
+/* expands the key into the bitsliced round keys, 8 words per round */
+static void _bs_key_schedule(uint32_t *skey, const uint8_t *key)
+{
+    static const uint8_t rcon[] = {
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36
+    };
+    uint32_t w[4];
+
+    for (unsigned i = 0; i < 4; i++) {
+        w[i] = _dec32le(key + (4 * i));
+    }
+    for (unsigned r = 0; r <= AES_BS_ROUNDS; r++) {
+        uint32_t *q = skey + (r << 3);
+
+        if (r > 0) {
+            uint32_t tmp = (w[3] << 24) | (w[3] >> 8);
+
+            w[0] ^= _bs_sub_word(tmp) ^ rcon[r - 1];
+            w[1] ^= w[0];
+            w[2] ^= w[1];
+            w[3] ^= w[2];
+        }
+        for (unsigned i = 0; i < 4; i++) {
+            q[2 * i] = w[i];
+            q[2 * i + 1] = w[i];
+        }
+        _bs_ortho(q);
+    }
+}
+
+static void _bs_load(uint32_t *q, const uint8_t *in, size_t nblocks)
+{
+    for (unsigned i = 0; i < 4; i++) {
+        q[2 * i] = _dec32le(in + (4 * i));
+        q[2 * i + 1] = (nblocks > 1) ? _dec32le(in + AES_BLOCK_SIZE + (4 * i)) : 0;
+    }
+    _bs_ortho(q);
+}
+
+static void _bs_store(uint8_t *out, uint32_t *q, size_t nblocks)
+{
+    _bs_ortho(q);
+    for (unsigned i = 0; i < 4; i++) {
+        _enc32le(out + (4 * i), q[2 * i]);
+        if (nblocks > 1) {
+            _enc32le(out + AES_BLOCK_SIZE + (4 * i), q[2 * i + 1]);
+        }
+    }
+}
+
+static int _sw_encrypt_blocks(const uint8_t *key, const uint8_t *plain,
+                              uint8_t *cipher, size_t nblocks)
+{
+    uint32_t skey[(AES_BS_ROUNDS + 1) * 8];
+    uint32_t q[8];
+
+    _bs_key_schedule(skey, key);
+    /* two blocks at a time */
+    while (nblocks > 0) {
+        size_t n = (nblocks > 1) ? 2 : 1;
+
+        _bs_load(q, plain, n);
+        _bs_add_round_key(q, skey);
+        for (unsigned r = 1; r < AES_BS_ROUNDS; r++) {
+            _bs_sbox(q);
+            _bs_shift_rows(q);
+            _bs_mix_columns(q);
+            _bs_add_round_key(q, skey + (r << 3));
+        }
+        _bs_sbox(q);
+        _bs_shift_rows(q);
+        _bs_add_round_key(q, skey + (AES_BS_ROUNDS << 3));
+        _bs_store(cipher, q, n);
+
+        plain += n * AES_BLOCK_SIZE;
+        cipher += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+    return 1;
+}
+
+static int _sw_decrypt_blocks(const uint8_t *key, const uint8_t *cipher,
+                              uint8_t *plain, size_t nblocks)
+{
+    uint32_t skey[(AES_BS_ROUNDS + 1) * 8];
+    uint32_t q[8];
+
+    _bs_key_schedule(skey, key);
+    while (nblocks > 0) {
+        size_t n = (nblocks > 1) ? 2 : 1;
+
+        _bs_load(q, cipher, n);
+        _bs_add_round_key(q, skey + (AES_BS_ROUNDS << 3));
+        for (unsigned r = AES_BS_ROUNDS - 1; r > 0; r--) {
+            _bs_inv_shift_rows(q);
+            _bs_inv_sbox(q);
+            _bs_add_round_key(q, skey + (r << 3));
+            _bs_inv_mix_columns(q);
+        }
+        _bs_inv_shift_rows(q);
+        _bs_inv_sbox(q);
+        _bs_add_round_key(q, skey);
+        _bs_store(plain, q, n);
+
+        cipher += n * AES_BLOCK_SIZE;
+        plain += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+    return 1;
+}
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
+
+#ifdef MODULE_CRYPTO_AES_NI
+/*
+ * AES-NI on x86 hosts (native). The functions are compiled for the AES
+ * instructions only, they are used if CPUID reports them.
+ */
+#if !defined(__i386__) && !defined(__x86_64__)
+#error "crypto_aes_ni: AES-NI is only available on x86"
+#endif
+
+#include <cpuid.h>
+#include <wmmintrin.h>
+
+#define AES_NI_ROUNDS   (10)
+#define AES_NI_TARGET   __attribute__((target("aes,sse2")))
+
+static bool _ni_supported(void)
+{
+    static int supported = -1;
+
+    if (supported < 0) {
+        unsigned a, b, c, d;
+        supported = __get_cpuid(1, &a, &b, &c, &d) && (c & bit_AES);
+    }
+    return supported;
+}
+
+AES_NI_TARGET static inline __m128i _ni_expand(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+#define NI_ROUND_KEY(rk, i, rcon) \
+    rk[i] = _ni_expand(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+AES_NI_TARGET static void _ni_key_schedule(__m128i *rk, const uint8_t *key)
+{
+    rk[0] = _mm_loadu_si128((const __m128i *)key);
+    NI_ROUND_KEY(rk, 1, 0x01);
+    NI_ROUND_KEY(rk, 2, 0x02);
+    NI_ROUND_KEY(rk, 3, 0x04);
+    NI_ROUND_KEY(rk, 4, 0x08);
+    NI_ROUND_KEY(rk, 5, 0x10);
+    NI_ROUND_KEY(rk, 6, 0x20);
+    NI_ROUND_KEY(rk, 7, 0x40);
+    NI_ROUND_KEY(rk, 8, 0x80);
+    NI_ROUND_KEY(rk, 9, 0x1B);
+    NI_ROUND_KEY(rk, 10, 0x36);
+}
+
+AES_NI_TARGET static void _ni_encrypt_blocks(const uint8_t *key, const uint8_t *plain,
+                                             uint8_t *cipher, size_t nblocks)
+{
+    __m128i rk[AES_NI_ROUNDS + 1];
+
+    _ni_key_schedule(rk, key);
+    /* four independent blocks keep the AES unit busy */
+    for (; nblocks >= 4; nblocks -= 4) {
+        const __m128i *in = (const __m128i *)plain;
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(in), rk[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(in + 1), rk[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(in + 2), rk[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(in + 3), rk[0]);
+
+        for (unsigned r = 1; r < AES_NI_ROUNDS; r++) {
+            b0 = _mm_aesenc_si128(b0, rk[r]);
+            b1 = _mm_aesenc_si128(b1, rk[r]);
+            b2 = _mm_aesenc_si128(b2, rk[r]);
+            b3 = _mm_aesenc_si128(b3, rk[r]);
+        }
+        __m128i *out = (__m128i *)cipher;
+        _mm_storeu_si128(out, _mm_aesenclast_si128(b0, rk[AES_NI_ROUNDS]));
+        _mm_storeu_si128(out + 1, _mm_aesenclast_si128(b1, rk[AES_NI_ROUNDS]));
+        _mm_storeu_si128(out + 2, _mm_aesenclast_si128(b2, rk[AES_NI_ROUNDS]));
+        _mm_storeu_si128(out + 3, _mm_aesenclast_si128(b3, rk[AES_NI_ROUNDS]));
+        plain += 4 * AES_BLOCK_SIZE;
+        cipher += 4 * AES_BLOCK_SIZE;
+    }
+    for (; nblocks > 0; nblocks--) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)plain), rk[0]);
+
+        for (unsigned r = 1; r < AES_NI_ROUNDS; r++) {
+            b = _mm_aesenc_si128(b, rk[r]);
+        }
+        _mm_storeu_si128((__m128i *)cipher, _mm_aesenclast_si128(b, rk[AES_NI_ROUNDS]));
+        plain += AES_BLOCK_SIZE;
+        cipher += AES_BLOCK_SIZE;
+    }
+}
+
+AES_NI_TARGET static void _ni_decrypt_blocks(const uint8_t *key, const uint8_t *cipher,
+                                             uint8_t *plain, size_t nblocks)
+{
+    __m128i ek[AES_NI_ROUNDS + 1];
+    __m128i dk[AES_NI_ROUNDS + 1];
+
+    /* equivalent inverse cipher: reversed keys, InvMixColumns applied */
+    _ni_key_schedule(ek, key);
+    dk[0] = ek[AES_NI_ROUNDS];
+    for (unsigned r = 1; r < AES_NI_ROUNDS; r++) {
+        dk[r] = _mm_aesimc_si128(ek[AES_NI_ROUNDS - r]);
+    }
+    dk[AES_NI_ROUNDS] = ek[0];
+
+    for (; nblocks >= 4; nblocks -= 4) {
+        const __m128i *in = (const __m128i *)cipher;
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(in), dk[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(in + 1), dk[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(in + 2), dk[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(in + 3), dk[0]);
+
+        for (unsigned r = 1; r < AES_NI_ROUNDS; r++) {
+            b0 = _mm_aesdec_si128(b0, dk[r]);
+            b1 = _mm_aesdec_si128(b1, dk[r]);
+            b2 = _mm_aesdec_si128(b2, dk[r]);
+            b3 = _mm_aesdec_si128(b3, dk[r]);
+        }
+        __m128i *out = (__m128i *)plain;
+        _mm_storeu_si128(out, _mm_aesdeclast_si128(b0, dk[AES_NI_ROUNDS]));
+        _mm_storeu_si128(out + 1, _mm_aesdeclast_si128(b1, dk[AES_NI_ROUNDS]));
+        _mm_storeu_si128(out + 2, _mm_aesdeclast_si128(b2, dk[AES_NI_ROUNDS]));
+        _mm_storeu_si128(out + 3, _mm_aesdeclast_si128(b3, dk[AES_NI_ROUNDS]));
+        cipher += 4 * AES_BLOCK_SIZE;
+        plain += 4 * AES_BLOCK_SIZE;
+    }
+    for (; nblocks > 0; nblocks--) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)cipher), dk[0]);
+
+        for (unsigned r = 1; r < AES_NI_ROUNDS; r++) {
+            b = _mm_aesdec_si128(b, dk[r]);
+        }
+        _mm_storeu_si128((__m128i *)plain, _mm_aesdeclast_si128(b, dk[AES_NI_ROUNDS]));
+        cipher += AES_BLOCK_SIZE;
+        plain += AES_BLOCK_SIZE;
+    }
+}
+#endif /* MODULE_CRYPTO_AES_NI */
+
+/*
+ * The backends are tried in order: AES peripheral, AES-NI, software
+ * (bitsliced or T-tables)
+ */
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *plain_blocks,
+                       uint8_t *cipher_blocks, size_t nblocks)
+{
+#ifdef MODULE_CRYPTO_AES_HW
+    if (aes_hw_encrypt_blocks(context->context, plain_blocks, cipher_blocks,
+                              nblocks) == 0) {
+        return 1;
+    }
+#endif
+#ifdef MODULE_CRYPTO_AES_NI
+    if (_ni_supported()) {
+        _ni_encrypt_blocks(context->context, plain_blocks, cipher_blocks, nblocks);
+        return 1;
+    }
+#endif
+    return _sw_encrypt_blocks(context->context, plain_blocks, cipher_blocks,
+                              nblocks);
+}
+
+int aes_decrypt_blocks(const cipher_context_t *context, const uint8_t *cipher_blocks,
+                       uint8_t *plain_blocks, size_t nblocks)
+{
+#ifdef MODULE_CRYPTO_AES_HW
+    if (aes_hw_decrypt_blocks(context->context, cipher_blocks, plain_blocks,
+                              nblocks) == 0) {
+        return 1;
+    }
+#endif
+#ifdef MODULE_CRYPTO_AES_NI
+    if (_ni_supported()) {
+        _ni_decrypt_blocks(context->context, cipher_blocks, plain_blocks, nblocks);
+        return 1;
+    }
+#endif
+    return _sw_decrypt_blocks(context->context, cipher_blocks, plain_blocks,
+                              nblocks);
+}
+
+int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
+                uint8_t *cipher_block)
+{
+    return aes_encrypt_blocks(context, plain_block, cipher_block, 1);
+}
+
+int aes_decrypt(const cipher_context_t *context, const uint8_t *cipher_block,
+                uint8_t *plain_block)
+{
+    return aes_decrypt_blocks(context, cipher_block, plain_block, 1);
+}
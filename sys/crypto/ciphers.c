@@ -44,6 +44,46 @@ int cipher_decrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output
 }
 
 
+int cipher_encrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t nblocks)
+{
+    const cipher_interface_t *iface = cipher->interface;
+
+    if (iface->encrypt_blocks != NULL) {
+        return iface->encrypt_blocks(&cipher->context, input, output, nblocks);
+    }
+    for (; nblocks > 0; nblocks--) {
+        int res = iface->encrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += iface->block_size;
+        output += iface->block_size;
+    }
+    return 1;
+}
+
+
+int cipher_decrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t nblocks)
+{
+    const cipher_interface_t *iface = cipher->interface;
+
+    if (iface->decrypt_blocks != NULL) {
+        return iface->decrypt_blocks(&cipher->context, input, output, nblocks);
+    }
+    for (; nblocks > 0; nblocks--) {
+        int res = iface->decrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += iface->block_size;
+        output += iface->block_size;
+    }
+    return 1;
+}
+
+
 int cipher_get_block_size(const cipher_t* cipher)
 {
     return cipher->interface->block_size;
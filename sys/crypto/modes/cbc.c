@@ -58,7 +58,9 @@ int cipher_decrypt_cbc(cipher_t* cipher, uint8_t iv[16],
                        uint8_t* input, size_t length, uint8_t* output)
 {
     size_t offset = 0;
-    uint8_t* input_block, *input_block_last, block_size;
+    uint8_t plain[CIPHER_BATCH_BLOCKS * CIPHER_MAX_BLOCK_SIZE],
+            input_block_last[CIPHER_MAX_BLOCK_SIZE],
+            next_block_last[CIPHER_MAX_BLOCK_SIZE], block_size;
 
 
     block_size = cipher_get_block_size(cipher);
@@ -66,23 +68,35 @@ int cipher_decrypt_cbc(cipher_t* cipher, uint8_t iv[16],
         return CIPHER_ERR_INVALID_LENGTH;
     }
 
-    input_block_last = iv;
-    do {
-        input_block = input + offset;
+    memcpy(input_block_last, iv, block_size);
+    while (offset < length) {
+        size_t nblocks = (length - offset) / block_size;
+        uint8_t *input_block = input + offset;
         uint8_t *output_block = output + offset;
 
-        if (cipher_decrypt(cipher, input_block, output_block) != 1) {
+        /* unlike encryption, the blocks can be decrypted at once */
+        nblocks = (nblocks < CIPHER_BATCH_BLOCKS) ? nblocks : CIPHER_BATCH_BLOCKS;
+        if (cipher_decrypt_blocks(cipher, input_block, plain, nblocks) != 1) {
             return CIPHER_ERR_DEC_FAILED;
         }
 
-        /* CBC-Mode: XOR plaintext with ciphertext of (n-1)-th block */
-        for (uint8_t i = 0; i < block_size; ++i) {
-            output_block[i] ^= input_block_last[i];
+        /* the last ciphertext block is needed by the next batch */
+        memcpy(next_block_last, input_block + (nblocks - 1) * block_size,
+               block_size);
+
+        /* CBC-Mode: XOR plaintext with ciphertext of (n-1)-th block, from the
+         * last block on so that input and output may be the same */
+        for (size_t n = nblocks; n-- > 0;) {
+            const uint8_t *prev = (n > 0) ? input_block + (n - 1) * block_size
+                                          : input_block_last;
+            for (uint8_t i = 0; i < block_size; ++i) {
+                output_block[n * block_size + i] = plain[n * block_size + i] ^ prev[i];
+            }
         }
+        memcpy(input_block_last, next_block_last, block_size);
 
-        input_block_last = input_block;
-        offset += block_size;
-    } while (offset < length);
+        offset += nblocks * block_size;
+    }
 
     return offset;
 }
@@ -18,6 +18,8 @@
 * @}
 */
 
+#include <string.h>
+
 #include "crypto/helper.h"
 #include "crypto/modes/ctr.h"
 
@@ -26,24 +28,31 @@ int cipher_encrypt_ctr(cipher_t* cipher, uint8_t nonce_counter[16],
                        uint8_t* output)
 {
     size_t offset = 0;
-    uint8_t stream_block[16] = {0}, block_size;
+    uint8_t stream[CIPHER_BATCH_BLOCKS * CIPHER_MAX_BLOCK_SIZE], block_size;
 
     block_size = cipher_get_block_size(cipher);
     do {
-        uint8_t block_size_input;
+        size_t nblocks = 0, len;
+
+        /* the key stream of several blocks is generated at once */
+        do {
+            memcpy(stream + nblocks * block_size, nonce_counter, block_size);
+            crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+            nblocks++;
+        } while ((nblocks < CIPHER_BATCH_BLOCKS) &&
+                 (offset + nblocks * block_size < length));
 
-        if (cipher_encrypt(cipher, nonce_counter, stream_block) != 1) {
+        if (cipher_encrypt_blocks(cipher, stream, stream, nblocks) != 1) {
             return CIPHER_ERR_ENC_FAILED;
         }
 
-        block_size_input = (length - offset > block_size) ?
-                           block_size : length - offset;
-        for (uint8_t i = 0; i < block_size_input; ++i) {
-            output[offset + i] = stream_block[i] ^ input[offset + i];
+        len = (length - offset > nblocks * block_size) ?
+              nblocks * block_size : length - offset;
+        for (size_t i = 0; i < len; ++i) {
+            output[offset + i] = stream[i] ^ input[offset + i];
         }
 
-        offset += block_size_input;
-        crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+        offset += len;
     } while (offset < length);
 
     return offset;
@@ -46,6 +46,8 @@ static off_t constfs_lseek(vfs_file_t *filp, off_t off, int whence);
 static int constfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mode, const char *abs_path);
 static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes);
 static ssize_t constfs_write(vfs_file_t *filp, const void *src, size_t nbytes);
+static ssize_t constfs_readv(vfs_file_t *filp, const struct iovec *iov, int iovcnt);
+static ssize_t constfs_pread(vfs_file_t *filp, void *dest, size_t nbytes, off_t off);
 
 /* Directory operations */
 static int constfs_opendir(vfs_DIR *dirp, const char *dirname, const char *abs_path);
@@ -67,6 +69,8 @@ static const vfs_file_ops_t constfs_file_ops = {
     .open  = constfs_open,
     .read  = constfs_read,
     .write = constfs_write,
+    .readv = constfs_readv,
+    .pread = constfs_pread,
 };
 
 static const vfs_dir_ops_t constfs_dir_ops = {
@@ -230,19 +234,42 @@ static int constfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mo
 
 static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes)
 {
-    constfs_file_t *fp = filp->private_data.ptr;
     DEBUG("constfs_read: %p, %p, %lu\n", (void *)filp, dest, (unsigned long)nbytes);
-    if ((size_t)filp->pos >= fp->size) {
-        /* Current offset is at or beyond end of file */
+    nbytes = constfs_pread(filp, dest, nbytes, filp->pos);
+    filp->pos += nbytes;
+    return nbytes;
+}
+
+static ssize_t constfs_readv(vfs_file_t *filp, const struct iovec *iov, int iovcnt)
+{
+    DEBUG("constfs_readv: %p, %p, %d\n", (void *)filp, (void *)iov, iovcnt);
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        size_t nbytes = constfs_pread(filp, iov[i].iov_base, iov[i].iov_len, filp->pos);
+        filp->pos += nbytes;
+        total += nbytes;
+        if (nbytes < iov[i].iov_len) {
+            /* end of file */
+            break;
+        }
+    }
+    return total;
+}
+
+static ssize_t constfs_pread(vfs_file_t *filp, void *dest, size_t nbytes, off_t off)
+{
+    constfs_file_t *fp = filp->private_data.ptr;
+    DEBUG("constfs_pread: %p, %p, %lu, %ld\n", (void *)filp, dest, (unsigned long)nbytes, (long)off);
+    if ((size_t)off >= fp->size) {
+        /* offset is at or beyond end of file */
         return 0;
     }
 
-    if (nbytes > (fp->size - filp->pos)) {
-        nbytes = fp->size - filp->pos;
+    if (nbytes > (fp->size - off)) {
+        nbytes = fp->size - off;
     }
-    memcpy(dest, fp->data + filp->pos, nbytes);
-    DEBUG("constfs_read: read %d bytes\n", nbytes);
-    filp->pos += nbytes;
+    memcpy(dest, fp->data + off, nbytes);
+    DEBUG("constfs_pread: read %lu bytes\n", (unsigned long)nbytes);
     return nbytes;
 }
 
@@ -45,8 +45,9 @@
  * @}
  */
 
-#include <string.h>
 #include <assert.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include "hashes/sha256.h"
 
@@ -122,41 +123,153 @@ static const uint32_t K[64] = {
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
 };
 
+/* One round, the variables are renamed instead of being shifted */
+#define RND(a, b, c, d, e, f, g, h, k, w) do { \
+        uint32_t t0 = h + S1(e) + Ch(e, f, g) + k + w; \
+        uint32_t t1 = S0(a) + Maj(a, b, c); \
+        d += t0; \
+        h = t0 + t1; \
+    } while (0)
+
+/* Next word of the message schedule, kept in a ring of 16 words */
+#define WX(i)   (W[(i) & 15] += s1(W[((i) - 2) & 15]) + W[((i) - 7) & 15] + \
+                                s0(W[((i) - 15) & 15]))
+
 /*
  * SHA256 block compression function.  The 256-bit state is transformed via
  * the 512-bit input block to produce a new state.
  */
-static void sha256_transform(uint32_t *state, const unsigned char block[64])
+static void sha256_transform_block(uint32_t *state, const unsigned char block[64])
 {
-    uint32_t W[64];
-    uint32_t S[8];
+    uint32_t W[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
 
-    /* 1. Prepare message schedule W. */
     be32dec_vect(W, block, 64);
-    for (int i = 16; i < 64; i++) {
-        W[i] = s1(W[i - 2]) + W[i - 7] + s0(W[i - 15]) + W[i - 16];
+
+    /* eight rounds per iteration bring the variables back in place */
+    for (unsigned i = 0; i < 16; i += 8) {
+        RND(a, b, c, d, e, f, g, h, K[i + 0], W[i + 0]);
+        RND(h, a, b, c, d, e, f, g, K[i + 1], W[i + 1]);
+        RND(g, h, a, b, c, d, e, f, K[i + 2], W[i + 2]);
+        RND(f, g, h, a, b, c, d, e, K[i + 3], W[i + 3]);
+        RND(e, f, g, h, a, b, c, d, K[i + 4], W[i + 4]);
+        RND(d, e, f, g, h, a, b, c, K[i + 5], W[i + 5]);
+        RND(c, d, e, f, g, h, a, b, K[i + 6], W[i + 6]);
+        RND(b, c, d, e, f, g, h, a, K[i + 7], W[i + 7]);
+    }
+    for (unsigned i = 16; i < 64; i += 8) {
+        RND(a, b, c, d, e, f, g, h, K[i + 0], WX(i + 0));
+        RND(h, a, b, c, d, e, f, g, K[i + 1], WX(i + 1));
+        RND(g, h, a, b, c, d, e, f, K[i + 2], WX(i + 2));
+        RND(f, g, h, a, b, c, d, e, K[i + 3], WX(i + 3));
+        RND(e, f, g, h, a, b, c, d, K[i + 4], WX(i + 4));
+        RND(d, e, f, g, h, a, b, c, K[i + 5], WX(i + 5));
+        RND(c, d, e, f, g, h, a, b, K[i + 6], WX(i + 6));
+        RND(b, c, d, e, f, g, h, a, K[i + 7], WX(i + 7));
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+#ifdef MODULE_HASHES_SHA256_NI
+/*
+ * SHA extensions on x86 hosts (native). The function is compiled for the SHA
+ * instructions only, it is used if CPUID reports them.
+ */
+#if !defined(__i386__) && !defined(__x86_64__)
+#error "hashes_sha256_ni: the SHA extensions are only available on x86"
+#endif
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+static bool sha256_ni_supported(void)
+{
+    static int supported = -1;
+
+    if (supported < 0) {
+        unsigned a, b, c, d;
+        supported = (__get_cpuid_max(0, NULL) >= 7);
+        if (supported) {
+            __cpuid_count(7, 0, a, b, c, d);
+            supported = !!(b & bit_SHA);
+            __cpuid(1, a, b, c, d);
+            supported = supported && (c & bit_SSE4_1) && (c & bit_SSSE3);
+        }
     }
+    return supported;
+}
 
-    /* 2. Initialize working variables. */
-    memcpy(S, state, 32);
+__attribute__((target("sha,sse4.1")))
+static void sha256_ni_transform(uint32_t *state, const unsigned char *data,
+                                size_t nblocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, tmp;
+
+    /* the instructions want the state as ABEF and CDGH */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
 
-    /* 3. Mix. */
-    for (int i = 0; i < 64; ++i) {
-        uint32_t e = S[(68 - i) % 8], f = S[(69 - i) % 8];
-        uint32_t g = S[(70 - i) % 8], h = S[(71 - i) % 8];
-        uint32_t t0 = h + S1(e) + Ch(e, f, g) + W[i] + K[i];
+    for (; nblocks > 0; nblocks--, data += 64) {
+        __m128i abef = state0, cdgh = state1;
+        __m128i msg[4];
 
-        uint32_t a = S[(64 - i) % 8], b = S[(65 - i) % 8];
-        uint32_t c = S[(66 - i) % 8], d = S[(67 - i) % 8];
-        uint32_t t1 = S0(a) + Maj(a, b, c);
+        for (unsigned i = 0; i < 16; i++) {
+            __m128i m;
 
-        S[(67 - i) % 8] = d + t0;
-        S[(71 - i) % 8] = t0 + t1;
+            if (i < 4) {
+                msg[i] = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(data + 16 * i)), mask);
+            }
+            m = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *)&K[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+            if ((i >= 3) && (i < 15)) {
+                tmp = _mm_alignr_epi8(msg[i & 3], msg[(i - 1) & 3], 4);
+                msg[(i + 1) & 3] = _mm_add_epi32(msg[(i + 1) & 3], tmp);
+                msg[(i + 1) & 3] = _mm_sha256msg2_epu32(msg[(i + 1) & 3], msg[i & 3]);
+            }
+            m = _mm_shuffle_epi32(m, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+            if ((i >= 1) && (i < 13)) {
+                msg[(i - 1) & 3] = _mm_sha256msg1_epu32(msg[(i - 1) & 3], msg[i & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
     }
 
-    /* 4. Mix local working variables into global state */
-    for (int i = 0; i < 8; i++) {
-        state[i] += S[i];
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i *)&state[0], state0);
+    _mm_storeu_si128((__m128i *)&state[4], state1);
+}
+#endif /* MODULE_HASHES_SHA256_NI */
+
+static void sha256_transform(uint32_t *state, const unsigned char *data,
+                             size_t nblocks)
+{
+#ifdef MODULE_HASHES_SHA256_NI
+    if (sha256_ni_supported()) {
+        sha256_ni_transform(state, data, nblocks);
+        return;
+    }
+#endif
+    for (; nblocks > 0; nblocks--, data += 64) {
+        sha256_transform_block(state, data);
     }
 }
 
@@ -231,16 +344,14 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     const unsigned char *src = data;
 
     memcpy(&ctx->buf[r], src, 64 - r);
-    sha256_transform(ctx->state, ctx->buf);
+    sha256_transform(ctx->state, ctx->buf, 1);
     src += 64 - r;
     len -= 64 - r;
 
     /* Perform complete blocks */
-    while (len >= 64) {
-        sha256_transform(ctx->state, src);
-        src += 64;
-        len -= 64;
-    }
+    sha256_transform(ctx->state, src, len / 64);
+    src += len & ~(size_t)0x3f;
+    len &= 0x3f;
 
     /* Copy left over data into buffer */
     memcpy(ctx->buf, src, len);
@@ -279,7 +390,34 @@ void *sha256(const void *data, size_t len, void *digest)
 }
 
 
-void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
+/*
+ * Hashes a 32 byte message that follows the blocks already compressed into
+ * state_in, with the padding block built in place instead of going through
+ * the buffer of a context.
+ */
+static void sha256_final32(const uint32_t state_in[8], uint32_t prefix_blocks,
+                           const void *data, void *digest)
+{
+    uint32_t state[8];
+    unsigned char block[64];
+    uint32_t bitlen[2] = { 0, (prefix_blocks * 64 + SHA256_DIGEST_LENGTH) << 3 };
+
+    memcpy(block, data, SHA256_DIGEST_LENGTH);
+    memcpy(&block[SHA256_DIGEST_LENGTH], PAD, 64 - SHA256_DIGEST_LENGTH - 8);
+    be32enc_vect(&block[56], bitlen, sizeof(bitlen));
+
+    memcpy(state, state_in, sizeof(state));
+    sha256_transform(state, block, 1);
+    be32enc_vect(digest, state, SHA256_DIGEST_LENGTH);
+}
+
+static const uint32_t sha256_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+void hmac_sha256_precompute(hmac_sha256_key_t *key_state, const void *key,
+                            size_t key_length)
 {
     unsigned char k[SHA256_INTERNAL_BLOCK_SIZE];
 
@@ -293,32 +431,47 @@ void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
     }
 
     /*
-     * create the inner and outer keypads
+     * Compress the inner and outer keypads, each fills one block
      * rising hamming distance enforcing i_* and o_* are distinct
      * in at least one bit
      */
-    unsigned char o_key_pad[SHA256_INTERNAL_BLOCK_SIZE];
-    unsigned char i_key_pad[SHA256_INTERNAL_BLOCK_SIZE];
+    unsigned char key_pad[SHA256_INTERNAL_BLOCK_SIZE];
 
     for (size_t i = 0; i < SHA256_INTERNAL_BLOCK_SIZE; ++i) {
-        o_key_pad[i] = 0x5c ^ k[i];
-        i_key_pad[i] = 0x36 ^ k[i];
+        key_pad[i] = 0x36 ^ k[i];
     }
+    memcpy(key_state->in, sha256_iv, sizeof(key_state->in));
+    sha256_transform(key_state->in, key_pad, 1);
 
-    /*
-     * Initiate calculation of the inner hash
-     * tmp = hash(i_key_pad CONCAT message)
-     */
-    sha256_init(&ctx->c_in);
-    sha256_update(&ctx->c_in, i_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    for (size_t i = 0; i < SHA256_INTERNAL_BLOCK_SIZE; ++i) {
+        key_pad[i] = 0x5c ^ k[i];
+    }
+    memcpy(key_state->out, sha256_iv, sizeof(key_state->out));
+    sha256_transform(key_state->out, key_pad, 1);
 
-    /*
-     * Initiate calculation of the outer hash
-     * result = hash(o_key_pad CONCAT tmp)
-     */
-    sha256_init(&ctx->c_out);
-    sha256_update(&ctx->c_out, o_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    memset(k, 0, sizeof(k));
+    memset(key_pad, 0, sizeof(key_pad));
+}
 
+void hmac_sha256_init_precomputed(hmac_context_t *ctx,
+                                  const hmac_sha256_key_t *key_state)
+{
+    /* both hashes continue after one block of key pad */
+    memcpy(ctx->c_in.state, key_state->in, sizeof(ctx->c_in.state));
+    ctx->c_in.count[0] = 0;
+    ctx->c_in.count[1] = SHA256_INTERNAL_BLOCK_SIZE << 3;
+
+    memcpy(ctx->c_out.state, key_state->out, sizeof(ctx->c_out.state));
+    ctx->c_out.count[0] = 0;
+    ctx->c_out.count[1] = SHA256_INTERNAL_BLOCK_SIZE << 3;
+}
+
+void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
+{
+    hmac_sha256_key_t key_state;
+
+    hmac_sha256_precompute(&key_state, key, key_length);
+    hmac_sha256_init_precomputed(ctx, &key_state);
 }
 
 void hmac_sha256_update(hmac_context_t *ctx, const void *data, size_t len)
@@ -337,8 +490,9 @@ void hmac_sha256_final(hmac_context_t *ctx, void *digest)
     }
 
     sha256_final(&ctx->c_in, tmp);
-    sha256_update(&ctx->c_out, tmp, SHA256_DIGEST_LENGTH);
-    sha256_final(&ctx->c_out, digest);
+    /* result = hash(o_key_pad CONCAT tmp), the key pad is compressed already */
+    sha256_final32(ctx->c_out.state, 1, tmp, digest);
+    memset((void *)&ctx->c_out, 0, sizeof(ctx->c_out));
 }
 
 const void *hmac_sha256(const void *key, size_t key_length,
@@ -354,6 +508,145 @@ const void *hmac_sha256(const void *key, size_t key_length,
     return digest;
 }
 
+const void *hmac_sha256_precomputed(const hmac_sha256_key_t *key_state,
+                                    const void *data, size_t len, void *digest)
+{
+    hmac_context_t ctx;
+
+    hmac_sha256_init_precomputed(&ctx, key_state);
+    hmac_sha256_update(&ctx, data, len);
+    hmac_sha256_final(&ctx, digest);
+
+    return digest;
+}
+
+/*
+ * Multi-buffer hashing: the messages of up to SHA256_MULTI_LANES lanes are
+ * compressed together, one block of each lane per round loop. The lanes are
+ * independent, so the compiler either puts them into one vector register
+ * (SSE2 on native) or interleaves them to fill the pipeline.
+ */
+typedef uint32_t sha256_lanes_t __attribute__((vector_size(4 * SHA256_MULTI_LANES)));
+
+static void sha256_multi_transform(sha256_lanes_t state[8],
+                                   const sha256_lanes_t block[16],
+                                   const sha256_lanes_t *active)
+{
+    sha256_lanes_t W[16], S[8], t0, t1;
+
+    memcpy(W, block, sizeof(W));
+    memcpy(S, state, sizeof(S));
+
+    for (unsigned i = 0; i < 64; i++) {
+        if (i >= 16) {
+            W[i & 15] += s1(W[(i - 2) & 15]) + W[(i - 7) & 15] + s0(W[(i - 15) & 15]);
+        }
+        t0 = S[7] + S1(S[4]) + Ch(S[4], S[5], S[6]) + K[i] + W[i & 15];
+        t1 = S0(S[0]) + Maj(S[0], S[1], S[2]);
+        S[7] = S[6];
+        S[6] = S[5];
+        S[5] = S[4];
+        S[4] = S[3] + t0;
+        S[3] = S[2];
+        S[2] = S[1];
+        S[1] = S[0];
+        S[0] = t0 + t1;
+    }
+
+    /* lanes that ran out of blocks keep their state */
+    for (unsigned i = 0; i < 8; i++) {
+        state[i] += S[i] & *active;
+    }
+}
+
+/* Big endian words of block number n of a message, including the padding */
+static void sha256_multi_load(uint32_t w[16], const unsigned char *data,
+                              size_t len, size_t n)
+{
+    unsigned char block[64];
+    size_t offset = n * 64;
+    const unsigned char *src = block;
+
+    if (offset + 64 <= len) {
+        src = data + offset;
+    }
+    else {
+        memset(block, 0, sizeof(block));
+        if (offset <= len) {
+            memcpy(block, data + offset, len - offset);
+            block[len - offset] = 0x80;
+        }
+        /* the 64 bit length ends the last block */
+        if (offset + 64 >= len + 9) {
+            uint32_t bitlen[2] = { (uint32_t)((uint64_t)len >> 29), (uint32_t)(len << 3) };
+            be32enc_vect(&block[56], bitlen, sizeof(bitlen));
+        }
+    }
+    be32dec_vect(w, src, 64);
+}
+
+void sha256_multi(const void *const data[], const size_t len[],
+                  void *const digest[], size_t numof)
+{
+#ifdef MODULE_HASHES_SHA256_NI
+    /* one message after another is faster with the SHA extensions */
+    if (sha256_ni_supported()) {
+        for (size_t i = 0; i < numof; i++) {
+            sha256(data[i], len[i], digest[i]);
+        }
+        return;
+    }
+#endif
+    for (size_t base = 0; base < numof; base += SHA256_MULTI_LANES) {
+        unsigned lanes = (numof - base < SHA256_MULTI_LANES) ?
+                         (numof - base) : SHA256_MULTI_LANES;
+        size_t blocks[SHA256_MULTI_LANES] = { 0 };
+        size_t max_blocks = 0;
+        sha256_lanes_t state[8];
+        sha256_lanes_t block[16];
+
+        for (unsigned l = 0; l < lanes; l++) {
+            /* 0x80 and the 64 bit length need 9 bytes */
+            blocks[l] = (len[base + l] + 9 + 63) / 64;
+            if (blocks[l] > max_blocks) {
+                max_blocks = blocks[l];
+            }
+        }
+        for (unsigned i = 0; i < 8; i++) {
+            for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+                state[i][l] = sha256_iv[i];
+            }
+        }
+
+        for (size_t n = 0; n < max_blocks; n++) {
+            sha256_lanes_t active;
+
+            for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+                uint32_t w[16] = { 0 };
+
+                active[l] = 0;
+                if ((l < lanes) && (n < blocks[l])) {
+                    sha256_multi_load(w, data[base + l], len[base + l], n);
+                    active[l] = UINT32_MAX;
+                }
+                for (unsigned i = 0; i < 16; i++) {
+                    block[i][l] = w[i];
+                }
+            }
+            sha256_multi_transform(state, block, &active);
+        }
+
+        for (unsigned l = 0; l < lanes; l++) {
+            uint32_t out[8];
+
+            for (unsigned i = 0; i < 8; i++) {
+                out[i] = state[i][l];
+            }
+            be32enc_vect(digest[base + l], out, SHA256_DIGEST_LENGTH);
+        }
+    }
+}
+
 /**
  * @brief helper to compute sha256 inplace for the given buffer
  *
@@ -362,11 +655,7 @@ const void *hmac_sha256(const void *key, size_t key_length,
  */
 static inline void sha256_inplace(unsigned char element[SHA256_DIGEST_LENGTH])
 {
-    sha256_context_t ctx;
-
-    sha256_init(&ctx);
-    sha256_update(&ctx, element, SHA256_DIGEST_LENGTH);
-    sha256_final(&ctx, element);
+    sha256_final32(sha256_iv, 0, element, element);
 }
 
 void *sha256_chain(const void *seed, size_t seed_length,
@@ -415,10 +704,8 @@ void *sha256_chain_with_waypoints(const void *seed,
 
         /* perform consecutive iterations starting at index 1*/
         for (size_t i = 1; i < elements; ++i) {
-            sha256_context_t ctx;
-            sha256_init(&ctx);
-            sha256_update(&ctx, waypoints[(i - 1)].element, SHA256_DIGEST_LENGTH);
-            sha256_final(&ctx, waypoints[i].element);
+            sha256_final32(sha256_iv, 0, waypoints[(i - 1)].element,
+                           waypoints[i].element);
             waypoints[i].index = i;
         }
 
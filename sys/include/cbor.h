@@ -27,6 +27,11 @@
  *   throughout the implementation
  * - User may allocate static buffers, this implementation uses the space
  *   provided by them (cf. @ref cbor_stream_t)
+ * - Decoding without copies: a @ref cbor_cursor_t walks the encoded data,
+ *   skips containers it is not interested in and hands out strings as
+ *   pointers into the buffer; @ref cbor_index_t adds positional access
+ * - Encoding into a buffer of any size: a @ref cbor_writer_t passes full
+ *   buffers on to a flush function, e.g. into a packet buffer chain
  *
  * @par Supported types (categorized by major type (MT)):
  *
@@ -109,6 +114,10 @@
 #include <time.h>
 #endif /* CBOR_NO_CTIME */
 
+#ifdef MODULE_GNRC_PKTBUF
+#include "net/gnrc/pkt.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -653,6 +662,541 @@ bool cbor_at_break(const cbor_stream_t *stream, size_t offset);
  */
 bool cbor_at_end(const cbor_stream_t *stream, size_t offset);
 
+/**
+ * @name Zero-copy pull parser
+ *
+ * A cbor_cursor_t walks over encoded data item by item, without copying
+ * anything: strings are handed out as pointers into the data. Containers are
+ * entered with cbor_cursor_enter() and left with cbor_cursor_leave(); items
+ * that are of no interest are passed over with cbor_skip(), which steps over
+ * strings by their length and over containers by counting their items,
+ * without decoding them.
+ *
+ * @code
+ * cbor_cursor_t it, map, value;
+ * uint64_t id;
+ *
+ * cbor_cursor_init(&it, payload, payload_len);
+ * if ((cbor_cursor_enter(&it, &map) == 0) &&
+ *     (cbor_map_find(&map, "id", &value) == 0) &&
+ *     (cbor_get_uint(&value, &id) == 0)) {
+ *     ...
+ * }
+ * @endcode
+ *
+ * The functions return 0 on success, -ENOENT at the end of a container,
+ * -EINVAL if the item has another type, -EBADMSG on malformed or truncated
+ * data and -EOVERFLOW if a value does not fit.
+ * @{
+ */
+
+/**
+ * @brief Major types as returned by cbor_cursor_type()
+ */
+typedef enum {
+    CBOR_MAJOR_UINT = 0,    /**< unsigned integer */
+    CBOR_MAJOR_NEGINT,      /**< negative integer */
+    CBOR_MAJOR_BYTES,       /**< byte string */
+    CBOR_MAJOR_TEXT,        /**< unicode string */
+    CBOR_MAJOR_ARRAY,       /**< array */
+    CBOR_MAJOR_MAP,         /**< map */
+    CBOR_MAJOR_TAG,         /**< semantic tag */
+    CBOR_MAJOR_SIMPLE,      /**< floats and simple values */
+} cbor_major_t;
+
+/**
+ * @brief Maximum nesting of indefinite length items cbor_skip() can step over
+ */
+#ifndef CBOR_SKIP_DEPTH
+#define CBOR_SKIP_DEPTH         (8U)
+#endif
+
+/**
+ * @brief Number of items left in an indefinite length container
+ */
+#define CBOR_CURSOR_INDEFINITE  (SIZE_MAX)
+
+/**
+ * @brief Position within CBOR encoded data
+ */
+typedef struct {
+    const uint8_t *data;    /**< encoded data */
+    size_t len;             /**< length of the encoded data */
+    size_t pos;             /**< offset of the next item */
+    size_t remaining;       /**< items left in the current container, or
+                                 CBOR_CURSOR_INDEFINITE */
+} cbor_cursor_t;
+
+/**
+ * @brief Points a cursor at the first top level item of @p data
+ *
+ * @param[out] it       the cursor
+ * @param[in] data      CBOR encoded data, must stay valid while it is parsed
+ * @param[in] len       length of @p data
+ */
+void cbor_cursor_init(cbor_cursor_t *it, const uint8_t *data, size_t len);
+
+/**
+ * @brief Whether there are no more items at the level of @p it
+ *
+ * @param[in] it        the cursor
+ *
+ * @return true at the end of the container (or of the data on top level)
+ */
+bool cbor_cursor_at_end(const cbor_cursor_t *it);
+
+/**
+ * @brief Returns the major type of the next item
+ *
+ * @param[in] it        the cursor
+ *
+ * @return  the @ref cbor_major_t of the item
+ * @return  -ENOENT at the end of the container
+ */
+int cbor_cursor_type(const cbor_cursor_t *it);
+
+/**
+ * @brief Reads an unsigned integer and advances @p it
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] val      the value
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_get_uint(cbor_cursor_t *it, uint64_t *val);
+
+/**
+ * @brief Reads an unsigned or negative integer and advances @p it
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] val      the value
+ *
+ * @return  0 on success
+ * @return  -EOVERFLOW if the value does not fit into @p val
+ * @return  other values < 0 on error
+ */
+int cbor_get_int(cbor_cursor_t *it, int64_t *val);
+
+/**
+ * @brief Reads a boolean and advances @p it
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] val      the value
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_get_bool(cbor_cursor_t *it, bool *val);
+
+/**
+ * @brief Reads null and advances @p it
+ *
+ * @param[in,out] it    the cursor
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_get_null(cbor_cursor_t *it);
+
+/**
+ * @brief Reads a definite length byte string and advances @p it
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] buf      the string within the data of @p it
+ * @param[out] len      length of the string
+ *
+ * @return  0 on success
+ * @return  -ENOTSUP for indefinite length strings
+ * @return  other values < 0 on error
+ */
+int cbor_get_bstr(cbor_cursor_t *it, const uint8_t **buf, size_t *len);
+
+/**
+ * @brief Reads a definite length unicode string and advances @p it
+ *
+ * The string is not zero terminated.
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] buf      the string within the data of @p it
+ * @param[out] len      length of the string
+ *
+ * @return  0 on success
+ * @return  -ENOTSUP for indefinite length strings
+ * @return  other values < 0 on error
+ */
+int cbor_get_tstr(cbor_cursor_t *it, const char **buf, size_t *len);
+
+/**
+ * @brief Reads a semantic tag
+ *
+ * The tagged item follows at @p it.
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] tag      the tag
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_get_tag(cbor_cursor_t *it, uint64_t *tag);
+
+#ifndef CBOR_NO_FLOAT
+/**
+ * @brief Reads a half, single or double precision float and advances @p it
+ *
+ * @param[in,out] it    the cursor
+ * @param[out] val      the value
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_get_double(cbor_cursor_t *it, double *val);
+#endif /* CBOR_NO_FLOAT */
+
+/**
+ * @brief Steps over the next item, including everything it contains
+ *
+ * Strings are skipped by their length, the items of containers are counted
+ * but not decoded.
+ *
+ * @param[in,out] it    the cursor
+ *
+ * @return  0 on success
+ * @return  -EOVERFLOW if indefinite length items are nested deeper than
+ *          @ref CBOR_SKIP_DEPTH
+ * @return  other values < 0 on error
+ */
+int cbor_skip(cbor_cursor_t *it);
+
+/**
+ * @brief Enters the array or map at @p it
+ *
+ * @p it itself stays at the container until cbor_cursor_leave(). The items
+ * of a map are its keys and values in turn.
+ *
+ * @param[in] it        cursor at an array or a map
+ * @param[out] inner    cursor at the first item of the container
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_cursor_enter(const cbor_cursor_t *it, cbor_cursor_t *inner);
+
+/**
+ * @brief Advances @p it behind the container it was entered at
+ *
+ * Items of @p inner that were not read are skipped.
+ *
+ * @param[in,out] it    cursor the container was entered at
+ * @param[in] inner     cursor returned by cbor_cursor_enter()
+ *
+ * @return  0 on success, < 0 on error
+ */
+int cbor_cursor_leave(cbor_cursor_t *it, const cbor_cursor_t *inner);
+
+/**
+ * @brief Finds the value of a unicode string key in a map
+ *
+ * @param[in] map       cursor within a map, at a key
+ * @param[in] key       zero terminated key
+ * @param[out] value    cursor at the value
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no such key
+ * @return  other values < 0 on error
+ */
+int cbor_map_find(const cbor_cursor_t *map, const char *key, cbor_cursor_t *value);
+
+/**
+ * @brief Finds the value of an integer key in a map
+ *
+ * @param[in] map       cursor within a map, at a key
+ * @param[in] key       the key
+ * @param[out] value    cursor at the value
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no such key
+ * @return  other values < 0 on error
+ */
+int cbor_map_find_int(const cbor_cursor_t *map, int64_t key, cbor_cursor_t *value);
+
+/**
+ * @brief Offsets of the items of one container, for repeated access
+ *
+ * Built in one pass by cbor_index_init(), after that an item is found
+ * without skipping over the items before it.
+ */
+typedef struct {
+    cbor_cursor_t items;    /**< cursor at the first item */
+    size_t *offsets;        /**< offsets of the items, of the keys for maps */
+    size_t numof;           /**< number of indexed items or map entries */
+    bool map;               /**< the container is a map */
+} cbor_index_t;
+
+/**
+ * @brief Indexes the array or map at @p it
+ *
+ * @param[out] idx      the index
+ * @param[in] it        cursor at an array or a map
+ * @param[out] offsets  storage for the offsets, one per item or map entry
+ * @param[in] max       number of elements in @p offsets
+ *
+ * @return  0 on success
+ * @return  -ENOBUFS if the container has more than @p max items
+ * @return  other values < 0 on error
+ */
+int cbor_index_init(cbor_index_t *idx, const cbor_cursor_t *it,
+                    size_t *offsets, size_t max);
+
+/**
+ * @brief Returns a cursor at item (or map entry) @p n
+ *
+ * For maps, the cursor is at the key, with the value following it.
+ *
+ * @param[in] idx       the index
+ * @param[in] n         number of the item
+ * @param[out] item     cursor at the item
+ *
+ * @return  0 on success
+ * @return  -ENOENT if @p n is out of range
+ */
+int cbor_index_get(const cbor_index_t *idx, size_t n, cbor_cursor_t *item);
+
+/**
+ * @brief Finds the value of a unicode string key in an indexed map
+ *
+ * Only the keys are looked at, the values are not skipped over.
+ *
+ * @param[in] idx       index of a map
+ * @param[in] key       zero terminated key
+ * @param[out] value    cursor at the value
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no such key
+ */
+int cbor_index_find(const cbor_index_t *idx, const char *key, cbor_cursor_t *value);
+
+/**
+ * @brief Finds the value of an integer key in an indexed map
+ *
+ * @param[in] idx       index of a map
+ * @param[in] key       the key
+ * @param[out] value    cursor at the value
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no such key
+ */
+int cbor_index_find_int(const cbor_index_t *idx, int64_t key, cbor_cursor_t *value);
+/** @} */
+
+/**
+ * @name Streaming encoder
+ *
+ * A cbor_writer_t encodes into a small buffer and hands the buffer to a flush
+ * function whenever it fills up, so the encoded data never has to be in one
+ * piece. Strings that do not fit into the buffer are passed to the flush
+ * function directly. cbor_writer_flush_pktbuf() appends to a GNRC packet
+ * buffer chain, a function writing to a stream socket looks like this:
+ *
+ * @code
+ * static int _flush_tcp(void *arg, const uint8_t *data, size_t len)
+ * {
+ *     ssize_t res = sock_tcp_write(arg, data, len);
+ *     return (res < 0) ? res : 0;
+ * }
+ * @endcode
+ *
+ * Errors are sticky: after the first error, the writer functions do nothing
+ * and return that error. A buffer too small for the largest item head
+ * (@ref CBOR_WRITER_BUF_MIN bytes) is such an error from the start.
+ * @{
+ */
+
+/**
+ * @brief Minimum size of the buffer of a writer: an initial byte and a 64 bit
+ *        argument
+ */
+#define CBOR_WRITER_BUF_MIN     (9U)
+
+/**
+ * @brief Takes encoded data from a writer
+ *
+ * @param[in] arg       argument given to cbor_writer_init()
+ * @param[in] data      encoded data
+ * @param[in] len       length of @p data
+ *
+ * @return  0 on success, < 0 on error
+ */
+typedef int (*cbor_writer_flush_t)(void *arg, const uint8_t *data, size_t len);
+
+/**
+ * @brief Streaming encoder
+ */
+typedef struct {
+    uint8_t *buf;               /**< encoding buffer */
+    size_t size;                /**< size of the buffer */
+    size_t pos;                 /**< bytes in the buffer */
+    size_t flushed;             /**< bytes handed to the flush function */
+    cbor_writer_flush_t flush;  /**< flush function, NULL for a fixed buffer */
+    void *arg;                  /**< argument of the flush function */
+    int res;                    /**< first error, 0 if none */
+} cbor_writer_t;
+
+/**
+ * @brief Initializes a writer
+ *
+ * @param[out] w        the writer
+ * @param[in] buf       encoding buffer, at least @ref CBOR_WRITER_BUF_MIN
+ *                      bytes
+ * @param[in] size      size of @p buf
+ * @param[in] flush     flush function, NULL to only fill @p buf
+ * @param[in] arg       argument of @p flush
+ *
+ * If @p size is less than @ref CBOR_WRITER_BUF_MIN, all writer functions
+ * return -EINVAL.
+ */
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, size_t size,
+                      cbor_writer_flush_t flush, void *arg);
+
+/**
+ * @brief Writes an unsigned integer
+ *
+ * @param[in,out] w     the writer
+ * @param[in] val       the value
+ *
+ * @return  0 on success
+ * @return  -ENOBUFS if the buffer of a writer without flush function is full
+ * @return  -EINVAL if the buffer of the writer is too small
+ * @return  other values < 0: error of the flush function
+ */
+int cbor_writer_uint(cbor_writer_t *w, uint64_t val);
+
+/**
+ * @brief Writes a signed integer
+ *
+ * @param[in,out] w     the writer
+ * @param[in] val       the value
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_int(cbor_writer_t *w, int64_t val);
+
+/**
+ * @brief Writes a boolean
+ *
+ * @param[in,out] w     the writer
+ * @param[in] val       the value
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_bool(cbor_writer_t *w, bool val);
+
+/**
+ * @brief Writes null
+ *
+ * @param[in,out] w     the writer
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_null(cbor_writer_t *w);
+
+/**
+ * @brief Writes a byte string
+ *
+ * @param[in,out] w     the writer
+ * @param[in] data      the string
+ * @param[in] len       length of @p data
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_bstr(cbor_writer_t *w, const void *data, size_t len);
+
+/**
+ * @brief Writes a unicode string
+ *
+ * @param[in,out] w     the writer
+ * @param[in] str       the string
+ * @param[in] len       length of @p str in bytes
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_tstr(cbor_writer_t *w, const char *str, size_t len);
+
+/**
+ * @brief Starts an array, the items follow
+ *
+ * @param[in,out] w     the writer
+ * @param[in] numof     number of items, CBOR_CURSOR_INDEFINITE for an
+ *                      indefinite length array that ends with
+ *                      cbor_writer_break()
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_array(cbor_writer_t *w, size_t numof);
+
+/**
+ * @brief Starts a map, the keys and values follow in turn
+ *
+ * @param[in,out] w     the writer
+ * @param[in] numof     number of entries, CBOR_CURSOR_INDEFINITE for an
+ *                      indefinite length map that ends with
+ *                      cbor_writer_break()
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_map(cbor_writer_t *w, size_t numof);
+
+/**
+ * @brief Writes a semantic tag for the next item
+ *
+ * @param[in,out] w     the writer
+ * @param[in] tag       the tag
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_tag(cbor_writer_t *w, uint64_t tag);
+
+/**
+ * @brief Ends an indefinite length array or map
+ *
+ * @param[in,out] w     the writer
+ *
+ * @return  0 on success, < 0 on error (see cbor_writer_uint())
+ */
+int cbor_writer_break(cbor_writer_t *w);
+
+/**
+ * @brief Hands the buffered data to the flush function
+ *
+ * @param[in,out] w     the writer
+ *
+ * @return  0 on success
+ * @return  < 0 the first error of the writer
+ */
+int cbor_writer_flush(cbor_writer_t *w);
+
+#if defined(MODULE_GNRC_PKTBUF) || defined(DOXYGEN)
+/**
+ * @brief Packet buffer chain built by cbor_writer_flush_pktbuf()
+ *
+ * Initialize to all zero for an empty chain.
+ */
+typedef struct {
+    gnrc_pktsnip_t *head;   /**< first snip of the chain, NULL if empty */
+    gnrc_pktsnip_t *tail;   /**< last snip of the chain */
+} cbor_writer_pktbuf_t;
+
+/**
+ * @brief Flush function that appends the data to a packet buffer chain
+ *
+ * Use with a pointer to a @ref cbor_writer_pktbuf_t as argument. Each flush
+ * adds one snip of type GNRC_NETTYPE_UNDEF at the end of the chain.
+ *
+ * @param[in,out] arg   pointer to the chain
+ * @param[in] data      encoded data
+ * @param[in] len       length of @p data
+ *
+ * @return  0 on success
+ * @return  -ENOMEM if the packet buffer is full
+ */
+int cbor_writer_flush_pktbuf(void *arg, const uint8_t *data, size_t len);
+#endif
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -123,6 +123,78 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
 int aes_decrypt(const cipher_context_t *context, const uint8_t *cipher_block,
                 uint8_t *plain_block);
 
+/**
+ * @brief   encrypts consecutive blocks with the same key
+ *
+ * The key schedule is expanded once for all blocks, and the blocks are
+ * processed in parallel where the implementation allows it.
+ *
+ * @param       context       the cipher_context_t-struct to use for this
+ *                            encryption
+ * @param       plain_blocks  @p nblocks blocks of plaintext
+ * @param       cipher_blocks memory for @p nblocks blocks of ciphertext, may
+ *                            be the same as @p plain_blocks
+ * @param       nblocks       number of blocks
+ *
+ * @return  1 or result of aes_set_encrypt_key if it failed
+ */
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *plain_blocks,
+                       uint8_t *cipher_blocks, size_t nblocks);
+
+/**
+ * @brief   decrypts consecutive blocks with the same key
+ *
+ * @param       context       the cipher_context_t-struct to use for this
+ *                            decryption
+ * @param       cipher_blocks @p nblocks blocks of ciphertext
+ * @param       plain_blocks  memory for @p nblocks blocks of plaintext, may
+ *                            be the same as @p cipher_blocks
+ * @param       nblocks       number of blocks
+ *
+ * @return  1 or negative value if cipher key cannot be expanded into
+ *          decryption key schedule
+ */
+int aes_decrypt_blocks(const cipher_context_t *context, const uint8_t *cipher_blocks,
+                       uint8_t *plain_blocks, size_t nblocks);
+
+#if defined(MODULE_CRYPTO_AES_HW) || defined(DOXYGEN)
+/**
+ * @brief   encrypts blocks with an on-chip AES peripheral
+ *
+ * Hook for CPUs with an AES peripheral, to be implemented by the CPU when the
+ * `crypto_aes_hw` module is used. The software implementation is used when
+ * the peripheral cannot handle a request.
+ *
+ * @param       key           AES_KEY_SIZE bytes of key
+ * @param       plain_blocks  @p nblocks blocks of plaintext
+ * @param       cipher_blocks memory for @p nblocks blocks of ciphertext, may
+ *                            be the same as @p plain_blocks
+ * @param       nblocks       number of blocks
+ *
+ * @return  0 on success
+ * @return  < 0 if the peripheral cannot handle the request (e.g. it is busy)
+ */
+int aes_hw_encrypt_blocks(const uint8_t *key, const uint8_t *plain_blocks,
+                          uint8_t *cipher_blocks, size_t nblocks);
+
+/**
+ * @brief   decrypts blocks with an on-chip AES peripheral
+ *
+ * @see aes_hw_encrypt_blocks()
+ *
+ * @param       key           AES_KEY_SIZE bytes of key
+ * @param       cipher_blocks @p nblocks blocks of ciphertext
+ * @param       plain_blocks  memory for @p nblocks blocks of plaintext, may
+ *                            be the same as @p cipher_blocks
+ * @param       nblocks       number of blocks
+ *
+ * @return  0 on success
+ * @return  < 0 if the peripheral cannot handle the request (e.g. it is busy)
+ */
+int aes_hw_decrypt_blocks(const uint8_t *key, const uint8_t *cipher_blocks,
+                          uint8_t *plain_blocks, size_t nblocks);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,7 @@
 #ifndef CRYPTO_CIPHERS_H
 #define CRYPTO_CIPHERS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -40,6 +41,15 @@ extern "C" {
 #define CIPHERS_MAX_KEY_SIZE 20
 #define CIPHER_MAX_BLOCK_SIZE 16
 
+/**
+ * @brief   Number of blocks the modes of operation hand to the cipher at once
+ *
+ * The modes keep a buffer of this many blocks on the stack.
+ */
+#ifndef CIPHER_BATCH_BLOCKS
+#define CIPHER_BATCH_BLOCKS (4U)
+#endif
+
 
 /**
  * Context sizes needed for the different ciphers.
@@ -96,6 +106,14 @@ typedef struct cipher_interface_st {
     /** the decrypt function */
     int (*decrypt)(const cipher_context_t* ctx, const uint8_t* cipher_block,
                    uint8_t* plain_block);
+
+    /** encrypts consecutive blocks, NULL to call encrypt for each block */
+    int (*encrypt_blocks)(const cipher_context_t* ctx, const uint8_t* plain_blocks,
+                          uint8_t* cipher_blocks, size_t nblocks);
+
+    /** decrypts consecutive blocks, NULL to call decrypt for each block */
+    int (*decrypt_blocks)(const cipher_context_t* ctx, const uint8_t* cipher_blocks,
+                          uint8_t* plain_blocks, size_t nblocks);
 } cipher_interface_t;
 
 
@@ -156,6 +174,39 @@ int cipher_encrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output
 int cipher_decrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output);
 
 
+/**
+ * @brief Encrypt consecutive blocks of BLOCK_SIZE length
+ *
+ * Ciphers process the blocks in one go, e.g. with the key schedule expanded
+ * only once and several blocks in parallel.
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p nblocks blocks of input data to encrypt
+ * @param output     pointer to allocated memory for @p nblocks blocks of
+ *                   encrypted data, may be the same as @p input
+ * @param nblocks    number of blocks
+ *
+ * @return  1 on success, the error of the cipher otherwise
+ */
+int cipher_encrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t nblocks);
+
+
+/**
+ * @brief Decrypt consecutive blocks of BLOCK_SIZE length
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p nblocks blocks of input data to decrypt
+ * @param output     pointer to allocated memory for @p nblocks blocks of
+ *                   decrypted data, may be the same as @p input
+ * @param nblocks    number of blocks
+ *
+ * @return  1 on success, the error of the cipher otherwise
+ */
+int cipher_decrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t nblocks);
+
+
 /**
  * @brief Get block size of cipher
  * *
@@ -81,6 +81,29 @@ typedef struct {
     sha256_context_t c_out;
 } hmac_context_t;
 
+/**
+ * @brief Precomputed HMAC SHA-256 key
+ *
+ * Holds the hash states after the inner and the outer key pad. A key is
+ * prepared once with hmac_sha256_precompute() and can then be used for any
+ * number of messages, saving the two compressions of the key pads per message.
+ */
+typedef struct {
+    /** state after the inner key pad */
+    uint32_t in[8];
+    /** state after the outer key pad */
+    uint32_t out[8];
+} hmac_sha256_key_t;
+
+/**
+ * @brief Number of messages sha256_multi() hashes side by side
+ *
+ * Must be a power of two. Four lanes fill a 128 bit vector register.
+ */
+#ifndef SHA256_MULTI_LANES
+#define SHA256_MULTI_LANES  (4U)
+#endif
+
 /**
  * @brief sha256-chain indexed element
  */
@@ -136,6 +159,27 @@ void *sha256(const void *data, size_t len, void *digest);
  */
 void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length);
 
+/**
+ * @brief Compresses the key pads of a HMAC key
+ *
+ * @param[out] key_state    the precomputed key
+ * @param[in] key           key used in the hmac-sha256 computation
+ * @param[in] key_length    the size in bytes of the key
+ */
+void hmac_sha256_precompute(hmac_sha256_key_t *key_state, const void *key,
+                            size_t key_length);
+
+/**
+ * @brief Initiate calculation of a HMAC with a precomputed key
+ *
+ * Continue with hmac_sha256_update() and hmac_sha256_final().
+ *
+ * @param[out] ctx          hmac_context_t handle to use
+ * @param[in] key_state     the key prepared by hmac_sha256_precompute()
+ */
+void hmac_sha256_init_precomputed(hmac_context_t *ctx,
+                                  const hmac_sha256_key_t *key_state);
+
 /**
  * @brief hmac_sha256_update Add data bytes for HMAC calculation
  * @param[in] ctx hmac_context_t handle to use
@@ -169,6 +213,35 @@ void hmac_sha256_final(hmac_context_t *ctx, void *digest);
 const void *hmac_sha256(const void *key, size_t key_length,
                         const void *data, size_t len, void *digest);
 
+/**
+ * @brief function to compute a hmac-sha256 with a precomputed key
+ *
+ * @param[in] key_state the key prepared by hmac_sha256_precompute()
+ * @param[in] data pointer to the buffer to generate the hmac-sha256
+ * @param[in] len the length of the message in bytes
+ * @param[out] digest the computed hmac-sha256,
+ *             length MUST be SHA256_DIGEST_LENGTH
+ * @returns pointer to the resulting digest
+ */
+const void *hmac_sha256_precomputed(const hmac_sha256_key_t *key_state,
+                                    const void *data, size_t len, void *digest);
+
+/**
+ * @brief Computes the sha256 of several independent messages at once
+ *
+ * The messages are processed in groups of @ref SHA256_MULTI_LANES, with the
+ * blocks of a group compressed side by side. This is faster than hashing
+ * them one after another where the compiler can vectorize the lanes, and
+ * gives the same digests as sha256().
+ *
+ * @param[in] data      the messages
+ * @param[in] len       the lengths of the messages in bytes
+ * @param[out] digest   buffers of SHA256_DIGEST_LENGTH bytes for the results
+ * @param[in] numof     number of messages
+ */
+void sha256_multi(const void *const data[], const size_t len[],
+                  void *const digest[], size_t numof);
+
 /**
  * @brief function to produce a hash chain statring with a given seed element.
  *        The chain is computed by taking the sha256 from the seed,
@@ -51,8 +51,92 @@ typedef struct {
     uint32_t next_hop_flags;
     /** Pointer to the shared generic address */
     universal_address_container_t *next_hop;
+#if defined(MODULE_FIB_TRIE) || defined(DOXYGEN)
+    /** previous entry (index) in the same lifetime wheel slot */
+    uint16_t wheel_prev;
+    /** next entry (index) in the same lifetime wheel slot */
+    uint16_t wheel_next;
+#endif
 } fib_entry_t;
 
+#if defined(MODULE_FIB_TRIE) || defined(DOXYGEN)
+/**
+ * @name    Prefix trie index for single hop tables
+ *
+ * With the `fib_trie` module a single hop table can be indexed by a
+ * path-compressed binary trie over the destination prefixes, so
+ * longest-prefix-match lookups cost O(prefix length) instead of
+ * O(table size). Lifetimes are tracked in a timer wheel, so expired
+ * entries are purged slot by slot whenever the table is changed, instead of
+ * being checked on every entry during lookup.
+ *
+ * The index is enabled by pointing fib_trie_t::nodes of the table to an
+ * array of @ref FIB_TRIE_NODES_NUMOF(fib_table_t::size) nodes before
+ * calling fib_init(). Tables without a node array use the linear search.
+ * @{
+ */
+/**
+ * @brief   Marks an unused link in the trie or lifetime wheel
+ */
+#define FIB_TRIE_NIL                (0xffff)
+
+/**
+ * @brief   Number of trie nodes needed to index a table of @p size entries
+ */
+#define FIB_TRIE_NODES_NUMOF(size)  (2 * (size))
+
+/**
+ * @brief   Number of slots of the lifetime wheel
+ */
+#ifndef FIB_TRIE_WHEEL_SLOTS
+#define FIB_TRIE_WHEEL_SLOTS        (16U)
+#endif
+
+/**
+ * @brief   Width of a lifetime wheel slot as power of two in microseconds
+ *
+ * The default of 2^20 us is roughly one second.
+ */
+#ifndef FIB_TRIE_WHEEL_SHIFT
+#define FIB_TRIE_WHEEL_SHIFT        (20U)
+#endif
+
+/**
+ * @brief   Node of the prefix trie
+ */
+typedef struct {
+    /** the entry for this prefix, NULL for pure branching nodes */
+    fib_entry_t *entry;
+    /** address bytes of the entry or of any entry below this node */
+    const uint8_t *key;
+    /** sub-tries for the next bit being 0 or 1 */
+    uint16_t child[2];
+    /** number of significant bits of the prefix */
+    uint16_t bitlen;
+} fib_trie_node_t;
+
+/**
+ * @brief   Prefix trie index and lifetime wheel of a single hop table
+ */
+typedef struct {
+    /** node pool, NULL disables the index */
+    fib_trie_node_t *nodes;
+    /** index of the root node */
+    uint16_t root;
+    /** head of the list of unused nodes (linked by fib_trie_node_t::child[0]) */
+    uint16_t free;
+    /** number of entries that could not be indexed */
+    uint16_t unindexed;
+    /** size of the addresses held by the index (all need to be equal) */
+    uint16_t key_size;
+    /** next wheel slot to purge (in units of 2^FIB_TRIE_WHEEL_SHIFT us) */
+    uint32_t wheel_pos;
+    /** first entry (index) of each wheel slot */
+    uint16_t wheel[FIB_TRIE_WHEEL_SLOTS];
+} fib_trie_t;
+/** @} */
+#endif
+
 /**
 * @brief Container descriptor for a FIB source route entry
 */
@@ -133,6 +217,14 @@ typedef struct {
     *   e.g. when the unreachable destination is covered by the prefix
     */
     universal_address_container_t* prefix_rp[FIB_MAX_REGISTERED_RP];
+    /** incremented on every change of the table's entries.
+    *   Allows users to detect stale copies of lookup results
+    */
+    unsigned version;
+#if defined(MODULE_FIB_TRIE) || defined(DOXYGEN)
+    /** prefix trie index (single hop tables only) */
+    fib_trie_t trie;
+#endif
 } fib_table_t;
 
 #ifdef __cplusplus
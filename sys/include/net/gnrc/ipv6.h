@@ -118,6 +118,94 @@ extern kernel_pid_t gnrc_ipv6_pid;
 extern fib_table_t gnrc_ipv6_fib_table;
 #endif
 
+#if defined(MODULE_GNRC_IPV6_FWD) || defined(DOXYGEN)
+/**
+ * @name    Forwarding fast path
+ *
+ * With the `gnrc_ipv6_fwd` module, packets that are not for this host are
+ * handed to a worker thread of the interface they were received on, so a slow
+ * interface does not stall forwarding of the others or the IPv6 control
+ * thread. The worker checks the packet, looks up its next hop in a flow cache
+ * of (destination => interface, link-layer address) results and sends it.
+ * Packets without a valid cache entry are handed back to the control thread,
+ * which also keeps local delivery and neighbor discovery; forwarding on the
+ * control thread fills the cache.
+ *
+ * The cache is invalidated on every change of the neighbor cache, the
+ * interface addresses or the FIB, and entries expire after
+ * @ref GNRC_IPV6_FWD_FLOW_LIFETIME so that neighbor unreachability detection
+ * still sees forwarded traffic.
+ * @{
+ */
+/**
+ * @brief   Maximum number of forwarding worker threads (one per receiving
+ *          interface)
+ *
+ * Packets received on interfaces beyond that are forwarded by the control
+ * thread.
+ */
+#ifndef GNRC_IPV6_FWD_WORKER_NUMOF
+#define GNRC_IPV6_FWD_WORKER_NUMOF  (GNRC_NETIF_NUMOF)
+#endif
+
+/**
+ * @brief   Default stack size to use for a forwarding worker thread
+ */
+#ifndef GNRC_IPV6_FWD_STACK_SIZE
+#define GNRC_IPV6_FWD_STACK_SIZE    (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Default priority for the forwarding worker threads
+ *
+ * @note    Must be higher than @ref GNRC_IPV6_PRIO, so a lazily created
+ *          worker is ready to receive before the control thread continues.
+ */
+#ifndef GNRC_IPV6_FWD_PRIO
+#define GNRC_IPV6_FWD_PRIO          (GNRC_IPV6_PRIO - 1)
+#endif
+
+/**
+ * @brief   Default message queue size of a forwarding worker thread
+ *
+ * Packets for a worker with a full queue are dropped.
+ */
+#ifndef GNRC_IPV6_FWD_MSG_QUEUE_SIZE
+#define GNRC_IPV6_FWD_MSG_QUEUE_SIZE    (8U)
+#endif
+
+/**
+ * @brief   Number of entries in the flow cache
+ *
+ * @note    Must be a power of 2.
+ */
+#ifndef GNRC_IPV6_FWD_FLOW_NUMOF
+#define GNRC_IPV6_FWD_FLOW_NUMOF    (16U)
+#endif
+
+/**
+ * @brief   Maximum age of a flow cache entry in microseconds
+ */
+#ifndef GNRC_IPV6_FWD_FLOW_LIFETIME
+#define GNRC_IPV6_FWD_FLOW_LIFETIME (1000000U)
+#endif
+
+/**
+ * @brief   @ref core_msg type for packets a forwarding worker hands back to
+ *          the IPv6 control thread, since their next hop is not cached
+ */
+#define GNRC_IPV6_FWD_MSG_SLOW_PATH (0x0230)
+
+/**
+ * @brief   Invalidates all entries of the flow cache
+ *
+ * Called by the neighbor cache and interface address management. Changes of
+ * @ref gnrc_ipv6_fib_table are detected by the flow cache itself.
+ */
+void gnrc_ipv6_fwd_invalidate(void);
+/** @} */
+#endif
+
 /**
  * @brief   Initialization of the IPv6 thread.
  *
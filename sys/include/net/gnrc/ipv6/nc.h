@@ -44,6 +44,21 @@ extern "C" {
 #define GNRC_IPV6_NC_SIZE           (GNRC_NETIF_NUMOF * 8)
 #endif
 
+#if defined(MODULE_GNRC_IPV6_NC_HASH) || defined(DOXYGEN)
+/**
+ * @brief   The number of slots of the neighbor cache's hash index
+ *
+ * With the `gnrc_ipv6_nc_hash` module, neighbor cache entries are looked up
+ * by their IPv6 address in an open-addressing hash index instead of scanning
+ * the whole cache, so @ref GNRC_IPV6_NC_SIZE can be raised without raising
+ * the per-packet lookup cost. The index should have at least twice as many
+ * slots as there are entries and takes 2 byte per slot.
+ */
+#ifndef GNRC_IPV6_NC_HASH_SIZE
+#define GNRC_IPV6_NC_HASH_SIZE      (GNRC_IPV6_NC_SIZE * 2)
+#endif
+#endif
+
 #ifndef GNRC_IPV6_NC_L2_ADDR_MAX
 /**
  * @brief   The maximum size of a link layer address
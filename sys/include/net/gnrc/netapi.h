@@ -51,6 +51,28 @@
  * USEMODULE += gnrc_netapi_callbacks
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * @}
+ *
+ * @defgroup    net_gnrc_netapi_batch   Batched dispatch extension
+ * @ingroup     net_gnrc_netapi
+ * @brief       Hand several packets to the next layer with one message
+ * @{
+ * @details The submodule `gnrc_netapi_batch` lets a layer collect the
+ *          packets it dispatches in a @ref gnrc_netapi_batch_t while it
+ *          drains its message queue. When the queue is empty or
+ *          @ref GNRC_NETAPI_BATCH_SIZE packets were collected, the whole
+ *          chain is sent with a single @ref GNRC_NETAPI_MSG_TYPE_RCV_BATCH
+ *          (or @ref GNRC_NETAPI_MSG_TYPE_SND_BATCH) message, provided the
+ *          only subscriber announced that it understands batches with
+ *          gnrc_netapi_batch_register(). Otherwise the packets are dispatched
+ *          one by one as usual.
+ *
+ * To use, add the module `gnrc_netapi_batch` to the `USEMODULE` macro in
+ * your application's Makefile:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_netapi_batch
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * @}
  * @author      Martine Lenders <mlenders@inf.fu-berlin.de>
  * @author      Hauke Petersen <hauke.petersen@fu-berlin.de>
  */
@@ -92,6 +114,20 @@ extern "C" {
  */
 #define GNRC_NETAPI_MSG_TYPE_ACK        (0x0205)
 
+/* 0x0206 is taken by GNRC_NETERR_MSG_TYPE (see net/gnrc/neterr.h) */
+
+/**
+ * @brief   @ref core_msg type for passing a chain of @ref net_gnrc_pkt up
+ *          the network stack (see @ref net_gnrc_netapi_batch)
+ */
+#define GNRC_NETAPI_MSG_TYPE_RCV_BATCH  (0x0208)
+
+/**
+ * @brief   @ref core_msg type for passing a chain of @ref net_gnrc_pkt down
+ *          the network stack (see @ref net_gnrc_netapi_batch)
+ */
+#define GNRC_NETAPI_MSG_TYPE_SND_BATCH  (0x0209)
+
 /**
  * @brief   Data structure to be send for setting (@ref GNRC_NETAPI_MSG_TYPE_SET)
  *          and getting (@ref GNRC_NETAPI_MSG_TYPE_GET) options
@@ -206,6 +242,114 @@ int gnrc_netapi_get(kernel_pid_t pid, netopt_t opt, uint16_t context,
 int gnrc_netapi_set(kernel_pid_t pid, netopt_t opt, uint16_t context,
                     void *data, size_t data_len);
 
+#if defined(MODULE_GNRC_NETAPI_BATCH) || defined(DOXYGEN)
+/**
+ * @addtogroup  net_gnrc_netapi_batch
+ * @{
+ */
+/**
+ * @brief   Maximum number of packets in one batch
+ */
+#ifndef GNRC_NETAPI_BATCH_SIZE
+#define GNRC_NETAPI_BATCH_SIZE      (8U)
+#endif
+
+/**
+ * @brief   Packets collected for one (type, demux context, command) target
+ *
+ * Initialize with zeros.
+ */
+typedef struct {
+    gnrc_pktsnip_t *head;       /**< first packet of the chain */
+    gnrc_pktsnip_t *tail;       /**< last packet of the chain */
+    uint32_t demux_ctx;         /**< demultiplexing context of the target */
+    gnrc_nettype_t type;        /**< type of the target */
+    uint16_t cmd;               /**< @ref GNRC_NETAPI_MSG_TYPE_RCV or
+                                 *   @ref GNRC_NETAPI_MSG_TYPE_SND */
+    uint8_t numof;              /**< number of packets in the chain */
+} gnrc_netapi_batch_t;
+
+/**
+ * @brief   Batch statistics of one @ref gnrc_nettype_t
+ */
+typedef struct {
+    uint32_t batches;           /**< number of flushed batches */
+    uint32_t pkts;              /**< number of packets in these batches */
+    uint32_t split;             /**< batches of more than one packet that
+                                 *   had to be dispatched packet by packet */
+    uint16_t max;               /**< size of the largest batch */
+} gnrc_netapi_batch_stats_t;
+
+/**
+ * @brief   Announce that a thread handles
+ *          @ref GNRC_NETAPI_MSG_TYPE_RCV_BATCH and
+ *          @ref GNRC_NETAPI_MSG_TYPE_SND_BATCH messages
+ *
+ * @param[in] pid   PID of the thread
+ */
+void gnrc_netapi_batch_register(kernel_pid_t pid);
+
+/**
+ * @brief   Adds a packet to a batch
+ *
+ * If the batch already holds packets for another target or is full after
+ * adding @p pkt, it is flushed.
+ *
+ * @pre A packet must only be part of one batch at a time.
+ *
+ * @param[in,out] batch     the batch
+ * @param[in] type          type of the targeted network module
+ * @param[in] demux_ctx     demultiplexing context for @p type
+ * @param[in] cmd           @ref GNRC_NETAPI_MSG_TYPE_RCV or
+ *                          @ref GNRC_NETAPI_MSG_TYPE_SND
+ * @param[in] pkt           the packet
+ *
+ * @return  Number of subscribers to (@p type, @p demux_ctx). @p pkt was not
+ *          taken if this is 0.
+ */
+int gnrc_netapi_batch_add(gnrc_netapi_batch_t *batch, gnrc_nettype_t type,
+                          uint32_t demux_ctx, uint16_t cmd,
+                          gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Dispatches all packets of a batch
+ *
+ * @param[in,out] batch     the batch, empty afterwards
+ */
+void gnrc_netapi_batch_flush(gnrc_netapi_batch_t *batch);
+
+/**
+ * @brief   Takes the first packet from a received chain
+ *
+ * @param[in,out] chain     the chain, as received in a
+ *                          @ref GNRC_NETAPI_MSG_TYPE_RCV_BATCH or
+ *                          @ref GNRC_NETAPI_MSG_TYPE_SND_BATCH message
+ *
+ * @return  the first packet of @p chain
+ * @return  NULL if @p chain is empty
+ */
+static inline gnrc_pktsnip_t *gnrc_netapi_batch_pop(gnrc_pktsnip_t **chain)
+{
+    gnrc_pktsnip_t *pkt = *chain;
+
+    if (pkt != NULL) {
+        *chain = pkt->batch_next;
+        pkt->batch_next = NULL;
+    }
+    return pkt;
+}
+
+/**
+ * @brief   Get the batch statistics for a network module type
+ *
+ * @param[in] type      type of the targeted network module
+ * @param[out] stats    the statistics
+ */
+void gnrc_netapi_batch_get_stats(gnrc_nettype_t type,
+                                 gnrc_netapi_batch_stats_t *stats);
+/** @} */
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -218,6 +218,26 @@ static inline void gnrc_netdev_set_tx_feedback(gnrc_netdev_t *dev,
 kernel_pid_t gnrc_netdev_init(char *stack, int stacksize, char priority,
                                const char *name, gnrc_netdev_t *gnrc_netdev);
 
+/**
+ * @brief   Fetch a received frame from a netdev device into a new packet
+ *          snip
+ *
+ * Uses @ref netdev_driver_t::recv_lend "recv_lend()" to have the driver
+ * read the frame straight into the packet buffer if the driver provides it
+ * and the two calls to @ref netdev_driver_t::recv "recv()" otherwise.
+ *
+ * @param[in] dev       the device
+ * @param[out] pkt      a snip of type GNRC_NETTYPE_UNDEF holding the frame,
+ *                      NULL if no frame was received
+ * @param[out] info     status information for the received frame, may be
+ *                      NULL (see @ref netdev_driver_t::recv "recv()")
+ *
+ * @return  size of the frame
+ * @return  0 or a negative errno (-ENOBUFS if the packet buffer is full) if
+ *          no frame was received
+ */
+int gnrc_netdev_recv_snip(netdev_t *dev, gnrc_pktsnip_t **pkt, void *info);
+
 #ifdef __cplusplus
 }
 #endif
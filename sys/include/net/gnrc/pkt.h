@@ -115,6 +115,12 @@ typedef struct gnrc_pktsnip {
     kernel_pid_t err_sub;           /**< subscriber to errors related to this
                                      *   packet snip */
 #endif
+#if defined(MODULE_GNRC_NETAPI_BATCH) || defined(DOXYGEN)
+    struct gnrc_pktsnip *batch_next;    /**< next packet in a
+                                         *   @ref net_gnrc_netapi_batch "batch"
+                                         *   (only valid in the packet's
+                                         *   first snip while in transit) */
+#endif
 } gnrc_pktsnip_t;
 
 /**
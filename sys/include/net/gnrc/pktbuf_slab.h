@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_pktbuf_slab   Size-class packet buffer
+ * @ingroup     net_gnrc_pktbuf
+ * @brief       Packet buffer backend with per-size-class free lists.
+ *
+ * Instead of one arena with a sorted list of holes (as
+ * @ref net_gnrc_pktbuf "gnrc_pktbuf_static" does) this implementation
+ * splits its memory into three pools of fixed-size blocks:
+ *
+ * - *small* blocks for packet snip descriptors and short headers,
+ * - *medium* blocks able to hold a full IEEE 802.15.4 frame and
+ * - *large* blocks able to hold a full Ethernet frame or a reassembled
+ *   IPv6 datagram.
+ *
+ * Every pool keeps its own LIFO free list, so both allocation and release
+ * are O(1) and the buffer can not fragment. If the best fitting class is
+ * exhausted the allocation falls back to the next larger class.
+ *
+ * Use it by adding `USEMODULE += gnrc_pktbuf_slab` to your application's
+ * Makefile; it replaces `gnrc_pktbuf_static`.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Configuration and statistics of the size-class packet buffer
+ */
+#ifndef GNRC_PKTBUF_SLAB_H
+#define GNRC_PKTBUF_SLAB_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Block size of the small class in byte.
+ *
+ * @note    Must be a multiple of `sizeof(void *)` and large enough to hold a
+ *          @ref gnrc_pktsnip_t.
+ */
+#ifndef GNRC_PKTBUF_SLAB_SMALL_SIZE
+#define GNRC_PKTBUF_SLAB_SMALL_SIZE     (48U)
+#endif
+
+/**
+ * @brief   Number of blocks in the small class.
+ */
+#ifndef GNRC_PKTBUF_SLAB_SMALL_NUMOF
+#define GNRC_PKTBUF_SLAB_SMALL_NUMOF    (48U)
+#endif
+
+/**
+ * @brief   Block size of the medium class in byte (IEEE 802.15.4 MTU).
+ *
+ * @note    Must be a multiple of `sizeof(void *)`.
+ */
+#ifndef GNRC_PKTBUF_SLAB_MEDIUM_SIZE
+#define GNRC_PKTBUF_SLAB_MEDIUM_SIZE    (128U)
+#endif
+
+/**
+ * @brief   Number of blocks in the medium class.
+ */
+#ifndef GNRC_PKTBUF_SLAB_MEDIUM_NUMOF
+#define GNRC_PKTBUF_SLAB_MEDIUM_NUMOF   (16U)
+#endif
+
+/**
+ * @brief   Block size of the large class in byte (Ethernet MTU incl.
+ *          header).
+ *
+ * @note    Must be a multiple of `sizeof(void *)`. This is the largest
+ *          payload a single snip can hold.
+ */
+#ifndef GNRC_PKTBUF_SLAB_LARGE_SIZE
+#define GNRC_PKTBUF_SLAB_LARGE_SIZE     (1520U)
+#endif
+
+/**
+ * @brief   Number of blocks in the large class.
+ */
+#ifndef GNRC_PKTBUF_SLAB_LARGE_NUMOF
+#define GNRC_PKTBUF_SLAB_LARGE_NUMOF    (2U)
+#endif
+
+/**
+ * @brief   Number of size classes
+ */
+#define GNRC_PKTBUF_SLAB_CLASSES        (3U)
+
+/**
+ * @brief   Usage statistics of one size class
+ */
+typedef struct {
+    uint16_t size;          /**< block size of the class */
+    uint16_t numof;         /**< number of blocks in the class */
+    uint16_t used;          /**< number of blocks currently in use */
+    uint16_t max_used;      /**< high-water mark of gnrc_pktbuf_slab_stats_t::used */
+    uint16_t fallbacks;     /**< allocations served by this class because
+                             *   all smaller fitting classes were exhausted */
+    uint16_t failed;        /**< allocations that failed because this was the
+                             *   best fitting class and all classes from here
+                             *   on were exhausted */
+} gnrc_pktbuf_slab_stats_t;
+
+/**
+ * @brief   Get the usage statistics of a size class
+ *
+ * @param[in] cls       Size class (0 is the smallest class).
+ *                      Must be < @ref GNRC_PKTBUF_SLAB_CLASSES
+ * @param[out] stats    The statistics of class @p cls.
+ */
+void gnrc_pktbuf_slab_get_stats(unsigned cls, gnrc_pktbuf_slab_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_PKTBUF_SLAB_H */
+/** @} */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_rpl_srh_tree RPL non-storing downward routes
+ * @ingroup     net_gnrc_rpl
+ * @brief       Downward route store of a RPL non-storing mode root
+ *
+ * In non-storing mode every node reports its DAO parent to the root, which
+ * builds the source routes of all downward traffic. Instead of installing
+ * the targets into the FIB, the root keeps one entry per node holding the
+ * index of its parent. A source route is the chain of parent indices from
+ * the destination up to the root and is built in O(depth).
+ *
+ * The source routing headers of recently used destinations are kept in a
+ * small cache. A DAO that only refreshes a lifetime leaves the cache intact;
+ * any change of the tree invalidates it.
+ *
+ * Nodes that are named as parent before they sent a DAO themselves are kept
+ * as placeholders, routes through them are unreachable until they do.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc6550#section-9.7">
+ *          RFC 6550, section 9.7, Non-storing Mode
+ *      </a>
+ * @{
+ *
+ * @file
+ * @brief       Definitions for the RPL non-storing downward route store
+ */
+#ifndef GNRC_RPL_SRH_TREE_H
+#define GNRC_RPL_SRH_TREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/ipv6/addr.h"
+#include "net/gnrc/rpl/srh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of nodes the root can keep, including placeholders
+ */
+#ifndef GNRC_RPL_SRH_TREE_NUMOF
+#define GNRC_RPL_SRH_TREE_NUMOF         (64U)
+#endif
+
+/**
+ * @brief   Number of hash buckets to find nodes by address, must be a
+ *          power of 2
+ */
+#ifndef GNRC_RPL_SRH_TREE_BUCKETS
+#define GNRC_RPL_SRH_TREE_BUCKETS       (16U)
+#endif
+
+/**
+ * @brief   Maximum number of hops of a source route, excluding the root
+ */
+#ifndef GNRC_RPL_SRH_TREE_MAX_DEPTH
+#define GNRC_RPL_SRH_TREE_MAX_DEPTH     (8U)
+#endif
+
+/**
+ * @brief   Number of cached source routing headers, 0 disables the cache
+ */
+#ifndef GNRC_RPL_SRH_TREE_CACHE_NUMOF
+#define GNRC_RPL_SRH_TREE_CACHE_NUMOF   (4U)
+#endif
+
+/**
+ * @brief   Maximum size of a source routing header built by the store
+ */
+#define GNRC_RPL_SRH_TREE_HDR_MAX       (sizeof(gnrc_rpl_srh_t) + \
+                                         ((GNRC_RPL_SRH_TREE_MAX_DEPTH - 1) * \
+                                          sizeof(ipv6_addr_t)))
+
+/**
+ * @brief   Clears the store and sets the address of the root
+ *
+ * @param[in] root  Address of the root, i.e. the DODAG id
+ */
+void gnrc_rpl_srh_tree_init(const ipv6_addr_t *root);
+
+/**
+ * @brief   Applies the transit information of a DAO to a target
+ *
+ * @param[in] target    Address of the target
+ * @param[in] parent    Address of the DAO parent of @p target
+ * @param[in] lifetime  Lifetime of the route in seconds, 0 removes it
+ *                      (No-Path DAO)
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p target is the root or its own parent
+ * @return  -ENOMEM if the store is full
+ */
+int gnrc_rpl_srh_tree_update(const ipv6_addr_t *target, const ipv6_addr_t *parent,
+                             uint32_t lifetime);
+
+/**
+ * @brief   Removes the route to a target
+ *
+ * Routes of nodes below @p target become unreachable until @p target is
+ * announced again.
+ *
+ * @param[in] target    Address of the target
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no route to @p target
+ */
+int gnrc_rpl_srh_tree_remove(const ipv6_addr_t *target);
+
+/**
+ * @brief   Ages all routes and removes the expired ones
+ *
+ * The routes are only scanned when the earliest of them is due, so this can
+ * be called in every lifetime update of RPL.
+ *
+ * @param[in] elapsed   Seconds since the last call
+ *
+ * @return  Number of removed routes
+ */
+unsigned gnrc_rpl_srh_tree_expire(uint32_t elapsed);
+
+/**
+ * @brief   Builds the source routing header for a destination
+ *
+ * The header lists the hops after the first one, ending with @p dst. Its
+ * next header field is left 0 for the caller to set.
+ *
+ * @param[in] dst       Destination of the packet
+ * @param[out] first_hop    The first hop, to be used as destination of
+ *                          the IPv6 header
+ * @param[out] srh      Buffer for the header, may be NULL if @p size is 0
+ * @param[in] size      Size of @p srh in bytes, GNRC_RPL_SRH_TREE_HDR_MAX
+ *                      is always sufficient
+ *
+ * @return  Size of the header in bytes, 0 if @p dst is a child of the root
+ *          and needs no header
+ * @return  -ENOENT if @p dst is unknown
+ * @return  -EHOSTUNREACH if the route leads through a node without a route
+ * @return  -ELOOP if the route is longer than GNRC_RPL_SRH_TREE_MAX_DEPTH
+ *          or has a loop
+ * @return  -ENOBUFS if @p size is too small
+ */
+int gnrc_rpl_srh_tree_build(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                            gnrc_rpl_srh_t *srh, size_t size);
+
+/**
+ * @brief   Gets the number of nodes with a route
+ *
+ * @return  Number of routes, placeholders are not counted
+ */
+unsigned gnrc_rpl_srh_tree_numof(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_RPL_SRH_TREE_H */
+/** @} */
@@ -170,6 +170,10 @@ typedef struct __attribute__((packed)) {
 
 /**
  * @brief Transit Option
+ *
+ * In non-storing mode the option is followed by the address of the DAO
+ * parent.
+ *
  * @see <a href="https://tools.ietf.org/html/rfc6550#section-6.7.8">
  *          RFC6550, section 6.7.8, Transit Information
  *      </a>
@@ -113,17 +113,23 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
                                                 uint8_t prefix_len, uint16_t ltime,
                                                 bool comp);
 
-#ifdef MODULE_GNRC_SIXLOWPAN_CTX
 /**
  * @brief   Removes context.
  *
  * @param[in] id    A context ID.
  */
-static inline void gnrc_sixlowpan_ctx_remove(uint8_t id)
-{
-    gnrc_sixlowpan_ctx_lookup_id(id)->prefix_len = 0;
-}
-#endif
+void gnrc_sixlowpan_ctx_remove(uint8_t id);
+
+/**
+ * @brief   Gets a counter that changes whenever a context is updated or
+ *          removed.
+ *
+ * Allows to keep compression decisions until the contexts change. Contexts
+ * that run out of lifetime do not change the counter.
+ *
+ * @return  The current value of the counter.
+ */
+unsigned gnrc_sixlowpan_ctx_version(void);
 
 #ifdef TEST_SUITES
 /**
@@ -42,6 +42,11 @@ extern "C" {
  */
 #define GNRC_SIXLOWPAN_MSG_FRAG_SND    (0x0225)
 
+/**
+ * @brief   Message type for the timeout of a reassembly buffer entry
+ */
+#define GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF (0x0226)
+
 /**
  * @brief   Definition of 6LoWPAN fragmentation type.
  */
@@ -53,6 +58,21 @@ typedef struct {
                              *   payload datagram */
 } gnrc_sixlowpan_msg_frag_t;
 
+/**
+ * @brief   Statistics of the reassembly buffer
+ */
+typedef struct {
+    uint32_t completed;     /**< datagrams that were reassembled completely */
+    uint32_t timed_out;     /**< datagrams that were removed because no
+                             *   fragment arrived in time */
+    uint32_t evicted;       /**< datagrams that were removed to make room for
+                             *   a new datagram */
+    uint32_t dropped;       /**< datagrams that could not be admitted to the
+                             *   reassembly buffer at all */
+    uint16_t used;          /**< datagrams currently under reassembly */
+    uint32_t mem_used;      /**< bytes currently reserved for reassembly */
+} gnrc_sixlowpan_frag_rbuf_stats_t;
+
 /**
  * @brief   Sends a packet fragmented.
  *
@@ -68,6 +88,20 @@ void gnrc_sixlowpan_frag_send(gnrc_sixlowpan_msg_frag_t *fragment_msg);
  */
 void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt);
 
+/**
+ * @brief   Handles a @ref GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF message
+ *
+ * @param[in] entry     Content of the message.
+ */
+void gnrc_sixlowpan_frag_gc_rbuf(void *entry);
+
+/**
+ * @brief   Gets the statistics of the reassembly buffer
+ *
+ * @param[out] stats    The statistics
+ */
+void gnrc_sixlowpan_frag_rbuf_get_stats(gnrc_sixlowpan_frag_rbuf_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,23 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of flows the encoded IPHC header is cached for
+ *
+ * Only used with the `gnrc_sixlowpan_iphc_cache` module. A flow is identified
+ * by addresses, traffic class, flow label, next header and hop limit of the
+ * IPv6 header, and by interface and link-layer addresses. The cached header
+ * is copied for every packet of the flow, only the NHC header is encoded
+ * anew. It is rebuilt when a context is updated or removed, when a
+ * context it uses runs out of lifetime, or when the source address was
+ * compressed against the IID of the interface and that IID changed. The
+ * latter is checked on every packet, so flows without a source link-layer
+ * address in the netif header still query the interface once per packet.
+ */
+#ifndef GNRC_SIXLOWPAN_IPHC_CACHE_SIZE
+#define GNRC_SIXLOWPAN_IPHC_CACHE_SIZE  (4U)
+#endif
+
 /**
  * @brief   Decompresses a received 6LoWPAN IPHC frame.
  *
@@ -52,6 +52,32 @@ int gnrc_tcp_init(void);
  */
 void gnrc_tcp_tcb_init(gnrc_tcp_tcb_t *tcb);
 
+/**
+ * @brief Set the receive buffer of a TCB.
+ *
+ * @pre gnrc_tcp_tcb_init() must have been successfully called.
+ * @pre @p tcb must not be NULL.
+ *
+ * @note If @p buf is NULL, a buffer of at least @p size bytes is taken from the
+ *       internal buffers when the connection is opened. If none is large enough
+ *       the largest available one is used. A small internal buffer is replaced
+ *       by a larger one while the connection is in use, if the application keeps
+ *       reading it empty. If @p buf is not NULL, @p buf is used for the receive
+ *       window of all following connections of @p tcb and must stay valid until
+ *       they are closed. Windows beyond 65535 bytes are announced via the
+ *       window scale option (RFC 7323) if the peer supports it.
+ *
+ * @param[in,out] tcb    TCB that should use the receive buffer.
+ * @param[in]     buf    Receive buffer supplied by the user, may be NULL.
+ * @param[in]     size   Size of @p buf, or the preferred size if @p buf is NULL.
+ *
+ * @returns   Zero on success.
+ *            -EISCONN if TCB is already in use.
+ *            -EINVAL if @p buf is not NULL and @p size is zero or @p size is
+ *            too large to be announced as window.
+ */
+int gnrc_tcp_tcb_set_rcvbuf(gnrc_tcp_tcb_t *tcb, void *buf, size_t size);
+
  /**
   * @brief Opens a connection actively.
   *
@@ -119,7 +145,10 @@ int gnrc_tcp_open_passive(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
  * @pre @p tcb must not be NULL.
  * @pre @p data must not be NULL.
  *
- * @note Blocks until up to @p len bytes were transmitted or an error occured.
+ * @note Blocks until up to @p len bytes were transmitted or an error occured. Transmitted
+ *       data is kept in the retransmission queue until the peer acknowledges it, this
+ *       function does not wait for the acknowledgment. Up to
+ *       GNRC_TCP_RETRANSMIT_QUEUE_SIZE - 1 segments can be in flight.
  *
  * @param[in,out] tcb                        TCB holding the connection information.
  * @param[in]     data                       Pointer to the data that should be transmitted.
@@ -133,6 +162,7 @@ int gnrc_tcp_open_passive(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
  *            -ECONNRESET if connection was resetted by the peer.
  *            -ECONNABORTED if the connection was aborted.
  *            -ETIMEDOUT if @p user_timeout_duration_us expired.
+ *            -ENOMEM if the packet buffer has no space for a segment.
  */
 ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
                       const uint32_t user_timeout_duration_us);
@@ -81,6 +81,36 @@ extern "C" {
 #define GNRC_TCP_RCV_BUF_SIZE (GNRC_TCP_DEFAULT_WINDOW)
 #endif
 
+/**
+ * @brief Number of preallocated large receive buffers
+ *
+ * Connections that ask for more than GNRC_TCP_RCV_BUF_SIZE bytes with
+ * gnrc_tcp_tcb_set_rcvbuf() get a large buffer. Connections with a small
+ * buffer move to a large one, if the application reads faster than the
+ * window allows the peer to send.
+ */
+#ifndef GNRC_TCP_RCV_BUFFERS_LARGE
+#define GNRC_TCP_RCV_BUFFERS_LARGE (0U)
+#endif
+
+/**
+ * @brief Size of the large receive buffers
+ */
+#ifndef GNRC_TCP_RCV_BUF_SIZE_LARGE
+#define GNRC_TCP_RCV_BUF_SIZE_LARGE (4U * GNRC_TCP_MSS)
+#endif
+
+/**
+ * @brief Number of unacknowledged segments a connection can keep in flight
+ *
+ * Every queued segment stays in the packet buffer until it is acknowledged, so
+ * GNRC_PKTBUF_SIZE must be able to hold this many MSS sized segments per
+ * connection. One entry is reserved for the FIN, the value must be at least 2.
+ */
+#ifndef GNRC_TCP_RETRANSMIT_QUEUE_SIZE
+#define GNRC_TCP_RETRANSMIT_QUEUE_SIZE (4U)
+#endif
+
 /**
  * @brief Lower bound for RTO = 1 sec (see RFC 6298)
  */
@@ -59,25 +59,35 @@ typedef struct _transmission_control_block {
     uint8_t status;        /**< A connections status flags */
     uint32_t snd_una;      /**< Send unacknowledged */
     uint32_t snd_nxt;      /**< Send next */
-    uint16_t snd_wnd;      /**< Send window */
+    uint32_t snd_wnd;      /**< Send window */
     uint32_t snd_wl1;      /**< SeqNo. from last window update */
     uint32_t snd_wl2;      /**< AckNo. from last window update */
     uint32_t rcv_nxt;      /**< Receive next */
-    uint16_t rcv_wnd;      /**< Receive window */
+    uint32_t rcv_wnd;      /**< Receive window */
     uint32_t iss;          /**< Initial sequence sumber */
     uint32_t irs;          /**< Initial received sequence number */
     uint16_t mss;          /**< The peers MSS */
+    uint8_t snd_wscale;    /**< The peers window scale shift count */
+    uint8_t rcv_wscale;    /**< Own window scale shift count */
     uint32_t rtt_start;    /**< Timer value for rtt estimation */
     int32_t rtt_var;       /**< Round trip time variance */
     int32_t srtt;          /**< Smoothed round trip time */
     int32_t rto;           /**< Retransmission timeout duration */
+    uint32_t rtt_seq;      /**< Sequence number whose acknowledgment ends the rtt estimation */
     uint8_t retries;       /**< Number of retransmissions */
+    uint8_t dup_acks;      /**< Number of consecutive duplicate ACKs */
+    uint32_t cwnd;         /**< Congestion window */
+    uint32_t ssthresh;     /**< Slow start threshold */
+    uint32_t recover;      /**< Send next at the start of the last loss recovery */
     xtimer_t tim_tout;     /**< Timer struct for timeouts */
     msg_t msg_tout;        /**< Message, sent on timeouts */
-    gnrc_pktsnip_t *pkt_retransmit;   /**< Pointer to packet in "retransmit queue" */
+    gnrc_pktsnip_t *rtx_queue[GNRC_TCP_RETRANSMIT_QUEUE_SIZE];  /**< Unacknowledged packets */
+    uint8_t rtx_head;      /**< Index of the oldest packet in rtx_queue */
+    uint8_t rtx_numof;     /**< Number of packets in rtx_queue */
     kernel_pid_t owner;               /**< PID of this connection handling thread */
     msg_t msg_queue[GNRC_TCP_TCB_MSG_QUEUE_SIZE];   /**< TCB message queue */
     uint8_t *rcv_buf_raw;    /**< Pointer to the receive buffer */
+    size_t rcv_buf_size;     /**< Requested or supplied receive buffer size */
     ringbuffer_t rcv_buf;    /**< Receive buffer data structure */
     mutex_t fsm_lock;        /**< Mutex for FSM access synchronization */
     mutex_t function_lock;   /**< Mutex for function call synchronization */
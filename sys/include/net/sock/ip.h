@@ -272,6 +272,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include "net/sock.h"
 
@@ -448,6 +449,34 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
 ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
                      uint8_t proto, const sock_ip_ep_t *remote);
 
+/**
+ * @brief   Sends the data of multiple buffers as one message to remote end
+ *          point
+ *
+ * Behaves like sock_ip_send(), but the payload is the concatenation of the
+ * buffers in @p vector, so headers and payload don't need to be copied into
+ * one buffer first.
+ *
+ * @note    Currently only provided by @ref net_gnrc_sock.
+ *
+ * @pre `((sock != NULL || remote != NULL))`
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object. May be NULL.
+ *                      A sensible local end point should be selected by the
+ *                      implementation in that case.
+ * @param[in] vector    Buffers to send, in order.
+ * @param[in] count     Number of buffers in @p vector.
+ * @param[in] proto     Protocol to use in the packet sent, as for
+ *                      sock_ip_send().
+ * @param[in] remote    Remote end point for the sent data, as for
+ *                      sock_ip_send().
+ *
+ * @return  The number of bytes sent on success.
+ * @return  The errors of sock_ip_send().
+ */
+ssize_t sock_ip_sendv(sock_ip_t *sock, const struct iovec *vector,
+                      unsigned count, uint8_t proto, const sock_ip_ep_t *remote);
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
@@ -272,6 +272,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include "net/sock.h"
 
@@ -433,6 +434,32 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
                       const sock_udp_ep_t *remote);
 
+/**
+ * @brief   Sends the data of multiple buffers as one UDP message to remote end
+ *          point
+ *
+ * Behaves like sock_udp_send(), but the payload is the concatenation of the
+ * buffers in @p vector, so headers and payload don't need to be copied into
+ * one buffer first.
+ *
+ * @note    Currently only provided by @ref net_gnrc_sock.
+ *
+ * @pre `((sock != NULL || remote != NULL))`
+ *
+ * @param[in] sock      A UDP sock object. May be `NULL`.
+ *                      A sensible local end point should be selected by the
+ *                      implementation in that case.
+ * @param[in] vector    Buffers to send, in order.
+ * @param[in] count     Number of buffers in @p vector.
+ * @param[in] remote    Remote end point for the sent data, as for
+ *                      sock_udp_send().
+ *
+ * @return  The number of bytes sent on success.
+ * @return  The errors of sock_udp_send().
+ */
+ssize_t sock_udp_sendv(sock_udp_t *sock, const struct iovec *vector,
+                       unsigned count, const sock_udp_ep_t *remote);
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
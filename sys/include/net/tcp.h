@@ -43,6 +43,7 @@ extern "C" {
 #define TCP_OPTION_KIND_EOL (0x00)  /**< "End of List"-Option */
 #define TCP_OPTION_KIND_NOP (0x01)  /**< "No Operatrion"-Option */
 #define TCP_OPTION_KIND_MSS (0x02)  /**< "Maximum Segment Size"-Option */
+#define TCP_OPTION_KIND_WS  (0x03)  /**< "Window Scale"-Option */
 /** @} */
 
 /**
@@ -50,6 +51,7 @@ extern "C" {
  * @{
  */
 #define TCP_OPTION_LENGTH_MSS (0x04)  /**< MSS Option Size always 4 */
+#define TCP_OPTION_LENGTH_WS  (0x03)  /**< Window Scale Option Size always 3 */
 /** @} */
 
 /**
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_schedprof Scheduler profiling
+ * @ingroup     sys
+ * @brief       Per-thread run time, ready-to-running latency and ISR time
+ *
+ * The scheduler calls into this module on every context switch and every
+ * time a thread becomes ready to run. Time stamps are taken from a cycle
+ * counter where the CPU has one (DWT on Cortex-M3 and up, `clock_gettime()`
+ * in nanoseconds on native) and from xtimer otherwise, see schedprof_hz().
+ * With xtimer, all time stamps are 0 until auto_init started it and called
+ * schedprof_xtimer_init().
+ *
+ * For every thread the module records
+ *
+ * - the time it spent running, including the ISRs that interrupted it,
+ * - the time ISRs stole from it (native only, see @ref SCHEDPROF_ISR),
+ * - how often it was scheduled and how often it was switched out while still
+ *   being runnable (preempted or yielded),
+ * - a histogram and the maximum of the time from becoming ready to running.
+ *
+ * With the `schedprof_trace` module every event is additionally written to
+ * a ring buffer of compact binary records (see @ref schedprof_event_t) that
+ * can be drained with schedprof_trace_read() for offline analysis of tail
+ * latency. The `schedprof` shell command prints the statistics and dumps the
+ * trace.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Scheduler profiling interface
+ */
+
+#ifndef SCHEDPROF_H
+#define SCHEDPROF_H
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of buckets of the wait time histograms
+ */
+#ifndef SCHEDPROF_HIST_NUMOF
+#define SCHEDPROF_HIST_NUMOF    (16U)
+#endif
+
+/**
+ * @brief   Wait times below 2^SCHEDPROF_HIST_SHIFT counter ticks go into the
+ *          first bucket
+ *
+ * Bucket `i > 0` counts wait times from `2^(SCHEDPROF_HIST_SHIFT + i - 1)` to
+ * below `2^(SCHEDPROF_HIST_SHIFT + i)` ticks, the last bucket also counts
+ * everything above.
+ */
+#ifndef SCHEDPROF_HIST_SHIFT
+#define SCHEDPROF_HIST_SHIFT    (6U)
+#endif
+
+/**
+ * @brief   Number of records in the trace ring buffer, must be a power of 2
+ */
+#ifndef SCHEDPROF_TRACE_NUMOF
+#define SCHEDPROF_TRACE_NUMOF   (64U)
+#endif
+
+/**
+ * @brief   Defined where the interrupt dispatcher calls schedprof_isr_enter()
+ *          and schedprof_isr_exit()
+ *
+ * This is only native's signal handler. Other CPUs have no common ISR entry,
+ * so there the time spent in ISRs is counted as run time of the interrupted
+ * thread and schedprof_thread_t::isr_time stays 0.
+ */
+#if defined(CPU_NATIVE) || defined(DOXYGEN)
+#define SCHEDPROF_ISR
+#endif
+
+/**
+ * @brief   Profile of a thread
+ *
+ * All times are in ticks of schedprof_hz().
+ */
+typedef struct {
+    uint64_t runtime;               /**< time the thread was running */
+    uint64_t isr_time;              /**< time stolen by ISRs while running */
+    uint32_t schedules;             /**< number of times it was scheduled */
+    uint32_t preemptions;           /**< number of times it was switched out
+                                     *   while still runnable */
+    uint32_t wait_max;              /**< maximum time from ready to running */
+    uint32_t wait_hist[SCHEDPROF_HIST_NUMOF];   /**< histogram of the times
+                                                 *   from ready to running */
+} schedprof_thread_t;
+
+/**
+ * @brief   Totals of all ISRs
+ */
+typedef struct {
+    uint64_t time;                  /**< time spent in ISRs */
+    uint32_t count;                 /**< number of (outermost) ISRs */
+} schedprof_isr_t;
+
+/**
+ * @brief   Trace event types
+ */
+enum {
+    SCHEDPROF_EVENT_READY = 0,      /**< schedprof_event_t::pid became ready */
+    SCHEDPROF_EVENT_SWITCH,         /**< switched from schedprof_event_t::arg
+                                     *   to schedprof_event_t::pid */
+    SCHEDPROF_EVENT_PREEMPT,        /**< schedprof_event_t::pid was switched
+                                     *   out while still runnable */
+    SCHEDPROF_EVENT_ISR_ENTER,      /**< ISR interrupted schedprof_event_t::pid */
+    SCHEDPROF_EVENT_ISR_EXIT,       /**< ISR returned to schedprof_event_t::pid */
+};
+
+/**
+ * @brief   A trace record
+ *
+ * Records are written in the byte order of the CPU.
+ */
+typedef struct {
+    uint32_t time;                  /**< time stamp in ticks of schedprof_hz() */
+    uint8_t event;                  /**< event type */
+    uint8_t pid;                    /**< thread the event refers to */
+    uint16_t arg;                   /**< event specific argument */
+} schedprof_event_t;
+
+/**
+ * @brief   Starts the counter, called by the kernel before the first thread
+ *          is created
+ */
+void schedprof_init(void);
+
+/**
+ * @brief   Starts taking time stamps from xtimer, called by auto_init after
+ *          xtimer_init()
+ *
+ * Does nothing on CPUs with a cycle counter.
+ */
+void schedprof_xtimer_init(void);
+
+/**
+ * @brief   Gets the current time stamp
+ *
+ * @return  the counter value in ticks of schedprof_hz()
+ */
+uint32_t schedprof_now(void);
+
+/**
+ * @brief   Gets the frequency of the counter
+ *
+ * @return  ticks per second
+ */
+uint32_t schedprof_hz(void);
+
+/**
+ * @brief   Called by the scheduler when a thread is put on the run queue
+ *
+ * @param[in] pid   the thread
+ */
+void schedprof_ready(kernel_pid_t pid);
+
+/**
+ * @brief   Called by the scheduler on a context switch
+ *
+ * @param[in] prev  the thread that was running, may be NULL
+ * @param[in] next  the thread that will be running
+ */
+void schedprof_switch(thread_t *prev, thread_t *next);
+
+#if defined(SCHEDPROF_ISR) || defined(DOXYGEN)
+/**
+ * @brief   Called by interrupt dispatchers when entering an ISR
+ */
+void schedprof_isr_enter(void);
+
+/**
+ * @brief   Called by interrupt dispatchers when leaving an ISR
+ */
+void schedprof_isr_exit(void);
+#endif
+
+/**
+ * @brief   Gets the profile of a thread
+ *
+ * @param[in] pid       the thread
+ * @param[out] prof     the profile
+ *
+ * @return  0 on success
+ * @return  -EINVAL, if @p pid is invalid
+ */
+int schedprof_get(kernel_pid_t pid, schedprof_thread_t *prof);
+
+#if defined(SCHEDPROF_ISR) || defined(DOXYGEN)
+/**
+ * @brief   Gets the ISR totals
+ *
+ * @param[out] isr      the totals
+ */
+void schedprof_get_isr(schedprof_isr_t *isr);
+#endif
+
+/**
+ * @brief   Clears all profiles, the ISR totals and the trace
+ */
+void schedprof_reset(void);
+
+#if defined(MODULE_SCHEDPROF_TRACE) || defined(DOXYGEN)
+/**
+ * @brief   Takes the oldest records out of the trace
+ *
+ * @param[out] buf      buffer for the records
+ * @param[in] numof     maximum number of records in @p buf
+ *
+ * @return  number of records written to @p buf
+ */
+unsigned schedprof_trace_read(schedprof_event_t *buf, unsigned numof);
+
+/**
+ * @brief   Gets the number of records that were overwritten before they
+ *          were read
+ *
+ * @return  number of lost records
+ */
+uint32_t schedprof_trace_lost(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDPROF_H */
+/** @} */
@@ -19,6 +19,10 @@
  * This ringbuffer implementation can be used without locking if
  * there's only one producer and one consumer.
  *
+ * Besides copying data in and out, the producer can write to the buffer
+ * memory in place (tsrb_reserve(), tsrb_commit()), e.g. as DMA target, and
+ * the consumer can parse the data where it is (tsrb_peek(), tsrb_consume()).
+ *
  * @note Buffer size must be a power of two!
  *
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
@@ -146,6 +150,49 @@ int tsrb_add_one(tsrb_t *rb, char c);
  */
 int tsrb_add(tsrb_t *rb, const char *src, size_t n);
 
+/**
+ * @brief       Get the free space at the write position, for writing to it
+ *              in place
+ *
+ * The space ends at the end of the buffer memory. Once the end was filled
+ * and committed, the next call returns the free space at its start.
+ *
+ * @note        Only to be used by the producer
+ *
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[out]  dst start of the free space
+ * @return      nr of bytes that can be written to @p dst
+ */
+unsigned tsrb_reserve(tsrb_t *rb, char **dst);
+
+/**
+ * @brief       Make bytes written via tsrb_reserve() available for reading
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes written, at most what tsrb_reserve() returned
+ */
+void tsrb_commit(tsrb_t *rb, unsigned n);
+
+/**
+ * @brief       Get the data at the read position, for reading it in place
+ *
+ * Like tsrb_reserve(), the data returned ends at the end of the buffer
+ * memory.
+ *
+ * @note        Only to be used by the consumer
+ *
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[out]  src start of the data
+ * @return      nr of bytes that can be read from @p src
+ */
+unsigned tsrb_peek(tsrb_t *rb, char **src);
+
+/**
+ * @brief       Remove bytes read via tsrb_peek() from ringbuffer
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes read, at most what tsrb_avail() returns
+ */
+void tsrb_consume(tsrb_t *rb, unsigned n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,11 @@
  * @ingroup     sys
  * @brief       universal address container
  *
+ * Each address is stored once, in the smallest of the entry pools it fits
+ * (see UNIVERSAL_ADDRESS_MAX_ENTRIES_2 and UNIVERSAL_ADDRESS_MAX_ENTRIES_8),
+ * and found by its hash. The content of a container does not change while it
+ * is referenced, so reading it does not lock.
+ *
  * @{
  *
  * @file
@@ -57,9 +62,11 @@ extern "C" {
  * @brief The container descriptor used to identify a universal address entry
  */
 typedef struct {
+    uint16_t next;                           /**< Next entry with the same hash */
     uint8_t use_count;                       /**< The number of entries link here */
     uint8_t address_size;                    /**< Size in bytes of the used generic address */
-    uint8_t address[UNIVERSAL_ADDRESS_SIZE]; /**< The generic address data */
+    uint8_t address[];                       /**< The generic address data, of up to
+                                                  UNIVERSAL_ADDRESS_SIZE bytes */
 } universal_address_container_t;
 
 /**
@@ -84,6 +91,20 @@ void universal_address_reset(void);
  */
 universal_address_container_t *universal_address_add(uint8_t *addr, size_t addr_size);
 
+/**
+ * @brief Find the container of a given address, without locking
+ *
+ * The container is not referenced by the call, so the result is only of use
+ * for comparing it against containers referenced otherwise: two equal
+ * addresses share the same container.
+ *
+ * @param[in] addr       pointer to the address
+ * @param[in] addr_size  the number of bytes of the address
+ * @return pointer to the universal_address_container_t containing the address
+ * @return NULL if the address is not stored
+ */
+universal_address_container_t *universal_address_find(const uint8_t *addr, size_t addr_size);
+
 /**
  * @brief Add a given container from the universal address entries. If the entry exists,
  *        the universal_address_container_t::use_count will be decreased.
@@ -67,6 +67,7 @@ using std::atomic_int;
 #include <sys/stat.h> /* for struct stat */
 #include <sys/types.h> /* for off_t etc. */
 #include <sys/statvfs.h> /* for struct statvfs */
+#include <sys/uio.h> /* for struct iovec */
 
 #include "kernel_types.h"
 #include "clist.h"
@@ -88,6 +89,13 @@ extern "C" {
 #define VFS_MAX_OPEN_FILES (16)
 #endif
 
+#ifndef VFS_MAX_MOUNTS
+/**
+ * @brief Maximum number of simultaneously mounted file systems
+ */
+#define VFS_MAX_MOUNTS (8)
+#endif
+
 #ifndef VFS_DIR_BUFFER_SIZE
 /**
  * @brief Size of buffer space in vfs_DIR
@@ -346,6 +354,70 @@ struct vfs_file_ops {
      * @return <0 on error
      */
     ssize_t (*write) (vfs_file_t *filp, const void *src, size_t nbytes);
+
+    /**
+     * @brief Read bytes from an open file into multiple buffers
+     *
+     * The buffers are filled in order. If this is NULL, the VFS calls
+     * @c read for each buffer until a read returns less than requested.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  iov      array of destination buffers
+     * @param[in]  iovcnt   number of buffers in @p iov
+     *
+     * @return number of bytes read on success
+     * @return <0 on error
+     */
+    ssize_t (*readv) (vfs_file_t *filp, const struct iovec *iov, int iovcnt);
+
+    /**
+     * @brief Write bytes from multiple buffers to an open file
+     *
+     * The buffers are written in order. If this is NULL, the VFS calls
+     * @c write for each buffer until a write returns less than requested.
+     * File types which must handle the buffers as one unit, e.g. datagram
+     * sockets, need to implement this.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  iov      array of source buffers
+     * @param[in]  iovcnt   number of buffers in @p iov
+     *
+     * @return number of bytes written on success
+     * @return <0 on error
+     */
+    ssize_t (*writev) (vfs_file_t *filp, const struct iovec *iov, int iovcnt);
+
+    /**
+     * @brief Read bytes from a given offset of an open file
+     *
+     * The file position is not changed. If this is NULL, the VFS seeks to
+     * @p off with @c lseek, calls @c read and seeks back.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  dest     pointer to destination buffer
+     * @param[in]  nbytes   maximum number of bytes to read
+     * @param[in]  off      offset in the file to read from
+     *
+     * @return number of bytes read on success
+     * @return <0 on error
+     */
+    ssize_t (*pread) (vfs_file_t *filp, void *dest, size_t nbytes, off_t off);
+
+    /**
+     * @brief Write bytes to a given offset of an open file
+     *
+     * The file position is not changed. If this is NULL, the VFS seeks to
+     * @p off with @c lseek, calls @c write and seeks back.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  src      pointer to source buffer
+     * @param[in]  nbytes   maximum number of bytes to write
+     * @param[in]  off      offset in the file to write to
+     *
+     * @return number of bytes written on success
+     * @return <0 on error
+     */
+    ssize_t (*pwrite) (vfs_file_t *filp, const void *src, size_t nbytes, off_t off);
 };
 
 /**
@@ -626,6 +698,68 @@ ssize_t vfs_read(int fd, void *dest, size_t count);
  */
 ssize_t vfs_write(int fd, const void *src, size_t count);
 
+/**
+ * @brief Read bytes from an open file into multiple buffers
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  iov      array of destination buffers, filled in order
+ * @param[in]  iovcnt   number of buffers in @p iov
+ *
+ * @return number of bytes read on success
+ * @return <0 on error
+ */
+ssize_t vfs_readv(int fd, const struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Write bytes from multiple buffers to an open file
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  iov      array of source buffers, written in order
+ * @param[in]  iovcnt   number of buffers in @p iov
+ *
+ * @return number of bytes written on success
+ * @return <0 on error
+ */
+ssize_t vfs_writev(int fd, const struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Read bytes from a given offset of an open file
+ *
+ * The file position is not changed.
+ *
+ * @attention For file systems without a @c pread operation, the file position
+ * is changed temporarily. Do not share such an fd between threads.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[out] dest     destination buffer to hold the file contents
+ * @param[in]  count    maximum number of bytes to read
+ * @param[in]  offset   offset in the file to read from
+ *
+ * @return number of bytes read on success
+ * @return -ESPIPE if the file is not seekable
+ * @return <0 on error
+ */
+ssize_t vfs_pread(int fd, void *dest, size_t count, off_t offset);
+
+/**
+ * @brief Write bytes to a given offset of an open file
+ *
+ * The file position is not changed.
+ *
+ * @attention For file systems without a @c pwrite operation, the file position
+ * is changed temporarily. Do not share such an fd between threads.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  src      pointer to source buffer
+ * @param[in]  count    maximum number of bytes to write
+ * @param[in]  offset   offset in the file to write to
+ *
+ * @return number of bytes written on success
+ * @return -ESPIPE if the file is not seekable
+ * @return <0 on error
+ */
+ssize_t vfs_pwrite(int fd, const void *src, size_t count, off_t offset);
+
 /**
  * @brief Open a directory for reading with readdir
  *
@@ -680,6 +814,7 @@ int vfs_closedir(vfs_DIR *dirp);
  * @param[in]  mountp    pointer to the mount structure of the file system to mount
  *
  * @return 0 on success
+ * @return -ENOSPC if @ref VFS_MAX_MOUNTS file systems are already mounted
  * @return <0 on error
  */
 int vfs_mount(vfs_mount_t *mountp);
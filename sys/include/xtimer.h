@@ -20,6 +20,16 @@
  * number of active timers.  The reason for this is that multiplexing is
  * realized by next-first singly linked lists.
  *
+ * Alternatively, the `xtimer_wheel` module replaces these lists by a
+ * hierarchical timing wheel: timers are hashed into one of
+ * @ref XTIMER_WHEEL_LEVELS levels of 2^@ref XTIMER_WHEEL_BITS slots each by
+ * their target time and cascade down to the next level when their slot is
+ * reached. Removal is O(1). Insertion is O(1) for timers that go into a
+ * wheel slot or into the list of timers beyond the top level. Timers due
+ * within the current 2^@ref XTIMER_WHEEL_SHIFT ticks, including those that
+ * cascade down from a reached slot, are inserted into a sorted list, which
+ * stays linear in the number of timers already due in that window.
+ *
  * @{
  * @file
  * @brief   xtimer interface definitions
@@ -74,6 +84,10 @@ typedef struct xtimer {
     xtimer_callback_t callback;  /**< callback function to call when timer
                                      expires */
     void *arg;                   /**< argument to pass to callback function */
+#if defined(MODULE_XTIMER_WHEEL) || defined(DOXYGEN)
+    struct xtimer **pprev;       /**< reference to the link pointing to this
+                                      timer (`xtimer_wheel` only) */
+#endif
 } xtimer_t;
 
 /**
@@ -580,6 +594,39 @@ int xtimer_mutex_lock_timeout(mutex_t *mutex, uint64_t us);
 #define XTIMER_HZ 1000000ul
 #endif
 
+#if defined(MODULE_XTIMER_WHEEL) || defined(DOXYGEN)
+#ifndef XTIMER_WHEEL_SHIFT
+/**
+ * @brief   Resolution of the lowest timer wheel level as power of two of
+ *          hardware ticks (`xtimer_wheel` only)
+ *
+ * Timers expiring within the same 2^XTIMER_WHEEL_SHIFT ticks are kept in a
+ * sorted list once their slot is reached.
+ */
+#define XTIMER_WHEEL_SHIFT  (10U)
+#endif
+
+#ifndef XTIMER_WHEEL_BITS
+/**
+ * @brief   Number of slots per timer wheel level as power of two
+ *          (`xtimer_wheel` only, 5 at most)
+ */
+#define XTIMER_WHEEL_BITS   (4U)
+#endif
+
+#ifndef XTIMER_WHEEL_LEVELS
+/**
+ * @brief   Number of timer wheel levels (`xtimer_wheel` only)
+ *
+ * Timers further than
+ * 2^(XTIMER_WHEEL_SHIFT + XTIMER_WHEEL_LEVELS * XTIMER_WHEEL_BITS) ticks in
+ * the future are kept in an unsorted list that is re-hashed whenever the
+ * top level wraps.
+ */
+#define XTIMER_WHEEL_LEVELS (5U)
+#endif
+#endif
+
 #include "xtimer/tick_conversion.h"
 
 #include "xtimer/implementation.h"
@@ -13,13 +13,162 @@
  */
 
 #include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
+#include <string.h>
+#include "byteorder.h"
 #include "od.h"
 #include "net/inet_csum.h"
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+/*
+ * The implementation of _csum() is chosen at build time by the target's
+ * capabilities:
+ *
+ * - x86 with AVX2 or SSE2 (e.g. `native` built with `-mavx2` or `-msse2`):
+ *   vectors of 16-bit words are summed into 32-bit lanes
+ * - other 32-bit platforms (e.g. Cortex-M): aligned 32-bit words are summed
+ *   into a 64-bit accumulator whose carries are folded back in the end
+ * - 8- and 16-bit platforms: 16-bit words are summed byte by byte
+ *
+ * All of them return the same value: the checksum of buf as a sequence of
+ * big-endian 16-bit words, with an odd last byte as the upper half of a word.
+ */
+#if defined(__AVX2__) || defined(__SSE2__) || (UINT_MAX > 0xffff)
+static inline uint16_t _fold(uint64_t sum)
+{
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return sum;
+}
+
+/* sums the last less than 4 bytes of buf in host byte order */
+static inline uint64_t _sum_tail(const uint8_t *buf, size_t len)
+{
+    uint64_t sum = 0;
+    uint16_t word;
+
+    if (len >= 2) {
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+        buf += 2;
+        len -= 2;
+    }
+    if (len) {
+        /* pad the last byte with a zero byte */
+        uint8_t last[2] = { *buf, 0 };
+
+        memcpy(&word, last, sizeof(word));
+        sum += word;
+    }
+    return sum;
+}
+
+/* sums buf in host byte order, so the sum is byte swapped on little endian
+ * platforms; buf must be 2-byte aligned */
+static uint64_t _sum_aligned(const uint8_t *buf, size_t len)
+{
+    uint64_t sum = 0;
+    uint16_t word;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    /* lanes can not overflow: len is less than 2^16 */
+#ifdef __AVX2__
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+
+    for (; len >= 32; buf += 32, len -= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)buf);
+
+        acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+        acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+    }
+    __m128i acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                                   _mm256_extracti128_si256(acc, 1));
+#else
+    __m128i acc128 = _mm_setzero_si128();
+#endif
+    for (; len >= 16; buf += 16, len -= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)buf);
+
+        acc128 = _mm_add_epi32(acc128, _mm_unpacklo_epi16(v, _mm_setzero_si128()));
+        acc128 = _mm_add_epi32(acc128, _mm_unpackhi_epi16(v, _mm_setzero_si128()));
+    }
+    uint32_t lanes[4];
+
+    _mm_storeu_si128((__m128i *)lanes, acc128);
+    sum = (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    if ((uintptr_t)buf & 2) {
+        if (len < 2) {
+            return sum + _sum_tail(buf, len);
+        }
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+        buf += 2;
+        len -= 2;
+    }
+    /* buf is 4-byte aligned now, so the loads below are single instructions
+     * even on cores without unaligned access */
+    const uint8_t *words = __builtin_assume_aligned(buf, 4);
+
+    for (; len >= 16; words += 16, len -= 16) {
+        uint32_t w[4];
+
+        memcpy(w, words, sizeof(w));
+        sum += (uint64_t)w[0] + w[1] + w[2] + w[3];
+    }
+    for (; len >= 4; words += 4, len -= 4) {
+        uint32_t w;
+
+        memcpy(&w, words, sizeof(w));
+        sum += w;
+    }
+    return sum + _sum_tail(words, len);
+}
+
+static uint16_t _csum(const uint8_t *buf, size_t len)
+{
+    if ((uintptr_t)buf & 1) {
+        /* summing from the next byte on swaps the halves of all words, so
+         * the first byte becomes a lower half and the result is swapped back */
+        uint16_t sum = ntohs(_fold(_sum_aligned(buf + 1, len - 1)));
+
+        return byteorder_swaps(_fold((uint32_t)sum + *buf));
+    }
+    return ntohs(_fold(_sum_aligned(buf, len)));
+}
+#else
+static uint16_t _csum(const uint8_t *buf, size_t len)
+{
+    uint32_t csum = 0;
+
+    for (size_t i = 0; i < (len >> 1); buf += 2, i++) {
+        csum += (uint16_t)(*buf << 8) + *(buf + 1); /* group bytes by 16-byte words */
+                                                    /* and add them */
+    }
+
+    if (len & 1) {                      /* if length is odd */
+        csum += (uint16_t)(*buf << 8);  /* add last byte as top half of 16-byte word */
+    }
+
+    while (csum >> 16) {
+        uint16_t carry = csum >> 16;
+        csum = (csum & 0xffff) + carry;
+    }
+
+    return csum;
+}
+#endif
+
 uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t accum_len)
 {
     uint32_t csum = sum;
@@ -41,17 +190,13 @@ uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t
         csum += *buf;         /* add first byte as bottom half of 16-byte word */
         buf++;
         len--;
-        accum_len++;
     }
 
-    for (int i = 0; i < (len >> 1); buf += 2, i++) {
-        csum += (uint16_t)(*buf << 8) + *(buf + 1); /* group bytes by 16-byte words */
-                                                    /* and add them */
+    if (len > 0) {
+        /* remaining buffer starts at an even position of the domain */
+        csum += _csum(buf, len);
     }
 
-    if ((accum_len + len) & 1)          /* if accumulated length is odd */
-        csum += (uint16_t)(*buf << 8);  /* add last byte as top half of 16-byte word */
-
     while (csum >> 16) {
         uint16_t carry = csum >> 16;
         csum = (csum & 0xffff) + carry;
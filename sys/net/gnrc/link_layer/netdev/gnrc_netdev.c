@@ -199,3 +199,51 @@ kernel_pid_t gnrc_netdev_init(char *stack, int stacksize, char priority,
 
     return res;
 }
+
+static void *_rx_alloc(void *arg, size_t len)
+{
+    gnrc_pktsnip_t **pkt = arg;
+
+    *pkt = gnrc_pktbuf_add(NULL, NULL, len, GNRC_NETTYPE_UNDEF);
+    return (*pkt != NULL) ? (*pkt)->data : NULL;
+}
+
+int gnrc_netdev_recv_snip(netdev_t *dev, gnrc_pktsnip_t **pkt, void *info)
+{
+    int nread;
+
+    *pkt = NULL;
+    if (dev->driver->recv_lend != NULL) {
+        nread = dev->driver->recv_lend(dev, _rx_alloc, pkt, info);
+    }
+    else {
+        int bytes_expected = dev->driver->recv(dev, NULL, 0, NULL);
+
+        if (bytes_expected <= 0) {
+            return bytes_expected;
+        }
+        *pkt = gnrc_pktbuf_add(NULL, NULL, bytes_expected, GNRC_NETTYPE_UNDEF);
+        if (*pkt == NULL) {
+            DEBUG("gnrc_netdev: cannot allocate pktsnip.\n");
+            /* drop the packet */
+            dev->driver->recv(dev, NULL, bytes_expected, NULL);
+            return -ENOBUFS;
+        }
+        nread = dev->driver->recv(dev, (*pkt)->data, bytes_expected, info);
+    }
+    if (nread <= 0) {
+        DEBUG("gnrc_netdev: read error or no packet (%d).\n", nread);
+        if (*pkt != NULL) {
+            gnrc_pktbuf_release(*pkt);
+            *pkt = NULL;
+        }
+        return nread;
+    }
+    if ((size_t)nread < (*pkt)->size) {
+        /* we've got less then the expected packet size,
+         * so free the unused space.*/
+        DEBUG("gnrc_netdev: reallocating.\n");
+        gnrc_pktbuf_realloc_data(*pkt, nread);
+    }
+    return nread;
+}
@@ -32,37 +32,10 @@
 static gnrc_pktsnip_t *_recv(gnrc_netdev_t *gnrc_netdev)
 {
     netdev_t *dev = gnrc_netdev->dev;
-    int bytes_expected = dev->driver->recv(dev, NULL, 0, NULL);
     gnrc_pktsnip_t *pkt = NULL;
+    int nread = gnrc_netdev_recv_snip(dev, &pkt, NULL);
 
-    if (bytes_expected > 0) {
-        pkt = gnrc_pktbuf_add(NULL, NULL,
-                bytes_expected,
-                GNRC_NETTYPE_UNDEF);
-
-        if(!pkt) {
-            DEBUG("_recv_ethernet_packet: cannot allocate pktsnip.\n");
-
-            /* drop the packet */
-            dev->driver->recv(dev, NULL, bytes_expected, NULL);
-
-            goto out;
-        }
-
-        int nread = dev->driver->recv(dev, pkt->data, bytes_expected, NULL);
-        if(nread <= 0) {
-            DEBUG("_recv_ethernet_packet: read error.\n");
-            goto safe_out;
-        }
-
-        if (nread < bytes_expected) {
-            /* we've got less then the expected packet size,
-             * so free the unused space.*/
-
-            DEBUG("_recv_ethernet_packet: reallocating.\n");
-            gnrc_pktbuf_realloc_data(pkt, nread);
-        }
-
+    if (nread > 0) {
         /* mark ethernet header */
         gnrc_pktsnip_t *eth_hdr = gnrc_pktbuf_mark(pkt, sizeof(ethernet_hdr_t), GNRC_NETTYPE_UNDEF);
         if (!eth_hdr) {
@@ -104,7 +77,6 @@ static gnrc_pktsnip_t *_recv(gnrc_netdev_t *gnrc_netdev)
         LL_APPEND(pkt, netif_hdr);
     }
 
-out:
     return pkt;
 
 safe_out:
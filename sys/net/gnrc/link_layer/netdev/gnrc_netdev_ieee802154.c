@@ -70,21 +70,9 @@ static gnrc_pktsnip_t *_recv(gnrc_netdev_t *gnrc_netdev)
     netdev_ieee802154_rx_info_t rx_info;
     netdev_ieee802154_t *state = (netdev_ieee802154_t *)gnrc_netdev->dev;
     gnrc_pktsnip_t *pkt = NULL;
-    int bytes_expected = netdev->driver->recv(netdev, NULL, 0, NULL);
+    int nread = gnrc_netdev_recv_snip(netdev, &pkt, &rx_info);
 
-    if (bytes_expected > 0) {
-        int nread;
-
-        pkt = gnrc_pktbuf_add(NULL, NULL, bytes_expected, GNRC_NETTYPE_UNDEF);
-        if (pkt == NULL) {
-            DEBUG("_recv_ieee802154: cannot allocate pktsnip.\n");
-            return NULL;
-        }
-        nread = netdev->driver->recv(netdev, pkt->data, bytes_expected, &rx_info);
-        if (nread <= 0) {
-            gnrc_pktbuf_release(pkt);
-            return NULL;
-        }
+    if (nread > 0) {
         if (!(state->flags & NETDEV_IEEE802154_RAW)) {
             gnrc_pktsnip_t *ieee802154_hdr, *netif_hdr;
             gnrc_netif_hdr_t *hdr;
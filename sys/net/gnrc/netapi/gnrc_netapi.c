@@ -18,6 +18,7 @@
  * @}
  */
 
+#include "bitfield.h"
 #include "mbox.h"
 #include "msg.h"
 #include "net/gnrc/netreg.h"
@@ -27,6 +28,12 @@
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+#ifdef MODULE_GNRC_NETAPI_BATCH
+/* threads handling GNRC_NETAPI_MSG_TYPE_{RCV,SND}_BATCH */
+static BITFIELD(_batch_pids, KERNEL_PID_LAST + 1);
+static gnrc_netapi_batch_stats_t _batch_stats[GNRC_NETTYPE_NUMOF];
+#endif
+
 /**
  * @brief   Unified function for getting and setting netapi options
  *
@@ -168,3 +175,117 @@ int gnrc_netapi_set(kernel_pid_t pid, netopt_t opt, uint16_t context,
     return _get_set(pid, GNRC_NETAPI_MSG_TYPE_SET, opt, context,
                     data, data_len);
 }
+
+#ifdef MODULE_GNRC_NETAPI_BATCH
+void gnrc_netapi_batch_register(kernel_pid_t pid)
+{
+    assert(pid_is_valid(pid));
+    bf_set(_batch_pids, pid);
+}
+
+int gnrc_netapi_batch_add(gnrc_netapi_batch_t *batch, gnrc_nettype_t type,
+                          uint32_t demux_ctx, uint16_t cmd,
+                          gnrc_pktsnip_t *pkt)
+{
+    int numof = gnrc_netreg_num(type, demux_ctx);
+
+    if (numof == 0) {
+        return 0;
+    }
+    if ((batch->numof > 0) && ((batch->type != type) ||
+                               (batch->demux_ctx != demux_ctx) ||
+                               (batch->cmd != cmd))) {
+        gnrc_netapi_batch_flush(batch);
+    }
+    pkt->batch_next = NULL;
+    if (batch->numof == 0) {
+        batch->head = pkt;
+        batch->type = type;
+        batch->demux_ctx = demux_ctx;
+        batch->cmd = cmd;
+    }
+    else {
+        batch->tail->batch_next = pkt;
+    }
+    batch->tail = pkt;
+    if (++batch->numof >= GNRC_NETAPI_BATCH_SIZE) {
+        gnrc_netapi_batch_flush(batch);
+    }
+    return numof;
+}
+
+static kernel_pid_t _batch_target(gnrc_netapi_batch_t *batch)
+{
+    gnrc_netreg_entry_t *sendto;
+
+    /* the packets can only be linked once, so only a single subscriber can
+     * get the chain */
+    if ((batch->numof < 2) || (gnrc_netreg_num(batch->type, batch->demux_ctx) != 1)) {
+        return KERNEL_PID_UNDEF;
+    }
+    sendto = gnrc_netreg_lookup(batch->type, batch->demux_ctx);
+#if defined(MODULE_GNRC_NETAPI_MBOX) || defined(MODULE_GNRC_NETAPI_CALLBACKS)
+    if (sendto->type != GNRC_NETREG_TYPE_DEFAULT) {
+        return KERNEL_PID_UNDEF;
+    }
+#endif
+    if (!bf_isset(_batch_pids, sendto->target.pid)) {
+        return KERNEL_PID_UNDEF;
+    }
+    return sendto->target.pid;
+}
+
+void gnrc_netapi_batch_flush(gnrc_netapi_batch_t *batch)
+{
+    gnrc_pktsnip_t *chain = batch->head, *pkt;
+    kernel_pid_t target;
+
+    if (batch->numof == 0) {
+        return;
+    }
+    target = _batch_target(batch);
+    if ((batch->type >= 0) && (batch->type < GNRC_NETTYPE_NUMOF)) {
+        gnrc_netapi_batch_stats_t *stats = &_batch_stats[batch->type];
+
+        stats->batches++;
+        stats->pkts += batch->numof;
+        if (batch->numof > stats->max) {
+            stats->max = batch->numof;
+        }
+        if ((batch->numof > 1) && (target == KERNEL_PID_UNDEF)) {
+            stats->split++;
+        }
+    }
+    if (target != KERNEL_PID_UNDEF) {
+        uint16_t type = (batch->cmd == GNRC_NETAPI_MSG_TYPE_SND) ?
+                        GNRC_NETAPI_MSG_TYPE_SND_BATCH :
+                        GNRC_NETAPI_MSG_TYPE_RCV_BATCH;
+
+        if (_snd_rcv(target, type, chain) < 1) {
+            /* unable to dispatch batch */
+            while ((pkt = gnrc_netapi_batch_pop(&chain))) {
+                gnrc_pktbuf_release(pkt);
+            }
+        }
+    }
+    else {
+        while ((pkt = gnrc_netapi_batch_pop(&chain))) {
+            if (gnrc_netapi_dispatch(batch->type, batch->demux_ctx, batch->cmd,
+                                     pkt) == 0) {
+                /* subscriber vanished since the packet was added */
+                gnrc_pktbuf_release(pkt);
+            }
+        }
+    }
+    batch->head = NULL;
+    batch->tail = NULL;
+    batch->numof = 0;
+}
+
+void gnrc_netapi_batch_get_stats(gnrc_nettype_t type,
+                                 gnrc_netapi_batch_stats_t *stats)
+{
+    assert((type >= 0) && (type < GNRC_NETTYPE_NUMOF));
+    *stats = _batch_stats[type];
+}
+#endif
@@ -36,6 +36,11 @@
 
 #include "net/gnrc/ipv6.h"
 
+#ifdef MODULE_GNRC_IPV6_FWD
+#include "mutex.h"
+#include "xtimer.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -55,6 +60,13 @@ static char _stack[GNRC_IPV6_STACK_SIZE];
  */
 static fib_entry_t _fib_entries[GNRC_IPV6_FIB_TABLE_SIZE];
 
+#ifdef MODULE_FIB_TRIE
+/**
+ * @brief buffer to store the prefix trie index of the IPv6 forwarding table
+ */
+static fib_trie_node_t _fib_trie_nodes[FIB_TRIE_NODES_NUMOF(GNRC_IPV6_FIB_TABLE_SIZE)];
+#endif
+
 /**
  * @brief the IPv6 forwarding table
  */
@@ -73,9 +85,18 @@ static void _receive(gnrc_pktsnip_t *pkt);
  * prep_hdr: prepare header for sending (call to _fill_ipv6_hdr()), otherwise
  * assume it is already prepared */
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr);
+#ifdef MODULE_GNRC_IPV6_ROUTER
+/* Sends a packet prepared by _fwd_prepare() over the appropriate interface */
+static void _forward(gnrc_pktsnip_t *pkt);
+#endif
 /* Main event loop for IPv6 */
 static void *_event_loop(void *args);
 
+#ifdef MODULE_GNRC_NETAPI_BATCH
+/* received packets waiting to be handed to the upper layers */
+static gnrc_netapi_batch_t _batch;
+#endif
+
 /* Handles encapsulated IPv6 packets: http://tools.ietf.org/html/rfc2473 */
 static void _decapsulate(gnrc_pktsnip_t *pkt);
 
@@ -91,6 +112,9 @@ kernel_pid_t gnrc_ipv6_init(void)
     gnrc_ipv6_fib_table.data.entries = _fib_entries;
     gnrc_ipv6_fib_table.table_type = FIB_TABLE_TYPE_SH;
     gnrc_ipv6_fib_table.size = GNRC_IPV6_FIB_TABLE_SIZE;
+#ifdef MODULE_FIB_TRIE
+    gnrc_ipv6_fib_table.trie.nodes = _fib_trie_nodes;
+#endif
     fib_init(&gnrc_ipv6_fib_table);
 #endif
 
@@ -229,9 +253,16 @@ static void _dispatch_next_header(gnrc_pktsnip_t *current, gnrc_pktsnip_t *pkt,
             gnrc_pktbuf_hold(pkt, 1);   /* don't remove from packet buffer in
                                          * next dispatch */
         }
+#ifdef MODULE_GNRC_NETAPI_BATCH
+        /* only the primary dispatch is batched: a packet can only be in one
+         * batch at a time */
+        if (gnrc_netapi_batch_add(&_batch, current->type, GNRC_NETREG_DEMUX_CTX_ALL,
+                                  GNRC_NETAPI_MSG_TYPE_RCV, pkt) == 0) {
+#else
         if (gnrc_netapi_dispatch_receive(current->type,
                                          GNRC_NETREG_DEMUX_CTX_ALL,
                                          pkt) == 0) {
+#endif
             gnrc_pktbuf_release(pkt);
         }
 
@@ -259,6 +290,9 @@ static void *_event_loop(void *args)
 
     /* register interest in all IPv6 packets */
     gnrc_netreg_register(GNRC_NETTYPE_IPV6, &me_reg);
+#ifdef MODULE_GNRC_NETAPI_BATCH
+    gnrc_netapi_batch_register(sched_active_pid);
+#endif
 
     /* preinitialize ACK */
     reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
@@ -279,6 +313,32 @@ static void *_event_loop(void *args)
                 _send(msg.content.ptr, true);
                 break;
 
+#ifdef MODULE_GNRC_NETAPI_BATCH
+            case GNRC_NETAPI_MSG_TYPE_RCV_BATCH:
+            case GNRC_NETAPI_MSG_TYPE_SND_BATCH: {
+                gnrc_pktsnip_t *chain = msg.content.ptr, *pkt;
+
+                DEBUG("ipv6: GNRC_NETAPI_MSG_TYPE_%s_BATCH received\n",
+                      (msg.type == GNRC_NETAPI_MSG_TYPE_RCV_BATCH) ? "RCV" : "SND");
+                while ((pkt = gnrc_netapi_batch_pop(&chain))) {
+                    if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV_BATCH) {
+                        _receive(pkt);
+                    }
+                    else {
+                        _send(pkt, true);
+                    }
+                }
+                break;
+            }
+#endif
+
+#ifdef MODULE_GNRC_IPV6_FWD
+            case GNRC_IPV6_FWD_MSG_SLOW_PATH:
+                DEBUG("ipv6: GNRC_IPV6_FWD_MSG_SLOW_PATH received\n");
+                _forward(msg.content.ptr);
+                break;
+#endif
+
             case GNRC_NETAPI_MSG_TYPE_GET:
             case GNRC_NETAPI_MSG_TYPE_SET:
                 DEBUG("ipv6: reply to unsupported get/set\n");
@@ -364,11 +424,39 @@ static void *_event_loop(void *args)
             default:
                 break;
         }
+#ifdef MODULE_GNRC_NETAPI_BATCH
+        /* hand everything received so far to the upper layers once the queue
+         * is drained */
+        if (msg_avail() == 0) {
+            gnrc_netapi_batch_flush(&_batch);
+        }
+#endif
     }
 
     return NULL;
 }
 
+#ifdef MODULE_NETSTATS_IPV6
+#ifdef MODULE_GNRC_IPV6_FWD
+/* the forwarding workers send, too */
+static mutex_t _tx_stats_lock = MUTEX_INIT;
+#endif
+
+static inline void _tx_stats_begin(void)
+{
+#ifdef MODULE_GNRC_IPV6_FWD
+    mutex_lock(&_tx_stats_lock);
+#endif
+}
+
+static inline void _tx_stats_end(void)
+{
+#ifdef MODULE_GNRC_IPV6_FWD
+    mutex_unlock(&_tx_stats_lock);
+#endif
+}
+#endif
+
 static void _send_to_iface(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
 {
     ((gnrc_netif_hdr_t *)pkt->data)->if_pid = iface;
@@ -381,8 +469,10 @@ static void _send_to_iface(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
         return;
     }
 #ifdef MODULE_NETSTATS_IPV6
+    _tx_stats_begin();
     if_entry->stats.tx_success++;
     if_entry->stats.tx_bytes += gnrc_pkt_len(pkt->next);
+    _tx_stats_end();
 #endif
 
 #ifdef MODULE_GNRC_SIXLOWPAN
@@ -445,7 +535,9 @@ static void _send_unicast(kernel_pid_t iface, uint8_t *dst_l2addr,
     DEBUG("ipv6: send unicast over interface %" PRIkernel_pid "\n", iface);
     /* and send to interface */
 #ifdef MODULE_NETSTATS_IPV6
+    _tx_stats_begin();
     gnrc_ipv6_netif_get_stats(iface)->tx_unicast_count++;
+    _tx_stats_end();
 #endif
     _send_to_iface(iface, pkt);
 }
@@ -515,7 +607,9 @@ static inline void _send_multicast_over_iface(kernel_pid_t iface, gnrc_pktsnip_t
     /* mark as multicast */
     ((gnrc_netif_hdr_t *)pkt->data)->flags |= GNRC_NETIF_HDR_FLAGS_MULTICAST;
 #ifdef MODULE_NETSTATS_IPV6
+    _tx_stats_begin();
     gnrc_ipv6_netif_get_stats(iface)->tx_mcast_count++;
+    _tx_stats_end();
 #endif
     /* and send to interface */
     _send_to_iface(iface, pkt);
@@ -654,6 +748,274 @@ static inline kernel_pid_t _next_hop_l2addr(uint8_t *l2addr, uint8_t *l2addr_len
     return found_iface;
 }
 
+#ifdef MODULE_GNRC_IPV6_ROUTER
+/* reverses a received packet into sending order and gets write access to all
+ * its snips */
+static gnrc_pktsnip_t *_reverse_snips(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *reversed_pkt = NULL, *ptr = pkt;
+
+    while (ptr != NULL) {
+        gnrc_pktsnip_t *next;
+        ptr = gnrc_pktbuf_start_write(ptr);     /* duplicate if not already done */
+        if (ptr == NULL) {
+            DEBUG("ipv6: unable to get write access to packet: dropping it\n");
+            gnrc_pktbuf_release(reversed_pkt);
+            gnrc_pktbuf_release(pkt);
+            return NULL;
+        }
+        next = ptr->next;
+        ptr->next = reversed_pkt;
+        reversed_pkt = ptr;
+        ptr = next;
+    }
+    return reversed_pkt;
+}
+
+/* Checks if a received packet that is not for this host may be forwarded,
+ * decrements its hop limit and removes its interface header. Returns NULL if
+ * the packet was dropped. */
+static gnrc_pktsnip_t *_fwd_prepare(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *ipv6)
+{
+    ipv6_hdr_t *hdr = ipv6->data;
+    gnrc_pktsnip_t *netif;
+
+    DEBUG("ipv6: decrement hop limit to %u\n", (uint8_t) (hdr->hl - 1));
+
+    /* RFC 4291, section 2.5.6 states: "Routers must not forward any
+     * packets with Link-Local source or destination addresses to other
+     * links."
+     */
+    if ((ipv6_addr_is_link_local(&(hdr->src))) || (ipv6_addr_is_link_local(&(hdr->dst)))) {
+        DEBUG("ipv6: do not forward packets with link-local source or"
+              " destination address\n");
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+    /* TODO: check if receiving interface is router */
+    if (--(hdr->hl) == 0) {  /* drop packets that *reach* Hop Limit 0 */
+        DEBUG("ipv6: hop limit reached 0: drop packet\n");
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+
+    DEBUG("ipv6: forward packet to next hop\n");
+
+    /* pkt might not be writable yet, if header was given above */
+    ipv6 = gnrc_pktbuf_start_write(ipv6);
+    if (ipv6 == NULL) {
+        DEBUG("ipv6: unable to get write access to packet: dropping it\n");
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+
+    /* remove L2 headers around IPV6 */
+    netif = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    if (netif != NULL) {
+        gnrc_pktbuf_remove_snip(pkt, netif);
+    }
+    return pkt;
+}
+#endif
+
+#ifdef MODULE_GNRC_IPV6_FWD
+#if (GNRC_IPV6_FWD_FLOW_NUMOF & (GNRC_IPV6_FWD_FLOW_NUMOF - 1))
+#error "GNRC_IPV6_FWD_FLOW_NUMOF must be a power of 2"
+#endif
+
+/* next hop of a destination as determined by _next_hop_l2addr() */
+typedef struct {
+    ipv6_addr_t dst;
+    uint32_t time;              /* time of the lookup in us */
+    unsigned gen;               /* _fwd_gen() before the lookup */
+    kernel_pid_t iface;         /* KERNEL_PID_UNDEF for unused entries */
+    uint8_t l2addr_len;
+    uint8_t l2addr[GNRC_IPV6_NC_L2_ADDR_MAX];
+} _fwd_flow_t;
+
+typedef struct {
+    kernel_pid_t iface;         /* receiving interface served by the worker */
+    kernel_pid_t pid;
+} _fwd_worker_t;
+
+static _fwd_flow_t _fwd_flows[GNRC_IPV6_FWD_FLOW_NUMOF];
+/* flows are set by the control thread and read by the workers */
+static mutex_t _fwd_flows_lock = MUTEX_INIT;
+static _fwd_worker_t _fwd_workers[GNRC_IPV6_FWD_WORKER_NUMOF];
+#if ENABLE_DEBUG
+static char _fwd_stacks[GNRC_IPV6_FWD_WORKER_NUMOF][GNRC_IPV6_FWD_STACK_SIZE +
+                                                   THREAD_EXTRA_STACKSIZE_PRINTF];
+#else
+static char _fwd_stacks[GNRC_IPV6_FWD_WORKER_NUMOF][GNRC_IPV6_FWD_STACK_SIZE];
+#endif
+static volatile unsigned _fwd_nc_gen;
+
+void gnrc_ipv6_fwd_invalidate(void)
+{
+    _fwd_nc_gen++;
+}
+
+/* both counters only grow, so their sum changes with any of them */
+static inline unsigned _fwd_gen(void)
+{
+#ifdef MODULE_FIB
+    return _fwd_nc_gen + gnrc_ipv6_fib_table.version;
+#else
+    return _fwd_nc_gen;
+#endif
+}
+
+static inline _fwd_flow_t *_fwd_flow(const ipv6_addr_t *dst)
+{
+    uint32_t hash = dst->u32[0].u32 ^ dst->u32[1].u32 ^ dst->u32[2].u32 ^
+                    dst->u32[3].u32;
+
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return &_fwd_flows[hash & (GNRC_IPV6_FWD_FLOW_NUMOF - 1)];
+}
+
+static bool _fwd_flow_valid(const _fwd_flow_t *flow, const ipv6_addr_t *dst)
+{
+    return (flow->iface != KERNEL_PID_UNDEF) && (flow->gen == _fwd_gen()) &&
+           ((xtimer_now_usec() - flow->time) < GNRC_IPV6_FWD_FLOW_LIFETIME) &&
+           ipv6_addr_equal(&flow->dst, dst);
+}
+
+static void _fwd_flow_set(unsigned gen, const ipv6_addr_t *dst, kernel_pid_t iface,
+                          const uint8_t *l2addr, uint8_t l2addr_len)
+{
+    _fwd_flow_t *flow = _fwd_flow(dst);
+
+    mutex_lock(&_fwd_flows_lock);
+    memcpy(&flow->dst, dst, sizeof(ipv6_addr_t));
+    flow->time = xtimer_now_usec();
+    flow->gen = gen;
+    flow->iface = iface;
+    flow->l2addr_len = l2addr_len;
+    memcpy(flow->l2addr, l2addr, l2addr_len);
+    mutex_unlock(&_fwd_flows_lock);
+}
+
+/* Copies the cached next hop of dst. Returns KERNEL_PID_UNDEF if there is
+ * none. */
+static kernel_pid_t _fwd_flow_get(const ipv6_addr_t *dst, uint8_t *l2addr,
+                                  uint8_t *l2addr_len)
+{
+    _fwd_flow_t *flow = _fwd_flow(dst);
+    kernel_pid_t iface = KERNEL_PID_UNDEF;
+
+    mutex_lock(&_fwd_flows_lock);
+    if (_fwd_flow_valid(flow, dst)) {
+        iface = flow->iface;
+        *l2addr_len = flow->l2addr_len;
+        memcpy(l2addr, flow->l2addr, flow->l2addr_len);
+    }
+    mutex_unlock(&_fwd_flows_lock);
+    return iface;
+}
+
+/* Sends a packet prepared by _fwd_prepare() to its cached next hop. Returns
+ * false if the next hop is not cached and the packet needs to take the slow
+ * path. */
+static bool _fwd_fast_path(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+    uint8_t l2addr_len = 0, l2addr[GNRC_IPV6_NC_L2_ADDR_MAX];
+    kernel_pid_t iface = _fwd_flow_get(&((ipv6_hdr_t *)ipv6->data)->dst,
+                                       l2addr, &l2addr_len);
+
+    if (iface == KERNEL_PID_UNDEF) {
+        return false;
+    }
+    if ((pkt = _reverse_snips(pkt)) != NULL) {
+        _send_unicast(iface, l2addr, l2addr_len, pkt);
+    }
+    return true;
+}
+
+static void *_fwd_worker(void *args)
+{
+    msg_t msg, msg_q[GNRC_IPV6_FWD_MSG_QUEUE_SIZE];
+
+    (void)args;
+    msg_init_queue(msg_q, GNRC_IPV6_FWD_MSG_QUEUE_SIZE);
+
+    while (1) {
+        gnrc_pktsnip_t *pkt;
+
+        msg_receive(&msg);
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        pkt = msg.content.ptr;
+        pkt = _fwd_prepare(pkt, gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6));
+        if ((pkt == NULL) || _fwd_fast_path(pkt)) {
+            continue;
+        }
+        /* neighbor discovery and address resolution stay on the control
+         * thread */
+        msg.type = GNRC_IPV6_FWD_MSG_SLOW_PATH;
+        msg.content.ptr = pkt;
+        if (msg_try_send(&msg, gnrc_ipv6_pid) < 1) {
+            DEBUG("ipv6: queue of control thread full, dropping packet\n");
+            gnrc_pktbuf_release(pkt);
+        }
+    }
+
+    return NULL;
+}
+
+static kernel_pid_t _fwd_worker_get(kernel_pid_t iface)
+{
+    for (unsigned i = 0; i < GNRC_IPV6_FWD_WORKER_NUMOF; i++) {
+        if (_fwd_workers[i].iface == iface) {
+            return _fwd_workers[i].pid;
+        }
+        if (_fwd_workers[i].iface == KERNEL_PID_UNDEF) {
+            /* interfaces may come up after IPv6, so workers are started on
+             * demand. The worker preempts us and waits for messages before
+             * thread_create() returns. */
+            kernel_pid_t pid = thread_create(_fwd_stacks[i], sizeof(_fwd_stacks[i]),
+                                             GNRC_IPV6_FWD_PRIO,
+                                             THREAD_CREATE_STACKTEST,
+                                             _fwd_worker, NULL, "ipv6_fwd");
+
+            if (pid <= KERNEL_PID_UNDEF) {
+                DEBUG("ipv6: unable to start forwarding worker\n");
+                return KERNEL_PID_UNDEF;
+            }
+            _fwd_workers[i].iface = iface;
+            _fwd_workers[i].pid = pid;
+            return pid;
+        }
+    }
+    return KERNEL_PID_UNDEF;
+}
+
+/* Hands a packet that is not for this host (in receive order) to the worker of
+ * the interface it was received on. Returns false if there is no worker for
+ * it and the packet needs to be forwarded by the control thread. */
+static bool _fwd_dispatch(kernel_pid_t iface, gnrc_pktsnip_t *pkt)
+{
+    kernel_pid_t worker;
+    msg_t msg;
+
+    if ((iface == KERNEL_PID_UNDEF) ||
+        ((worker = _fwd_worker_get(iface)) == KERNEL_PID_UNDEF)) {
+        return false;
+    }
+    msg.type = GNRC_NETAPI_MSG_TYPE_RCV;
+    msg.content.ptr = pkt;
+    if (msg_try_send(&msg, worker) < 1) {
+        DEBUG("ipv6: forwarding queue of interface %" PRIkernel_pid " full, "
+              "dropping packet\n", iface);
+        gnrc_pktbuf_release(pkt);
+    }
+    return true;
+}
+#endif /* MODULE_GNRC_IPV6_FWD */
+
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
 {
     kernel_pid_t iface = KERNEL_PID_UNDEF;
@@ -746,6 +1108,11 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
     else {
         uint8_t l2addr_len = GNRC_IPV6_NC_L2_ADDR_MAX;
         uint8_t l2addr[l2addr_len];
+#ifdef MODULE_GNRC_IPV6_FWD
+        /* only cache lookups that were not restricted to an interface */
+        bool cache = (iface == KERNEL_PID_UNDEF);
+        unsigned gen = _fwd_gen();
+#endif
 
         iface = _next_hop_l2addr(l2addr, &l2addr_len, iface, &hdr->dst, pkt);
 
@@ -754,6 +1121,11 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
             gnrc_pktbuf_release(pkt);
             return;
         }
+#ifdef MODULE_GNRC_IPV6_FWD
+        if (cache) {
+            _fwd_flow_set(gen, &hdr->dst, iface, l2addr, l2addr_len);
+        }
+#endif
 
         if (prep_hdr) {
             if (_fill_ipv6_hdr(iface, ipv6, payload) < 0) {
@@ -767,6 +1139,16 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
     }
 }
 
+#ifdef MODULE_GNRC_IPV6_ROUTER
+static void _forward(gnrc_pktsnip_t *pkt)
+{
+    /* reverse packet snip list order */
+    if ((pkt = _reverse_snips(pkt)) != NULL) {
+        _send(pkt, false);
+    }
+}
+#endif
+
 /* functions for receiving */
 static inline bool _pkt_not_for_me(kernel_pid_t *iface, ipv6_hdr_t *hdr)
 {
@@ -906,61 +1288,15 @@ static void _receive(gnrc_pktsnip_t *pkt)
 
 #ifdef MODULE_GNRC_IPV6_ROUTER    /* only routers redirect */
         /* redirect to next hop */
-        DEBUG("ipv6: decrement hop limit to %u\n", (uint8_t) (hdr->hl - 1));
-
-        /* RFC 4291, section 2.5.6 states: "Routers must not forward any
-         * packets with Link-Local source or destination addresses to other
-         * links."
-         */
-        if ((ipv6_addr_is_link_local(&(hdr->src))) || (ipv6_addr_is_link_local(&(hdr->dst)))) {
-            DEBUG("ipv6: do not forward packets with link-local source or"
-                  " destination address\n");
-            gnrc_pktbuf_release(pkt);
-            return;
-        }
-        /* TODO: check if receiving interface is router */
-        else if (--(hdr->hl) > 0) {  /* drop packets that *reach* Hop Limit 0 */
-            gnrc_pktsnip_t *reversed_pkt = NULL, *ptr = pkt;
-
-            DEBUG("ipv6: forward packet to next hop\n");
-
-            /* pkt might not be writable yet, if header was given above */
-            ipv6 = gnrc_pktbuf_start_write(ipv6);
-            if (ipv6 == NULL) {
-                DEBUG("ipv6: unable to get write access to packet: dropping it\n");
-                gnrc_pktbuf_release(pkt);
-                return;
-            }
-
-            /* remove L2 headers around IPV6 */
-            netif = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
-            if (netif != NULL) {
-                gnrc_pktbuf_remove_snip(pkt, netif);
-            }
-
-            /* reverse packet snip list order */
-            while (ptr != NULL) {
-                gnrc_pktsnip_t *next;
-                ptr = gnrc_pktbuf_start_write(ptr);     /* duplicate if not already done */
-                if (ptr == NULL) {
-                    DEBUG("ipv6: unable to get write access to packet: dropping it\n");
-                    gnrc_pktbuf_release(reversed_pkt);
-                    gnrc_pktbuf_release(pkt);
-                    return;
-                }
-                next = ptr->next;
-                ptr->next = reversed_pkt;
-                reversed_pkt = ptr;
-                ptr = next;
-            }
-            _send(reversed_pkt, false);
+#ifdef MODULE_GNRC_IPV6_FWD
+        if (_fwd_dispatch(iface, pkt)) {
             return;
         }
-        else {
-            DEBUG("ipv6: hop limit reached 0: drop packet\n");
-            gnrc_pktbuf_release(pkt);
-            return;
+#endif
+        if ((pkt = _fwd_prepare(pkt, ipv6)) != NULL) {
+            _forward(pkt);
         }
+        return;
 
 #else  /* MODULE_GNRC_IPV6_ROUTER */
         DEBUG("ipv6: dropping packet\n");
@@ -15,6 +15,7 @@
 #include <errno.h>
 #include <string.h>
 
+#include "bitfield.h"
 #include "net/gnrc/ipv6.h"
 #include "net/ipv6/addr.h"
 #include "net/gnrc/ipv6/nc.h"
@@ -37,6 +38,77 @@ static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
 static gnrc_ipv6_nc_t ncache[GNRC_IPV6_NC_SIZE];
 
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+#if (GNRC_IPV6_NC_HASH_SIZE <= GNRC_IPV6_NC_SIZE) || (GNRC_IPV6_NC_SIZE >= 65535)
+#error "GNRC_IPV6_NC_HASH_SIZE must be larger than GNRC_IPV6_NC_SIZE"
+#endif
+
+/* open-addressing index with linear probing: position in ncache + 1 per slot,
+ * 0 for empty slots. Since gnrc_ipv6_nc_add() keeps IPv6 addresses unique
+ * over all interfaces, the address alone is the key. */
+static uint16_t _index[GNRC_IPV6_NC_HASH_SIZE];
+/* allocated entries of ncache */
+static uint8_t _used[(GNRC_IPV6_NC_SIZE + 7) / 8];
+
+static inline unsigned _hash(const ipv6_addr_t *addr)
+{
+    uint32_t hash = addr->u32[0].u32 ^ addr->u32[1].u32 ^ addr->u32[2].u32 ^
+                    addr->u32[3].u32;
+
+    /* mix all bits into the lower ones used by the modulo */
+    hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+    hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+    return ((hash >> 16) ^ hash) % GNRC_IPV6_NC_HASH_SIZE;
+}
+
+static inline unsigned _next_slot(unsigned slot)
+{
+    return (slot + 1 < GNRC_IPV6_NC_HASH_SIZE) ? (slot + 1) : 0;
+}
+
+/* returns the slot of ipv6_addr or the empty slot it would go to */
+static unsigned _index_slot(const ipv6_addr_t *ipv6_addr)
+{
+    unsigned slot = _hash(ipv6_addr);
+
+    while ((_index[slot] != 0) &&
+           !ipv6_addr_equal(&ncache[_index[slot] - 1].ipv6_addr, ipv6_addr)) {
+        slot = _next_slot(slot);
+    }
+    return slot;
+}
+
+static void _index_add(gnrc_ipv6_nc_t *entry)
+{
+    _index[_index_slot(&entry->ipv6_addr)] = (entry - ncache) + 1;
+}
+
+/* must be called while entry->ipv6_addr is still set */
+static void _index_remove(gnrc_ipv6_nc_t *entry)
+{
+    unsigned gap = _index_slot(&entry->ipv6_addr), slot = gap;
+
+    if (_index[gap] == 0) {
+        return;
+    }
+    _index[gap] = 0;
+    /* move up following entries of the probe sequence, so lookups never stop
+     * at the gap before reaching them (backward shift deletion) */
+    while (_index[slot = _next_slot(slot)] != 0) {
+        unsigned home = _hash(&ncache[_index[slot] - 1].ipv6_addr);
+
+        /* entry can stay if its home slot lies cyclically in (gap, slot] */
+        if ((gap < slot) ? ((gap < home) && (home <= slot))
+                         : ((gap < home) || (home <= slot))) {
+            continue;
+        }
+        _index[gap] = _index[slot];
+        _index[slot] = 0;
+        gap = slot;
+    }
+}
+#endif
+
 static void _nc_remove(kernel_pid_t iface, gnrc_ipv6_nc_t *entry)
 {
     (void) iface;
@@ -73,9 +145,18 @@ static void _nc_remove(kernel_pid_t iface, gnrc_ipv6_nc_t *entry)
     xtimer_remove(&entry->nbr_sol_timer);
     xtimer_remove(&entry->nbr_adv_timer);
 
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    if (!ipv6_addr_is_unspecified(&(entry->ipv6_addr))) {
+        _index_remove(entry);
+    }
+    bf_unset(_used, entry - ncache);
+#endif
     ipv6_addr_set_unspecified(&(entry->ipv6_addr));
     entry->iface = KERNEL_PID_UNDEF;
     entry->flags = 0;
+#ifdef MODULE_GNRC_IPV6_FWD
+    gnrc_ipv6_fwd_invalidate();
+#endif
 }
 
 void gnrc_ipv6_nc_init(void)
@@ -86,10 +167,20 @@ void gnrc_ipv6_nc_init(void)
         _nc_remove(entry->iface, entry);
     }
     memset(ncache, 0, sizeof(ncache));
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    memset(_index, 0, sizeof(_index));
+    memset(_used, 0, sizeof(_used));
+#endif
 }
 
+/* with gnrc_ipv6_nc_hash the returned entry is marked as allocated */
 gnrc_ipv6_nc_t *_find_free_entry(void)
 {
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    int pos = bf_get_unset(_used, GNRC_IPV6_NC_SIZE);
+
+    return (pos < 0) ? NULL : (ncache + pos);
+#else
     for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
         if (ipv6_addr_is_unspecified(&(ncache[i].ipv6_addr))) {
             return ncache + i;
@@ -97,12 +188,38 @@ gnrc_ipv6_nc_t *_find_free_entry(void)
     }
 
     return NULL;
+#endif
+}
+
+static gnrc_ipv6_nc_t *_nc_update(gnrc_ipv6_nc_t *entry, const void *l2_addr,
+                                  size_t l2_addr_len, uint8_t flags)
+{
+    DEBUG("ipv6_nc: Address %s already registered.\n",
+          ipv6_addr_to_str(addr_str, &entry->ipv6_addr, sizeof(addr_str)));
+
+    if ((l2_addr != NULL) && (l2_addr_len > 0)) {
+        DEBUG("ipv6_nc: Update to L2 address %s",
+              gnrc_netif_addr_to_str(addr_str, sizeof(addr_str),
+                                     l2_addr, l2_addr_len));
+
+        memcpy(&(entry->l2_addr), l2_addr, l2_addr_len);
+        entry->l2_addr_len = l2_addr_len;
+        entry->flags = flags;
+        DEBUG(" with flags = 0x%0x\n", flags);
+#ifdef MODULE_GNRC_IPV6_FWD
+        gnrc_ipv6_fwd_invalidate();
+#endif
+    }
+    return entry;
 }
 
 gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr,
                                  const void *l2_addr, size_t l2_addr_len, uint8_t flags)
 {
     gnrc_ipv6_nc_t *free_entry = NULL;
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    unsigned slot;
+#endif
 
     if (ipv6_addr == NULL) {
         DEBUG("ipv6_nc: address was NULL\n");
@@ -114,23 +231,16 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
         return NULL;
     }
 
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    slot = _index_slot(ipv6_addr);
+    if (_index[slot] != 0) {
+        return _nc_update(&ncache[_index[slot] - 1], l2_addr, l2_addr_len, flags);
+    }
+    free_entry = _find_free_entry();
+#else
     for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
         if (ipv6_addr_equal(&(ncache[i].ipv6_addr), ipv6_addr)) {
-            DEBUG("ipv6_nc: Address %s already registered.\n",
-                  ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)));
-
-            if ((l2_addr != NULL) && (l2_addr_len > 0)) {
-                DEBUG("ipv6_nc: Update to L2 address %s",
-                      gnrc_netif_addr_to_str(addr_str, sizeof(addr_str),
-                                             l2_addr, l2_addr_len));
-
-                memcpy(&(ncache[i].l2_addr), l2_addr, l2_addr_len);
-                ncache[i].l2_addr_len = l2_addr_len;
-                ncache[i].flags = flags;
-                DEBUG(" with flags = 0x%0x\n", flags);
-
-            }
-            return &ncache[i];
+            return _nc_update(&ncache[i], l2_addr, l2_addr_len, flags);
         }
 
         if (ipv6_addr_is_unspecified(&(ncache[i].ipv6_addr)) && !free_entry) {
@@ -138,6 +248,7 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
             free_entry = &ncache[i];
         }
     }
+#endif
 
     if (!free_entry) {
         /* reached end of NC without finding updateable or free entry */
@@ -152,6 +263,9 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
     free_entry->pkts = NULL;
 #endif
     memcpy(&(free_entry->ipv6_addr), ipv6_addr, sizeof(ipv6_addr_t));
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    _index[slot] = (free_entry - ncache) + 1;
+#endif
     DEBUG("ipv6_nc: Register %s for interface %" PRIkernel_pid,
           ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
           iface);
@@ -187,6 +301,9 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_add(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
 #endif
 
     free_entry->nbr_sol_msg.content.ptr = free_entry;
+#ifdef MODULE_GNRC_IPV6_FWD
+    gnrc_ipv6_fwd_invalidate();
+#endif
 
     return free_entry;
 }
@@ -204,6 +321,23 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_get(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
         return NULL;
     }
 
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    unsigned slot = _index_slot(ipv6_addr);
+
+    if (_index[slot] != 0) {
+        gnrc_ipv6_nc_t *entry = &ncache[_index[slot] - 1];
+
+        if ((entry->iface == KERNEL_PID_UNDEF) || (iface == KERNEL_PID_UNDEF) ||
+            (iface == entry->iface)) {
+            DEBUG("ipv6_nc: Found entry for %s on interface %" PRIkernel_pid
+                  " (0 = all interfaces) [%p]\n",
+                  ipv6_addr_to_str(addr_str, ipv6_addr, sizeof(addr_str)),
+                  iface, (void *)entry);
+
+            return entry;
+        }
+    }
+#else
     for (int i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
         if (((ncache[i].iface == KERNEL_PID_UNDEF) || (iface == KERNEL_PID_UNDEF) ||
              (iface == ncache[i].iface)) &&
@@ -216,6 +350,7 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_get(kernel_pid_t iface, const ipv6_addr_t *ipv6_add
             return ncache + i;
         }
     }
+#endif
 
     return NULL;
 }
@@ -33,6 +33,9 @@
 #include "net/gnrc/sixlowpan/netif.h"
 
 #include "net/gnrc/ipv6/netif.h"
+#ifdef MODULE_GNRC_IPV6_FWD
+#include "net/gnrc/ipv6.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -86,6 +89,10 @@ static ipv6_addr_t *_add_addr_to_entry(gnrc_ipv6_netif_t *entry, const ipv6_addr
 
     tmp_addr->prefix_len = prefix_len;
     tmp_addr->flags = flags;
+#ifdef MODULE_GNRC_IPV6_FWD
+    /* on-link prefixes might have changed */
+    gnrc_ipv6_fwd_invalidate();
+#endif
 
 #ifdef MODULE_GNRC_SIXLOWPAN_ND
     if (!ipv6_addr_is_multicast(&(tmp_addr->addr)) &&
@@ -322,6 +329,9 @@ static void _remove_addr_from_entry(gnrc_ipv6_netif_t *entry, ipv6_addr_t *addr)
                   ipv6_addr_to_str(addr_str, addr, sizeof(addr_str)), entry->pid);
             ipv6_addr_set_unspecified(&(entry->addrs[i].addr));
             entry->addrs[i].flags = 0;
+#ifdef MODULE_GNRC_IPV6_FWD
+            gnrc_ipv6_fwd_invalidate();
+#endif
 #ifdef MODULE_GNRC_NDP_ROUTER
             /* Removal of prefixes MAY allow the router to retransmit up to
              * GNRC_NDP_MAX_INIT_RTR_ADV_NUMOF unsolicited RA
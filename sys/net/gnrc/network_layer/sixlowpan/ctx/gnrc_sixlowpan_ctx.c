@@ -25,6 +25,7 @@
 static gnrc_sixlowpan_ctx_t _ctxs[GNRC_SIXLOWPAN_CTX_SIZE];
 static uint32_t _ctx_inval_times[GNRC_SIXLOWPAN_CTX_SIZE];
 static mutex_t _ctx_mutex = MUTEX_INIT;
+static unsigned _ctx_version;
 
 static uint32_t _current_minute(void);
 static void _update_lifetime(uint8_t id);
@@ -126,11 +127,29 @@ gnrc_sixlowpan_ctx_t *gnrc_sixlowpan_ctx_update(uint8_t id, const ipv6_addr_t *p
           id, ipv6_addr_to_str(ipv6str, &_ctxs[id].prefix, sizeof(ipv6str)),
           _ctxs[id].prefix_len, _ctxs[id].ltime);
     _ctx_inval_times[id] = ltime + _current_minute();
+    _ctx_version++;
 
     mutex_unlock(&_ctx_mutex);
     return &(_ctxs[id]);
 }
 
+void gnrc_sixlowpan_ctx_remove(uint8_t id)
+{
+    if (id >= GNRC_SIXLOWPAN_CTX_SIZE) {
+        return;
+    }
+
+    mutex_lock(&_ctx_mutex);
+    _ctxs[id].prefix_len = 0;
+    _ctx_version++;
+    mutex_unlock(&_ctx_mutex);
+}
+
+unsigned gnrc_sixlowpan_ctx_version(void)
+{
+    return _ctx_version;
+}
+
 static uint32_t _current_minute(void)
 {
     return xtimer_now_usec() / (US_PER_SEC * 60);
@@ -163,6 +182,7 @@ static void _update_lifetime(uint8_t id)
 void gnrc_sixlowpan_ctx_reset(void)
 {
     memset(_ctxs, 0, sizeof(_ctxs));
+    _ctx_version++;
 }
 #endif
 
@@ -311,4 +311,14 @@ void gnrc_sixlowpan_frag_handle_pkt(gnrc_pktsnip_t *pkt)
     gnrc_pktbuf_release(pkt);
 }
 
+void gnrc_sixlowpan_frag_gc_rbuf(void *entry)
+{
+    rbuf_timeout(entry);
+}
+
+void gnrc_sixlowpan_frag_rbuf_get_stats(gnrc_sixlowpan_frag_rbuf_stats_t *stats)
+{
+    rbuf_get_stats(stats);
+}
+
 /** @} */
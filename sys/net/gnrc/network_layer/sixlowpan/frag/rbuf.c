@@ -42,10 +42,27 @@
 #define RBUF_INT_SIZE (DIV_CEIL(GNRC_IPV6_NETIF_DEFAULT_MTU, GNRC_SIXLOWPAN_FRAG_SIZE) * RBUF_SIZE)
 #endif
 
+#if RBUF_HASH_SIZE == 0
+#error "RBUF_HASH_SIZE must not be 0"
+#endif
+
 static rbuf_int_t rbuf_int[RBUF_INT_SIZE];
 
 static rbuf_t rbuf[RBUF_SIZE];
 
+/* entries by hash of (src, dst, size, tag) */
+static rbuf_t *_buckets[RBUF_HASH_SIZE];
+/* entries in use, least recently updated first */
+static rbuf_t *_lru;
+/* entries and intervals that were released after use. Those that were never
+ * used yet are handed out by index, so no initialization is needed */
+static rbuf_t *_free;
+static rbuf_int_t *_free_ints;
+static unsigned _rbuf_fresh;
+static unsigned _rbuf_int_fresh;
+
+static gnrc_sixlowpan_frag_rbuf_stats_t _stats;
+
 #if ENABLE_DEBUG
 static char l2addr_str[3 * RBUF_L2ADDR_MAX_LEN];
 #endif
@@ -61,8 +78,10 @@ static rbuf_int_t *_rbuf_int_get_free(void);
 static void _rbuf_rem(rbuf_t *entry);
 /* update interval buffer of entry */
 static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size);
-/* checks timeouts and removes entries if necessary (oldest if full) */
-static void _rbuf_gc(void);
+/* removes an entry that did not receive a fragment for RBUF_TIMEOUT */
+static void _rbuf_time_out(rbuf_t *entry);
+/* removes entries that timed out but whose timer message got lost */
+static void _rbuf_gc(uint32_t now_usec);
 /* gets an entry identified by its tupel */
 static rbuf_t *_rbuf_get(const void *src, size_t src_len,
                          const void *dst, size_t dst_len,
@@ -80,7 +99,7 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
     rbuf_int_t *ptr;
     uint8_t *data = ((uint8_t *)pkt->data) + sizeof(sixlowpan_frag_t);
 
-    _rbuf_gc();
+    _rbuf_gc(xtimer_now_usec());
     entry = _rbuf_get(gnrc_netif_hdr_get_src_addr(netif_hdr), netif_hdr->src_l2addr_len,
                       gnrc_netif_hdr_get_dst_addr(netif_hdr), netif_hdr->dst_l2addr_len,
                       byteorder_ntohs(frag->disp_size) & SIXLOWPAN_FRAG_SIZE_MASK,
@@ -178,6 +197,7 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         new_netif_hdr->lqi = netif_hdr->lqi;
         new_netif_hdr->rssi = netif_hdr->rssi;
         LL_APPEND(entry->pkt, netif);
+        _stats.completed++;
 
         if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL,
                                           entry->pkt)) {
@@ -196,15 +216,57 @@ static inline bool _rbuf_int_overlap_partially(rbuf_int_t *i, uint16_t start, ui
         ((start != i->start) || (end != i->end)); /* not identical */
 }
 
-static rbuf_int_t *_rbuf_int_get_free(void)
+void rbuf_timeout(rbuf_t *entry)
 {
-    for (unsigned int i = 0; i < RBUF_INT_SIZE; i++) {
-        if (rbuf_int[i].end == 0) { /* start must be smaller than end anyways*/
-            return rbuf_int + i;
-        }
+    uint32_t elapsed;
+
+    if (entry->pkt == NULL) {
+        /* entry was removed after the timer fired */
+        return;
+    }
+    /* a fragment arrival only updates rbuf_t::arrival, the timer is
+     * restarted here for the remaining time */
+    elapsed = xtimer_now_usec() - entry->arrival;
+    if (elapsed < RBUF_TIMEOUT) {
+        xtimer_set_msg(&entry->timer, RBUF_TIMEOUT - elapsed,
+                       &entry->timer_msg, thread_getpid());
+        return;
     }
+    _rbuf_time_out(entry);
+}
 
-    return NULL;
+void rbuf_get_stats(gnrc_sixlowpan_frag_rbuf_stats_t *stats)
+{
+    *stats = _stats;
+}
+
+static unsigned _rbuf_hash(const uint8_t *src, size_t src_len,
+                           const uint8_t *dst, size_t dst_len,
+                           size_t size, uint16_t tag)
+{
+    uint32_t hash = ((uint32_t)tag << 16) | size;
+
+    for (unsigned i = 0; i < src_len; i++) {
+        hash = (hash * 33) ^ src[i];
+    }
+    for (unsigned i = 0; i < dst_len; i++) {
+        hash = (hash * 33) ^ dst[i];
+    }
+    hash ^= hash >> 16;
+    return hash % RBUF_HASH_SIZE;
+}
+
+static rbuf_int_t *_rbuf_int_get_free(void)
+{
+    rbuf_int_t *res = _free_ints;
+
+    if (res != NULL) {
+        _free_ints = res->next;
+    }
+    else if (_rbuf_int_fresh < RBUF_INT_SIZE) {
+        res = &rbuf_int[_rbuf_int_fresh++];
+    }
+    return res;
 }
 
 static void _rbuf_rem(rbuf_t *entry)
@@ -212,13 +274,19 @@ static void _rbuf_rem(rbuf_t *entry)
     while (entry->ints != NULL) {
         rbuf_int_t *next = entry->ints->next;
 
-        entry->ints->start = 0;
-        entry->ints->end = 0;
-        entry->ints->next = NULL;
+        LL_PREPEND(_free_ints, entry->ints);
         entry->ints = next;
     }
 
+    xtimer_remove(&entry->timer);
+    LL_DELETE(_buckets[_rbuf_hash(entry->src, entry->src_len,
+                                  entry->dst, entry->dst_len,
+                                  entry->datagram_size, entry->tag)], entry);
+    DL_DELETE2(_lru, entry, lru_prev, lru_next);
+    _stats.used--;
+    _stats.mem_used -= entry->datagram_size;
     entry->pkt = NULL;
+    LL_PREPEND(_free, entry);
 }
 
 static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
@@ -248,73 +316,97 @@ static bool _rbuf_update_ints(rbuf_t *entry, uint16_t offset, size_t frag_size)
     return true;
 }
 
-static void _rbuf_gc(void)
+static void _rbuf_time_out(rbuf_t *entry)
 {
-    uint32_t now_usec = xtimer_now_usec();
-    unsigned int i;
-
-    for (i = 0; i < RBUF_SIZE; i++) {
-        /* since pkt occupies pktbuf, aggressivly collect garbage */
-        if ((rbuf[i].pkt != NULL) &&
-              ((now_usec - rbuf[i].arrival) > RBUF_TIMEOUT)) {
-            DEBUG("6lo rfrag: entry (%s, ", gnrc_netif_addr_to_str(l2addr_str,
-                    sizeof(l2addr_str), rbuf[i].src, rbuf[i].src_len));
-            DEBUG("%s, %u, %u) timed out\n",
-                  gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), rbuf[i].dst,
-                                         rbuf[i].dst_len),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-
-            gnrc_pktbuf_release(rbuf[i].pkt);
-            _rbuf_rem(&(rbuf[i]));
-        }
+    DEBUG("6lo rfrag: entry (%s, ", gnrc_netif_addr_to_str(l2addr_str,
+            sizeof(l2addr_str), entry->src, entry->src_len));
+    DEBUG("%s, %u, %u) timed out\n",
+          gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), entry->dst,
+                                 entry->dst_len),
+          (unsigned)entry->datagram_size, entry->tag);
+
+    _stats.timed_out++;
+    gnrc_pktbuf_release(entry->pkt);
+    _rbuf_rem(entry);
+}
+
+static void _rbuf_gc(uint32_t now_usec)
+{
+    /* the timers normally take care of this, but their message is dropped
+     * when the queue of the 6LoWPAN thread is full. The list is ordered by
+     * arrival, so only its head needs to be checked. */
+    while ((_lru != NULL) && ((now_usec - _lru->arrival) >= RBUF_TIMEOUT)) {
+        _rbuf_time_out(_lru);
+    }
+}
+
+static void _rbuf_evict(void)
+{
+    rbuf_t *oldest = _lru;
+
+    assert(oldest != NULL);
+    DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
+    _stats.evicted++;
+    gnrc_pktbuf_release(oldest->pkt);
+    _rbuf_rem(oldest);
+}
+
+static rbuf_t *_rbuf_alloc(void)
+{
+    rbuf_t *res = _free;
+
+    if (res != NULL) {
+        _free = res->next;
     }
+    else if (_rbuf_fresh < RBUF_SIZE) {
+        res = &rbuf[_rbuf_fresh++];
+    }
+    return res;
 }
 
 static rbuf_t *_rbuf_get(const void *src, size_t src_len,
                          const void *dst, size_t dst_len,
                          size_t size, uint16_t tag)
 {
-    rbuf_t *res = NULL, *oldest = NULL;
+    rbuf_t *res, **bucket = &_buckets[_rbuf_hash(src, src_len, dst, dst_len,
+                                                 size, tag)];
     uint32_t now_usec = xtimer_now_usec();
 
-    for (unsigned int i = 0; i < RBUF_SIZE; i++) {
-        /* check first if entry already available */
-        if ((rbuf[i].pkt != NULL) && (rbuf[i].pkt->size == size) &&
-            (rbuf[i].tag == tag) && (rbuf[i].src_len == src_len) &&
-            (rbuf[i].dst_len == dst_len) &&
-            (memcmp(rbuf[i].src, src, src_len) == 0) &&
-            (memcmp(rbuf[i].dst, dst, dst_len) == 0)) {
-            DEBUG("6lo rfrag: entry %p (%s, ", (void *)(&rbuf[i]),
+    /* check first if entry already available */
+    for (res = *bucket; res != NULL; res = res->next) {
+        if ((res->datagram_size == size) && (res->tag == tag) &&
+            (res->src_len == src_len) && (res->dst_len == dst_len) &&
+            (memcmp(res->src, src, src_len) == 0) &&
+            (memcmp(res->dst, dst, dst_len) == 0)) {
+            DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
                   gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
-                                         rbuf[i].src, rbuf[i].src_len));
+                                         res->src, res->src_len));
             DEBUG("%s, %u, %u) found\n",
                   gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str),
-                                         rbuf[i].dst, rbuf[i].dst_len),
-                  (unsigned)rbuf[i].pkt->size, rbuf[i].tag);
-            rbuf[i].arrival = now_usec;
-            return &(rbuf[i]);
-        }
-
-        /* if there is a free spot: remember it */
-        if ((res == NULL) && (rbuf[i].pkt == NULL)) {
-            res = &(rbuf[i]);
+                                         res->dst, res->dst_len),
+                  (unsigned)res->datagram_size, res->tag);
+            res->arrival = now_usec;
+            /* keep the list ordered by arrival */
+            DL_DELETE2(_lru, res, lru_prev, lru_next);
+            DL_APPEND2(_lru, res, lru_prev, lru_next);
+            return res;
         }
+    }
 
-        /* remember oldest slot */
-        /* note that xtimer_now will overflow in ~1.2 hours */
-        if ((oldest == NULL) || (oldest->arrival - rbuf[i].arrival < UINT32_MAX / 2)) {
-            oldest = &(rbuf[i]);
-        }
+    if (size > RBUF_MEM_BUDGET) {
+        DEBUG("6lo rfrag: datagram exceeds reassembly memory budget.\n");
+        _stats.dropped++;
+        return NULL;
     }
 
-    /* entry not in buffer and no empty spot found */
-    if (res == NULL) {
-        assert(oldest != NULL);
-        assert(oldest->pkt != NULL); /* if oldest->pkt == NULL, res must not be NULL */
-        DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
-        gnrc_pktbuf_release(oldest->pkt);
-        _rbuf_rem(oldest);
-        res = oldest;
+    /* make room for the new datagram by removing the least recently updated
+     * entries */
+    while ((_stats.mem_used + size) > RBUF_MEM_BUDGET) {
+        _rbuf_evict();
+    }
+    if ((res = _rbuf_alloc()) == NULL) {
+        _rbuf_evict();
+        res = _rbuf_alloc();
     }
 
     /* now we have an empty spot */
@@ -322,6 +414,8 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
     res->pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_IPV6);
     if (res->pkt == NULL) {
         DEBUG("6lo rfrag: can not allocate reassembly buffer space.\n");
+        _stats.dropped++;
+        LL_PREPEND(_free, res);
         return NULL;
     }
 
@@ -333,14 +427,23 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
     res->src_len = src_len;
     res->dst_len = dst_len;
     res->tag = tag;
+    res->datagram_size = size;
     res->cur_size = 0;
+    LL_PREPEND(*bucket, res);
+    DL_APPEND2(_lru, res, lru_prev, lru_next);
+    _stats.used++;
+    _stats.mem_used += size;
+
+    res->timer_msg.type = GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF;
+    res->timer_msg.content.ptr = res;
+    xtimer_set_msg(&res->timer, RBUF_TIMEOUT, &res->timer_msg, thread_getpid());
 
     DEBUG("6lo rfrag: entry %p (%s, ", (void *)res,
           gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->src,
                                  res->src_len));
     DEBUG("%s, %u, %u) created\n",
           gnrc_netif_addr_to_str(l2addr_str, sizeof(l2addr_str), res->dst,
-                                 res->dst_len), (unsigned)res->pkt->size,
+                                 res->dst_len), (unsigned)res->datagram_size,
           res->tag);
 
     return res;
@@ -21,8 +21,11 @@
 
 #include <inttypes.h>
 
+#include "msg.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pkt.h"
+#include "net/ipv6.h"
+#include "xtimer.h"
 
 #include "net/gnrc/sixlowpan/frag.h"
 #ifdef __cplusplus
@@ -31,8 +34,34 @@ extern "C" {
 #endif
 
 #define RBUF_L2ADDR_MAX_LEN (8U)               /**< maximum length for link-layer addresses */
+
+#ifndef RBUF_SIZE
 #define RBUF_SIZE           (4U)               /**< size of the reassembly buffer */
+#endif
+
+#ifndef RBUF_TIMEOUT
 #define RBUF_TIMEOUT        (3U * US_PER_SEC) /**< timeout for reassembly in microseconds */
+#endif
+
+/**
+ * @brief   Number of buckets of the hash over (source, destination, tag, size)
+ *          that is used to find the entry of a fragment
+ */
+#ifndef RBUF_HASH_SIZE
+#define RBUF_HASH_SIZE      (RBUF_SIZE)
+#endif
+
+/**
+ * @brief   Maximum number of bytes in the packet buffer all datagrams under
+ *          reassembly may occupy together
+ *
+ * If a new datagram does not fit into the budget the least recently updated
+ * datagrams are evicted. On border routers this keeps reassembly from
+ * starving the rest of the stack of packet buffer space.
+ */
+#ifndef RBUF_MEM_BUDGET
+#define RBUF_MEM_BUDGET     (RBUF_SIZE * IPV6_MIN_MTU)
+#endif
 
 /**
  * @brief   Fragment intervals to identify limits of fragments.
@@ -70,9 +99,17 @@ typedef struct rbuf_int {
  *
  * @internal
  */
-typedef struct {
+typedef struct rbuf {
+    struct rbuf *next;                  /**< next entry in hash bucket or
+                                         *   free list */
+    struct rbuf *lru_prev;              /**< previous (less recently updated)
+                                         *   entry in LRU list */
+    struct rbuf *lru_next;              /**< next (more recently updated)
+                                         *   entry in LRU list */
     rbuf_int_t *ints;                   /**< intervals of the fragment */
     gnrc_pktsnip_t *pkt;                /**< the reassembled packet in packet buffer */
+    xtimer_t timer;                     /**< timeout timer of the entry */
+    msg_t timer_msg;                    /**< message sent by rbuf_t::timer */
     uint32_t arrival;                   /**< time in microseconds of arrival of
                                          *   last received fragment */
     uint8_t src[RBUF_L2ADDR_MAX_LEN];   /**< source address */
@@ -80,6 +117,7 @@ typedef struct {
     uint8_t src_len;                    /**< length of source address */
     uint8_t dst_len;                    /**< length of destination address */
     uint16_t tag;                       /**< the datagram's tag */
+    uint16_t datagram_size;             /**< the datagram's size */
     uint16_t cur_size;                  /**< the datagram's current size */
 } rbuf_t;
 
@@ -100,6 +138,27 @@ typedef struct {
 void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *frag,
               size_t frag_size, size_t offset);
 
+/**
+ * @brief   Handles the expiry of the timer of an entry
+ *
+ * Removes the entry if no fragment arrived for @ref RBUF_TIMEOUT, otherwise
+ * restarts the timer for the remaining time.
+ *
+ * @param[in] entry     The entry the timer belongs to.
+ *
+ * @internal
+ */
+void rbuf_timeout(rbuf_t *entry);
+
+/**
+ * @brief   Gets the reassembly statistics
+ *
+ * @param[out] stats    The statistics
+ *
+ * @internal
+ */
+void rbuf_get_stats(gnrc_sixlowpan_frag_rbuf_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
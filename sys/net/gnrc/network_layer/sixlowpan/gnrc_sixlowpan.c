@@ -34,6 +34,11 @@
 
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 
+#ifdef MODULE_GNRC_NETAPI_BATCH
+/* decoded packets waiting to be handed to IPv6 */
+static gnrc_netapi_batch_t _batch;
+#endif
+
 #ifdef MODULE_GNRC_SIXLOWPAN_FRAG
 static gnrc_sixlowpan_msg_frag_t fragment_msg = {KERNEL_PID_UNDEF, NULL, 0, 0};
 #endif
@@ -163,7 +168,12 @@ static void _receive(gnrc_pktsnip_t *pkt)
         gnrc_pktbuf_release(pkt);
         return;
     }
+#ifdef MODULE_GNRC_NETAPI_BATCH
+    if (!gnrc_netapi_batch_add(&_batch, GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL,
+                               GNRC_NETAPI_MSG_TYPE_RCV, pkt)) {
+#else
     if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+#endif
         DEBUG("6lo: No receivers for this packet found\n");
         gnrc_pktbuf_release(pkt);
     }
@@ -318,6 +328,9 @@ static void *_event_loop(void *args)
 
     /* register interest in all 6LoWPAN packets */
     gnrc_netreg_register(GNRC_NETTYPE_SIXLOWPAN, &me_reg);
+#ifdef MODULE_GNRC_NETAPI_BATCH
+    gnrc_netapi_batch_register(sched_active_pid);
+#endif
 
     /* preinitialize ACK */
     reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
@@ -338,6 +351,25 @@ static void *_event_loop(void *args)
                 _send(msg.content.ptr);
                 break;
 
+#ifdef MODULE_GNRC_NETAPI_BATCH
+            case GNRC_NETAPI_MSG_TYPE_RCV_BATCH:
+            case GNRC_NETAPI_MSG_TYPE_SND_BATCH: {
+                gnrc_pktsnip_t *chain = msg.content.ptr, *pkt;
+
+                DEBUG("6lo: GNRC_NETAPI_MSG_TYPE_%s_BATCH received\n",
+                      (msg.type == GNRC_NETAPI_MSG_TYPE_RCV_BATCH) ? "RCV" : "SND");
+                while ((pkt = gnrc_netapi_batch_pop(&chain))) {
+                    if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV_BATCH) {
+                        _receive(pkt);
+                    }
+                    else {
+                        _send(pkt);
+                    }
+                }
+                break;
+            }
+#endif
+
             case GNRC_NETAPI_MSG_TYPE_GET:
             case GNRC_NETAPI_MSG_TYPE_SET:
                 DEBUG("6lo: reply to unsupported get/set\n");
@@ -349,12 +381,23 @@ static void *_event_loop(void *args)
                 DEBUG("6lo: send fragmented event received\n");
                 gnrc_sixlowpan_frag_send(msg.content.ptr);
                 break;
+
+            case GNRC_SIXLOWPAN_MSG_FRAG_GC_RBUF:
+                DEBUG("6lo: reassembly buffer timeout event received\n");
+                gnrc_sixlowpan_frag_gc_rbuf(msg.content.ptr);
+                break;
 #endif
 
             default:
                 DEBUG("6lo: operation not supported\n");
                 break;
         }
+#ifdef MODULE_GNRC_NETAPI_BATCH
+        /* hand everything decoded so far to IPv6 once the queue is drained */
+        if (msg_avail() == 0) {
+            gnrc_netapi_batch_flush(&_batch);
+        }
+#endif
     }
 
     return NULL;
@@ -581,23 +581,136 @@ inline static size_t iphc_nhc_udp_encode(gnrc_pktsnip_t *udp, ipv6_hdr_t *ipv6_h
 }
 #endif
 
-bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
+/* what an encoded header depends on besides the IPv6 and link-layer header */
+typedef struct {
+    eui64_t iid;                /* source IID queried from the interface */
+    uint16_t ctx_used;          /* bit field of the context IDs used */
+    bool iid_queried;           /* iid was used for source address compression */
+} _deps_t;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+/* dispatch, CID extension, TF, next header, hop limit and both addresses
+ * carried inline */
+#define IPHC_HDR_MAX                (SIXLOWPAN_IPHC_HDR_LEN + SIXLOWPAN_IPHC_CID_EXT_LEN + \
+                                     4 + 1 + 1 + (2 * sizeof(ipv6_addr_t)))
+
+/* encoded header of a flow, only used by the 6LoWPAN thread */
+typedef struct {
+    ipv6_addr_t src;
+    ipv6_addr_t dst;
+    network_uint32_t v_tc_fl;
+    kernel_pid_t if_pid;
+    unsigned ctx_version;       /* of the contexts the header was built with */
+    _deps_t deps;
+    uint8_t nh;
+    uint8_t hl;
+    uint8_t src_l2addr_len;
+    uint8_t dst_l2addr_len;
+    uint8_t src_l2addr[IEEE802154_LONG_ADDRESS_LEN];
+    uint8_t dst_l2addr[IEEE802154_LONG_ADDRESS_LEN];
+    uint8_t len;                /* 0 if unused */
+    uint8_t hdr[IPHC_HDR_MAX];
+} _flow_t;
+
+static _flow_t _flows[GNRC_SIXLOWPAN_IPHC_CACHE_SIZE];
+static unsigned _flows_next;
+
+static bool _flow_match(const _flow_t *flow, gnrc_netif_hdr_t *netif_hdr,
+                        const ipv6_hdr_t *ipv6_hdr)
 {
-    gnrc_netif_hdr_t *netif_hdr = pkt->data;
-    ipv6_hdr_t *ipv6_hdr = pkt->next->data;
-    uint8_t *iphc_hdr;
-    uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
-    bool addr_comp = false, nhc_comp = false;
-    gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
-    gnrc_pktsnip_t *dispatch = gnrc_pktbuf_add(NULL, NULL, pkt->next->size,
-                                               GNRC_NETTYPE_SIXLOWPAN);
+    return (flow->len > 0) &&
+           (flow->v_tc_fl.u32 == ipv6_hdr->v_tc_fl.u32) &&
+           (flow->nh == ipv6_hdr->nh) && (flow->hl == ipv6_hdr->hl) &&
+           (flow->if_pid == netif_hdr->if_pid) &&
+           ipv6_addr_equal(&flow->dst, &ipv6_hdr->dst) &&
+           ipv6_addr_equal(&flow->src, &ipv6_hdr->src) &&
+           (flow->src_l2addr_len == netif_hdr->src_l2addr_len) &&
+           (flow->dst_l2addr_len == netif_hdr->dst_l2addr_len) &&
+           (memcmp(flow->src_l2addr, gnrc_netif_hdr_get_src_addr(netif_hdr),
+                   flow->src_l2addr_len) == 0) &&
+           (memcmp(flow->dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+                   flow->dst_l2addr_len) == 0);
+}
 
-    if (dispatch == NULL) {
-        DEBUG("6lo iphc: error allocating dispatch space\n");
-        return false;
+static _flow_t *_flow_get(gnrc_netif_hdr_t *netif_hdr, const ipv6_hdr_t *ipv6_hdr)
+{
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_IPHC_CACHE_SIZE; i++) {
+        _flow_t *flow = &_flows[i];
+
+        if (!_flow_match(flow, netif_hdr, ipv6_hdr)) {
+            continue;
+        }
+        if (flow->ctx_version != gnrc_sixlowpan_ctx_version()) {
+            flow->len = 0;
+            return NULL;
+        }
+        /* the contexts used may have run out of lifetime meanwhile */
+        for (uint8_t id = 0; id < GNRC_SIXLOWPAN_CTX_SIZE; id++) {
+            gnrc_sixlowpan_ctx_t *ctx;
+
+            if ((flow->deps.ctx_used & (1U << id)) &&
+                (((ctx = gnrc_sixlowpan_ctx_lookup_id(id)) == NULL) ||
+                 !(ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_COMP))) {
+                flow->len = 0;
+                return NULL;
+            }
+        }
+        /* so may have the address of the interface */
+        if (flow->deps.iid_queried) {
+            eui64_t iid;
+
+            iid.uint64.u64 = 0;
+            gnrc_netapi_get(netif_hdr->if_pid, NETOPT_IPV6_IID, 0, &iid,
+                            sizeof(eui64_t));
+            if (iid.uint64.u64 != flow->deps.iid.uint64.u64) {
+                flow->len = 0;
+                return NULL;
+            }
+        }
+        DEBUG("6lo iphc: using cached header of flow %u\n", i);
+        return flow;
     }
+    return NULL;
+}
 
-    iphc_hdr = dispatch->data;
+static void _flow_add(gnrc_netif_hdr_t *netif_hdr, const ipv6_hdr_t *ipv6_hdr,
+                      const uint8_t *iphc_hdr, uint16_t len, const _deps_t *deps)
+{
+    _flow_t *flow = &_flows[_flows_next];
+
+    if ((netif_hdr->src_l2addr_len > sizeof(flow->src_l2addr)) ||
+        (netif_hdr->dst_l2addr_len > sizeof(flow->dst_l2addr)) ||
+        (len > sizeof(flow->hdr))) {
+        return;
+    }
+    /* replaced in turn, a periodic flow is hit again before it is evicted */
+    _flows_next = (_flows_next + 1) % GNRC_SIXLOWPAN_IPHC_CACHE_SIZE;
+    flow->src = ipv6_hdr->src;
+    flow->dst = ipv6_hdr->dst;
+    flow->v_tc_fl = ipv6_hdr->v_tc_fl;
+    flow->if_pid = netif_hdr->if_pid;
+    flow->ctx_version = gnrc_sixlowpan_ctx_version();
+    flow->deps = *deps;
+    flow->nh = ipv6_hdr->nh;
+    flow->hl = ipv6_hdr->hl;
+    flow->src_l2addr_len = netif_hdr->src_l2addr_len;
+    flow->dst_l2addr_len = netif_hdr->dst_l2addr_len;
+    memcpy(flow->src_l2addr, gnrc_netif_hdr_get_src_addr(netif_hdr),
+           netif_hdr->src_l2addr_len);
+    memcpy(flow->dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+           netif_hdr->dst_l2addr_len);
+    memcpy(flow->hdr, iphc_hdr, len);
+    flow->len = len;
+}
+#endif
+
+/* Compresses everything but the NHC header */
+static uint16_t _encode(gnrc_netif_hdr_t *netif_hdr, ipv6_hdr_t *ipv6_hdr,
+                        uint8_t *iphc_hdr, _deps_t *deps)
+{
+    uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
+    bool addr_comp = false;
+    gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
 
     /* set initial dispatch value*/
     iphc_hdr[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
@@ -667,13 +780,11 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
         iphc_hdr[inline_pos++] = (uint8_t)((ipv6_hdr_get_fl(ipv6_hdr) & 0x000000ff) >> 8);
     }
 
-    /* compress next header */
+    /* compress next header, the NHC header follows the addresses */
     switch (ipv6_hdr->nh) {
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
         case PROTNUM_UDP:
-            iphc_nhc_udp_encode(pkt->next->next, ipv6_hdr);
             iphc_hdr[IPHC1_IDX] |= SIXLOWPAN_IPHC1_NH;
-            nhc_comp = true;
             break;
 #endif
 
@@ -713,6 +824,7 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
             if (((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
                 iphc_hdr[CID_EXT_IDX] |= ((src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) << 4);
             }
+            deps->ctx_used |= 1U << (src_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
         }
 
         if ((src_ctx != NULL) || ipv6_addr_is_link_local(&(ipv6_hdr->src))) {
@@ -730,6 +842,8 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
                 /* but take from driver otherwise */
                 gnrc_netapi_get(netif_hdr->if_pid, NETOPT_IPV6_IID, 0, &iid,
                                 sizeof(eui64_t));
+                deps->iid = iid;
+                deps->iid_queried = true;
             }
 
             if ((ipv6_hdr->src.u64[1].u64 == iid.uint64.u64) ||
@@ -823,6 +937,7 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
                 if ((ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) {
                     iphc_hdr[CID_EXT_IDX] |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
                 }
+                deps->ctx_used |= 1U << (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
                 iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[1];
                 iphc_hdr[inline_pos++] = ipv6_hdr->dst.u8[2];
                 memcpy(iphc_hdr + inline_pos, ipv6_hdr->dst.u16 + 6, 4);
@@ -842,6 +957,7 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
             if (((dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0)) {
                 iphc_hdr[CID_EXT_IDX] |= (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
             }
+            deps->ctx_used |= 1U << (dst_ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
         }
 
         ieee802154_get_iid(&iid, gnrc_netif_hdr_get_dst_addr(netif_hdr),
@@ -877,9 +993,48 @@ bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
         inline_pos += 16;
     }
 
-    if (nhc_comp) {
+    return inline_pos;
+}
+
+bool gnrc_sixlowpan_iphc_encode(gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *netif_hdr = pkt->data;
+    ipv6_hdr_t *ipv6_hdr = pkt->next->data;
+    uint8_t *iphc_hdr;
+    uint16_t inline_pos;
+    _deps_t deps = { .ctx_used = 0, .iid_queried = false };
+    gnrc_pktsnip_t *dispatch = gnrc_pktbuf_add(NULL, NULL, pkt->next->size,
+                                               GNRC_NETTYPE_SIXLOWPAN);
+
+    if (dispatch == NULL) {
+        DEBUG("6lo iphc: error allocating dispatch space\n");
+        return false;
+    }
+
+    iphc_hdr = dispatch->data;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_CACHE
+    _flow_t *flow = _flow_get(netif_hdr, ipv6_hdr);
+
+    if (flow != NULL) {
+        memcpy(iphc_hdr, flow->hdr, flow->len);
+        inline_pos = flow->len;
+    }
+    else {
+        inline_pos = _encode(netif_hdr, ipv6_hdr, iphc_hdr, &deps);
+        _flow_add(netif_hdr, ipv6_hdr, iphc_hdr, inline_pos, &deps);
+    }
+#else
+    inline_pos = _encode(netif_hdr, ipv6_hdr, iphc_hdr, &deps);
+#endif
+
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (ipv6_hdr->nh == PROTNUM_UDP) {
+        /* sets the NHC header as next header */
+        iphc_nhc_udp_encode(pkt->next->next, ipv6_hdr);
         iphc_hdr[inline_pos++] = ipv6_hdr->nh;
     }
+#endif
 
     /* shrink dispatch allocation to final size */
     /* NOTE: Since this only shrinks the data nothing bad SHOULD happen ;-) */
@@ -0,0 +1,569 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_gnrc_pktbuf_slab
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "mutex.h"
+#include "utlist.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/pktbuf_slab.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pkt.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define _ALIGNMENT_MASK    (sizeof(void *) - 1)
+
+/* number of pointer-sized words a pool of a size class occupies */
+#define _POOL_WORDS(size, numof)    (((size) / sizeof(uintptr_t)) * (numof))
+
+typedef struct _free {
+    struct _free *next;
+} _free_t;
+
+typedef struct {
+    uint8_t *pool;                      /**< first block of the class */
+    _free_t *free;                      /**< LIFO list of unused blocks */
+    gnrc_pktbuf_slab_stats_t stats;     /**< size, number and usage of blocks */
+} _class_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+static uintptr_t _pool_small[_POOL_WORDS(GNRC_PKTBUF_SLAB_SMALL_SIZE,
+                                         GNRC_PKTBUF_SLAB_SMALL_NUMOF)];
+static uintptr_t _pool_medium[_POOL_WORDS(GNRC_PKTBUF_SLAB_MEDIUM_SIZE,
+                                          GNRC_PKTBUF_SLAB_MEDIUM_NUMOF)];
+static uintptr_t _pool_large[_POOL_WORDS(GNRC_PKTBUF_SLAB_LARGE_SIZE,
+                                         GNRC_PKTBUF_SLAB_LARGE_NUMOF)];
+
+/* ordered by ascending block size */
+static _class_t _classes[GNRC_PKTBUF_SLAB_CLASSES] = {
+    { .pool = (uint8_t *)_pool_small,
+      .stats = { .size = GNRC_PKTBUF_SLAB_SMALL_SIZE,
+                 .numof = GNRC_PKTBUF_SLAB_SMALL_NUMOF } },
+    { .pool = (uint8_t *)_pool_medium,
+      .stats = { .size = GNRC_PKTBUF_SLAB_MEDIUM_SIZE,
+                 .numof = GNRC_PKTBUF_SLAB_MEDIUM_NUMOF } },
+    { .pool = (uint8_t *)_pool_large,
+      .stats = { .size = GNRC_PKTBUF_SLAB_LARGE_SIZE,
+                 .numof = GNRC_PKTBUF_SLAB_LARGE_NUMOF } },
+};
+
+/* internal gnrc_pktbuf functions */
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type);
+static void *_pktbuf_alloc(size_t size);
+static void _pktbuf_free(void *data);
+
+static inline size_t _pool_size(const _class_t *cls)
+{
+    return (size_t)cls->stats.size * cls->stats.numof;
+}
+
+/* returns the size class ptr belongs to (ptr may point into a block) */
+static _class_t *_class_of(const void *ptr)
+{
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _class_t *cls = &_classes[i];
+
+        if (((uintptr_t)ptr - (uintptr_t)cls->pool) < _pool_size(cls)) {
+            return cls;
+        }
+    }
+    return NULL;
+}
+
+static inline uint8_t *_block_start(const _class_t *cls, const void *ptr)
+{
+    size_t offset = (uintptr_t)ptr - (uintptr_t)cls->pool;
+
+    return cls->pool + ((offset / cls->stats.size) * cls->stats.size);
+}
+
+/* number of bytes usable from ptr to the end of its block */
+static inline size_t _capacity(const _class_t *cls, const void *ptr)
+{
+    return (_block_start(cls, ptr) + cls->stats.size) - (const uint8_t *)ptr;
+}
+
+static inline bool _pktbuf_contains(void *ptr)
+{
+    return (_class_of(ptr) != NULL);
+}
+
+static inline void _set_pktsnip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *next,
+                                void *data, size_t size, gnrc_nettype_t type)
+{
+    pkt->next = next;
+    pkt->data = data;
+    pkt->size = size;
+    pkt->type = type;
+    pkt->users = 1;
+#ifdef MODULE_GNRC_NETERR
+    pkt->err_sub = KERNEL_PID_UNDEF;
+#endif
+}
+
+void gnrc_pktbuf_init(void)
+{
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _class_t *cls = &_classes[i];
+
+        assert((cls->stats.size & _ALIGNMENT_MASK) == 0);
+        cls->free = NULL;
+        /* push in reverse order so the first block is handed out first */
+        for (unsigned j = cls->stats.numof; j > 0; j--) {
+            _free_t *block = (_free_t *)(cls->pool + ((j - 1) * cls->stats.size));
+
+            block->next = cls->free;
+            cls->free = block;
+        }
+        cls->stats.used = 0;
+        cls->stats.max_used = 0;
+        cls->stats.fallbacks = 0;
+        cls->stats.failed = 0;
+    }
+    assert(sizeof(gnrc_pktsnip_t) <= GNRC_PKTBUF_SLAB_LARGE_SIZE);
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_add(gnrc_pktsnip_t *next, void *data, size_t size,
+                                gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt;
+
+    if (size > GNRC_PKTBUF_SLAB_LARGE_SIZE) {
+        DEBUG("pktbuf: size (%u) > GNRC_PKTBUF_SLAB_LARGE_SIZE (%u)\n",
+              (unsigned)size, GNRC_PKTBUF_SLAB_LARGE_SIZE);
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    pkt = _create_snip(next, data, size, type);
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_mark(gnrc_pktsnip_t *pkt, size_t size, gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *marked_snip;
+    void *new_data_marked;
+
+    mutex_lock(&_mutex);
+    if ((size == 0) || (pkt == NULL) || (size > pkt->size) || (pkt->data == NULL)) {
+        DEBUG("pktbuf: size == 0 (was %u) or pkt == NULL (was %p) or "
+              "size > pkt->size (was %u) or pkt->data == NULL (was %p)\n",
+              (unsigned)size, (void *)pkt, (pkt ? (unsigned)pkt->size : 0),
+              (pkt ? pkt->data : NULL));
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    /* create new snip descriptor for marked data */
+    marked_snip = _pktbuf_alloc(sizeof(gnrc_pktsnip_t));
+    if (marked_snip == NULL) {
+        DEBUG("pktbuf: could not reallocate marked section.\n");
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->size != size) {
+        /* a block can only be owned by one snip: copy the marked section to
+         * its own block and keep the remainder in the original block (blocks
+         * are freed by any pointer into them) */
+        new_data_marked = _pktbuf_alloc(size);
+        if (new_data_marked == NULL) {
+            DEBUG("pktbuf: could not reallocate marked section.\n");
+            _pktbuf_free(marked_snip);
+            mutex_unlock(&_mutex);
+            return NULL;
+        }
+        memcpy(new_data_marked, pkt->data, size);
+        pkt->data = ((uint8_t *)pkt->data) + size;
+    }
+    else {
+        new_data_marked = pkt->data;
+        pkt->data = NULL;
+    }
+    pkt->size -= size;
+    _set_pktsnip(marked_snip, pkt->next, new_data_marked, size, type);
+    pkt->next = marked_snip;
+    mutex_unlock(&_mutex);
+    return marked_snip;
+}
+
+int gnrc_pktbuf_realloc_data(gnrc_pktsnip_t *pkt, size_t size)
+{
+    _class_t *cls;
+
+    mutex_lock(&_mutex);
+    assert(pkt != NULL);
+    cls = _class_of(pkt->data);
+    assert(((pkt->size == 0) && (pkt->data == NULL)) ||
+           ((pkt->size > 0) && (pkt->data != NULL) && _pktbuf_contains(pkt->data)));
+    /* new size and old size are equal */
+    if (size == pkt->size) {
+        /* nothing to do */
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+    /* new size is 0 and data pointer isn't already NULL */
+    if ((size == 0) && (pkt->data != NULL)) {
+        /* set data pointer to NULL */
+        _pktbuf_free(pkt->data);
+        pkt->data = NULL;
+    }
+    /* new size does not fit into the current block */
+    else if ((cls == NULL) || (size > _capacity(cls, pkt->data))) {
+        void *new_data = _pktbuf_alloc(size);
+        if (new_data == NULL) {
+            DEBUG("pktbuf: error allocating new data section\n");
+            mutex_unlock(&_mutex);
+            return ENOMEM;
+        }
+        if (pkt->data != NULL) {            /* if old data exist */
+            memcpy(new_data, pkt->data, (pkt->size < size) ? pkt->size : size);
+            _pktbuf_free(pkt->data);
+        }
+        pkt->data = new_data;
+    }
+    /* shrunk data fits a smaller class: move it there to give the (scarcer)
+     * larger block back, but keep it in place if that class is exhausted */
+    else if ((cls != &_classes[0]) && (size <= (cls - 1)->stats.size) &&
+             ((cls - 1)->free != NULL)) {
+        void *new_data = _pktbuf_alloc(size);
+
+        assert(_class_of(new_data) < cls);
+        memcpy(new_data, pkt->data, size);
+        _pktbuf_free(pkt->data);
+        pkt->data = new_data;
+    }
+    pkt->size = size;
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_pktbuf_hold(gnrc_pktsnip_t *pkt, unsigned int num)
+{
+    mutex_lock(&_mutex);
+    while (pkt) {
+        pkt->users += num;
+        pkt = pkt->next;
+    }
+    mutex_unlock(&_mutex);
+}
+
+static void _release_error_locked(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    while (pkt) {
+        gnrc_pktsnip_t *tmp;
+        assert(_pktbuf_contains(pkt));
+        tmp = pkt->next;
+        if (pkt->users == 1) {
+            pkt->users = 0; /* not necessary but to be on the safe side */
+            _pktbuf_free(pkt->data);
+            _pktbuf_free(pkt);
+        }
+        else {
+            pkt->users--;
+        }
+        DEBUG("pktbuf: report status code %" PRIu32 "\n", err);
+        gnrc_neterr_report(pkt, err);
+        pkt = tmp;
+    }
+}
+
+void gnrc_pktbuf_release_error(gnrc_pktsnip_t *pkt, uint32_t err)
+{
+    mutex_lock(&_mutex);
+    _release_error_locked(pkt, err);
+    mutex_unlock(&_mutex);
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt)
+{
+    mutex_lock(&_mutex);
+    if ((pkt == NULL) || (pkt->size == 0)) {
+        mutex_unlock(&_mutex);
+        return NULL;
+    }
+    if (pkt->users > 1) {
+        gnrc_pktsnip_t *new;
+        new = _create_snip(pkt->next, pkt->data, pkt->size, pkt->type);
+        if (new != NULL) {
+            pkt->users--;
+        }
+        mutex_unlock(&_mutex);
+        return new;
+    }
+    mutex_unlock(&_mutex);
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_get_iovec(gnrc_pktsnip_t *pkt, size_t *len)
+{
+    size_t length;
+    gnrc_pktsnip_t *head;
+    struct iovec *vec;
+
+    assert(len != NULL);
+    if (pkt == NULL) {
+        *len = 0;
+        return NULL;
+    }
+
+    /* count the number of snips in the packet and allocate the IOVEC */
+    length = gnrc_pkt_count(pkt);
+    head = gnrc_pktbuf_add(pkt, NULL, (length * sizeof(struct iovec)),
+                           GNRC_NETTYPE_IOVEC);
+    if (head == NULL) {
+        *len = 0;
+        return NULL;
+    }
+
+    assert(head->data != NULL);
+    vec = (struct iovec *)(head->data);
+    /* fill the IOVEC */
+    while (pkt != NULL) {
+        vec->iov_base = pkt->data;
+        vec->iov_len = pkt->size;
+        ++vec;
+        pkt = pkt->next;
+    }
+    *len = length;
+    return head;
+}
+
+void gnrc_pktbuf_slab_get_stats(unsigned cls, gnrc_pktbuf_slab_stats_t *stats)
+{
+    assert((cls < GNRC_PKTBUF_SLAB_CLASSES) && (stats != NULL));
+    mutex_lock(&_mutex);
+    *stats = _classes[cls].stats;
+    mutex_unlock(&_mutex);
+}
+
+#ifdef DEVELHELP
+void gnrc_pktbuf_stats(void)
+{
+    mutex_lock(&_mutex);
+    puts("packet buffer (size classes):");
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        gnrc_pktbuf_slab_stats_t *stats = &_classes[i].stats;
+
+        printf("  class %u: %4u byte x %3u blocks, used: %3u, max. used: %3u, "
+               "fallbacks: %u, failed: %u\n", i, stats->size, stats->numof,
+               stats->used, stats->max_used, stats->fallbacks, stats->failed);
+    }
+    mutex_unlock(&_mutex);
+}
+#endif
+
+#ifdef TEST_SUITES
+bool gnrc_pktbuf_is_empty(void)
+{
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        if (_classes[i].stats.used > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool gnrc_pktbuf_is_sane(void)
+{
+    /* Invariants of this implementation:
+     *  - forall ptr in a class' free list: ptr is the start of a block of
+     *    that class
+     *  - forall classes: length(free list) + used == numof
+     */
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _class_t *cls = &_classes[i];
+        unsigned count = 0;
+
+        for (_free_t *ptr = cls->free; ptr != NULL; ptr = ptr->next) {
+            if ((_class_of(ptr) != cls) || (_block_start(cls, ptr) != (uint8_t *)ptr) ||
+                (++count > cls->stats.numof)) {
+                return false;
+            }
+        }
+        if ((count + cls->stats.used) != cls->stats.numof) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+static gnrc_pktsnip_t *_create_snip(gnrc_pktsnip_t *next, void *data, size_t size,
+                                    gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt = _pktbuf_alloc(sizeof(gnrc_pktsnip_t));
+    void *_data = NULL;
+
+    if (pkt == NULL) {
+        DEBUG("pktbuf: error allocating new packet snip\n");
+        return NULL;
+    }
+    if (size > 0) {
+        _data = _pktbuf_alloc(size);
+        if (_data == NULL) {
+            DEBUG("pktbuf: error allocating data for new packet snip\n");
+            _pktbuf_free(pkt);
+            return NULL;
+        }
+    }
+    _set_pktsnip(pkt, next, _data, size, type);
+    if (data != NULL) {
+        memcpy(_data, data, size);
+    }
+    return pkt;
+}
+
+static void *_pktbuf_alloc(size_t size)
+{
+    _class_t *best = NULL;
+
+    for (unsigned i = 0; i < GNRC_PKTBUF_SLAB_CLASSES; i++) {
+        _class_t *cls = &_classes[i];
+        _free_t *block = cls->free;
+
+        if (size > cls->stats.size) {
+            continue;
+        }
+        if (best == NULL) {
+            best = cls;
+        }
+        if (block != NULL) {
+            cls->free = block->next;
+            if (++cls->stats.used > cls->stats.max_used) {
+                cls->stats.max_used = cls->stats.used;
+            }
+            if (cls != best) {
+                cls->stats.fallbacks++;
+            }
+            return block;
+        }
+    }
+    if (best != NULL) {
+        best->stats.failed++;
+    }
+    DEBUG("pktbuf: no space left in packet buffer for %u byte\n",
+          (unsigned)size);
+    return NULL;
+}
+
+static void _pktbuf_free(void *data)
+{
+    _class_t *cls = _class_of(data);
+    _free_t *block;
+
+    if (cls == NULL) {
+        return;
+    }
+    block = (_free_t *)_block_start(cls, data);
+    block->next = cls->free;
+    cls->free = block;
+    assert(cls->stats.used > 0);
+    cls->stats.used--;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_remove_snip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *snip)
+{
+    LL_DELETE(pkt, snip);
+    snip->next = NULL;
+    gnrc_pktbuf_release(snip);
+
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_replace_snip(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *old, gnrc_pktsnip_t *add)
+{
+    /* If add is a list we need to preserve its tail */
+    if (add->next != NULL) {
+        gnrc_pktsnip_t *tail = add->next;
+        gnrc_pktsnip_t *back;
+        LL_SEARCH_SCALAR(tail, back, next, NULL); /* find the last snip in add */
+        /* Replace old */
+        LL_REPLACE_ELEM(pkt, old, add);
+        /* and wire in the tail between */
+        back->next = add->next;
+        add->next = tail;
+    }
+    else {
+        /* add is a single element, has no tail, simply replace */
+        LL_REPLACE_ELEM(pkt, old, add);
+    }
+    old->next = NULL;
+    gnrc_pktbuf_release(old);
+
+    return pkt;
+}
+
+gnrc_pktsnip_t *gnrc_pktbuf_duplicate_upto(gnrc_pktsnip_t *pkt, gnrc_nettype_t type)
+{
+    mutex_lock(&_mutex);
+
+    bool is_shared = pkt->users > 1;
+    size_t size = gnrc_pkt_len_upto(pkt, type);
+
+    DEBUG("ipv6_ext: duplicating %d octets\n", (int) size);
+
+    gnrc_pktsnip_t *tmp;
+    gnrc_pktsnip_t *target = gnrc_pktsnip_search_type(pkt, type);
+    gnrc_pktsnip_t *next = (target == NULL) ? NULL : target->next;
+    gnrc_pktsnip_t *new = _create_snip(next, NULL, size, type);
+
+    if (new == NULL) {
+        mutex_unlock(&_mutex);
+
+        return NULL;
+    }
+
+    /* copy payloads */
+    for (tmp = pkt; tmp != NULL; tmp = tmp->next) {
+        uint8_t *dest = ((uint8_t *)new->data) + (size - tmp->size);
+
+        memcpy(dest, tmp->data, tmp->size);
+
+        size -= tmp->size;
+
+        if (tmp->type == type) {
+            break;
+        }
+    }
+
+    /* decrements reference counters */
+
+    if (target != NULL) {
+        target->next = NULL;
+    }
+
+    _release_error_locked(pkt, GNRC_NETERR_SUCCESS);
+
+    if (is_shared && (target != NULL)) {
+        target->next = next;
+    }
+
+    mutex_unlock(&_mutex);
+
+    return new;
+}
+
+/** @} */
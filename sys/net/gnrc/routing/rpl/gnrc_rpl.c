@@ -25,6 +25,9 @@
 #include "net/gnrc/rpl/p2p.h"
 #include "net/gnrc/rpl/p2p_dodag.h"
 #endif
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+#include "net/gnrc/rpl/srh_tree.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -119,6 +122,11 @@ gnrc_rpl_instance_t *gnrc_rpl_root_init(uint8_t instance_id, ipv6_addr_t *dodag_
 #ifndef GNRC_RPL_WITHOUT_PIO
     dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
 #endif
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        gnrc_rpl_srh_tree_init(dodag_id);
+    }
+#endif
 
     trickle_start(gnrc_rpl_pid, &dodag->trickle, GNRC_RPL_MSG_TYPE_TRICKLE_INTERVAL,
                   GNRC_RPL_MSG_TYPE_TRICKLE_CALLBACK, (1 << dodag->dio_min),
@@ -297,6 +305,9 @@ void _update_lifetime(void)
 #ifdef MODULE_GNRC_RPL_P2P
     gnrc_rpl_p2p_update();
 #endif
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+    gnrc_rpl_srh_tree_expire(GNRC_RPL_LIFETIME_UPDATE_STEP);
+#endif
 
     xtimer_set_msg(&_lt_timer, _lt_time, &_lt_msg, gnrc_rpl_pid);
 }
@@ -38,6 +38,10 @@
 #include "net/gnrc/rpl/p2p.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+#include "net/gnrc/rpl/srh_tree.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -306,6 +310,27 @@ void gnrc_rpl_recv_DIS(gnrc_rpl_dis_t *dis, kernel_pid_t iface, ipv6_addr_t *src
     }
 }
 
+static void _add_target_fib_entry(gnrc_rpl_dodag_t *dodag, gnrc_rpl_opt_target_t *target,
+                                  ipv6_addr_t *src)
+{
+    uint32_t fib_dst_flags = 0;
+
+    if (target->prefix_length <= IPV6_ADDR_BIT_LEN) {
+        fib_dst_flags = ((uint32_t)(target->prefix_length) << FIB_FLAG_NET_PREFIX_SHIFT);
+    }
+
+    DEBUG("RPL: adding fib entry %s/%d 0x%" PRIx32 "\n",
+          ipv6_addr_to_str(addr_str, &(target->target), sizeof(addr_str)),
+          target->prefix_length,
+          fib_dst_flags);
+
+    fib_add_entry(&gnrc_ipv6_fib_table, dodag->iface, target->target.u8,
+                  sizeof(ipv6_addr_t), fib_dst_flags, src->u8,
+                  sizeof(ipv6_addr_t), FIB_FLAG_RPL_ROUTE,
+                  (dodag->default_lifetime * dodag->lifetime_unit) *
+                  MS_PER_SEC);
+}
+
 /** @todo allow target prefixes in target options to be of variable length */
 bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt, uint16_t len,
                     ipv6_addr_t *src, uint32_t *included_opts)
@@ -316,6 +341,11 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
     eui64_t iid;
     *included_opts = 0;
     ipv6_addr_t *me;
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+    /* the root of a non-storing DODAG keeps the downward routes itself */
+    bool ns_root = (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+                   (dodag->node_status == GNRC_RPL_ROOT_NODE);
+#endif
 
 #ifndef GNRC_RPL_WITHOUT_VALIDATION
     if (!gnrc_rpl_validation_options(msg_type, inst, opt, len)) {
@@ -393,22 +423,14 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     first_target = target;
                 }
 
-                uint32_t fib_dst_flags = 0;
-
-                if (target->prefix_length <= IPV6_ADDR_BIT_LEN) {
-                    fib_dst_flags = ((uint32_t)(target->prefix_length) << FIB_FLAG_NET_PREFIX_SHIFT);
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+                if (ns_root) {
+                    /* added with the parent of the following transit option */
+                    break;
                 }
+#endif
 
-                DEBUG("RPL: adding fib entry %s/%d 0x%" PRIx32 "\n",
-                      ipv6_addr_to_str(addr_str, &(target->target), sizeof(addr_str)),
-                      target->prefix_length,
-                      fib_dst_flags);
-
-                fib_add_entry(&gnrc_ipv6_fib_table, dodag->iface, target->target.u8,
-                              sizeof(ipv6_addr_t), fib_dst_flags, src->u8,
-                              sizeof(ipv6_addr_t), FIB_FLAG_RPL_ROUTE,
-                              (dodag->default_lifetime * dodag->lifetime_unit) *
-                              MS_PER_SEC);
+                _add_target_fib_entry(dodag, target, src);
                 break;
 
             case (GNRC_RPL_OPT_TRANSIT):
@@ -421,6 +443,37 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     break;
                 }
 
+#ifdef MODULE_GNRC_RPL_SRH_TREE
+                if (ns_root) {
+                    if (transit->length < (sizeof(gnrc_rpl_opt_transit_t) -
+                                           sizeof(gnrc_rpl_opt_t) + sizeof(ipv6_addr_t))) {
+                        /* no parent to build the tree with: route the
+                         * targets via the FIB like a storing node */
+                        DEBUG("RPL: non-storing RPL TRANSIT DAO option without "
+                              "parent address, using the FIB\n");
+                        for (gnrc_rpl_opt_target_t *t = first_target;
+                             t->type == GNRC_RPL_OPT_TARGET;
+                             t = (gnrc_rpl_opt_target_t *) (((uint8_t *) t) +
+                                 sizeof(gnrc_rpl_opt_t) + t->length)) {
+                            _add_target_fib_entry(dodag, t, src);
+                        }
+                    }
+                    else {
+                        ipv6_addr_t *parent = (ipv6_addr_t *)(transit + 1);
+                        do {
+                            gnrc_rpl_srh_tree_update(&first_target->target, parent,
+                                                     transit->path_lifetime *
+                                                     dodag->lifetime_unit);
+                            first_target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (first_target)) +
+                                           sizeof(gnrc_rpl_opt_t) + first_target->length);
+                        }
+                        while (first_target->type == GNRC_RPL_OPT_TARGET);
+                        first_target = NULL;
+                        break;
+                    }
+                }
+#endif
+
                 do {
                     DEBUG("RPL: updating fib entry %s/%d\n",
                           ipv6_addr_to_str(addr_str, &(first_target->target), sizeof(addr_str)),
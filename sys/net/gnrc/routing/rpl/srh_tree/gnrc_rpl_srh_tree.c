@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/gnrc/rpl/srh_tree.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if ENABLE_DEBUG
+static char addr_str[IPV6_ADDR_MAX_STR_LEN];
+#endif
+
+#if (GNRC_RPL_SRH_TREE_BUCKETS & (GNRC_RPL_SRH_TREE_BUCKETS - 1)) != 0
+#error "GNRC_RPL_SRH_TREE_BUCKETS must be a power of 2"
+#endif
+
+/* parent of a placeholder, and end of the hash chains and free list */
+#define NONE                (0xffff)
+/* parent of the children of the root */
+#define ROOT                (0xfffe)
+
+/* the compression fields of the header are 4 bit wide */
+#define COMPR_MAX           (15U)
+
+enum {
+    NODE_FREE = 0,
+    NODE_PLACEHOLDER,
+    NODE_ACTIVE,
+};
+
+typedef struct {
+    ipv6_addr_t addr;
+    uint32_t expires;           /* in seconds of _now */
+    uint16_t parent;            /* index, ROOT or NONE */
+    uint16_t next;              /* hash chain or free list */
+    uint16_t children;          /* nodes pointing to this as parent */
+    uint8_t state;
+} _node_t;
+
+typedef struct {
+    uint16_t node;              /* destination, NONE if unused */
+    uint16_t gen;               /* _gen the header was built in */
+    uint8_t size;
+    ipv6_addr_t first_hop;
+    uint8_t hdr[GNRC_RPL_SRH_TREE_HDR_MAX];
+} _cache_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+static ipv6_addr_t _root;
+static _node_t _nodes[GNRC_RPL_SRH_TREE_NUMOF];
+static uint16_t _buckets[GNRC_RPL_SRH_TREE_BUCKETS];
+static uint16_t _free;
+static unsigned _active;
+static uint32_t _now;
+static uint32_t _next_expiry;
+/* changes whenever a route may change */
+static uint16_t _gen;
+#if GNRC_RPL_SRH_TREE_CACHE_NUMOF
+static _cache_t _cache[GNRC_RPL_SRH_TREE_CACHE_NUMOF];
+static unsigned _cache_next;
+#endif
+
+static unsigned _hash(const ipv6_addr_t *addr)
+{
+    /* FNV-1a, the interface identifier differs most */
+    uint32_t h = 2166136261U;
+
+    for (unsigned i = sizeof(ipv6_addr_t); i > 0; i--) {
+        h = (h ^ addr->u8[i - 1]) * 16777619U;
+    }
+    return (h ^ (h >> 16)) & (GNRC_RPL_SRH_TREE_BUCKETS - 1);
+}
+
+static uint16_t _find(const ipv6_addr_t *addr)
+{
+    uint16_t i = _buckets[_hash(addr)];
+
+    while ((i != NONE) && !ipv6_addr_equal(&_nodes[i].addr, addr)) {
+        i = _nodes[i].next;
+    }
+    return i;
+}
+
+static uint16_t _alloc(const ipv6_addr_t *addr)
+{
+    uint16_t i = _free;
+
+    if (i == NONE) {
+        return NONE;
+    }
+    _node_t *node = &_nodes[i];
+    unsigned bucket = _hash(addr);
+
+    _free = node->next;
+    node->addr = *addr;
+    node->parent = NONE;
+    node->children = 0;
+    node->state = NODE_PLACEHOLDER;
+    node->next = _buckets[bucket];
+    _buckets[bucket] = i;
+    return i;
+}
+
+static void _unlink(uint16_t i)
+{
+    uint16_t *it = &_buckets[_hash(&_nodes[i].addr)];
+
+    while (*it != i) {
+        it = &_nodes[*it].next;
+    }
+    *it = _nodes[i].next;
+    _nodes[i].state = NODE_FREE;
+    _nodes[i].next = _free;
+    _free = i;
+}
+
+/* Releases a reference to a parent, placeholders are freed with the last */
+static void _put(uint16_t i)
+{
+    if ((--_nodes[i].children == 0) && (_nodes[i].state == NODE_PLACEHOLDER)) {
+        _unlink(i);
+    }
+}
+
+/* Turns a node into a placeholder, or frees it if nothing points to it */
+static void _detach(uint16_t i)
+{
+    _node_t *node = &_nodes[i];
+
+    if (node->state == NODE_ACTIVE) {
+        _active--;
+    }
+    node->state = NODE_PLACEHOLDER;
+    if (node->parent < ROOT) {
+        /* placeholders have no parent, so this never cascades further */
+        _put(node->parent);
+    }
+    node->parent = NONE;
+    if (node->children == 0) {
+        _unlink(i);
+    }
+}
+
+static void _set_parent(uint16_t i, uint16_t parent)
+{
+    uint16_t old = _nodes[i].parent;
+
+    if (parent < ROOT) {
+        _nodes[parent].children++;
+    }
+    _nodes[i].parent = parent;
+    if (old < ROOT) {
+        _put(old);
+    }
+}
+
+/* Starts a new generation, the cached headers of older ones are not used */
+static void _changed(void)
+{
+    _gen++;
+#if GNRC_RPL_SRH_TREE_CACHE_NUMOF
+    if (_gen == 0) {
+        /* wrapped, entries 65536 changes old would match again */
+        for (unsigned i = 0; i < GNRC_RPL_SRH_TREE_CACHE_NUMOF; i++) {
+            _cache[i].node = NONE;
+        }
+    }
+#endif
+}
+
+void gnrc_rpl_srh_tree_init(const ipv6_addr_t *root)
+{
+    mutex_lock(&_mutex);
+    _root = *root;
+    for (unsigned i = 0; i < GNRC_RPL_SRH_TREE_NUMOF; i++) {
+        _nodes[i].state = NODE_FREE;
+        _nodes[i].next = (i + 1 < GNRC_RPL_SRH_TREE_NUMOF) ? i + 1 : NONE;
+    }
+    _free = 0;
+    memset(_buckets, 0xff, sizeof(_buckets));
+    _active = 0;
+    _now = 0;
+    _next_expiry = UINT32_MAX;
+    _changed();
+#if GNRC_RPL_SRH_TREE_CACHE_NUMOF
+    for (unsigned i = 0; i < GNRC_RPL_SRH_TREE_CACHE_NUMOF; i++) {
+        _cache[i].node = NONE;
+    }
+#endif
+    mutex_unlock(&_mutex);
+}
+
+static int _remove(const ipv6_addr_t *target)
+{
+    uint16_t i = _find(target);
+
+    if ((i == NONE) || (_nodes[i].state != NODE_ACTIVE)) {
+        return -ENOENT;
+    }
+    DEBUG("RPL SRH tree: removing %s\n",
+          ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+    _detach(i);
+    _changed();
+    return 0;
+}
+
+int gnrc_rpl_srh_tree_update(const ipv6_addr_t *target, const ipv6_addr_t *parent,
+                             uint32_t lifetime)
+{
+    mutex_lock(&_mutex);
+    if (ipv6_addr_equal(target, &_root) || ipv6_addr_equal(target, parent)) {
+        mutex_unlock(&_mutex);
+        return -EINVAL;
+    }
+    if (lifetime == 0) {
+        _remove(target);
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+
+    uint16_t i = _find(target);
+    uint16_t p = ROOT;
+
+    if ((i == NONE) && ((i = _alloc(target)) == NONE)) {
+        mutex_unlock(&_mutex);
+        return -ENOMEM;
+    }
+    if (!ipv6_addr_equal(parent, &_root) && ((p = _find(parent)) == NONE) &&
+        ((p = _alloc(parent)) == NONE)) {
+        /* a new target is not kept without its parent */
+        if ((_nodes[i].state == NODE_PLACEHOLDER) && (_nodes[i].children == 0)) {
+            _unlink(i);
+        }
+        mutex_unlock(&_mutex);
+        return -ENOMEM;
+    }
+
+    DEBUG("RPL SRH tree: %s via %s for %" PRIu32 " s\n",
+          ipv6_addr_to_str(addr_str, target, sizeof(addr_str)),
+          ipv6_addr_to_str(addr_str, parent, sizeof(addr_str)), lifetime);
+
+    if (_nodes[i].state != NODE_ACTIVE) {
+        _nodes[i].state = NODE_ACTIVE;
+        _active++;
+    }
+    if (_nodes[i].parent != p) {
+        _set_parent(i, p);
+        _changed();
+    }
+    _nodes[i].expires = _now + lifetime;
+    if (_nodes[i].expires < _next_expiry) {
+        _next_expiry = _nodes[i].expires;
+    }
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+int gnrc_rpl_srh_tree_remove(const ipv6_addr_t *target)
+{
+    mutex_lock(&_mutex);
+    int res = _remove(target);
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+unsigned gnrc_rpl_srh_tree_expire(uint32_t elapsed)
+{
+    unsigned removed = 0;
+
+    mutex_lock(&_mutex);
+    _now += elapsed;
+    if (_now < _next_expiry) {
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+    _next_expiry = UINT32_MAX;
+    for (uint16_t i = 0; i < GNRC_RPL_SRH_TREE_NUMOF; i++) {
+        _node_t *node = &_nodes[i];
+
+        if (node->state != NODE_ACTIVE) {
+            continue;
+        }
+        if (node->expires <= _now) {
+            DEBUG("RPL SRH tree: %s expired\n",
+                  ipv6_addr_to_str(addr_str, &node->addr, sizeof(addr_str)));
+            _detach(i);
+            removed++;
+        }
+        else if (node->expires < _next_expiry) {
+            _next_expiry = node->expires;
+        }
+    }
+    if (removed > 0) {
+        _changed();
+    }
+    mutex_unlock(&_mutex);
+    return removed;
+}
+
+static unsigned _common_prefix(const ipv6_addr_t *a, const ipv6_addr_t *b)
+{
+    unsigned n = 0;
+
+    while ((n < COMPR_MAX) && (a->u8[n] == b->u8[n])) {
+        n++;
+    }
+    return n;
+}
+
+static int _build(uint16_t dst, ipv6_addr_t *first_hop, uint8_t *buf, size_t size)
+{
+    /* hops from the destination up to the first hop */
+    uint16_t path[GNRC_RPL_SRH_TREE_MAX_DEPTH];
+    unsigned depth = 0;
+
+    for (uint16_t i = dst; i != ROOT; i = _nodes[i].parent) {
+        if (_nodes[i].parent == NONE) {
+            return -EHOSTUNREACH;
+        }
+        if (depth == GNRC_RPL_SRH_TREE_MAX_DEPTH) {
+            return -ELOOP;
+        }
+        path[depth++] = i;
+    }
+    *first_hop = _nodes[path[depth - 1]].addr;
+    if (depth == 1) {
+        return 0;
+    }
+
+    /* every intermediate address shares the prefix elided by CmprI with
+     * every address that can be in the IPv6 header, the last one shares
+     * the prefix elided by CmprE */
+    const ipv6_addr_t *last = &_nodes[dst].addr;
+    unsigned compr_i = COMPR_MAX, compr_e = COMPR_MAX;
+
+    for (unsigned k = 1; k < depth; k++) {
+        const ipv6_addr_t *addr = &_nodes[path[k]].addr;
+        unsigned n = _common_prefix(addr, last);
+
+        compr_e = (n < compr_e) ? n : compr_e;
+        for (unsigned j = k + 1; j < depth; j++) {
+            n = _common_prefix(addr, &_nodes[path[j]].addr);
+            compr_i = (n < compr_i) ? n : compr_i;
+        }
+    }
+    if (depth == 2) {
+        /* no intermediate addresses */
+        compr_i = compr_e;
+    }
+
+    /* addresses after the first hop */
+    unsigned numof = depth - 1;
+    size_t len = sizeof(gnrc_rpl_srh_t) + ((numof - 1) * (sizeof(ipv6_addr_t) - compr_i)) +
+                 (sizeof(ipv6_addr_t) - compr_e);
+    unsigned pad = (8 - (len & 7)) & 7;
+
+    if (len + pad > size) {
+        return -ENOBUFS;
+    }
+
+    gnrc_rpl_srh_t *srh = (gnrc_rpl_srh_t *)buf;
+    uint8_t *vec = (uint8_t *)(srh + 1);
+
+    srh->nh = 0;
+    srh->len = ((len + pad) / 8) - 1;
+    srh->type = GNRC_RPL_SRH_TYPE;
+    srh->seg_left = numof;
+    srh->compr = (compr_i << 4) | compr_e;
+    srh->pad_resv = pad << 4;
+    srh->resv = 0;
+    for (unsigned k = depth - 1; k > 1; k--) {
+        const ipv6_addr_t *addr = &_nodes[path[k - 1]].addr;
+        memcpy(vec, &addr->u8[compr_i], sizeof(ipv6_addr_t) - compr_i);
+        vec += sizeof(ipv6_addr_t) - compr_i;
+    }
+    memcpy(vec, &last->u8[compr_e], sizeof(ipv6_addr_t) - compr_e);
+    memset(vec + sizeof(ipv6_addr_t) - compr_e, 0, pad);
+    return len + pad;
+}
+
+int gnrc_rpl_srh_tree_build(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                            gnrc_rpl_srh_t *srh, size_t size)
+{
+    int res;
+
+    mutex_lock(&_mutex);
+    uint16_t i = _find(dst);
+
+    if ((i == NONE) || (_nodes[i].state != NODE_ACTIVE)) {
+        mutex_unlock(&_mutex);
+        return -ENOENT;
+    }
+#if GNRC_RPL_SRH_TREE_CACHE_NUMOF
+    _cache_t *entry = NULL;
+
+    for (unsigned k = 0; k < GNRC_RPL_SRH_TREE_CACHE_NUMOF; k++) {
+        if ((_cache[k].node == i) && (_cache[k].gen == _gen)) {
+            entry = &_cache[k];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        /* replaced in turn, entries of older generations are dead anyway */
+        entry = &_cache[_cache_next];
+        entry->node = NONE;
+        if ((res = _build(i, &entry->first_hop, entry->hdr, sizeof(entry->hdr))) < 0) {
+            mutex_unlock(&_mutex);
+            return res;
+        }
+        _cache_next = (_cache_next + 1) % GNRC_RPL_SRH_TREE_CACHE_NUMOF;
+        entry->node = i;
+        entry->gen = _gen;
+        entry->size = res;
+    }
+    res = entry->size;
+    if ((size_t)res > size) {
+        res = -ENOBUFS;
+    }
+    else {
+        *first_hop = entry->first_hop;
+        if (res > 0) {
+            memcpy(srh, entry->hdr, res);
+        }
+    }
+#else
+    res = _build(i, first_hop, (uint8_t *)srh, size);
+#endif
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+unsigned gnrc_rpl_srh_tree_numof(void)
+{
+    return _active;
+}
+
+/** @} */
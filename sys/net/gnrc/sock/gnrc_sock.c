@@ -111,6 +111,34 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
     return 0;
 }
 
+gnrc_pktsnip_t *gnrc_sock_pkt_from_iov(const struct iovec *vector, unsigned count)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+
+    /* gnrc_pktbuf_add() prepends, so the chain is built from its end */
+    while (count-- > 0) {
+        gnrc_pktsnip_t *snip;
+
+        if ((vector[count].iov_len == 0) && ((pkt != NULL) || (count > 0))) {
+            continue;
+        }
+        snip = gnrc_pktbuf_add(pkt, vector[count].iov_base, vector[count].iov_len,
+                               GNRC_NETTYPE_UNDEF);
+        if (snip == NULL) {
+            if (pkt != NULL) {
+                gnrc_pktbuf_release(pkt);
+            }
+            return NULL;
+        }
+        pkt = snip;
+    }
+    if (pkt == NULL) {
+        /* empty payload */
+        pkt = gnrc_pktbuf_add(NULL, NULL, 0, GNRC_NETTYPE_UNDEF);
+    }
+    return pkt;
+}
+
 ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
                        const sock_ip_ep_t *remote, uint8_t nh)
 {
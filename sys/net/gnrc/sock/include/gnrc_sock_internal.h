@@ -24,6 +24,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <sys/uio.h>
 #include "mbox.h"
 #include "net/af.h"
 #include "net/gnrc.h"
@@ -115,6 +116,15 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt, uint32_t time
  */
 ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
                        const sock_ip_ep_t *remote, uint8_t nh);
+
+/**
+ * @brief   Copy buffers into a chain of payload snips, one per buffer
+ * @internal
+ *
+ * @return  the first snip of the chain
+ * @return  NULL, if no memory was available
+ */
+gnrc_pktsnip_t *gnrc_sock_pkt_from_iov(const struct iovec *vector, unsigned count);
 /**
  * @}
  */
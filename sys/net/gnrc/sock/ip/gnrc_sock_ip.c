@@ -125,6 +125,15 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
 
 ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
                      uint8_t proto, const sock_ip_ep_t *remote)
+{
+    const struct iovec vector = { .iov_base = (void *)data, .iov_len = len };
+
+    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
+    return sock_ip_sendv(sock, &vector, 1, proto, remote);
+}
+
+ssize_t sock_ip_sendv(sock_ip_t *sock, const struct iovec *vector,
+                      unsigned count, uint8_t proto, const sock_ip_ep_t *remote)
 {
     int res;
     gnrc_pktsnip_t *pkt;
@@ -132,7 +141,6 @@ ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
     sock_ip_ep_t rem;
 
     assert((sock != NULL) || (remote != NULL));
-    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
     if ((remote != NULL) && (sock != NULL) &&
         (sock->local.netif != SOCK_ADDR_ANY_NETIF) &&
         (remote->netif != SOCK_ADDR_ANY_NETIF) &&
@@ -185,7 +193,7 @@ ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
          * there was no remote given on create, take from local */
         rem.family = local.family;
     }
-    pkt = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    pkt = gnrc_sock_pkt_from_iov(vector, count);
     if (pkt == NULL) {
         return -ENOMEM;
     }
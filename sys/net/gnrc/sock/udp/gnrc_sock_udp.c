@@ -211,6 +211,15 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
 
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
                       const sock_udp_ep_t *remote)
+{
+    const struct iovec vector = { .iov_base = (void *)data, .iov_len = len };
+
+    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
+    return sock_udp_sendv(sock, &vector, 1, remote);
+}
+
+ssize_t sock_udp_sendv(sock_udp_t *sock, const struct iovec *vector,
+                       unsigned count, const sock_udp_ep_t *remote)
 {
     int res;
     gnrc_pktsnip_t *payload, *pkt;
@@ -219,7 +228,6 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
     sock_ip_ep_t *rem;
 
     assert((sock != NULL) || (remote != NULL));
-    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
 
     if (remote != NULL) {
         if (remote->port == 0) {
@@ -289,7 +297,7 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
         return -EINVAL;
     }
     /* generate payload and header snips */
-    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    payload = gnrc_sock_pkt_from_iov(vector, count);
     if (payload == NULL) {
         return -ENOMEM;
     }
@@ -209,6 +209,35 @@ void gnrc_tcp_tcb_init(gnrc_tcp_tcb_t *tcb)
     mutex_init(&(tcb->function_lock));
 }
 
+int gnrc_tcp_tcb_set_rcvbuf(gnrc_tcp_tcb_t *tcb, void *buf, size_t size)
+{
+    assert(tcb != NULL);
+
+    int ret = 0;
+
+    if (buf != NULL && (size == 0 || size > ((size_t) UINT16_MAX << OPTION_WSCALE_MAX))) {
+        return -EINVAL;
+    }
+
+    mutex_lock(&(tcb->function_lock));
+    if (tcb->state != FSM_STATE_CLOSED) {
+        ret = -EISCONN;
+    }
+    else if (buf != NULL) {
+        tcb->rcv_buf_raw = buf;
+        tcb->status |= STATUS_RCVBUF_USER;
+    }
+    else if (tcb->status & STATUS_RCVBUF_USER) {
+        tcb->rcv_buf_raw = NULL;
+        tcb->status &= ~STATUS_RCVBUF_USER;
+    }
+    if (ret == 0) {
+        tcb->rcv_buf_size = size;
+    }
+    mutex_unlock(&(tcb->function_lock));
+    return ret;
+}
+
 int gnrc_tcp_open_active(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
                          const uint8_t *target_addr, const uint16_t target_port,
                          const uint16_t local_port)
@@ -299,8 +328,8 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         xtimer_set_msg(&user_timeout_timer, timeout_duration_us, &user_timeout_msg, tcb->owner);
     }
 
-    /* Loop until something was sent and acked */
-    while (ret == 0 || tcb->pkt_retransmit != NULL) {
+    /* Loop until something was sent. Sent data is acknowledged in the background */
+    while (ret == 0) {
         /* Check if the connections state is closed. If so, a reset was received */
         if (tcb->state == FSM_STATE_CLOSED) {
             ret = -ECONNRESET;
@@ -321,8 +350,11 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         }
 
         /* Try to send data if nothing has been sent and we are not probing */
-        if (ret == 0 && !probing) {
+        if (!probing) {
             ret = _fsm(tcb, FSM_EVENT_CALL_SEND, NULL, (void *) data, len);
+            if (ret != 0) {
+                break;
+            }
         }
 
         /* Wait for responses */
@@ -336,7 +368,6 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
 
             case MSG_TYPE_USER_SPEC_TIMEOUT:
                 DEBUG("gnrc_tcp.c : gnrc_tcp_send() : USER_SPEC_TIMEOUT\n");
-                _fsm(tcb, FSM_EVENT_CLEAR_RETRANSMIT, NULL, NULL, 0);
                 ret = -ETIMEDOUT;
                 break;
 
@@ -450,8 +481,7 @@ ssize_t gnrc_tcp_recv(gnrc_tcp_tcb_t *tcb, void *data, const size_t max_len,
                     break;
 
                 case MSG_TYPE_USER_SPEC_TIMEOUT:
-                    DEBUG("gnrc_tcp.c : gnrc_tcp_send() : USER_SPEC_TIMEOUT\n");
-                    _fsm(tcb, FSM_EVENT_CLEAR_RETRANSMIT, NULL, NULL, 0);
+                    DEBUG("gnrc_tcp.c : gnrc_tcp_recv() : USER_SPEC_TIMEOUT\n");
                     ret = -ETIMEDOUT;
                     break;
 
@@ -37,6 +37,15 @@
  */
 #define TCB_EQUAL(a,b)      ((a) != (b))
 
+#if GNRC_TCP_RETRANSMIT_QUEUE_SIZE < 2
+#error "GNRC_TCP_RETRANSMIT_QUEUE_SIZE must be at least 2"
+#endif
+
+/**
+ * @brief Number of duplicate ACKs that trigger a fast retransmit (see RFC 5681)
+ */
+#define DUP_ACK_THRESHOLD   (3U)
+
 /**
  * @brief Checks if a given port number is currently used by a TCB as local_port.
  *
@@ -80,14 +89,194 @@ static uint16_t _get_random_local_port(void)
  */
 static int _clear_retransmit(gnrc_tcp_tcb_t *tcb)
 {
-    if (tcb->pkt_retransmit != NULL) {
-        gnrc_pktbuf_release(tcb->pkt_retransmit);
+    if (tcb->rtx_numof > 0) {
         xtimer_remove(&(tcb->tim_tout));
-        tcb->pkt_retransmit = NULL;
+        while (tcb->rtx_numof > 0) {
+            gnrc_pktbuf_release(tcb->rtx_queue[tcb->rtx_head]);
+            tcb->rtx_queue[tcb->rtx_head] = NULL;
+            tcb->rtx_head = (tcb->rtx_head + 1) % GNRC_TCP_RETRANSMIT_QUEUE_SIZE;
+            tcb->rtx_numof -= 1;
+        }
     }
+    tcb->status &= ~(STATUS_RTT_PENDING | STATUS_FAST_RECOVERY | STATUS_RTO_RECOVERY);
     return 0;
 }
 
+/**
+ * @brief Calculates the sender maximum segment size (SMSS).
+ *
+ * @param[in] tcb   TCB holding the connection information.
+ *
+ * @returns   The smaller one of the own and the peers MSS.
+ */
+static uint32_t _smss(const gnrc_tcp_tcb_t *tcb)
+{
+    /* If the peer did not announce a MSS, use our own */
+    if (tcb->mss == 0 || tcb->mss > GNRC_TCP_MSS) {
+        return GNRC_TCP_MSS;
+    }
+    return tcb->mss;
+}
+
+/**
+ * @brief Limits the congestion window to what the retransmit queue can keep in flight.
+ *
+ * @param[in,out] tcb   TCB holding the congestion control state.
+ */
+static void _limit_cwnd(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t max = (GNRC_TCP_RETRANSMIT_QUEUE_SIZE - 1) * _smss(tcb);
+
+    if (tcb->cwnd > max) {
+        tcb->cwnd = max;
+    }
+}
+
+/**
+ * @brief Initializes congestion control, once the peers MSS is known.
+ *
+ * @param[in,out] tcb   TCB holding the congestion control state.
+ */
+static void _init_congestion_control(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = _smss(tcb);
+
+    /* Initial window (see RFC 5681 3.1) */
+    if (smss > 2190) {
+        tcb->cwnd = 2 * smss;
+    }
+    else if (smss > 1095) {
+        tcb->cwnd = 3 * smss;
+    }
+    else {
+        tcb->cwnd = 4 * smss;
+    }
+    _limit_cwnd(tcb);
+    tcb->ssthresh = UINT32_MAX;
+    tcb->recover = tcb->snd_una;
+    tcb->dup_acks = 0;
+}
+
+/**
+ * @brief Retransmits the oldest unacknowledged packet without backing off the RTO.
+ *
+ * @param[in,out] tcb   TCB holding the retransmit queue.
+ */
+static void _retransmit_first(gnrc_tcp_tcb_t *tcb)
+{
+    gnrc_pktsnip_t *pkt = tcb->rtx_queue[tcb->rtx_head];
+
+    /* Increase users: every send attempt consumes a user */
+    gnrc_pktbuf_hold(pkt, 1);
+    _pkt_send(tcb, pkt, 0, true);
+}
+
+/**
+ * @brief Reduces the slow start threshold after a loss (see RFC 5681 equation 4).
+ *
+ * @param[in,out] tcb   TCB holding the congestion control state.
+ */
+static void _reduce_ssthresh(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t flight = tcb->snd_nxt - tcb->snd_una;
+    uint32_t smss = _smss(tcb);
+
+    tcb->ssthresh = (flight / 2 > 2 * smss) ? flight / 2 : 2 * smss;
+    tcb->recover = tcb->snd_nxt;
+    tcb->dup_acks = 0;
+}
+
+/**
+ * @brief Congestion control for an ACK of new data (see RFC 5681 and RFC 6582).
+ *
+ * @note Must be called after snd_una was advanced and the acknowledged packets were
+ *       removed from the retransmit queue.
+ *
+ * @param[in,out] tcb     TCB holding the congestion control state.
+ * @param[in]     acked   Number of newly acknowledged bytes.
+ */
+static void _cc_ack(gnrc_tcp_tcb_t *tcb, const uint32_t acked)
+{
+    uint32_t smss = _smss(tcb);
+
+    tcb->dup_acks = 0;
+    if (tcb->status & STATUS_FAST_RECOVERY) {
+        /* Full ACK: Deflate the window and leave fast recovery */
+        if (LEQ_32_BIT(tcb->recover, tcb->snd_una)) {
+            uint32_t flight = tcb->snd_nxt - tcb->snd_una;
+
+            flight = ((flight > smss) ? flight : smss) + smss;
+            tcb->cwnd = (flight < tcb->ssthresh) ? flight : tcb->ssthresh;
+            tcb->status &= ~STATUS_FAST_RECOVERY;
+        }
+        /* Partial ACK: The next segment was lost as well, retransmit it */
+        else {
+            _retransmit_first(tcb);
+            tcb->cwnd = (tcb->cwnd > acked) ? tcb->cwnd - acked : 0;
+            if (acked >= smss) {
+                tcb->cwnd += smss;
+            }
+            if (tcb->cwnd < smss) {
+                tcb->cwnd = smss;
+            }
+        }
+        tcb->status |= STATUS_NOTIFY_USER;
+        return;
+    }
+
+    /* After a timeout all segments sent before it are retransmitted one per ACK */
+    if (tcb->status & STATUS_RTO_RECOVERY) {
+        if (LSS_32_BIT(tcb->snd_una, tcb->recover) && tcb->rtx_numof > 0) {
+            _retransmit_first(tcb);
+        }
+        else {
+            tcb->status &= ~STATUS_RTO_RECOVERY;
+        }
+    }
+
+    /* Slow start */
+    if (tcb->cwnd < tcb->ssthresh) {
+        tcb->cwnd += (acked < smss) ? acked : smss;
+    }
+    /* Congestion avoidance: Grow by about one SMSS per round trip */
+    else {
+        uint32_t inc = (smss * smss) / tcb->cwnd;
+        tcb->cwnd += (inc > 0) ? inc : 1;
+    }
+    _limit_cwnd(tcb);
+    tcb->status |= STATUS_NOTIFY_USER;
+}
+
+/**
+ * @brief Congestion control for a duplicate ACK (see RFC 5681 and RFC 6582).
+ *
+ * @param[in,out] tcb   TCB holding the congestion control state.
+ */
+static void _cc_dup_ack(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = _smss(tcb);
+
+    /* Inflate the window for every segment that left the network */
+    if (tcb->status & STATUS_FAST_RECOVERY) {
+        tcb->cwnd += smss;
+        tcb->status |= STATUS_NOTIFY_USER;
+        return;
+    }
+
+    /* Don't start a new recovery for losses of the last one (see RFC 6582 3.2) */
+    if (tcb->dup_acks >= DUP_ACK_THRESHOLD || LSS_32_BIT(tcb->snd_una, tcb->recover)) {
+        return;
+    }
+
+    /* Fast retransmit on the third duplicate ACK, enter fast recovery */
+    if (++tcb->dup_acks == DUP_ACK_THRESHOLD) {
+        _reduce_ssthresh(tcb);
+        _retransmit_first(tcb);
+        tcb->cwnd = tcb->ssthresh + DUP_ACK_THRESHOLD * smss;
+        tcb->status |= STATUS_FAST_RECOVERY;
+    }
+}
+
 /**
  * @brief Restarts timewait timer.
  *
@@ -189,6 +378,10 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
             break;
 
         case FSM_STATE_ESTABLISHED:
+            _init_congestion_control(tcb);
+            tcb->status |= STATUS_NOTIFY_USER;
+            break;
+
         case FSM_STATE_CLOSE_WAIT:
             tcb->status |= STATUS_NOTIFY_USER;
             break;
@@ -220,7 +413,6 @@ static int _fsm_call_open(gnrc_tcp_tcb_t *tcb)
     int ret = 0;                        /* Return value */
 
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_open()\n");
-    tcb->rcv_wnd = GNRC_TCP_DEFAULT_WINDOW;
 
     if (tcb->status & STATUS_PASSIVE) {
         /* Passive open, T: CLOSED -> LISTEN */
@@ -253,34 +445,57 @@ static int _fsm_call_open(gnrc_tcp_tcb_t *tcb)
 /**
  * @brief FSM Handling function for sending data.
  *
+ * @note Sends segments as long as the send and the congestion window allow it.
+ *       One entry of the retransmit queue is kept free for the FIN.
+ *
  * @param[in,out] tcb   TCB holding the connection information.
  * @param[in,out] buf   Buffer containing data to send.
  * @param[in]     len   Maximum Number of Bytes to send from @p buf.
  *
  * @returns   Number of successfully transmitted bytes.
+ *            -ENOMEM if nothing could be sent because the packet buffer is full.
  */
 static int _fsm_call_send(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
 {
     gnrc_pktsnip_t *out_pkt = NULL;     /* Outgoing packet */
     uint16_t seq_con = 0;               /* Sequence number consumption (out_pkt) */
+    uint32_t smss = _smss(tcb);         /* Sender maximum segment size */
+    size_t sent = 0;                    /* Number of bytes sent */
 
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_send()\n");
-    size_t payload = (tcb->snd_una + tcb->snd_wnd) - tcb->snd_nxt;
+    while (sent < len && tcb->rtx_numof < GNRC_TCP_RETRANSMIT_QUEUE_SIZE - 1) {
+        uint32_t flight = tcb->snd_nxt - tcb->snd_una;
+        uint32_t wnd = (tcb->snd_wnd < tcb->cwnd) ? tcb->snd_wnd : tcb->cwnd;
+
+        /* Check if window is open */
+        if (wnd <= flight) {
+            break;
+        }
 
-    /* Check if window is open and all packets were transmitted */
-    if (payload > 0 && tcb->snd_wnd > 0 && tcb->pkt_retransmit == NULL) {
         /* Calculate segment size */
-        payload = (payload < GNRC_TCP_MSS) ? payload : GNRC_TCP_MSS;
-        payload = (payload < tcb->mss) ? payload : tcb->mss;
-        payload = (payload < len) ? payload : len;
+        size_t payload = wnd - flight;
+        payload = (payload < smss) ? payload : smss;
+        payload = (payload < len - sent) ? payload : len - sent;
 
-        /* Calculate payload size for this segment */
-        _pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK, tcb->snd_nxt, tcb->rcv_nxt, buf, payload);
+        /* Avoid the silly window syndrome: Wait for ACKs instead of sending a small */
+        /* segment, if the data would fill a bigger one (see RFC 1122 4.2.3.4) */
+        if (flight > 0 && payload < smss && payload < len - sent) {
+            break;
+        }
+
+        /* Build segment, wait for ACKs to free the packet buffer if that fails */
+        if (_pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK, tcb->snd_nxt, tcb->rcv_nxt,
+                       (uint8_t *) buf + sent, payload) < 0) {
+            if (sent == 0 && tcb->rtx_numof == 0) {
+                return -ENOMEM;
+            }
+            break;
+        }
         _pkt_setup_retransmit(tcb, out_pkt, false);
         _pkt_send(tcb, out_pkt, seq_con, false);
-        return payload;
+        sent += payload;
     }
-    return 0;
+    return sent;
 }
 
 /**
@@ -296,18 +511,30 @@ static int _fsm_call_recv(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
 {
     gnrc_pktsnip_t *out_pkt = NULL;     /* Outgoing packet */
     uint16_t seq_con = 0;               /* Sequence number consumption of outgoing packet */
+    size_t thresh = 0;                  /* Minimal window increase worth announcing */
 
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_recv()\n");
     if (ringbuffer_empty(&tcb->rcv_buf)) {
         return 0;
     }
 
+    /* Less than one segment fit into the buffer: The window limited the peer */
+    thresh = (tcb->rcv_buf.size / 2 < GNRC_TCP_MSS) ? tcb->rcv_buf.size / 2 : GNRC_TCP_MSS;
+    bool full = (ringbuffer_get_free(&tcb->rcv_buf) < thresh);
+
     /* Read data into 'buf' up to 'len' bytes from receive buffer */
     size_t rcvd = ringbuffer_get(&(tcb->rcv_buf), buf, len);
 
-    /* If receive buffer can store more than GNRC_TCP_MSS: open window to available buffer size */
-    if (ringbuffer_get_free(&tcb->rcv_buf) >= GNRC_TCP_MSS) {
-        tcb->rcv_wnd = ringbuffer_get_free(&(tcb->rcv_buf));
+    /* If the window limited the peer although the user keeps up: Use a larger buffer */
+    if (full && ringbuffer_empty(&tcb->rcv_buf)) {
+        _rcvbuf_grow_buffer(tcb);
+        thresh = (tcb->rcv_buf.size / 2 < GNRC_TCP_MSS) ? tcb->rcv_buf.size / 2 : GNRC_TCP_MSS;
+    }
+
+    /* Open window if it grew by min(buffer / 2, MSS) bytes (see RFC 1122 4.2.3.3) */
+    size_t wnd = ringbuffer_get_free(&tcb->rcv_buf);
+    if (wnd > tcb->rcv_wnd && wnd - tcb->rcv_wnd >= thresh) {
+        tcb->rcv_wnd = wnd;
 
         /* Send ACK to anounce window update */
         _pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK, tcb->snd_nxt, tcb->rcv_nxt, NULL, 0);
@@ -399,6 +626,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
     seg_ack = byteorder_ntohl(tcp_hdr->ack_num);
     seg_wnd = byteorder_ntohs(tcp_hdr->window);
 
+    /* The window of a SYN is never scaled (see RFC 7323 2.2) */
+    if (!(ctl & MSK_SYN)) {
+        seg_wnd <<= tcb->snd_wscale;
+    }
+
     /* Extract network layer header */
 #ifdef MODULE_GNRC_IPV6
     LL_SEARCH_SCALAR(in_pkt, snp, type, GNRC_NETTYPE_IPV6);
@@ -471,6 +703,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
             tcb->snd_nxt = tcb->iss;
             tcb->snd_wnd = seg_wnd;
 
+            /* Scale the own window only if the peer offered window scaling as well */
+            if (!(tcb->status & STATUS_WSCALE)) {
+                tcb->rcv_wscale = 0;
+            }
+
             /* Send SYN+ACK: seq_no = iss, ack_no = rcv_nxt, T: LISTEN -> SYN_RCVD */
             _pkt_build(tcb, &out_pkt, &seq_con, MSK_SYN_ACK, tcb->iss, tcb->rcv_nxt, NULL, 0);
             _pkt_setup_retransmit(tcb, out_pkt, false);
@@ -505,6 +742,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
         if (ctl & MSK_SYN) {
             tcb->rcv_nxt = seg_seq + 1;
             tcb->irs = seg_seq;
+
+            /* Scale the own window only if the peer answered with window scaling */
+            if (!(tcb->status & STATUS_WSCALE)) {
+                tcb->rcv_wscale = 0;
+            }
             if (ctl & MSK_ACK) {
                 tcb->snd_una = seg_ack;
                 _pkt_acknowledge(tcb, seg_ack);
@@ -596,8 +838,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 tcb->state == FSM_STATE_CLOSING || tcb->state == FSM_STATE_LAST_ACK) {
                 /* Acknowledge previously sent data */
                 if (LSS_32_BIT(tcb->snd_una, seg_ack) && LEQ_32_BIT(seg_ack, tcb->snd_nxt)) {
+                    uint32_t acked = seg_ack - tcb->snd_una;
+
                     tcb->snd_una = seg_ack;
                     _pkt_acknowledge(tcb, seg_ack);
+                    _cc_ack(tcb, acked);
                 }
                 /* ACK received for something not yet sent: Reply with pure ACK */
                 else if (LSS_32_BIT(tcb->snd_nxt, seg_ack)) {
@@ -606,6 +851,11 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                     _pkt_send(tcb, out_pkt, seq_con, false);
                     return 0;
                 }
+                /* Duplicate ACK: No data, same window and data in flight (see RFC 5681) */
+                else if (seg_ack == tcb->snd_una && pay_len == 0 && !(ctl & MSK_FIN) &&
+                         seg_wnd == tcb->snd_wnd && tcb->rtx_numof > 0) {
+                    _cc_dup_ack(tcb);
+                }
                 /* Update receive window */
                 if (LEQ_32_BIT(tcb->snd_una, seg_ack) && LEQ_32_BIT(seg_ack, tcb->snd_nxt)) {
                     if (LSS_32_BIT(tcb->snd_wl1, seg_seq) || (tcb->snd_wl1 == seg_seq &&
@@ -621,25 +871,25 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 /* Additional processing */
                 /* Check additionaly if previously sent FIN was acknowledged */
                 if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_numof == 0) {
                         _transition_to(tcb, FSM_STATE_FIN_WAIT_2);
                     }
                 }
                 /* If retransmission queue is empty, acknowledge close operation */
                 if (tcb->state == FSM_STATE_FIN_WAIT_2) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_numof == 0) {
                         /* Optional: Unblock user close operation */
                     }
                 }
                 /* If our FIN has been acknowledged: Transition to TIME_WAIT */
                 if (tcb->state == FSM_STATE_CLOSING) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_numof == 0) {
                         _transition_to(tcb, FSM_STATE_TIME_WAIT);
                     }
                 }
                 /* If our FIN was acknowledged and status is LAST_ACK: close connection */
                 if (tcb->state == FSM_STATE_LAST_ACK) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->rtx_numof == 0) {
                         _transition_to(tcb, FSM_STATE_CLOSED);
                         return 0;
                     }
@@ -693,7 +943,7 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 _transition_to(tcb, FSM_STATE_CLOSE_WAIT);
             }
             else if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                if (tcb->pkt_retransmit == NULL) {
+                if (tcb->rtx_numof == 0) {
                     _transition_to(tcb, FSM_STATE_TIME_WAIT);
                 }
                 else {
@@ -735,9 +985,17 @@ static int _fsm_timeout_timewait(gnrc_tcp_tcb_t *tcb)
 static int _fsm_timeout_retransmit(gnrc_tcp_tcb_t *tcb)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit()\n");
-    if (tcb->pkt_retransmit != NULL) {
-        _pkt_setup_retransmit(tcb, tcb->pkt_retransmit, true);
-        _pkt_send(tcb, tcb->pkt_retransmit, 0, true);
+    if (tcb->rtx_numof > 0) {
+        gnrc_pktsnip_t *pkt = tcb->rtx_queue[tcb->rtx_head];
+
+        /* Restart with one segment, resend everything that was in flight (see RFC 5681 3.1) */
+        _reduce_ssthresh(tcb);
+        tcb->cwnd = _smss(tcb);
+        tcb->status &= ~STATUS_FAST_RECOVERY;
+        tcb->status |= STATUS_RTO_RECOVERY;
+
+        _pkt_setup_retransmit(tcb, pkt, true);
+        _pkt_send(tcb, pkt, 0, true);
     }
     else {
         DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit() : Retransmit queue is empty\n");
@@ -24,8 +24,16 @@
 
 int _option_parse(gnrc_tcp_tcb_t *tcb, tcp_hdr_t *hdr)
 {
+    uint16_t ctl = byteorder_ntohs(hdr->off_ctl);
+
+    /* Window scaling is negotiated in the SYN segments only, start over on every SYN */
+    if (ctl & MSK_SYN) {
+        tcb->status &= ~STATUS_WSCALE;
+        tcb->snd_wscale = 0;
+    }
+
     /* Extract offset value. Return if no options are set */
-    uint8_t offset = GET_OFFSET(byteorder_ntohs(hdr->off_ctl));
+    uint8_t offset = GET_OFFSET(ctl);
     if (offset <= TCP_HDR_OFFSET_MIN) {
         return 0;
     }
@@ -60,10 +68,31 @@ int _option_parse(gnrc_tcp_tcb_t *tcb, tcp_hdr_t *hdr)
                       tcb->mss);
                 break;
 
+            case TCP_OPTION_KIND_WS:
+                if (option->length != TCP_OPTION_LENGTH_WS) {
+                    DEBUG("gnrc_tcp_option.c : _option_parse() : invalid WS Option length.\n");
+                    return -1;
+                }
+                if (ctl & MSK_SYN) {
+                    tcb->snd_wscale = option->value[0];
+                    if (tcb->snd_wscale > OPTION_WSCALE_MAX) {
+                        tcb->snd_wscale = OPTION_WSCALE_MAX;
+                    }
+                    tcb->status |= STATUS_WSCALE;
+                }
+                DEBUG("gnrc_tcp_option.c : _option_parse() : WS option found. WS=%"PRIu8"\n",
+                      option->value[0]);
+                break;
+
             default:
                 DEBUG("gnrc_tcp_option.c : _option_parse() : Unknown option found.\
                       KIND=%"PRIu8", LENGTH=%"PRIu8"\n", option->kind, option->length);
         }
+        /* Options with a length field span at least kind and length */
+        if (option->length < 2 || option->length > opt_left) {
+            DEBUG("gnrc_tcp_option.c : _option_parse() : invalid option length.\n");
+            return -1;
+        }
         opt_ptr += option->length;
         opt_left -= option->length;
     }
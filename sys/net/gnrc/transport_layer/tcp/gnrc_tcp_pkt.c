@@ -46,6 +46,24 @@ static inline uint32_t _max(const uint32_t x, const uint32_t y)
   return (x > y) ? x : y;
 }
 
+/**
+ * @brief Calculates the window field of an outgoing segment.
+ *
+ * @param[in] tcb   TCB holding the connection information.
+ * @param[in] ctl   Control bits of the outgoing segment.
+ *
+ * @returns   The receive window, scaled unless @p ctl contains SYN (see RFC 7323 2.2).
+ */
+static uint16_t _pkt_get_wnd(const gnrc_tcp_tcb_t *tcb, const uint16_t ctl)
+{
+    uint32_t wnd = tcb->rcv_wnd;
+
+    if (!(ctl & MSK_SYN)) {
+        wnd >>= tcb->rcv_wscale;
+    }
+    return (wnd > UINT16_MAX) ? UINT16_MAX : wnd;
+}
+
 int _pkt_build_reset_from_pkt(gnrc_pktsnip_t **out_pkt, gnrc_pktsnip_t *in_pkt)
 {
     tcp_hdr_t tcp_hdr_out;
@@ -140,7 +158,7 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
     tcp_hdr.checksum = byteorder_htons(0);
     tcp_hdr.seq_num = byteorder_htonl(seq_num);
     tcp_hdr.ack_num = byteorder_htonl(ack_num);
-    tcp_hdr.window = byteorder_htons(tcb->rcv_wnd);
+    tcp_hdr.window = byteorder_htons(_pkt_get_wnd(tcb, ctl));
     tcp_hdr.urgent_ptr = byteorder_htons(0);
 
     /* Calculate option field size. */
@@ -148,11 +166,16 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
     if (ctl & MSK_SYN) {
         offset += 1;
     }
+    /* Add window scale option if SYN is sent, to a SYN+ACK only if the peer sent it */
+    bool wscale = (ctl & MSK_SYN) && (!(ctl & MSK_ACK) || (tcb->status & STATUS_WSCALE));
+    if (wscale) {
+        offset += 1;
+    }
     /* Set offset and control bit accordingly */
     tcp_hdr.off_ctl = byteorder_htons(_option_build_offset_control(offset, ctl));
 
     /* Allocate TCP header: size = offset * 4 bytes */
-    tcp_snp = gnrc_pktbuf_add(pay_snp, &tcp_hdr, offset * 4, GNRC_NETTYPE_TCP);
+    tcp_snp = gnrc_pktbuf_add(pay_snp, NULL, offset * 4, GNRC_NETTYPE_TCP);
     if (tcp_snp == NULL) {
         DEBUG("gnrc_tcp_pkt.c : _pkt_build() : Can't allocate buffer for TCP Header\n.");
         gnrc_pktbuf_release(pay_snp);
@@ -160,6 +183,8 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
         return -ENOMEM;
     }
     else {
+        memcpy(tcp_snp->data, &tcp_hdr, sizeof(tcp_hdr));
+
         /* Add options if existing */
         if (TCP_HDR_OFFSET_MIN < offset) {
             uint8_t *opt_ptr = (uint8_t *) tcp_snp->data + sizeof(tcp_hdr);
@@ -172,6 +197,13 @@ int _pkt_build(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t **out_pkt, uint16_t *seq_con,
             if (ctl & MSK_SYN) {
                 network_uint32_t mss_option = byteorder_htonl(_option_build_mss(GNRC_TCP_MSS));
                 memcpy(opt_ptr, &mss_option, sizeof(mss_option));
+                opt_ptr += sizeof(mss_option);
+            }
+            /* If window scaling is offered: Add window scale option */
+            if (wscale) {
+                network_uint32_t ws_option = byteorder_htonl(_option_build_wscale(tcb->rcv_wscale));
+                memcpy(opt_ptr, &ws_option, sizeof(ws_option));
+                opt_ptr += sizeof(ws_option);
             }
             /* Increase opt_ptr and decrease opt_ptr, if other options are added */
             /* NOTE: Add additional options here */
@@ -219,12 +251,20 @@ int _pkt_send(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *out_pkt, const uint16_t seq_c
 
     /* If this is no retransmission, advance sequence number and measure time */
     if (!retransmit) {
-        tcb->retries = 0;
         tcb->snd_nxt += seq_con;
-        tcb->rtt_start = xtimer_now().ticks32;
+
+        /* Time one segment per round trip: its ACK ends the measurement */
+        if (seq_con > 0 && !(tcb->status & STATUS_RTT_PENDING)) {
+            tcb->status |= STATUS_RTT_PENDING;
+            tcb->rtt_seq = tcb->snd_nxt;
+            tcb->rtt_start = xtimer_now().ticks32;
+        }
     }
     else {
         tcb->retries += 1;
+
+        /* Retransmitted data must not be timed (Karns Algorithm) */
+        tcb->status &= ~STATUS_RTT_PENDING;
     }
 
     /* Pass packet down the network stack */
@@ -296,6 +336,58 @@ uint32_t _pkt_get_pay_len(gnrc_pktsnip_t *pkt)
     return seg_len;
 }
 
+/**
+ * @brief Extracts the sequence number of a packet.
+ *
+ * @param[in] pkt   Packet to extract the sequence number from.
+ *
+ * @returns   Sequence number of @p pkt.
+ */
+static uint32_t _pkt_get_seq_num(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *snp = NULL;
+
+    LL_SEARCH_SCALAR(pkt, snp, type, GNRC_NETTYPE_TCP);
+    return byteorder_ntohl(((tcp_hdr_t *) snp->data)->seq_num);
+}
+
+/**
+ * @brief Starts the retransmission timer with the current RTO.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+static void _pkt_start_retransmit_timer(gnrc_tcp_tcb_t *tcb)
+{
+    /* Perform boundry checks on current RTO before usage */
+    if (tcb->rto < (int32_t) GNRC_TCP_RTO_LOWER_BOUND) {
+        tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
+    }
+    else if (tcb->rto > (int32_t) GNRC_TCP_RTO_UPPER_BOUND) {
+        tcb->rto = GNRC_TCP_RTO_UPPER_BOUND;
+    }
+
+    /* Setup retransmission timer, msg to TCP thread with ptr to TCB */
+    tcb->msg_tout.type = MSG_TYPE_RETRANSMISSION;
+    tcb->msg_tout.content.ptr = (void *) tcb;
+    xtimer_set_msg(&tcb->tim_tout, tcb->rto, &tcb->msg_tout, gnrc_tcp_pid);
+}
+
+/**
+ * @brief Calculates the RTO from the current round trip time estimation.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+static void _pkt_calc_rto(gnrc_tcp_tcb_t *tcb)
+{
+    /* If there is no estimation yet: rto is 1 sec (Lower Bound) */
+    if (tcb->srtt == RTO_UNINITIALIZED || tcb->rtt_var == RTO_UNINITIALIZED) {
+        tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
+    }
+    else {
+        tcb->rto = tcb->srtt + _max(GNRC_TCP_RTO_GRANULARITY,  GNRC_TCP_RTO_K * tcb->rtt_var);
+    }
+}
+
 int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool retransmit)
 {
     gnrc_pktsnip_t *snp = NULL;
@@ -308,10 +400,27 @@ int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool r
         return -EINVAL;
     }
 
-    /* Check if retransmit queue is full and pkt is not already in retransmit queue */
-    if (tcb->pkt_retransmit != NULL && tcb->pkt_retransmit != pkt) {
-        DEBUG("gnrc_tcp_pkt.c : _pkt_setup_retransmit() : Nothing to do\n");
-        return -ENOMEM;
+    /* A retransmission is always the oldest packet in the retransmit queue */
+    if (retransmit) {
+        if (tcb->rtx_numof == 0 || tcb->rtx_queue[tcb->rtx_head] != pkt) {
+            DEBUG("gnrc_tcp_pkt.c : _pkt_setup_retransmit() : pkt is not the oldest\n");
+            return -EINVAL;
+        }
+
+        /* Increase users: every send attempt consumes a user */
+        gnrc_pktbuf_hold(pkt, 1);
+
+        /* Double the rto (Timer Backoff) */
+        tcb->rto *= 2;
+
+        /* If the transmission has been tried five times, we assume srtt and rtt_var are bogus */
+        /* New measurements must be taken the next time something is sent. */
+        if (tcb->retries >= 5) {
+            tcb->srtt = RTO_UNINITIALIZED;
+            tcb->rtt_var = RTO_UNINITIALIZED;
+        }
+        _pkt_start_retransmit_timer(tcb);
+        return 0;
     }
 
     /* Extract control bits and segment length */
@@ -324,76 +433,63 @@ int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool r
         return 0;
     }
 
-    /* Assign pkt and increase users: every send attempt consumes a user */
-    tcb->pkt_retransmit = pkt;
-    gnrc_pktbuf_hold(pkt, 1);
-
-    /* RTO adjustment */
-    if (!retransmit) {
-        /* If this is the first transmission: rto is 1 sec (Lower Bound) */
-        if (tcb->srtt == RTO_UNINITIALIZED || tcb->rtt_var == RTO_UNINITIALIZED) {
-            tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
-        }
-        else {
-            tcb->rto = tcb->srtt + _max(GNRC_TCP_RTO_GRANULARITY,  GNRC_TCP_RTO_K * tcb->rtt_var);
-        }
+    /* Check if retransmit queue is full */
+    if (tcb->rtx_numof >= GNRC_TCP_RETRANSMIT_QUEUE_SIZE) {
+        DEBUG("gnrc_tcp_pkt.c : _pkt_setup_retransmit() : Retransmit queue is full\n");
+        return -ENOMEM;
     }
-    else {
-        /* If this is a retransmission: Double the rto (Timer Backoff) */
-        tcb->rto *= 2;
 
-        /* If the transmission has been tried five times, we assume srtt and rtt_var are bogus */
-        /* New measurements must be taken the next time something is sent. */
-        if (tcb->retries >= 5) {
-            tcb->srtt = RTO_UNINITIALIZED;
-            tcb->rtt_var = RTO_UNINITIALIZED;
-        }
-    }
+    /* Append pkt and increase users: every send attempt consumes a user */
+    tcb->rtx_queue[(tcb->rtx_head + tcb->rtx_numof) % GNRC_TCP_RETRANSMIT_QUEUE_SIZE] = pkt;
+    tcb->rtx_numof += 1;
+    gnrc_pktbuf_hold(pkt, 1);
 
-    /* Perform boundry checks on current RTO before usage */
-    if (tcb->rto < (int32_t) GNRC_TCP_RTO_LOWER_BOUND) {
-        tcb->rto = GNRC_TCP_RTO_LOWER_BOUND;
+    /* The timer covers the oldest packet, start it if there was nothing in flight */
+    if (tcb->rtx_numof == 1) {
+        _pkt_calc_rto(tcb);
+        _pkt_start_retransmit_timer(tcb);
     }
-    else if (tcb->rto > (int32_t) GNRC_TCP_RTO_UPPER_BOUND) {
-        tcb->rto = GNRC_TCP_RTO_UPPER_BOUND;
-    }
-
-    /* Setup retransmission timer, msg to TCP thread with ptr to TCB */
-    tcb->msg_tout.type = MSG_TYPE_RETRANSMISSION;
-    tcb->msg_tout.content.ptr = (void *) tcb;
-    xtimer_set_msg(&tcb->tim_tout, tcb->rto, &tcb->msg_tout, gnrc_tcp_pid);
     return 0;
 }
 
 int _pkt_acknowledge(gnrc_tcp_tcb_t *tcb, const uint32_t ack)
 {
     uint32_t seg = 0;
-    gnrc_pktsnip_t *snp = NULL;
-    tcp_hdr_t *hdr;
+    gnrc_pktsnip_t *pkt = NULL;
+    bool acked = false;
 
     /* Retransmission queue is empty. Nothing to ACK there */
-    if (tcb->pkt_retransmit == NULL) {
+    if (tcb->rtx_numof == 0) {
         DEBUG("gnrc_tcp_pkt.c : _pkt_acknowledge() : There is no packet to ack\n");
         return -ENODATA;
     }
 
-    LL_SEARCH_SCALAR(tcb->pkt_retransmit, snp, type, GNRC_NETTYPE_TCP);
-    hdr = (tcp_hdr_t *) snp->data;
-
-    /* There must be a packet, waiting to be acknowledged. */
-    seg = byteorder_ntohl(hdr->seq_num) + _pkt_get_seg_len(tcb->pkt_retransmit) - 1;
-
-    /* If segment can be acknowledged -> stop timer, release packet from pktbuf and update rto. */
-    if (LSS_32_BIT(seg, ack)) {
-        xtimer_remove(&(tcb->tim_tout));
-        gnrc_pktbuf_release(tcb->pkt_retransmit);
-        tcb->pkt_retransmit = NULL;
+    /* Release all packets that are acknowledged completely, oldest first */
+    while (tcb->rtx_numof > 0) {
+        pkt = tcb->rtx_queue[tcb->rtx_head];
+        seg = _pkt_get_seq_num(pkt) + _pkt_get_seg_len(pkt) - 1;
+        if (!LSS_32_BIT(seg, ack)) {
+            break;
+        }
+        gnrc_pktbuf_release(pkt);
+        tcb->rtx_queue[tcb->rtx_head] = NULL;
+        tcb->rtx_head = (tcb->rtx_head + 1) % GNRC_TCP_RETRANSMIT_QUEUE_SIZE;
+        tcb->rtx_numof -= 1;
+        acked = true;
+    }
+    if (!acked) {
+        return 0;
+    }
+    tcb->retries = 0;
 
-        /* Measure round trip time */
+    /* Measure round trip time if the timed segment was acknowledged */
+    if ((tcb->status & STATUS_RTT_PENDING) && LEQ_32_BIT(tcb->rtt_seq, ack)) {
         int32_t rtt = xtimer_now().ticks32 - tcb->rtt_start;
 
-        /* Use time only if ther was no timer overflow and no retransmission (Karns Alogrithm) */
-        if (tcb->retries == 0 && rtt > 0) {
+        tcb->status &= ~STATUS_RTT_PENDING;
+
+        /* Use time only if there was no timer overflow */
+        if (rtt > 0) {
             /* If this is the first sample taken */
             if (tcb->srtt == RTO_UNINITIALIZED && tcb->rtt_var == RTO_UNINITIALIZED) {
                 tcb->srtt = rtt;
@@ -408,6 +504,13 @@ int _pkt_acknowledge(gnrc_tcp_tcb_t *tcb, const uint32_t ack)
             }
         }
     }
+
+    /* Restart the timer for the remaining packets (see RFC 6298 5.3) */
+    xtimer_remove(&(tcb->tim_tout));
+    if (tcb->rtx_numof > 0) {
+        _pkt_calc_rto(tcb);
+        _pkt_start_retransmit_timer(tcb);
+    }
     return 0;
 }
 
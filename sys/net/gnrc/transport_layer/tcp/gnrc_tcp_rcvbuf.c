@@ -16,16 +16,51 @@
  * @author      Simon Brummer <simon.brummer@posteo.de>
  */
 #include <errno.h>
+#include <string.h>
+#include "internal/common.h"
+#include "internal/option.h"
 #include "internal/rcvbuf.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+#if (GNRC_TCP_RCV_BUFFERS > UINT8_MAX) || (GNRC_TCP_RCV_BUFFERS_LARGE > UINT8_MAX)
+#error "At most 255 receive buffers per size class are supported"
+#endif
+
 /**
  * @brief Internal struct holding receive buffers.
  */
 rcvbuf_t _static_buf;
 
+/**
+ * @brief Storage and free index stacks of the size classes.
+ * @{
+ */
+static uint8_t _small_bufs[GNRC_TCP_RCV_BUFFERS][GNRC_TCP_RCV_BUF_SIZE];
+static uint8_t _small_free[GNRC_TCP_RCV_BUFFERS];
+#if GNRC_TCP_RCV_BUFFERS_LARGE > 0
+static uint8_t _large_bufs[GNRC_TCP_RCV_BUFFERS_LARGE][GNRC_TCP_RCV_BUF_SIZE_LARGE];
+static uint8_t _large_free[GNRC_TCP_RCV_BUFFERS_LARGE];
+#endif
+/** @} */
+
+/**
+ * @brief Initializes a size class, all buffers are free.
+ */
+static void _rcvbuf_init_class(rcvbuf_class_t *cls, uint8_t *buffers, size_t size,
+                               uint8_t *free_idx, uint8_t numof)
+{
+    cls->buffers = buffers;
+    cls->size = size;
+    cls->free = free_idx;
+    cls->free_numof = numof;
+    for (uint8_t i = 0; i < numof; ++i) {
+        /* Hand out the first buffer first */
+        free_idx[i] = numof - 1 - i;
+    }
+}
+
 /**
  * @brief Initializes all receive buffers.
  */
@@ -33,69 +68,151 @@ void _rcvbuf_init(void)
 {
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_init() : entry\n");
     mutex_init(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        _static_buf.entries[i].used = 0;
-    }
+    _rcvbuf_init_class(&_static_buf.classes[0], &_small_bufs[0][0], GNRC_TCP_RCV_BUF_SIZE,
+                       _small_free, GNRC_TCP_RCV_BUFFERS);
+#if GNRC_TCP_RCV_BUFFERS_LARGE > 0
+    _rcvbuf_init_class(&_static_buf.classes[1], &_large_bufs[0][0], GNRC_TCP_RCV_BUF_SIZE_LARGE,
+                       _large_free, GNRC_TCP_RCV_BUFFERS_LARGE);
+#endif
 }
 
 /**
- * @brief Allocate receive buffer.
+ * @brief Allocate a receive buffer of a size class.
+ *
+ * @note Must be called with the lock held.
+ *
+ * @param[in,out] cls   Size class to allocate from.
  *
  * @returns   Not NULL if a receive buffer was allocated.
- *            NULL if allocation failed.
+ *            NULL if all buffers of @p cls are used.
  */
-static void* _rcvbuf_alloc(void)
+static uint8_t *_rcvbuf_alloc(rcvbuf_class_t *cls)
 {
-    void *result = NULL;
-    DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_alloc() : Entry\n");
-    mutex_lock(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        if (_static_buf.entries[i].used == 0) {
-            _static_buf.entries[i].used = 1;
-            result = (void *)(_static_buf.entries[i].buffer);
-            break;
-        }
+    if (cls->free_numof == 0) {
+        return NULL;
     }
-    mutex_unlock(&(_static_buf.lock));
-    return result;
+    cls->free_numof -= 1;
+    return cls->buffers + (cls->free[cls->free_numof] * cls->size);
 }
 
 /**
  * @brief Release allocated receive buffer.
  *
+ * @note Must be called with the lock held.
+ *
  * @param[in] buf   Pointer to buffer that should be released.
  */
-static void _rcvbuf_free(void * const buf)
+static void _rcvbuf_free(uint8_t * const buf)
 {
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_free() : Entry\n");
-    mutex_lock(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        if ((_static_buf.entries[i].used == 1) && (buf == _static_buf.entries[i].buffer)) {
-            _static_buf.entries[i].used = 0;
+    for (unsigned i = 0; i < RCVBUF_CLASSES; ++i) {
+        rcvbuf_class_t *cls = &_static_buf.classes[i];
+        size_t numof = (i == 0) ? GNRC_TCP_RCV_BUFFERS : GNRC_TCP_RCV_BUFFERS_LARGE;
+
+        if (cls->buffers <= buf && buf < cls->buffers + (numof * cls->size)) {
+            cls->free[cls->free_numof] = (buf - cls->buffers) / cls->size;
+            cls->free_numof += 1;
+            return;
         }
     }
-    mutex_unlock(&(_static_buf.lock));
+}
+
+/**
+ * @brief Assigns a buffer to the TCB and opens the receive window.
+ */
+static void _rcvbuf_assign(gnrc_tcp_tcb_t *tcb, uint8_t *buf, size_t size)
+{
+    tcb->rcv_buf_raw = buf;
+    ringbuffer_init(&tcb->rcv_buf, (char *) buf, size);
+    tcb->rcv_wnd = size;
 }
 
 int _rcvbuf_get_buffer(gnrc_tcp_tcb_t *tcb)
 {
+    uint8_t *buf = NULL;
+    size_t size = 0;
+    size_t max_size = _static_buf.classes[RCVBUF_CLASSES - 1].size;
+
+    /* Reuse the buffer supplied by the user */
+    if (tcb->status & STATUS_RCVBUF_USER) {
+        _rcvbuf_assign(tcb, tcb->rcv_buf_raw, tcb->rcv_buf_size);
+        tcb->rcv_wscale = _option_calc_wscale(tcb->rcv_buf_size);
+        return 0;
+    }
+
     if (tcb->rcv_buf_raw == NULL) {
-        tcb->rcv_buf_raw = _rcvbuf_alloc();
-        if (tcb->rcv_buf_raw == NULL) {
+        mutex_lock(&(_static_buf.lock));
+        /* Take the smallest buffer that is large enough ... */
+        for (unsigned i = 0; i < RCVBUF_CLASSES && buf == NULL; ++i) {
+            if (_static_buf.classes[i].size >= tcb->rcv_buf_size) {
+                buf = _rcvbuf_alloc(&_static_buf.classes[i]);
+                size = _static_buf.classes[i].size;
+            }
+        }
+        /* ... or the largest smaller one */
+        for (unsigned i = RCVBUF_CLASSES; i > 0 && buf == NULL; --i) {
+            buf = _rcvbuf_alloc(&_static_buf.classes[i - 1]);
+            size = _static_buf.classes[i - 1].size;
+        }
+        mutex_unlock(&(_static_buf.lock));
+
+        if (buf == NULL) {
             DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_get_buffer() : Can't allocate rcv_buf_raw\n");
             return -ENOMEM;
         }
-        else {
-            ringbuffer_init(&tcb->rcv_buf, (char *) tcb->rcv_buf_raw, GNRC_TCP_RCV_BUF_SIZE);
+        _rcvbuf_assign(tcb, buf, size);
+    }
+    /* The buffer can grow to the largest class later */
+    tcb->rcv_wscale = _option_calc_wscale(max_size);
+    return 0;
+}
+
+int _rcvbuf_grow_buffer(gnrc_tcp_tcb_t *tcb)
+{
+    uint8_t *buf = NULL;
+    size_t size = 0;
+
+    if ((tcb->status & STATUS_RCVBUF_USER) || tcb->rcv_buf_raw == NULL) {
+        return -ENOMEM;
+    }
+
+    mutex_lock(&(_static_buf.lock));
+    for (unsigned i = 0; i < RCVBUF_CLASSES && buf == NULL; ++i) {
+        if (_static_buf.classes[i].size > tcb->rcv_buf.size) {
+            buf = _rcvbuf_alloc(&_static_buf.classes[i]);
+            size = _static_buf.classes[i].size;
         }
     }
+    if (buf == NULL) {
+        mutex_unlock(&(_static_buf.lock));
+        return -ENOMEM;
+    }
+
+    /* Move the unread data to the beginning of the new buffer */
+    unsigned avail = ringbuffer_get(&tcb->rcv_buf, (char *) buf, tcb->rcv_buf.size);
+    _rcvbuf_free(tcb->rcv_buf_raw);
+    mutex_unlock(&(_static_buf.lock));
+
+    DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_grow_buffer() : %u -> %u bytes\n",
+          tcb->rcv_buf.size, (unsigned) size);
+    /* The announced window stays as it is, the caller announces the larger one */
+    uint32_t rcv_wnd = tcb->rcv_wnd;
+    _rcvbuf_assign(tcb, buf, size);
+    tcb->rcv_buf.avail = avail;
+    tcb->rcv_wnd = rcv_wnd;
     return 0;
 }
 
 void _rcvbuf_release_buffer(gnrc_tcp_tcb_t *tcb)
 {
+    /* A buffer supplied by the user stays assigned */
+    if (tcb->status & STATUS_RCVBUF_USER) {
+        return;
+    }
     if (tcb->rcv_buf_raw != NULL) {
+        mutex_lock(&(_static_buf.lock));
         _rcvbuf_free(tcb->rcv_buf_raw);
+        mutex_unlock(&(_static_buf.lock));
         tcb->rcv_buf_raw = NULL;
     }
 }
@@ -22,6 +22,7 @@
 #ifndef GNRC_TCP_INTERNAL_OPTION_H
 #define GNRC_TCP_INTERNAL_OPTION_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include "assert.h"
 #include "net/tcp.h"
@@ -44,6 +45,41 @@ inline static uint32_t _option_build_mss(uint16_t mss)
             ((uint32_t) TCP_OPTION_LENGTH_MSS << 16) | mss);
 }
 
+/**
+ * @brief Largest window scale shift count (see RFC 7323 2.3).
+ */
+#define OPTION_WSCALE_MAX (14U)
+
+/**
+ * @brief Helper function to build the window scale option, preceded by a NOP.
+ *
+ * @param[in] shift   Window scale shift count that should be set.
+ *
+ * @returns   NOP and window scale option value.
+ */
+inline static uint32_t _option_build_wscale(uint8_t shift)
+{
+    return (((uint32_t) TCP_OPTION_KIND_NOP << 24) | ((uint32_t) TCP_OPTION_KIND_WS << 16) |
+            ((uint32_t) TCP_OPTION_LENGTH_WS << 8) | shift);
+}
+
+/**
+ * @brief Calculates the shift count needed to announce a window of a given size.
+ *
+ * @param[in] size   Largest receive window that should be announced.
+ *
+ * @returns   Smallest shift count that fits @p size into 16 bit.
+ */
+inline static uint8_t _option_calc_wscale(size_t size)
+{
+    uint8_t shift = 0;
+
+    while ((size >> shift) > UINT16_MAX && shift < OPTION_WSCALE_MAX) {
+        shift += 1;
+    }
+    return shift;
+}
+
 /**
  * @brief Helper function to build the combined option and control flag field.
  *
@@ -61,6 +97,9 @@ inline static uint16_t _option_build_offset_control(uint16_t nopts, uint16_t ctl
 /**
  * @brief Parses options of a given TCP header.
  *
+ * @note The window scale option is only accepted in SYN segments. Receiving a SYN resets
+ *       the window scaling state of @p tcb.
+ *
  * @param[in,out] tcb   TCB holding the connection information.
  * @param[in]     hdr   TCP header to be parsed.
  *
@@ -110,18 +110,25 @@ uint32_t _pkt_get_pay_len(gnrc_pktsnip_t *pkt);
 /**
  * @brief Adds a packet to the retransmission mechanism.
  *
+ * @note The retransmission timer covers the oldest packet in the queue. It is started
+ *       if @p pkt is the only packet in the queue. A retransmission of the oldest packet
+ *       backs off the RTO and restarts the timer.
+ *
  * @param[in,out] tcb          TCB holding the connection information.
  * @param[in]     pkt          Packet to add to the retransmission mechanism.
  * @param[in]     retransmit   Flag used to indicate that @p pkt is a retransmit.
  *
  * @returns   Zero on success.
  *            -ENOMEM if the retransmission queue is full.
- *            -EINVAL if pkt is null.
+ *            -EINVAL if pkt is null or a retransmit of a packet that is not the oldest.
  */
 int _pkt_setup_retransmit(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *pkt, const bool retransmit);
 
 /**
- * @brief Acknowledges and removes packet from the retransmission mechanism.
+ * @brief Acknowledges and removes packets from the retransmission mechanism.
+ *
+ * @note Releases all packets that are covered by @p ack, samples the round trip time
+ *       and restarts the retransmission timer if packets remain in the queue.
  *
  * @param[in,out] tcb   TCB holding the connection information.
  * @param[in]     ack   Acknowldegment number used to acknowledge packets.
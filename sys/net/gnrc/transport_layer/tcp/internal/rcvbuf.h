@@ -32,19 +32,30 @@ extern "C" {
 #endif
 
 /**
- * @brief Receive buffer entry.
+ * @brief Number of receive buffer size classes.
  */
-typedef struct rcvbuf_entry {
-    uint8_t used;                          /**< Flag: Is buffer in use? */
-    uint8_t buffer[GNRC_TCP_RCV_BUF_SIZE]; /**< Receive buffer storage */
-} rcvbuf_entry_t;
+#if GNRC_TCP_RCV_BUFFERS_LARGE > 0
+#define RCVBUF_CLASSES (2U)
+#else
+#define RCVBUF_CLASSES (1U)
+#endif
+
+/**
+ * @brief Receive buffers of one size.
+ */
+typedef struct rcvbuf_class {
+    uint8_t *buffers;     /**< Storage of all buffers of this class */
+    size_t size;          /**< Size of each buffer */
+    uint8_t *free;        /**< Stack of the indices of free buffers */
+    uint8_t free_numof;   /**< Number of free buffers */
+} rcvbuf_class_t;
 
 /**
  * @brief   Stuct holding receive buffers.
  */
 typedef struct rcvbuf {
-    mutex_t lock;                                 /**< Lock for allocation synchronization */
-    rcvbuf_entry_t entries[GNRC_TCP_RCV_BUFFERS]; /**< Maintained receive buffers */
+    mutex_t lock;                            /**< Lock for allocation synchronization */
+    rcvbuf_class_t classes[RCVBUF_CLASSES];  /**< Size classes, smallest first */
 } rcvbuf_t;
 
 /**
@@ -55,6 +66,11 @@ void _rcvbuf_init(void);
 /**
  * @brief Allocate receive buffer and assign it to TCB.
  *
+ * @note A buffer supplied with gnrc_tcp_tcb_set_rcvbuf() is reused. Otherwise the buffer is
+ *       taken from the smallest size class that holds tcb->rcv_buf_size bytes, or from the
+ *       largest smaller class if none is left. Sets the receive window and the own window
+ *       scale shift count accordingly.
+ *
  * @param[in,out] tcb   TCB that aquires receive buffer.
  *
  * @returns   Zero  on success.
@@ -62,6 +78,16 @@ void _rcvbuf_init(void);
  */
 int _rcvbuf_get_buffer(gnrc_tcp_tcb_t *tcb);
 
+/**
+ * @brief Moves the contents of the receive buffer to a buffer of the next larger size class.
+ *
+ * @param[in,out] tcb   TCB holding the receive buffer that should grow.
+ *
+ * @returns   Zero on success.
+ *            -ENOMEM if there is no larger buffer left or the buffer was supplied by the user.
+ */
+int _rcvbuf_grow_buffer(gnrc_tcp_tcb_t *tcb);
+
 /**
  * @brief Release allocated receive buffer.
  *
@@ -231,6 +231,9 @@ static void *_event_loop(void *arg)
     msg_init_queue(msg_queue, GNRC_UDP_MSG_QUEUE_SIZE);
     /* register UPD at netreg */
     gnrc_netreg_register(GNRC_NETTYPE_UDP, &netreg);
+#ifdef MODULE_GNRC_NETAPI_BATCH
+    gnrc_netapi_batch_register(sched_active_pid);
+#endif
 
     /* dispatch NETAPI messages */
     while (1) {
@@ -244,6 +247,24 @@ static void *_event_loop(void *arg)
                 DEBUG("udp: GNRC_NETAPI_MSG_TYPE_SND\n");
                 _send(msg.content.ptr);
                 break;
+#ifdef MODULE_GNRC_NETAPI_BATCH
+            case GNRC_NETAPI_MSG_TYPE_RCV_BATCH:
+            case GNRC_NETAPI_MSG_TYPE_SND_BATCH: {
+                gnrc_pktsnip_t *chain = msg.content.ptr, *pkt;
+
+                DEBUG("udp: GNRC_NETAPI_MSG_TYPE_%s_BATCH\n",
+                      (msg.type == GNRC_NETAPI_MSG_TYPE_RCV_BATCH) ? "RCV" : "SND");
+                while ((pkt = gnrc_netapi_batch_pop(&chain))) {
+                    if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV_BATCH) {
+                        _receive(pkt);
+                    }
+                    else {
+                        _send(pkt);
+                    }
+                }
+                break;
+            }
+#endif
             case GNRC_NETAPI_MSG_TYPE_SET:
             case GNRC_NETAPI_MSG_TYPE_GET:
                 msg_reply(&msg, &reply);
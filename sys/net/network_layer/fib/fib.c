@@ -36,6 +36,7 @@
 
 #include "net/fib.h"
 #include "net/fib/table.h"
+#include "fib_trie.h"
 
 #ifdef MODULE_IPV6_ADDR
 #include "net/ipv6/addr.h"
@@ -65,6 +66,32 @@ static void fib_lifetime_to_absolute(uint32_t ms, uint64_t *target)
     *target = xtimer_now_usec64() + (ms * US_PER_MS);
 }
 
+static int fib_remove(fib_table_t *table, fib_entry_t *entry);
+
+/**
+ * @brief removes the entries of all lifetime wheel slots that passed
+ *
+ * This is done whenever the table is changed, so lookups only have to
+ * check the lifetime of the entry they found.
+ *
+ * @param[in] table     the FIB table
+ */
+static void fib_purge_expired(fib_table_t *table)
+{
+#ifdef MODULE_FIB_TRIE
+    if (fib_trie_enabled(table)) {
+        uint64_t now = xtimer_now_usec64();
+        fib_entry_t *expired;
+
+        while ((expired = fib_trie_pop_expired(table, now)) != NULL) {
+            fib_remove(table, expired);
+        }
+    }
+#else
+    (void)table;
+#endif
+}
+
 /**
  * @brief returns pointer to the entry for the given destination address
  *
@@ -97,6 +124,26 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
     DEBUG("\n");
 #endif
 
+#ifdef MODULE_FIB_TRIE
+    if (fib_trie_enabled(table)) {
+        while ((ret = fib_trie_find(table, dst, dst_size, entry_arr)) >= 0) {
+            if ((entry_arr[0]->lifetime == FIB_LIFETIME_NO_EXPIRE) ||
+                (entry_arr[0]->lifetime >= now)) {
+                *entry_arr_size = 1;
+                return ret;
+            }
+            /* expired, but its wheel slot was not purged yet */
+            fib_remove(table, entry_arr[0]);
+        }
+        if (ret != -ENOTSUP) {
+            *entry_arr_size = 0;
+            return -EHOSTUNREACH;
+        }
+        /* not all entries are indexed => fall back to linear search */
+        ret = -EHOSTUNREACH;
+    }
+#endif
+
     for (size_t i = 0; i < dst_size; ++i) {
         if (dst[i] != 0) {
             is_all_zeros_addr = false;
@@ -112,20 +159,7 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
             /* check if the lifetime expired */
             if (table->data.entries[i].lifetime < now) {
                 /* remove this entry if its lifetime expired */
-                table->data.entries[i].lifetime = 0;
-                table->data.entries[i].global_flags = 0;
-                table->data.entries[i].next_hop_flags = 0;
-                table->data.entries[i].iface_id = KERNEL_PID_UNDEF;
-
-                if (table->data.entries[i].global != NULL) {
-                    universal_address_rem(table->data.entries[i].global);
-                    table->data.entries[i].global = NULL;
-                }
-
-                if (table->data.entries[i].next_hop != NULL) {
-                    universal_address_rem(table->data.entries[i].next_hop);
-                    table->data.entries[i].next_hop = NULL;
-                }
+                fib_remove(table, &table->data.entries[i]);
             }
         }
 
@@ -192,6 +226,7 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
 /**
  * @brief updates the next hop the lifetime and the interface id for a given entry
  *
+ * @param[in] table          the FIB table the entry belongs to
  * @param[in] entry          the entry to be updated
  * @param[in] next_hop       the next hop address to be updated
  * @param[in] next_hop_size  the next hop address size
@@ -201,7 +236,7 @@ static int fib_find_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
  * @return 0 if the entry has been updated
  *         -ENOMEM if the entry cannot be updated due to insufficient RAM
  */
-static int fib_upd_entry(fib_entry_t *entry, uint8_t *next_hop,
+static int fib_upd_entry(fib_table_t *table, fib_entry_t *entry, uint8_t *next_hop,
                          size_t next_hop_size, uint32_t next_hop_flags,
                          uint32_t lifetime)
 {
@@ -214,13 +249,26 @@ static int fib_upd_entry(fib_entry_t *entry, uint8_t *next_hop,
     universal_address_rem(entry->next_hop);
     entry->next_hop = container;
     entry->next_hop_flags = next_hop_flags;
+    table->version++;
 
+#ifdef MODULE_FIB_TRIE
+    if (fib_trie_enabled(table)) {
+        fib_trie_wheel_unlink(table, entry);
+    }
+#else
+    (void)table;
+#endif
     if (lifetime != (uint32_t)FIB_LIFETIME_NO_EXPIRE) {
         fib_lifetime_to_absolute(lifetime, &entry->lifetime);
     }
     else {
         entry->lifetime = FIB_LIFETIME_NO_EXPIRE;
     }
+#ifdef MODULE_FIB_TRIE
+    if (fib_trie_enabled(table)) {
+        fib_trie_wheel_link(table, entry);
+    }
+#endif
 
     return 0;
 }
@@ -260,6 +308,7 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
             if (table->data.entries[i].next_hop != NULL) {
                 /* everything worked fine */
                 table->data.entries[i].iface_id = iface_id;
+                table->version++;
 
                 if (lifetime != (uint32_t) FIB_LIFETIME_NO_EXPIRE) {
                     fib_lifetime_to_absolute(lifetime, &table->data.entries[i].lifetime);
@@ -267,6 +316,11 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
                 else {
                     table->data.entries[i].lifetime = FIB_LIFETIME_NO_EXPIRE;
                 }
+#ifdef MODULE_FIB_TRIE
+                if (fib_trie_enabled(table)) {
+                    fib_trie_add(table, &table->data.entries[i]);
+                }
+#endif
 
                 return 0;
             }
@@ -279,12 +333,20 @@ static int fib_create_entry(fib_table_t *table, kernel_pid_t iface_id,
 /**
  * @brief removes the given entry
  *
+ * @param[in] table the FIB table the entry belongs to
  * @param[in] entry the entry to be removed
  *
  * @return 0 on success
  */
-static int fib_remove(fib_entry_t *entry)
+static int fib_remove(fib_table_t *table, fib_entry_t *entry)
 {
+#ifdef MODULE_FIB_TRIE
+    if (fib_trie_enabled(table) && (entry->global != NULL)) {
+        fib_trie_remove(table, entry);
+    }
+#else
+    (void)table;
+#endif
     if (entry->global != NULL) {
         universal_address_rem(entry->global);
     }
@@ -300,6 +362,7 @@ static int fib_remove(fib_entry_t *entry)
 
     entry->iface_id = KERNEL_PID_UNDEF;
     entry->lifetime = 0;
+    table->version++;
 
     return 0;
 }
@@ -399,11 +462,13 @@ int fib_add_entry(fib_table_t *table,
         return -EFAULT;
     }
 
+    fib_purge_expired(table);
+
     int ret = fib_find_entry(table, dst, dst_size, &(entry[0]), &count);
 
     if (ret == 1) {
         /* we must take the according entry and update the values */
-        ret = fib_upd_entry(entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
+        ret = fib_upd_entry(table, entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
     }
     else {
         ret = fib_create_entry(table, iface_id, dst, dst_size, dst_flags,
@@ -430,10 +495,12 @@ int fib_update_entry(fib_table_t *table, uint8_t *dst, size_t dst_size,
         return -EFAULT;
     }
 
+    fib_purge_expired(table);
+
     if (fib_find_entry(table, dst, dst_size, &(entry[0]), &count) == 1) {
         DEBUG("[fib_update_entry] found entry: %p\n", (void *)(entry[0]));
         /* we must take the according entry and update the values */
-        ret = fib_upd_entry(entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
+        ret = fib_upd_entry(table, entry[0], next_hop, next_hop_size, next_hop_flags, lifetime);
     }
     else {
         /* we have ambiguous entries, i.e. count > 1
@@ -453,11 +520,13 @@ void fib_remove_entry(fib_table_t *table, uint8_t *dst, size_t dst_size)
     size_t count = 1;
     fib_entry_t *entry[count];
 
+    fib_purge_expired(table);
+
     int ret = fib_find_entry(table, dst, dst_size, &(entry[0]), &count);
 
     if (ret == 1) {
         /* we must take the according entry and update the values */
-        fib_remove(entry[0]);
+        fib_remove(table, entry[0]);
     }
     else {
         /* we have ambiguous entries, i.e. count > 1
@@ -477,7 +546,7 @@ void fib_flush(fib_table_t *table, kernel_pid_t interface)
     for (size_t i = 0; i < table->size; ++i) {
         if ((interface == KERNEL_PID_UNDEF) ||
             (interface == table->data.entries[i].iface_id)) {
-            fib_remove(&table->data.entries[i]);
+            fib_remove(table, &table->data.entries[i]);
         }
     }
 
@@ -587,6 +656,7 @@ void fib_init(fib_table_t *table)
     }
 
     table->notify_rp_pos = 0;
+    table->version = 0;
 
     if (table->table_type == FIB_TABLE_TYPE_SR) {
         memset(table->data.source_routes->headers, 0,
@@ -596,6 +666,11 @@ void fib_init(fib_table_t *table)
     }
     else {
         memset(table->data.entries, 0, (table->size * sizeof(fib_entry_t)));
+#ifdef MODULE_FIB_TRIE
+        if (fib_trie_enabled(table)) {
+            fib_trie_init(table, xtimer_now_usec64());
+        }
+#endif
     }
     universal_address_init();
     mutex_unlock(&(table->mtx_access));
@@ -621,6 +696,11 @@ void fib_deinit(fib_table_t *table)
     }
     else {
         memset(table->data.entries, 0, (table->size * sizeof(fib_entry_t)));
+#ifdef MODULE_FIB_TRIE
+        if (fib_trie_enabled(table)) {
+            fib_trie_init(table, xtimer_now_usec64());
+        }
+#endif
     }
     universal_address_reset();
     mutex_unlock(&(table->mtx_access));
@@ -920,14 +1000,11 @@ int fib_sr_search(fib_table_t *table, fib_sr_t *fib_sr, uint8_t *addr, size_t ad
         return -ENOENT;
     }
 
+    /* equal addresses share their container */
+    universal_address_container_t *address = universal_address_find(addr, addr_size);
     fib_sr_entry_t *elt;
     LL_FOREACH(fib_sr->sr_path, elt) {
-        size_t addr_size_match = addr_size << 3;
-        if (universal_address_compare(elt->address, addr, &addr_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
-
-            /* temporary workaround to calm compiler */
-            (void)sr_path_entry;
-
+        if ((address != NULL) && (elt->address == address)) {
             *sr_path_entry = elt;
             mutex_unlock(&(table->mtx_access));
             return 0;
@@ -953,10 +1030,10 @@ int fib_sr_entry_append(fib_table_t *table, fib_sr_t *fib_sr,
         return -ENOENT;
     }
 
+    universal_address_container_t *address = universal_address_find(addr, addr_size);
     fib_sr_entry_t *elt;
     LL_FOREACH(fib_sr->sr_path, elt) {
-        size_t addr_size_match = addr_size << 3;
-        if (universal_address_compare(elt->address, addr, &addr_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
+        if ((address != NULL) && (elt->address == address)) {
             mutex_unlock(&(table->mtx_access));
             return -EINVAL;
         }
@@ -999,10 +1076,10 @@ int fib_sr_entry_add(fib_table_t *table, fib_sr_t *fib_sr,
     }
 
     bool found = false;
+    universal_address_container_t *address = universal_address_find(addr, addr_size);
     fib_sr_entry_t *elt;
     LL_FOREACH(fib_sr->sr_path, elt) {
-        size_t addr_size_match = addr_size << 3;
-        if (universal_address_compare(elt->address, addr, &addr_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
+        if ((address != NULL) && (elt->address == address)) {
             mutex_unlock(&(table->mtx_access));
             return -EINVAL;
         }
@@ -1053,12 +1130,11 @@ int fib_sr_entry_delete(fib_table_t *table, fib_sr_t *fib_sr, uint8_t *addr, siz
         return -ENOENT;
     }
 
+    universal_address_container_t *address = universal_address_find(addr, addr_size);
     fib_sr_entry_t *elt, *tmp;
     tmp = fib_sr->sr_path;
     LL_FOREACH(fib_sr->sr_path, elt) {
-        size_t addr_size_match = addr_size << 3;
-
-        if (universal_address_compare(elt->address, addr, &addr_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
+        if ((address != NULL) && (elt->address == address)) {
             universal_address_rem(elt->address);
             if (keep_remaining_route) {
                 tmp->next = elt->next;
@@ -1104,16 +1180,16 @@ int fib_sr_entry_overwrite(fib_table_t *table, fib_sr_t *fib_sr,
         return -ENOENT;
     }
 
+    universal_address_container_t *address_old = universal_address_find(addr_old, addr_old_size);
+    universal_address_container_t *address_new = universal_address_find(addr_new, addr_new_size);
     fib_sr_entry_t *elt, *elt_repl;
     elt_repl = NULL;
     LL_FOREACH(fib_sr->sr_path, elt) {
-        size_t addr_old_size_match = addr_old_size << 3;
-        size_t addr_new_size_match = addr_old_size << 3;
-        if (universal_address_compare(elt->address, addr_old, &addr_old_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
+        if ((address_old != NULL) && (elt->address == address_old)) {
             elt_repl = elt;
         }
 
-        if (universal_address_compare(elt->address, addr_new, &addr_new_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
+        if ((address_new != NULL) && (elt->address == address_new)) {
             mutex_unlock(&(table->mtx_access));
             return -EINVAL;
         }
@@ -1187,13 +1263,14 @@ static fib_sr_t* _fib_create_sr_from_partial(fib_table_t *table, uint8_t *dst, s
                                              int check_free_entry, int *error) {
 fib_sr_t* hit = NULL;
 
-    for (size_t i = 0; i < table->size; ++i) {
+    universal_address_container_t *address = universal_address_find(dst, dst_size);
+
+    for (size_t i = 0; (address != NULL) && (i < table->size); ++i) {
         if (table->data.source_routes->headers[i].sr_lifetime != 0) {
 
             fib_sr_entry_t *elt;
             LL_FOREACH(table->data.source_routes->headers[i].sr_path, elt) {
-                size_t addr_size_match = dst_size << 3;
-                if (universal_address_compare(elt->address, dst, &addr_size_match) == UNIVERSAL_ADDRESS_EQUAL) {
+                if (elt->address == address) {
                     /* we create a new sr */
                     if (check_free_entry == -1) {
                         /* we have no room to create a new sr
@@ -1393,9 +1470,9 @@ int fib_sr_get_route(fib_table_t *table, uint8_t *dst, size_t dst_size, kernel_p
         LL_COUNT(hit->sr_path, elt, count);
 
         if (((size_t)count > *addr_list_elements)
-            || (sizeof(hit->sr_path->address->address) > *element_size)) {
+            || (UNIVERSAL_ADDRESS_SIZE > *element_size)) {
             *addr_list_elements = count;
-            *element_size = sizeof(hit->sr_path->address->address);
+            *element_size = UNIVERSAL_ADDRESS_SIZE;
             mutex_unlock(&(table->mtx_access));
             return -ENOBUFS;
         }
@@ -1406,21 +1483,21 @@ int fib_sr_get_route(fib_table_t *table, uint8_t *dst, size_t dst_size, kernel_p
 
         if (reverse) {
             /* we move to the last list element */
-            next_entry += (count - 1) * sizeof(hit->sr_path->address->address);
+            next_entry += (count - 1) * UNIVERSAL_ADDRESS_SIZE;
             /* and set the storing direction during the iteration */
             one_address_size *= -1;
         }
 
         elt = NULL;
         LL_FOREACH(hit->sr_path, elt) {
-            size_t tmp_size = sizeof(hit->sr_path->address->address);
+            size_t tmp_size = UNIVERSAL_ADDRESS_SIZE;
             universal_address_get_address(elt->address, next_entry, &tmp_size);
             next_entry += one_address_size;
         }
         *sr_iface_id = hit->sr_iface_id;
         *sr_flags = hit->sr_flags;
         *addr_list_elements = count;
-        *element_size = sizeof(hit->sr_path->address->address);
+        *element_size = UNIVERSAL_ADDRESS_SIZE;
     }
     else {
 
@@ -0,0 +1,397 @@
+/*
+ * Copyright (C) 2017 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_fib
+ * @{
+ *
+ * @file
+ * @brief       Path-compressed prefix trie index and lifetime wheel for
+ *              single hop FIB tables
+ *
+ * @}
+ */
+
+#ifdef MODULE_FIB_TRIE
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include "net/fib.h"
+#include "fib_trie.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static inline uint16_t _entry_idx(fib_table_t *table, fib_entry_t *entry)
+{
+    return (uint16_t)(entry - table->data.entries);
+}
+
+static inline const uint8_t *_entry_key(const fib_entry_t *entry)
+{
+    return entry->global->address;
+}
+
+static inline unsigned _bit(const uint8_t *key, uint16_t pos)
+{
+    return (key[pos >> 3] >> (7 - (pos & 0x7))) & 0x1;
+}
+
+/* number of leading bits a and b have in common, at most max */
+static uint16_t _common_bits(const uint8_t *a, const uint8_t *b, uint16_t max)
+{
+    uint16_t i = 0;
+
+    while (((i + 8) <= max) && (a[i >> 3] == b[i >> 3])) {
+        i += 8;
+    }
+    while ((i < max) && (_bit(a, i) == _bit(b, i))) {
+        i++;
+    }
+    return i;
+}
+
+/* prefix length as the linear search interprets an entry: all-zero
+ * addresses are default routes, entries with a prefix length flag are
+ * networks and all others are host routes */
+static uint16_t _prefix_len(const fib_entry_t *entry)
+{
+    uint16_t bits = entry->global->address_size << 3;
+    uint32_t prefix = (entry->global_flags & FIB_FLAG_NET_PREFIX_MASK)
+                      >> FIB_FLAG_NET_PREFIX_SHIFT;
+    bool all_zero = true;
+
+    for (unsigned i = 0; i < entry->global->address_size; i++) {
+        if (entry->global->address[i] != 0) {
+            all_zero = false;
+            break;
+        }
+    }
+    if (all_zero) {
+        return 0;
+    }
+    if ((prefix > 0) && (prefix < bits)) {
+        return (uint16_t)prefix;
+    }
+    return bits;
+}
+
+static uint16_t _node_alloc(fib_trie_t *trie, fib_entry_t *entry,
+                            const uint8_t *key, uint16_t bitlen)
+{
+    uint16_t idx = trie->free;
+    fib_trie_node_t *node = &trie->nodes[idx];
+
+    assert(idx != FIB_TRIE_NIL);
+    trie->free = node->child[0];
+    node->entry = entry;
+    node->key = key;
+    node->child[0] = FIB_TRIE_NIL;
+    node->child[1] = FIB_TRIE_NIL;
+    node->bitlen = bitlen;
+    return idx;
+}
+
+static void _node_free(fib_trie_t *trie, uint16_t idx)
+{
+    trie->nodes[idx].entry = NULL;
+    trie->nodes[idx].key = NULL;
+    trie->nodes[idx].child[0] = trie->free;
+    trie->free = idx;
+}
+
+/* key of any entry below node (branching nodes always have two children) */
+static const uint8_t *_any_key(fib_trie_t *trie, fib_trie_node_t *node)
+{
+    while (node->entry == NULL) {
+        node = &trie->nodes[node->child[0]];
+    }
+    return _entry_key(node->entry);
+}
+
+void fib_trie_init(fib_table_t *table, uint64_t now)
+{
+    fib_trie_t *trie = &table->trie;
+    size_t numof = FIB_TRIE_NODES_NUMOF(table->size);
+
+    assert(numof < FIB_TRIE_NIL);
+    trie->root = FIB_TRIE_NIL;
+    trie->free = FIB_TRIE_NIL;
+    for (size_t i = numof; i > 0; i--) {
+        _node_free(trie, i - 1);
+    }
+    trie->unindexed = 0;
+    trie->key_size = 0;
+    trie->wheel_pos = (uint32_t)(now >> FIB_TRIE_WHEEL_SHIFT);
+    for (unsigned i = 0; i < FIB_TRIE_WHEEL_SLOTS; i++) {
+        trie->wheel[i] = FIB_TRIE_NIL;
+    }
+}
+
+static int _insert(fib_trie_t *trie, fib_entry_t *entry)
+{
+    const uint8_t *key = _entry_key(entry);
+    uint16_t len = _prefix_len(entry);
+    uint16_t *link = &trie->root;
+
+    if (trie->root == FIB_TRIE_NIL) {
+        trie->key_size = entry->global->address_size;
+    }
+    else if (trie->key_size != entry->global->address_size) {
+        return -EINVAL;
+    }
+    while (*link != FIB_TRIE_NIL) {
+        fib_trie_node_t *node = &trie->nodes[*link];
+        uint16_t common = _common_bits(key, node->key,
+                                       (len < node->bitlen) ? len : node->bitlen);
+
+        if (common < node->bitlen) {
+            /* prefixes diverge (or the new one is shorter) within the
+             * compressed path: split it */
+            uint16_t split = *link;
+
+            if (common == len) {
+                *link = _node_alloc(trie, entry, key, len);
+                trie->nodes[*link].child[_bit(node->key, len)] = split;
+            }
+            else {
+                *link = _node_alloc(trie, NULL, key, common);
+                trie->nodes[*link].child[_bit(key, common)] =
+                    _node_alloc(trie, entry, key, len);
+                trie->nodes[*link].child[_bit(node->key, common)] = split;
+            }
+            return 0;
+        }
+        if (len == node->bitlen) {
+            if (node->entry != NULL) {
+                /* two addresses sharing the same (masked) prefix */
+                return -EEXIST;
+            }
+            node->entry = entry;
+            node->key = key;
+            return 0;
+        }
+        link = &node->child[_bit(key, node->bitlen)];
+    }
+    *link = _node_alloc(trie, entry, key, len);
+    return 0;
+}
+
+static int _remove(fib_trie_t *trie, fib_entry_t *entry)
+{
+    const uint8_t *key = _entry_key(entry);
+    uint16_t len = _prefix_len(entry);
+    uint16_t *link = &trie->root, *parent_link = NULL;
+    fib_trie_node_t *node = NULL;
+
+    if (trie->key_size != entry->global->address_size) {
+        return -ENOENT;
+    }
+    while (*link != FIB_TRIE_NIL) {
+        node = &trie->nodes[*link];
+        if ((node->bitlen > len) || (node->entry == entry)) {
+            break;
+        }
+        parent_link = link;
+        link = &node->child[_bit(key, node->bitlen)];
+    }
+    if ((*link == FIB_TRIE_NIL) || (node->entry != entry)) {
+        return -ENOENT;
+    }
+    node->entry = NULL;
+    if ((node->child[0] != FIB_TRIE_NIL) && (node->child[1] != FIB_TRIE_NIL)) {
+        /* keep as branching node */
+    }
+    else if ((node->child[0] != FIB_TRIE_NIL) || (node->child[1] != FIB_TRIE_NIL)) {
+        uint16_t idx = *link;
+
+        *link = (node->child[0] != FIB_TRIE_NIL) ? node->child[0] : node->child[1];
+        _node_free(trie, idx);
+    }
+    else {
+        _node_free(trie, *link);
+        *link = FIB_TRIE_NIL;
+        if (parent_link != NULL) {
+            fib_trie_node_t *parent = &trie->nodes[*parent_link];
+
+            if (parent->entry == NULL) {
+                /* branching node with only one child left: collapse */
+                uint16_t idx = *parent_link;
+
+                *parent_link = (parent->child[0] != FIB_TRIE_NIL) ?
+                               parent->child[0] : parent->child[1];
+                _node_free(trie, idx);
+            }
+        }
+    }
+    /* nodes above the removed entry may still refer to its address */
+    for (uint16_t idx = trie->root; idx != FIB_TRIE_NIL;) {
+        node = &trie->nodes[idx];
+        if (node->key == key) {
+            node->key = _any_key(trie, node);
+        }
+        if (node->bitlen >= len) {
+            break;
+        }
+        idx = node->child[_bit(key, node->bitlen)];
+    }
+    return 0;
+}
+
+void fib_trie_add(fib_table_t *table, fib_entry_t *entry)
+{
+    fib_trie_t *trie = &table->trie;
+
+    if (_insert(trie, entry) < 0) {
+        DEBUG("[fib_trie_add] could not index entry %p\n", (void *)entry);
+        trie->unindexed++;
+    }
+    fib_trie_wheel_link(table, entry);
+}
+
+void fib_trie_remove(fib_table_t *table, fib_entry_t *entry)
+{
+    fib_trie_t *trie = &table->trie;
+
+    fib_trie_wheel_unlink(table, entry);
+    if (_remove(trie, entry) < 0) {
+        assert(trie->unindexed > 0);
+        trie->unindexed--;
+    }
+    if (trie->root == FIB_TRIE_NIL) {
+        /* allow addresses of another size from now on */
+        trie->key_size = 0;
+    }
+}
+
+static inline bool _in_wheel(const fib_entry_t *entry)
+{
+    return (entry->lifetime != 0) && (entry->lifetime != FIB_LIFETIME_NO_EXPIRE);
+}
+
+static inline uint16_t *_wheel_slot(fib_trie_t *trie, uint64_t lifetime)
+{
+    return &trie->wheel[(lifetime >> FIB_TRIE_WHEEL_SHIFT) % FIB_TRIE_WHEEL_SLOTS];
+}
+
+void fib_trie_wheel_link(fib_table_t *table, fib_entry_t *entry)
+{
+    uint16_t *head;
+
+    if (!_in_wheel(entry)) {
+        return;
+    }
+    head = _wheel_slot(&table->trie, entry->lifetime);
+    entry->wheel_prev = FIB_TRIE_NIL;
+    entry->wheel_next = *head;
+    if (*head != FIB_TRIE_NIL) {
+        table->data.entries[*head].wheel_prev = _entry_idx(table, entry);
+    }
+    *head = _entry_idx(table, entry);
+}
+
+void fib_trie_wheel_unlink(fib_table_t *table, fib_entry_t *entry)
+{
+    uint16_t *head;
+
+    if (!_in_wheel(entry)) {
+        return;
+    }
+    head = _wheel_slot(&table->trie, entry->lifetime);
+    if (entry->wheel_prev == FIB_TRIE_NIL) {
+        if (*head != _entry_idx(table, entry)) {
+            /* already unlinked */
+            return;
+        }
+        *head = entry->wheel_next;
+    }
+    else {
+        table->data.entries[entry->wheel_prev].wheel_next = entry->wheel_next;
+    }
+    if (entry->wheel_next != FIB_TRIE_NIL) {
+        table->data.entries[entry->wheel_next].wheel_prev = entry->wheel_prev;
+    }
+    entry->wheel_prev = FIB_TRIE_NIL;
+    entry->wheel_next = FIB_TRIE_NIL;
+}
+
+fib_entry_t *fib_trie_pop_expired(fib_table_t *table, uint64_t now)
+{
+    fib_trie_t *trie = &table->trie;
+    uint32_t cur = (uint32_t)(now >> FIB_TRIE_WHEEL_SHIFT);
+
+    if ((cur - trie->wheel_pos) > FIB_TRIE_WHEEL_SLOTS) {
+        /* visiting every slot once covers all entries */
+        trie->wheel_pos = cur - FIB_TRIE_WHEEL_SLOTS;
+    }
+    /* all entries of a passed slot expired, except for those of later
+     * rounds of the wheel */
+    while (trie->wheel_pos != cur) {
+        uint16_t idx = trie->wheel[trie->wheel_pos % FIB_TRIE_WHEEL_SLOTS];
+
+        while (idx != FIB_TRIE_NIL) {
+            fib_entry_t *entry = &table->data.entries[idx];
+
+            if (entry->lifetime < now) {
+                fib_trie_wheel_unlink(table, entry);
+                return entry;
+            }
+            idx = entry->wheel_next;
+        }
+        trie->wheel_pos++;
+    }
+    return NULL;
+}
+
+int fib_trie_find(fib_table_t *table, const uint8_t *dst, size_t dst_size,
+                  fib_entry_t **entry)
+{
+    fib_trie_t *trie = &table->trie;
+    fib_entry_t *best = NULL;
+    uint16_t bits = dst_size << 3, checked = 0;
+
+    if (trie->unindexed > 0) {
+        return -ENOTSUP;
+    }
+    if (dst_size != trie->key_size) {
+        /* all entries have a different size, so none can match */
+        return -EHOSTUNREACH;
+    }
+    for (uint16_t idx = trie->root; idx != FIB_TRIE_NIL;) {
+        fib_trie_node_t *node = &trie->nodes[idx];
+
+        /* verify the bits skipped by path compression */
+        if (_common_bits(dst + (checked >> 3), node->key + (checked >> 3),
+                         node->bitlen - (checked & ~0x7)) < (node->bitlen - (checked & ~0x7))) {
+            break;
+        }
+        checked = node->bitlen;
+        if (node->entry != NULL) {
+            if (memcmp(_entry_key(node->entry), dst, dst_size) == 0) {
+                *entry = node->entry;
+                return 1;
+            }
+            best = node->entry;
+        }
+        if (node->bitlen >= bits) {
+            break;
+        }
+        idx = node->child[_bit(dst, node->bitlen)];
+    }
+    if (best == NULL) {
+        return -EHOSTUNREACH;
+    }
+    *entry = best;
+    return 0;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif
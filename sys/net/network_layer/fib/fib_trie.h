@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2017 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_fib
+ * @{
+ *
+ * @file
+ * @brief       Internal functions of the FIB prefix trie index
+ *
+ * All functions expect the table's access mutex to be held.
+ */
+
+#ifndef FIB_TRIE_H
+#define FIB_TRIE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "net/fib/table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(MODULE_FIB_TRIE) || defined(DOXYGEN)
+/**
+ * @brief   Checks if a table uses the trie index
+ */
+static inline bool fib_trie_enabled(fib_table_t *table)
+{
+    return (table->table_type == FIB_TABLE_TYPE_SH) && (table->trie.nodes != NULL);
+}
+
+/**
+ * @brief   Empties the index and the lifetime wheel of @p table
+ *
+ * @param[in] table     the table
+ * @param[in] now       the current time in us
+ */
+void fib_trie_init(fib_table_t *table, uint64_t now);
+
+/**
+ * @brief   Adds a freshly created entry to the index and the lifetime wheel
+ *
+ * @param[in] table     the table
+ * @param[in] entry     the entry, fib_entry_t::global and
+ *                      fib_entry_t::lifetime must be set
+ */
+void fib_trie_add(fib_table_t *table, fib_entry_t *entry);
+
+/**
+ * @brief   Removes an entry from the index and the lifetime wheel
+ *
+ * @param[in] table     the table
+ * @param[in] entry     the entry, before its fields are cleared
+ */
+void fib_trie_remove(fib_table_t *table, fib_entry_t *entry);
+
+/**
+ * @brief   Puts an entry into the lifetime wheel slot of its lifetime
+ *
+ * @param[in] table     the table
+ * @param[in] entry     the entry
+ */
+void fib_trie_wheel_link(fib_table_t *table, fib_entry_t *entry);
+
+/**
+ * @brief   Takes an entry out of the lifetime wheel (call before changing
+ *          fib_entry_t::lifetime)
+ *
+ * @param[in] table     the table
+ * @param[in] entry     the entry
+ */
+void fib_trie_wheel_unlink(fib_table_t *table, fib_entry_t *entry);
+
+/**
+ * @brief   Purges the lifetime wheel up to the current slot
+ *
+ * Expired entries are taken out of the wheel one at a time and must be
+ * removed by the caller.
+ *
+ * @param[in] table     the table
+ * @param[in] now       the current time in us
+ *
+ * @return  an expired entry
+ * @return  NULL, if all passed slots are purged
+ */
+fib_entry_t *fib_trie_pop_expired(fib_table_t *table, uint64_t now);
+
+/**
+ * @brief   Longest prefix match lookup in the index
+ *
+ * @param[in] table     the table
+ * @param[in] dst       the destination address
+ * @param[in] dst_size  the destination address size
+ * @param[out] entry    the best matching entry
+ *
+ * @return  1, if an entry with exactly @p dst was found
+ * @return  0, if a prefix (or default route) covering @p dst was found
+ * @return  -EHOSTUNREACH, if no entry matches
+ * @return  -ENOTSUP, if the index can not answer the query because some
+ *          entries are not indexed
+ */
+int fib_trie_find(fib_table_t *table, const uint8_t *dst, size_t dst_size,
+                  fib_entry_t **entry);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIB_TRIE_H */
+/** @} */
@@ -98,6 +98,8 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
 static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
                              int flags, const struct sockaddr *address,
                              socklen_t address_len);
+static int _bind_connect(socket_t *s, const struct sockaddr *address,
+                         socklen_t address_len);
 
 static socket_t *_get_free_socket(void)
 {
@@ -315,6 +317,66 @@ static inline ssize_t socket_write(vfs_file_t *filp, const void *buf, size_t n)
     return socket_sendto(filp->private_data.ptr, buf, n, 0, NULL, 0);
 }
 
+static ssize_t socket_writev(vfs_file_t *filp, const struct iovec *iov, int iovcnt)
+{
+    socket_t *s = filp->private_data.ptr;
+    ssize_t res = 0;
+
+    if (s->sock == NULL) {  /* socket is not connected */
+#ifdef MODULE_SOCK_TCP
+        if (s->type == SOCK_STREAM) {
+            errno = ENOTCONN;
+            return -1;
+        }
+#endif
+        /* bind implicitly */
+        if ((res = _bind_connect(s, NULL, 0)) < 0) {
+            return res;
+        }
+    }
+    /* a datagram must not be split up, so the vector is handed to the stack
+     * as one packet where the stack supports it */
+    switch (s->type) {
+#if defined(MODULE_SOCK_IP) && defined(MODULE_GNRC_SOCK_IP)
+        case SOCK_RAW:
+            res = sock_ip_sendv(&s->sock->raw, iov, iovcnt, s->protocol, NULL);
+            break;
+#endif
+#ifdef MODULE_SOCK_TCP
+        case SOCK_STREAM:
+            for (int i = 0; i < iovcnt; i++) {
+                int tmp = sock_tcp_write(&s->sock->tcp.sock, iov[i].iov_base,
+                                         iov[i].iov_len);
+                if (tmp < 0) {
+                    res = (res == 0) ? tmp : res;
+                    break;
+                }
+                res += tmp;
+                if ((size_t)tmp < iov[i].iov_len) {
+                    break;
+                }
+            }
+            break;
+#endif
+#if defined(MODULE_SOCK_UDP) && defined(MODULE_GNRC_SOCK_UDP)
+        case SOCK_DGRAM:
+            res = sock_udp_sendv(&s->sock->udp, iov, iovcnt, NULL);
+            break;
+#endif
+        default:
+            if (iovcnt == 1) {
+                return socket_write(filp, iov[0].iov_base, iov[0].iov_len);
+            }
+            res = -EOPNOTSUPP;
+            break;
+    }
+    if (res < 0) {
+        errno = -res;
+        res = -1;
+    }
+    return res;
+}
+
 static const vfs_file_ops_t socket_ops = {
     .close = socket_close,
     .fcntl = NULL,          /* TODO: provide when needed */
@@ -322,6 +384,7 @@ static const vfs_file_ops_t socket_ops = {
     .lseek = socket_lseek,
     .read = socket_read,
     .write = socket_write,
+    .writev = socket_writev,
 };
 
 int socket(int domain, int type, int protocol)
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_schedprof
+ * @{
+ *
+ * @file
+ * @brief       Scheduler profiling implementation
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bitarithm.h"
+#include "irq.h"
+#include "sched.h"
+#include "schedprof.h"
+
+#if defined(CPU_NATIVE)
+#include <time.h>
+#include "native_internal.h"
+
+#define SCHEDPROF_HZ    (1000000000LU)
+#elif defined(CPU_ARCH_CORTEX_M3) || defined(CPU_ARCH_CORTEX_M4) || \
+      defined(CPU_ARCH_CORTEX_M4F) || defined(CPU_ARCH_CORTEX_M7)
+#include "cpu.h"
+#include "periph_conf.h"
+
+#define SCHEDPROF_DWT
+#define SCHEDPROF_HZ    (CLOCK_CORECLOCK)
+#else
+#include "xtimer.h"
+
+#define SCHEDPROF_XTIMER
+#define SCHEDPROF_HZ    (XTIMER_HZ)
+#endif
+
+#if (SCHEDPROF_TRACE_NUMOF & (SCHEDPROF_TRACE_NUMOF - 1)) != 0
+#error "SCHEDPROF_TRACE_NUMOF must be a power of 2"
+#endif
+
+/* everything in here is accessed from the scheduler with interrupts
+ * disabled */
+static schedprof_thread_t _prof[KERNEL_PID_LAST + 1];
+/* start of the current time slice of a running thread, or the time a ready
+ * thread was put on the run queue */
+static uint32_t _since[KERNEL_PID_LAST + 1];
+#ifdef SCHEDPROF_ISR
+static schedprof_isr_t _isr;
+static uint32_t _isr_start;
+static unsigned _isr_nesting;
+#endif
+#ifdef SCHEDPROF_XTIMER
+/* the scheduler runs long before auto_init starts xtimer */
+static bool _xtimer_ready;
+#endif
+
+#ifdef MODULE_SCHEDPROF_TRACE
+static schedprof_event_t _trace[SCHEDPROF_TRACE_NUMOF];
+static unsigned _trace_head;
+static unsigned _trace_numof;
+static uint32_t _trace_lost;
+#endif
+
+static inline uint32_t _now(void)
+{
+#if defined(CPU_NATIVE)
+    struct timespec t;
+
+    real_clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((t.tv_sec * 1000000000LLU) + t.tv_nsec);
+#elif defined(SCHEDPROF_DWT)
+    return DWT->CYCCNT;
+#else
+    return _xtimer_ready ? _xtimer_now() : 0;
+#endif
+}
+
+static inline void _trace_put(uint32_t time, uint8_t event,
+                              kernel_pid_t pid, kernel_pid_t arg)
+{
+#ifdef MODULE_SCHEDPROF_TRACE
+    schedprof_event_t *rec = &_trace[_trace_head];
+
+    rec->time = time;
+    rec->event = event;
+    rec->pid = (uint8_t)pid;
+    rec->arg = (uint16_t)arg;
+    _trace_head = (_trace_head + 1) & (SCHEDPROF_TRACE_NUMOF - 1);
+    /* overwrite the oldest record, the most recent ones are the
+     * interesting ones */
+    if (_trace_numof < SCHEDPROF_TRACE_NUMOF) {
+        _trace_numof++;
+    }
+    else {
+        _trace_lost++;
+    }
+#else
+    (void)time;
+    (void)event;
+    (void)pid;
+    (void)arg;
+#endif
+}
+
+static inline unsigned _hist_bucket(uint32_t wait)
+{
+    unsigned bucket;
+
+    wait >>= SCHEDPROF_HIST_SHIFT;
+    if (wait == 0) {
+        return 0;
+    }
+    bucket = bitarithm_msb(wait) + 1;
+    return (bucket < SCHEDPROF_HIST_NUMOF) ? bucket : (SCHEDPROF_HIST_NUMOF - 1);
+}
+
+void schedprof_init(void)
+{
+#ifdef SCHEDPROF_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+void schedprof_xtimer_init(void)
+{
+#ifdef SCHEDPROF_XTIMER
+    _xtimer_ready = true;
+#endif
+}
+
+uint32_t schedprof_now(void)
+{
+    return _now();
+}
+
+uint32_t schedprof_hz(void)
+{
+    return SCHEDPROF_HZ;
+}
+
+void schedprof_ready(kernel_pid_t pid)
+{
+    uint32_t now = _now();
+
+    _since[pid] = now;
+    _trace_put(now, SCHEDPROF_EVENT_READY, pid, KERNEL_PID_UNDEF);
+}
+
+void schedprof_switch(thread_t *prev, thread_t *next)
+{
+    uint32_t now = _now();
+    schedprof_thread_t *prof = &_prof[next->pid];
+    uint32_t wait = now - _since[next->pid];
+    kernel_pid_t prev_pid = KERNEL_PID_UNDEF;
+
+    if (prev != NULL) {
+        prev_pid = prev->pid;
+        _prof[prev_pid].runtime += now - _since[prev_pid];
+        /* the scheduler already changed the state from running, so the
+         * thread is still on the run queue if it was not blocked */
+        if (prev->status >= STATUS_ON_RUNQUEUE) {
+            _prof[prev_pid].preemptions++;
+            _since[prev_pid] = now;
+            _trace_put(now, SCHEDPROF_EVENT_PREEMPT, prev_pid, KERNEL_PID_UNDEF);
+        }
+    }
+
+    prof->schedules++;
+    prof->wait_hist[_hist_bucket(wait)]++;
+    if (wait > prof->wait_max) {
+        prof->wait_max = wait;
+    }
+    _since[next->pid] = now;
+    _trace_put(now, SCHEDPROF_EVENT_SWITCH, next->pid, prev_pid);
+}
+
+#ifdef SCHEDPROF_ISR
+void schedprof_isr_enter(void)
+{
+    if (_isr_nesting++ == 0) {
+        _isr_start = _now();
+        _trace_put(_isr_start, SCHEDPROF_EVENT_ISR_ENTER, sched_active_pid,
+                   KERNEL_PID_UNDEF);
+    }
+}
+
+void schedprof_isr_exit(void)
+{
+    if (--_isr_nesting == 0) {
+        uint32_t now = _now();
+        uint32_t time = now - _isr_start;
+
+        _prof[sched_active_pid].isr_time += time;
+        _isr.time += time;
+        _isr.count++;
+        _trace_put(now, SCHEDPROF_EVENT_ISR_EXIT, sched_active_pid,
+                   KERNEL_PID_UNDEF);
+    }
+}
+#endif
+
+int schedprof_get(kernel_pid_t pid, schedprof_thread_t *prof)
+{
+    unsigned state;
+
+    if ((pid < 0) || (pid > KERNEL_PID_LAST)) {
+        return -EINVAL;
+    }
+    state = irq_disable();
+    *prof = _prof[pid];
+    irq_restore(state);
+    return 0;
+}
+
+#ifdef SCHEDPROF_ISR
+void schedprof_get_isr(schedprof_isr_t *isr)
+{
+    unsigned state = irq_disable();
+
+    *isr = _isr;
+    irq_restore(state);
+}
+#endif
+
+void schedprof_reset(void)
+{
+    unsigned state = irq_disable();
+
+    memset(_prof, 0, sizeof(_prof));
+#ifdef SCHEDPROF_ISR
+    memset(&_isr, 0, sizeof(_isr));
+#endif
+#ifdef MODULE_SCHEDPROF_TRACE
+    _trace_numof = 0;
+    _trace_lost = 0;
+#endif
+    irq_restore(state);
+}
+
+#ifdef MODULE_SCHEDPROF_TRACE
+unsigned schedprof_trace_read(schedprof_event_t *buf, unsigned numof)
+{
+    unsigned state = irq_disable();
+    unsigned tail = (_trace_head - _trace_numof) & (SCHEDPROF_TRACE_NUMOF - 1);
+
+    if (numof > _trace_numof) {
+        numof = _trace_numof;
+    }
+    for (unsigned i = 0; i < numof; i++) {
+        buf[i] = _trace[tail];
+        tail = (tail + 1) & (SCHEDPROF_TRACE_NUMOF - 1);
+    }
+    _trace_numof -= numof;
+    irq_restore(state);
+    return numof;
+}
+
+uint32_t schedprof_trace_lost(void)
+{
+    return _trace_lost;
+}
+#endif
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_shell_commands
+ * @{
+ *
+ * @file
+ * @brief       Shell commands for the scheduler profiling module
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sched.h"
+#include "schedprof.h"
+#include "thread.h"
+
+#define TRACE_CHUNK     (8U)
+
+static uint32_t _to_us(uint64_t ticks)
+{
+    return (uint32_t)((ticks * 1000000LLU) / schedprof_hz());
+}
+
+static const char *_name(kernel_pid_t pid)
+{
+#ifdef DEVELHELP
+    const char *name = thread_getname(pid);
+
+    return (name != NULL) ? name : "-";
+#else
+    (void)pid;
+    return "-";
+#endif
+}
+
+static void _usage(const char *cmd)
+{
+    printf("usage: %s [hist|trace|reset]\n", cmd);
+}
+
+static void _print_threads(void)
+{
+#ifdef SCHEDPROF_ISR
+    schedprof_isr_t isr;
+#endif
+
+    printf("%3s | %-16s | %10s | %10s | %8s | %8s | %10s\n", "pid", "name",
+           "run [us]", "isr [us]", "sched", "preempt", "wmax [us]");
+    for (kernel_pid_t i = KERNEL_PID_FIRST; i <= KERNEL_PID_LAST; i++) {
+        schedprof_thread_t prof;
+
+        if ((sched_threads[i] == NULL) || (schedprof_get(i, &prof) < 0)) {
+            continue;
+        }
+        printf("%3" PRIkernel_pid " | %-16s | %10" PRIu32 " | %10" PRIu32
+               " | %8" PRIu32 " | %8" PRIu32 " | %10" PRIu32 "\n",
+               i, _name(i), _to_us(prof.runtime), _to_us(prof.isr_time),
+               prof.schedules, prof.preemptions, _to_us(prof.wait_max));
+    }
+#ifdef SCHEDPROF_ISR
+    schedprof_get_isr(&isr);
+    printf("isr: %" PRIu32 " calls, %" PRIu32 " us\n", isr.count, _to_us(isr.time));
+#endif
+}
+
+static void _print_hist(void)
+{
+    printf("%3s | bucket counts, bucket 0: < %" PRIu32 " ticks, "
+           "doubling, %" PRIu32 " ticks/s\n", "pid",
+           (uint32_t)(1LU << SCHEDPROF_HIST_SHIFT), schedprof_hz());
+    for (kernel_pid_t i = KERNEL_PID_FIRST; i <= KERNEL_PID_LAST; i++) {
+        schedprof_thread_t prof;
+
+        if ((sched_threads[i] == NULL) || (schedprof_get(i, &prof) < 0)) {
+            continue;
+        }
+        printf("%3" PRIkernel_pid " |", i);
+        for (unsigned j = 0; j < SCHEDPROF_HIST_NUMOF; j++) {
+            printf(" %" PRIu32, prof.wait_hist[j]);
+        }
+        puts("");
+    }
+}
+
+static int _dump_trace(void)
+{
+#ifdef MODULE_SCHEDPROF_TRACE
+    schedprof_event_t buf[TRACE_CHUNK];
+    unsigned numof;
+
+    /* one record per line as raw bytes in CPU byte order, see
+     * schedprof_event_t */
+    printf("trace: %" PRIu32 " ticks/s, %" PRIu32 " records lost\n",
+           schedprof_hz(), schedprof_trace_lost());
+    while ((numof = schedprof_trace_read(buf, TRACE_CHUNK)) > 0) {
+        for (unsigned i = 0; i < numof; i++) {
+            const uint8_t *rec = (const uint8_t *)&buf[i];
+
+            for (unsigned j = 0; j < sizeof(schedprof_event_t); j++) {
+                printf("%02x", rec[j]);
+            }
+            puts("");
+        }
+    }
+    return 0;
+#else
+    puts("trace: module schedprof_trace not included");
+    return 1;
+#endif
+}
+
+int _schedprof_handler(int argc, char **argv)
+{
+    if (argc < 2) {
+        _print_threads();
+        return 0;
+    }
+    if (strcmp(argv[1], "hist") == 0) {
+        _print_hist();
+        return 0;
+    }
+    if (strcmp(argv[1], "trace") == 0) {
+        return _dump_trace();
+    }
+    if (strcmp(argv[1], "reset") == 0) {
+        schedprof_reset();
+        return 0;
+    }
+    _usage(argv[0]);
+    return 1;
+}
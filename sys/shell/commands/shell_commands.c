@@ -37,6 +37,10 @@ extern int _heap_handler(int argc, char **argv);
 extern int _ps_handler(int argc, char **argv);
 #endif
 
+#ifdef MODULE_SCHEDPROF
+extern int _schedprof_handler(int argc, char **argv);
+#endif
+
 #ifdef MODULE_SHT11
 extern int _get_temperature_handler(int argc, char **argv);
 extern int _get_humidity_handler(int argc, char **argv);
@@ -143,6 +147,9 @@ const shell_command_t _shell_command_list[] = {
 #ifdef MODULE_PS
     {"ps", "Prints information about running threads.", _ps_handler},
 #endif
+#ifdef MODULE_SCHEDPROF
+    {"schedprof", "Scheduler profile ('schedprof [hist|trace|reset]')", _schedprof_handler},
+#endif
 #ifdef MODULE_SHT11
     {"temp", "Prints measured temperature.", _get_temperature_handler},
     {"hum", "Prints measured humidity.", _get_humidity_handler},
@@ -17,21 +17,37 @@
  * @}
  */
 
+#include <stdatomic.h>
+#include <string.h>
+
 #include "tsrb.h"
 
+/* The ring memory is accessed with plain loads and stores, only the counters
+ * are shared: the fences keep the compiler from moving buffer accesses past
+ * the counter update that hands them over to the other side. */
+#define _acquire()  atomic_signal_fence(memory_order_acquire)
+#define _release()  atomic_signal_fence(memory_order_release)
+
 static void _push(tsrb_t *rb, char c)
 {
-    rb->buf[rb->writes++ & (rb->size - 1)] = c;
+    rb->buf[rb->writes & (rb->size - 1)] = c;
+    _release();
+    rb->writes++;
 }
 
 static char _pop(tsrb_t *rb)
 {
-    return rb->buf[rb->reads++ & (rb->size - 1)];
+    char c = rb->buf[rb->reads & (rb->size - 1)];
+
+    _release();
+    rb->reads++;
+    return c;
 }
 
 int tsrb_get_one(tsrb_t *rb)
 {
     if (!tsrb_empty(rb)) {
+        _acquire();
         return _pop(rb);
     }
     else {
@@ -42,9 +58,18 @@ int tsrb_get_one(tsrb_t *rb)
 int tsrb_get(tsrb_t *rb, char *dst, size_t n)
 {
     size_t tmp = n;
-    while (tmp && !tsrb_empty(rb)) {
-        *dst++ = _pop(rb);
-        tmp--;
+    char *src;
+    unsigned len;
+
+    /* at most two chunks, unless the producer adds data meanwhile */
+    while (tmp && (len = tsrb_peek(rb, &src))) {
+        if (len > tmp) {
+            len = tmp;
+        }
+        memcpy(dst, src, len);
+        tsrb_consume(rb, len);
+        dst += len;
+        tmp -= len;
     }
     return (n - tmp);
 }
@@ -52,6 +77,7 @@ int tsrb_get(tsrb_t *rb, char *dst, size_t n)
 int tsrb_add_one(tsrb_t *rb, char c)
 {
     if (!tsrb_full(rb)) {
+        _acquire();
         _push(rb, c);
         return 0;
     }
@@ -63,9 +89,57 @@ int tsrb_add_one(tsrb_t *rb, char c)
 int tsrb_add(tsrb_t *rb, const char *src, size_t n)
 {
     size_t tmp = n;
-    while (tmp && !tsrb_full(rb)) {
-        _push(rb, *src++);
-        tmp--;
+    char *dst;
+    unsigned len;
+
+    while (tmp && (len = tsrb_reserve(rb, &dst))) {
+        if (len > tmp) {
+            len = tmp;
+        }
+        memcpy(dst, src, len);
+        tsrb_commit(rb, len);
+        src += len;
+        tmp -= len;
     }
     return (n - tmp);
 }
+
+unsigned tsrb_reserve(tsrb_t *rb, char **dst)
+{
+    unsigned pos = rb->writes & (rb->size - 1);
+    unsigned len = tsrb_free(rb);
+
+    _acquire();
+    if (len > rb->size - pos) {
+        len = rb->size - pos;
+    }
+    *dst = &rb->buf[pos];
+    return len;
+}
+
+void tsrb_commit(tsrb_t *rb, unsigned n)
+{
+    assert(n <= tsrb_free(rb));
+    _release();
+    rb->writes += n;
+}
+
+unsigned tsrb_peek(tsrb_t *rb, char **src)
+{
+    unsigned pos = rb->reads & (rb->size - 1);
+    unsigned len = tsrb_avail(rb);
+
+    _acquire();
+    if (len > rb->size - pos) {
+        len = rb->size - pos;
+    }
+    *src = &rb->buf[pos];
+    return len;
+}
+
+void tsrb_consume(tsrb_t *rb, unsigned n)
+{
+    assert(n <= tsrb_avail(rb));
+    _release();
+    rb->reads += n;
+}
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <stdatomic.h>
 #ifdef MODULE_FIB
 #include "net/fib.h"
 #ifdef MODULE_GNRC_IPV6
@@ -46,77 +47,282 @@
 #   define UNIVERSAL_ADDRESS_MAX_ENTRIES    (UA_ADD0)
 #endif
 
+/**
+ * @brief Number of entries for addresses of up to 2 bytes, e.g. short link
+ *        layer addresses
+ */
+#ifndef UNIVERSAL_ADDRESS_MAX_ENTRIES_2
+#   define UNIVERSAL_ADDRESS_MAX_ENTRIES_2  (0)
+#endif
+
+/**
+ * @brief Number of entries for addresses of up to 8 bytes, e.g. EUI-64
+ */
+#ifndef UNIVERSAL_ADDRESS_MAX_ENTRIES_8
+#   define UNIVERSAL_ADDRESS_MAX_ENTRIES_8  (0)
+#endif
+
+/**
+ * @brief Number of hash buckets, must be a power of two
+ */
+#ifndef UNIVERSAL_ADDRESS_BUCKETS
+#   define UNIVERSAL_ADDRESS_BUCKETS        (16U)
+#endif
+
+#define UA_NONE         (UINT16_MAX)
+#define UA_NUMOF        (UNIVERSAL_ADDRESS_MAX_ENTRIES_2 + \
+                         UNIVERSAL_ADDRESS_MAX_ENTRIES_8 + \
+                         UNIVERSAL_ADDRESS_MAX_ENTRIES)
+/* entry size, keeping the 16 bit link of the next entry aligned */
+#define UA_STRIDE(size) ((sizeof(universal_address_container_t) + (size) + 1) & ~1U)
+
+/**
+ * @brief A pool of entries of the same size
+ */
+typedef struct {
+    uint8_t *mem;       /**< memory of the entries */
+    uint16_t first;     /**< index of the first entry */
+    uint16_t numof;     /**< number of entries */
+    uint8_t stride;     /**< bytes per entry */
+    uint8_t size;       /**< maximum address size */
+} _pool_t;
+
 /**
  * @brief counter indicating the number of entries allocated
  */
 static size_t universal_address_table_filled = 0;
 
 /**
- * @brief The array of universal_address containers
+ * @brief The memory of the universal_address containers, per size
+ * @{
+ */
+#if UNIVERSAL_ADDRESS_MAX_ENTRIES_2 > 0
+static union {
+    universal_address_container_t align;
+    uint8_t mem[UNIVERSAL_ADDRESS_MAX_ENTRIES_2 * UA_STRIDE(2)];
+} universal_address_table_2;
+#endif
+
+#if UNIVERSAL_ADDRESS_MAX_ENTRIES_8 > 0
+static union {
+    universal_address_container_t align;
+    uint8_t mem[UNIVERSAL_ADDRESS_MAX_ENTRIES_8 * UA_STRIDE(8)];
+} universal_address_table_8;
+#endif
+
+static union {
+    universal_address_container_t align;
+    uint8_t mem[UNIVERSAL_ADDRESS_MAX_ENTRIES * UA_STRIDE(UNIVERSAL_ADDRESS_SIZE)];
+} universal_address_table;
+/** @} */
+
+/**
+ * @brief The pools, from the smallest addresses to the largest
+ */
+static const _pool_t universal_address_pools[] = {
+#if UNIVERSAL_ADDRESS_MAX_ENTRIES_2 > 0
+    { universal_address_table_2.mem, 0,
+      UNIVERSAL_ADDRESS_MAX_ENTRIES_2, UA_STRIDE(2), 2 },
+#endif
+#if UNIVERSAL_ADDRESS_MAX_ENTRIES_8 > 0
+    { universal_address_table_8.mem, UNIVERSAL_ADDRESS_MAX_ENTRIES_2,
+      UNIVERSAL_ADDRESS_MAX_ENTRIES_8, UA_STRIDE(8), 8 },
+#endif
+    { universal_address_table.mem,
+      UNIVERSAL_ADDRESS_MAX_ENTRIES_2 + UNIVERSAL_ADDRESS_MAX_ENTRIES_8,
+      UNIVERSAL_ADDRESS_MAX_ENTRIES, UA_STRIDE(UNIVERSAL_ADDRESS_SIZE),
+      UNIVERSAL_ADDRESS_SIZE },
+};
+
+#define UA_POOLS        (sizeof(universal_address_pools) / sizeof(_pool_t))
+
+/**
+ * @brief first entry of each hash chain
+ */
+static uint16_t universal_address_buckets[UNIVERSAL_ADDRESS_BUCKETS];
+
+/**
+ * @brief first unused entry of each pool
+ */
+static uint16_t universal_address_unused[UA_POOLS];
+
+/**
+ * @brief incremented before and after the hash chains change, so it is odd
+ *        while they do
  */
-static universal_address_container_t universal_address_table[UNIVERSAL_ADDRESS_MAX_ENTRIES];
+static volatile unsigned universal_address_version;
 
 /**
  * @brief access mutex to control exclusive operations on calls
  */
 static mutex_t mtx_access = MUTEX_INIT;
 
+static unsigned _hash(const uint8_t *addr, size_t addr_size)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261U;
+
+    for (size_t i = 0; i < addr_size; ++i) {
+        hash = (hash ^ addr[i]) * 16777619U;
+    }
+    return (hash ^ (hash >> 16)) & (UNIVERSAL_ADDRESS_BUCKETS - 1);
+}
+
+static const _pool_t *_pool(uint16_t idx)
+{
+    for (unsigned p = 0; p < UA_POOLS; ++p) {
+        const _pool_t *pool = &universal_address_pools[p];
+        if ((uint16_t)(idx - pool->first) < pool->numof) {
+            return pool;
+        }
+    }
+    return NULL;
+}
+
+static universal_address_container_t *_entry(const _pool_t *pool, uint16_t idx)
+{
+    return (universal_address_container_t *)&pool->mem[(idx - pool->first) * pool->stride];
+}
+
+static uint16_t _index(const universal_address_container_t *entry, const _pool_t **pool)
+{
+    for (unsigned p = 0; p < UA_POOLS; ++p) {
+        *pool = &universal_address_pools[p];
+        size_t offset = (const uint8_t *)entry - (*pool)->mem;
+        if (offset < (size_t)((*pool)->numof * (*pool)->stride)) {
+            return (*pool)->first + offset / (*pool)->stride;
+        }
+    }
+    return UA_NONE;
+}
+
+static void _begin_change(void)
+{
+    universal_address_version++;
+    atomic_signal_fence(memory_order_seq_cst);
+}
+
+static void _end_change(void)
+{
+    atomic_signal_fence(memory_order_seq_cst);
+    universal_address_version++;
+}
+
 /**
  * @brief finds the universal address container for the given address
  *
+ * Without the mutex held, the chains may change meanwhile. Then it returns a
+ * wrong result, but never goes out of bounds or around in circles.
+ *
  * @param[in] addr       pointer to the address
  * @param[in] addr_size  the number of bytes required for the address entry
  *
  * @return pointer to the universal_address_container_t containing the address on success
- *         NULL if the address could not be inserted
+ *         NULL if the address is not stored
  */
-static universal_address_container_t *universal_address_find_entry(uint8_t *addr, size_t addr_size)
+static universal_address_container_t *universal_address_find_entry(const uint8_t *addr,
+                                                                   size_t addr_size)
 {
+    uint16_t idx = universal_address_buckets[_hash(addr, addr_size)];
+
     /* cppcheck-suppress unsignedLessThanZero
-     * (reason: UNIVERSAL_ADDRESS_MAX_ENTRIES may be zero in which case this
-     * code is optimized out) */
-    for (size_t i = 0; i < UNIVERSAL_ADDRESS_MAX_ENTRIES; ++i) {
-        if (universal_address_table[i].address_size == addr_size) {
-            if (memcmp((universal_address_table[i].address), addr, addr_size) == 0) {
-                return &(universal_address_table[i]);
-            }
+     * (reason: UA_NUMOF may be zero in which case this code is optimized out) */
+    for (unsigned n = 0; (idx != UA_NONE) && (n < UA_NUMOF); ++n) {
+        const _pool_t *pool = _pool(idx);
+        if (pool == NULL) {
+            break;
+        }
+
+        universal_address_container_t *entry = _entry(pool, idx);
+        if ((entry->address_size == addr_size) && (addr_size <= pool->size) &&
+            (memcmp(entry->address, addr, addr_size) == 0)) {
+            return entry;
         }
+        idx = entry->next;
     }
 
     return NULL;
 }
 
 /**
- * @brief finds the next empty or unused universal address containers
+ * @brief takes an unused entry for an address of the given size, from the
+ *        pool of the smallest entries that fit
  *
  * @return pointer to the next free/unused universal_address_container_t
- *         or NULL if no memory is left in universal_address_table
+ *         or NULL if no memory is left for the size
  */
-static universal_address_container_t *universal_address_get_next_unused_entry(void)
+static universal_address_container_t *universal_address_get_next_unused_entry(size_t addr_size)
 {
-    /* cppcheck-suppress unsignedLessThanZero
-     * (reason: UNIVERSAL_ADDRESS_MAX_ENTRIES may be zero in which case this
-     * code is optimized out) */
-    if (universal_address_table_filled < UNIVERSAL_ADDRESS_MAX_ENTRIES) {
-        /* cppcheck-suppress unsignedLessThanZero */
-        for (size_t i = 0; i < UNIVERSAL_ADDRESS_MAX_ENTRIES; ++i) {
-            if (universal_address_table[i].use_count == 0) {
-                return &(universal_address_table[i]);
-            }
+    for (unsigned p = 0; p < UA_POOLS; ++p) {
+        const _pool_t *pool = &universal_address_pools[p];
+        if ((addr_size <= pool->size) && (universal_address_unused[p] != UA_NONE)) {
+            universal_address_container_t *entry = _entry(pool, universal_address_unused[p]);
+            universal_address_unused[p] = entry->next;
+            return entry;
         }
     }
 
     return NULL;
 }
 
+/**
+ * @brief removes an entry from its hash chain and gives it back to its pool
+ */
+static void universal_address_release_entry(universal_address_container_t *entry)
+{
+    const _pool_t *pool;
+    uint16_t idx = _index(entry, &pool);
+    uint16_t *link = &universal_address_buckets[_hash(entry->address, entry->address_size)];
+
+    while (*link != idx) {
+        link = &_entry(_pool(*link), *link)->next;
+    }
+
+    _begin_change();
+    *link = entry->next;
+    _end_change();
+
+    entry->next = universal_address_unused[pool - universal_address_pools];
+    universal_address_unused[pool - universal_address_pools] = idx;
+}
+
+/**
+ * @brief puts all entries back to their pools
+ */
+static void universal_address_clear(void)
+{
+    _begin_change();
+    for (unsigned i = 0; i < UNIVERSAL_ADDRESS_BUCKETS; ++i) {
+        universal_address_buckets[i] = UA_NONE;
+    }
+    _end_change();
+
+    for (unsigned p = 0; p < UA_POOLS; ++p) {
+        const _pool_t *pool = &universal_address_pools[p];
+        universal_address_unused[p] = UA_NONE;
+        for (uint16_t i = pool->numof; i > 0; --i) {
+            universal_address_container_t *entry = _entry(pool, pool->first + i - 1);
+            entry->use_count = 0;
+            entry->next = universal_address_unused[p];
+            universal_address_unused[p] = pool->first + i - 1;
+        }
+    }
+
+    universal_address_table_filled = 0;
+}
+
 universal_address_container_t *universal_address_add(uint8_t *addr, size_t addr_size)
 {
+    if (addr_size > UNIVERSAL_ADDRESS_SIZE) {
+        return NULL;
+    }
+
     mutex_lock(&mtx_access);
     universal_address_container_t *pEntry = universal_address_find_entry(addr, addr_size);
 
     if (pEntry == NULL) {
         /* look for a free entry */
-        pEntry = universal_address_get_next_unused_entry();
+        pEntry = universal_address_get_next_unused_entry(addr_size);
 
         if (pEntry == NULL) {
             mutex_unlock(&mtx_access);
@@ -124,18 +330,18 @@ universal_address_container_t *universal_address_add(uint8_t *addr, size_t addr_
             return NULL;
         }
 
-        /* look if the former memory has distinct size */
-        if (pEntry->address_size != addr_size) {
-            /* clean the address */
-            memset(pEntry->address, 0, UNIVERSAL_ADDRESS_SIZE);
-
-            /* set the used bytes */
-            pEntry->address_size = addr_size;
-            pEntry->use_count = 0;
-        }
-
         /* copy the address */
+        pEntry->address_size = addr_size;
+        pEntry->use_count = 0;
         memcpy((pEntry->address), addr, addr_size);
+
+        /* make it visible to lookups */
+        uint16_t *bucket = &universal_address_buckets[_hash(addr, addr_size)];
+        const _pool_t *pool;
+        pEntry->next = *bucket;
+        _begin_change();
+        *bucket = _index(pEntry, &pool);
+        _end_change();
     }
 
     pEntry->use_count++;
@@ -150,17 +356,38 @@ universal_address_container_t *universal_address_add(uint8_t *addr, size_t addr_
     return pEntry;
 }
 
+universal_address_container_t *universal_address_find(const uint8_t *addr, size_t addr_size)
+{
+    unsigned version = universal_address_version;
+    universal_address_container_t *entry;
+
+    atomic_signal_fence(memory_order_seq_cst);
+    if (!(version & 1)) {
+        entry = universal_address_find_entry(addr, addr_size);
+        atomic_signal_fence(memory_order_seq_cst);
+        if (version == universal_address_version) {
+            return entry;
+        }
+    }
+
+    /* the chains changed meanwhile, wait for it to complete */
+    mutex_lock(&mtx_access);
+    entry = universal_address_find_entry(addr, addr_size);
+    mutex_unlock(&mtx_access);
+    return entry;
+}
+
 void universal_address_rem(universal_address_container_t *entry)
 {
     mutex_lock(&mtx_access);
     DEBUG("[universal_address_rem] entry: %p\n", (void *)entry);
 
-    /* we do not delete anything on remove */
     if (entry != NULL) {
         if (entry->use_count != 0) {
             entry->use_count--;
 
             if (entry->use_count == 0) {
+                universal_address_release_entry(entry);
                 universal_address_table_filled--;
             }
         }
@@ -176,30 +403,23 @@ void universal_address_rem(universal_address_container_t *entry)
 uint8_t* universal_address_get_address(universal_address_container_t *entry,
                                   uint8_t *addr, size_t *addr_size)
 {
-    mutex_lock(&mtx_access);
-
     if (*addr_size >= entry->address_size) {
         memcpy(addr, entry->address, entry->address_size);
         *addr_size = entry->address_size;
-        mutex_unlock(&mtx_access);
         return addr;
     }
 
     *addr_size = entry->address_size;
-    mutex_unlock(&mtx_access);
     return NULL;
 }
 
 int universal_address_compare(universal_address_container_t *entry,
                               uint8_t *addr, size_t *addr_size_in_bits)
 {
-    mutex_lock(&mtx_access);
-
     int ret = -ENOENT;
 
     /* If we have distinct sizes, the addresses are probably not comperable */
     if ((size_t)(entry->address_size<<3) != *addr_size_in_bits) {
-        mutex_unlock(&mtx_access);
         return ret;
     }
 
@@ -221,13 +441,11 @@ int universal_address_compare(universal_address_container_t *entry,
     /* if the address is all 0 its a default route address */
     if (test_all_zeros) {
         *addr_size_in_bits = 0;
-        mutex_unlock(&mtx_access);
         return UNIVERSAL_ADDRESS_IS_ALL_ZERO_ADDRESS;
     }
 
     /* if we have no distinct bytes the addresses are equal */
     if (idx == -1) {
-        mutex_unlock(&mtx_access);
         return UNIVERSAL_ADDRESS_EQUAL;
     }
 
@@ -244,18 +462,15 @@ int universal_address_compare(universal_address_container_t *entry,
     *addr_size_in_bits = (idx << 3) + j;
     ret = UNIVERSAL_ADDRESS_MATCHING_PREFIX;
 
-    mutex_unlock(&mtx_access);
     return ret;
 }
 
 int universal_address_compare_prefix(universal_address_container_t *entry,
                               uint8_t *prefix, size_t prefix_size_in_bits)
 {
-    mutex_lock(&mtx_access);
     int ret = -ENOENT;
     /* If we have distinct sizes, the prefix is not comperable */
     if ((size_t)(entry->address_size<<3) != prefix_size_in_bits) {
-        mutex_unlock(&mtx_access);
         return ret;
     }
 
@@ -293,45 +508,25 @@ int universal_address_compare_prefix(universal_address_container_t *entry,
         }
     }
 
-    mutex_unlock(&mtx_access);
     return ret;
 }
 
 void universal_address_init(void)
 {
     mutex_lock(&mtx_access);
-
-    /* cppcheck-suppress unsignedLessThanZero
-     * (reason: UNIVERSAL_ADDRESS_MAX_ENTRIES may be zero in which case this
-     * code is optimized out) */
-    for (size_t i = 0; i < UNIVERSAL_ADDRESS_MAX_ENTRIES; ++i) {
-        universal_address_table[i].use_count = 0;
-        universal_address_table[i].address_size = 0;
-        memset(universal_address_table[i].address, 0, UNIVERSAL_ADDRESS_SIZE);
-    }
-
+    universal_address_clear();
     mutex_unlock(&mtx_access);
 }
 
 void universal_address_reset(void)
 {
     mutex_lock(&mtx_access);
-
-    /* cppcheck-suppress unsignedLessThanZero
-     * (reason: UNIVERSAL_ADDRESS_MAX_ENTRIES may be zero in which case this
-     * code is optimized out) */
-    for (size_t i = 0; i < UNIVERSAL_ADDRESS_MAX_ENTRIES; ++i) {
-        universal_address_table[i].use_count = 0;
-    }
-
-    universal_address_table_filled = 0;
+    universal_address_clear();
     mutex_unlock(&mtx_access);
 }
 
 void universal_address_print_entry(universal_address_container_t *entry)
 {
-    mutex_lock(&mtx_access);
-
     if (entry != NULL) {
         printf("[universal_address_print_entry] entry@: %p, use_count: %d, \
 address_size: %d, content: ", \
@@ -344,16 +539,11 @@ address_size: %d, content: ", \
 
         puts("");
     }
-
-    mutex_unlock(&mtx_access);
 }
 
 int universal_address_get_num_used_entries(void)
 {
-    mutex_lock(&mtx_access);
-    size_t ret = universal_address_table_filled;
-    mutex_unlock(&mtx_access);
-    return ret;
+    return universal_address_table_filled;
 }
 
 void universal_address_print_table(void)
@@ -361,10 +551,10 @@ void universal_address_print_table(void)
     printf("[universal_address_print_table] universal_address_table_filled: %d\n", \
            (int)universal_address_table_filled);
 
-    /* cppcheck-suppress unsignedLessThanZero
-     * (reason: UNIVERSAL_ADDRESS_MAX_ENTRIES may be zero in which case this
-     * code is optimized out) */
-    for (size_t i = 0; i < UNIVERSAL_ADDRESS_MAX_ENTRIES; ++i) {
-        universal_address_print_entry(&universal_address_table[i]);
+    for (unsigned p = 0; p < UA_POOLS; ++p) {
+        const _pool_t *pool = &universal_address_pools[p];
+        for (uint16_t i = 0; i < pool->numof; ++i) {
+            universal_address_print_entry(_entry(pool, pool->first + i));
+        }
     }
 }
@@ -15,6 +15,7 @@
  */
 
 #include <errno.h> /* for error codes */
+#include <stdbool.h> /* for bool */
 #include <string.h> /* for strncmp */
 #include <stddef.h> /* for NULL */
 #include <sys/types.h> /* for off_t etc */
@@ -58,6 +59,27 @@ static vfs_file_t _vfs_open_files[VFS_MAX_OPEN_FILES];
  */
 static clist_node_t _vfs_mounts_list;
 
+/**
+ * @internal
+ * @brief Table of all currently mounted file systems, for path lookups
+ *
+ * The table is sorted by descending mount point length, so the first mount
+ * point that is a prefix of a path is the longest one. Mounts of equal length
+ * are sorted by descending age, like the lookup in the mount list did before.
+ * The table is only modified with _mount_mutex held, lookups read it without
+ * locking and use _mount_gen to detect concurrent modifications.
+ */
+static vfs_mount_t *_vfs_mount_table[VFS_MAX_MOUNTS];
+
+/**
+ * @internal
+ * @brief Generation of the mount table
+ *
+ * Odd while the mount table is being modified or a file system is being
+ * unmounted, incremented to the next even number afterwards.
+ */
+static atomic_uint _mount_gen = ATOMIC_VAR_INIT(0);
+
 /**
  * @internal
  * @brief Find an unused entry in the _vfs_open_files array and mark it as used
@@ -117,6 +139,19 @@ inline static int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *moun
  */
 inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path);
 
+/**
+ * @internal
+ * @brief Find the mount point in the mount table which is the longest prefix
+ * of @p name
+ *
+ * @param[in]  name      absolute path to file
+ * @param[in]  name_len  length of @p name
+ *
+ * @return pointer to the mount on success
+ * @return NULL if no mount point is a prefix of @p name
+ */
+inline static vfs_mount_t *_lookup_mount(const char *name, size_t name_len);
+
 /**
  * @internal
  * @brief Check that a given fd number is valid
@@ -128,8 +163,33 @@ inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
  */
 inline static int _fd_is_valid(int fd);
 
+/**
+ * @internal
+ * @brief Check that a vector of buffers is valid
+ *
+ * @param[in]  iov      array of buffers
+ * @param[in]  iovcnt   number of buffers in @p iov
+ *
+ * @return 0 if the vector is valid
+ * @return <0 if the vector is not valid
+ */
+inline static int _iov_is_valid(const struct iovec *iov, int iovcnt);
+
+/**
+ * @internal
+ * @brief Move the file position to @p off and return the previous position
+ *
+ * Used for the pread/pwrite fallback for drivers that only support lseek.
+ *
+ * @param[in]  filp     pointer to open file
+ * @param[in]  off      new absolute file position
+ *
+ * @return previous file position on success
+ * @return <0 on error
+ */
+inline static off_t _seek_swap(vfs_file_t *filp, off_t off);
+
 static mutex_t _mount_mutex = MUTEX_INIT;
-static mutex_t _open_mutex = MUTEX_INIT;
 
 int vfs_close(int fd)
 {
@@ -263,9 +323,7 @@ int vfs_open(const char *name, int flags, mode_t mode)
         DEBUG("vfs_open: no matching mount\n");
         return res;
     }
-    mutex_lock(&_open_mutex);
     int fd = _init_fd(VFS_ANY_FD, mountp->fs->f_op, mountp, flags, NULL);
-    mutex_unlock(&_open_mutex);
     if (fd < 0) {
         DEBUG("vfs_open: _init_fd: ERR %d!\n", fd);
         /* remember to decrement the open_files count */
@@ -332,6 +390,158 @@ ssize_t vfs_write(int fd, const void *src, size_t count)
     return filp->f_op->write(filp, src, count);
 }
 
+ssize_t vfs_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    DEBUG("vfs_readv: %d, %p, %d\n", fd, (void *)iov, iovcnt);
+    int res = _iov_is_valid(iov, iovcnt);
+    if (res < 0) {
+        return res;
+    }
+    res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_RDONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for reading */
+        return -EBADF;
+    }
+    if (filp->f_op->readv != NULL) {
+        return filp->f_op->readv(filp, iov, iovcnt);
+    }
+    if (filp->f_op->read == NULL) {
+        /* driver does not implement read() */
+        return -EINVAL;
+    }
+    /* read one buffer after the other, until the file runs dry */
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        ssize_t nbytes = filp->f_op->read(filp, iov[i].iov_base, iov[i].iov_len);
+        if (nbytes < 0) {
+            /* report the bytes that were read before the error, if any */
+            return (total > 0) ? total : nbytes;
+        }
+        total += nbytes;
+        if ((size_t)nbytes < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t vfs_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    DEBUG_NOT_STDOUT(fd, "vfs_writev: %d, %p, %d\n", fd, (void *)iov, iovcnt);
+    int res = _iov_is_valid(iov, iovcnt);
+    if (res < 0) {
+        return res;
+    }
+    res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_WRONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for writing */
+        return -EBADF;
+    }
+    if (filp->f_op->writev != NULL) {
+        return filp->f_op->writev(filp, iov, iovcnt);
+    }
+    if (filp->f_op->write == NULL) {
+        /* driver does not implement write() */
+        return -EINVAL;
+    }
+    /* write one buffer after the other, until the file is full */
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        ssize_t nbytes = filp->f_op->write(filp, iov[i].iov_base, iov[i].iov_len);
+        if (nbytes < 0) {
+            /* report the bytes that were written before the error, if any */
+            return (total > 0) ? total : nbytes;
+        }
+        total += nbytes;
+        if ((size_t)nbytes < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t vfs_pread(int fd, void *dest, size_t count, off_t offset)
+{
+    DEBUG("vfs_pread: %d, %p, %lu, %ld\n", fd, dest, (unsigned long)count, (long)offset);
+    if (dest == NULL) {
+        return -EFAULT;
+    }
+    if (offset < 0) {
+        return -EINVAL;
+    }
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_RDONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for reading */
+        return -EBADF;
+    }
+    if (filp->f_op->pread != NULL) {
+        return filp->f_op->pread(filp, dest, count, offset);
+    }
+    if (filp->f_op->read == NULL) {
+        /* driver does not implement read() */
+        return -EINVAL;
+    }
+    off_t pos = _seek_swap(filp, offset);
+    if (pos < 0) {
+        return pos;
+    }
+    ssize_t nbytes = filp->f_op->read(filp, dest, count);
+    filp->f_op->lseek(filp, pos, SEEK_SET);
+    return nbytes;
+}
+
+ssize_t vfs_pwrite(int fd, const void *src, size_t count, off_t offset)
+{
+    DEBUG("vfs_pwrite: %d, %p, %lu, %ld\n", fd, src, (unsigned long)count, (long)offset);
+    if (src == NULL) {
+        return -EFAULT;
+    }
+    if (offset < 0) {
+        return -EINVAL;
+    }
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_WRONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for writing */
+        return -EBADF;
+    }
+    if (filp->f_op->pwrite != NULL) {
+        return filp->f_op->pwrite(filp, src, count, offset);
+    }
+    if (filp->f_op->write == NULL) {
+        /* driver does not implement write() */
+        return -EINVAL;
+    }
+    off_t pos = _seek_swap(filp, offset);
+    if (pos < 0) {
+        return pos;
+    }
+    ssize_t nbytes = filp->f_op->write(filp, src, count);
+    filp->f_op->lseek(filp, pos, SEEK_SET);
+    return nbytes;
+}
+
 int vfs_opendir(vfs_DIR *dirp, const char *dirname)
 {
     DEBUG("vfs_opendir: %p, \"%s\"\n", (void *)dirp, dirname);
@@ -428,6 +638,12 @@ int vfs_mount(vfs_mount_t *mountp)
         DEBUG("vfs_mount: Already mounted\n");
         return -EBUSY;
     }
+    if (_vfs_mount_table[VFS_MAX_MOUNTS - 1] != NULL) {
+        /* mount table full */
+        mutex_unlock(&_mount_mutex);
+        DEBUG("vfs_mount: ERR mount table full!\n");
+        return -ENOSPC;
+    }
     if (mountp->fs->fs_op != NULL) {
         if (mountp->fs->fs_op->mount != NULL) {
             /* yes, a file system driver does not need to implement mount/umount */
@@ -440,6 +656,15 @@ int vfs_mount(vfs_mount_t *mountp)
     }
     /* insert last in list */
     clist_rpush(&_vfs_mounts_list, &mountp->list_entry);
+    /* insert before the shorter and equally long mount points in the table */
+    atomic_fetch_add(&_mount_gen, 1);
+    unsigned i = VFS_MAX_MOUNTS - 1;
+    for (; (i > 0) && ((_vfs_mount_table[i - 1] == NULL) ||
+                       (_vfs_mount_table[i - 1]->mount_point_len <= mountp->mount_point_len)); i--) {
+        _vfs_mount_table[i] = _vfs_mount_table[i - 1];
+    }
+    _vfs_mount_table[i] = mountp;
+    atomic_fetch_add(&_mount_gen, 1);
     mutex_unlock(&_mount_mutex);
     DEBUG("vfs_mount: mount done\n");
     return 0;
@@ -453,8 +678,12 @@ int vfs_umount(vfs_mount_t *mountp)
         return -EINVAL;
     }
     mutex_lock(&_mount_mutex);
+    /* Lookups which have not finished by now take the mutex, so the
+     * open_files count can't increase anymore */
+    atomic_fetch_add(&_mount_gen, 1);
     DEBUG("vfs_umount: -> \"%s\" open=%d\n", mountp->mount_point, atomic_load(&mountp->open_files));
     if (atomic_load(&mountp->open_files) > 0) {
+        atomic_fetch_add(&_mount_gen, 1);
         mutex_unlock(&_mount_mutex);
         return -EBUSY;
     }
@@ -464,6 +693,7 @@ int vfs_umount(vfs_mount_t *mountp)
             if (res < 0) {
                 /* umount failed */
                 DEBUG("vfs_umount: ERR %d!\n", res);
+                atomic_fetch_add(&_mount_gen, 1);
                 mutex_unlock(&_mount_mutex);
                 return res;
             }
@@ -474,9 +704,20 @@ int vfs_umount(vfs_mount_t *mountp)
     if (node == NULL) {
         /* not found */
         DEBUG("vfs_umount: ERR not mounted!\n");
+        atomic_fetch_add(&_mount_gen, 1);
         mutex_unlock(&_mount_mutex);
         return -EINVAL;
     }
+    /* remove it from the table, too */
+    unsigned i = 0;
+    while ((i < VFS_MAX_MOUNTS - 1) && (_vfs_mount_table[i] != mountp)) {
+        ++i;
+    }
+    for (; i < VFS_MAX_MOUNTS - 1; ++i) {
+        _vfs_mount_table[i] = _vfs_mount_table[i + 1];
+    }
+    _vfs_mount_table[VFS_MAX_MOUNTS - 1] = NULL;
+    atomic_fetch_add(&_mount_gen, 1);
     mutex_unlock(&_mount_mutex);
     return 0;
 }
@@ -714,9 +955,7 @@ int vfs_bind(int fd, int flags, const vfs_file_ops_t *f_op, void *private_data)
     if (f_op == NULL) {
         return -EINVAL;
     }
-    mutex_lock(&_open_mutex);
     fd = _init_fd(fd, f_op, NULL, flags, private_data);
-    mutex_unlock(&_open_mutex);
     if (fd < 0) {
         DEBUG("vfs_bind: _init_fd: ERR %d!\n", fd);
         return fd;
@@ -810,30 +1049,40 @@ const vfs_mount_t *vfs_iterate_mounts(const vfs_mount_t *cur)
     return container_of(node, vfs_mount_t, list_entry);
 }
 
+/**
+ * @internal
+ * @brief Claim the slot @p fd by setting its pid, if the slot is unused
+ *
+ * The compare-and-swap makes concurrent allocations safe without a lock.
+ */
+inline static bool _claim_fd(int fd, kernel_pid_t pid)
+{
+    kernel_pid_t unused = KERNEL_PID_UNDEF;
+    return __atomic_compare_exchange_n(&_vfs_open_files[fd].pid, &unused, pid, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
 inline static int _allocate_fd(int fd)
 {
+    kernel_pid_t pid = thread_getpid();
+    if (pid == KERNEL_PID_UNDEF) {
+        /* This happens when calling vfs_bind during boot, before threads have
+         * been started. */
+        pid = -1;
+    }
     if (fd < 0) {
         for (fd = 0; fd < VFS_MAX_OPEN_FILES; ++fd) {
-            if (_vfs_open_files[fd].pid == KERNEL_PID_UNDEF) {
-                break;
+            if (_claim_fd(fd, pid)) {
+                return fd;
             }
         }
-        if (fd >= VFS_MAX_OPEN_FILES) {
-            /* The _vfs_open_files array is full */
-            return -ENFILE;
-        }
+        /* The _vfs_open_files array is full */
+        return -ENFILE;
     }
-    else if (_vfs_open_files[fd].pid != KERNEL_PID_UNDEF) {
+    if (!_claim_fd(fd, pid)) {
         /* The desired fd is already in use */
         return -EEXIST;
     }
-    kernel_pid_t pid = thread_getpid();
-    if (pid == KERNEL_PID_UNDEF) {
-        /* This happens when calling vfs_bind during boot, before threads have
-         * been started. */
-        pid = -1;
-    }
-    _vfs_open_files[fd].pid = pid;
     return fd;
 }
 
@@ -843,7 +1092,7 @@ inline static void _free_fd(int fd)
     if (_vfs_open_files[fd].mp != NULL) {
         atomic_fetch_sub(&_vfs_open_files[fd].mp->open_files, 1);
     }
-    _vfs_open_files[fd].pid = KERNEL_PID_UNDEF;
+    __atomic_store_n(&_vfs_open_files[fd].pid, KERNEL_PID_UNDEF, __ATOMIC_RELEASE);
 }
 
 inline static int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *mountp, int flags, void *private_data)
@@ -861,27 +1110,15 @@ inline static int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *moun
     return fd;
 }
 
-inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path)
+inline static vfs_mount_t *_lookup_mount(const char *name, size_t name_len)
 {
-    size_t longest_match = 0;
-    size_t name_len = strlen(name);
-    mutex_lock(&_mount_mutex);
-
-    clist_node_t *node = _vfs_mounts_list.next;
-    if (node == NULL) {
-        /* list empty */
-        mutex_unlock(&_mount_mutex);
-        return -ENOENT;
-    }
-    vfs_mount_t *mountp = NULL;
-    do {
-        node = node->next;
-        vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
-        size_t len = it->mount_point_len;
-        if (len < longest_match) {
-            /* Already found a longer prefix */
-            continue;
+    for (unsigned i = 0; i < VFS_MAX_MOUNTS; ++i) {
+        vfs_mount_t *it = _vfs_mount_table[i];
+        if (it == NULL) {
+            /* end of table */
+            break;
         }
+        size_t len = it->mount_point_len;
         if (len > name_len) {
             /* path name is shorter than the mount point name */
             continue;
@@ -891,29 +1128,95 @@ inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
             continue;
         }
         if (strncmp(name, it->mount_point, len) == 0) {
-            /* mount_point is a prefix of name */
-            /* special check for mount_point == "/" */
-            if (len > 1) {
-                longest_match = len;
+            /* mount_point is a prefix of name, and the longest one as the
+             * table is sorted by length */
+            return it;
+        }
+    }
+    return NULL;
+}
+
+inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path)
+{
+    size_t name_len = strlen(name);
+    vfs_mount_t *mountp = NULL;
+
+    /* Look up without locking, unless the mount table is being modified */
+    unsigned gen = atomic_load(&_mount_gen);
+    if ((gen & 1) == 0) {
+        mountp = _lookup_mount(name, name_len);
+        if (mountp != NULL) {
+            /* Increment open files counter for this mount, vfs_umount checks
+             * it after marking the table as modified */
+            atomic_fetch_add(&mountp->open_files, 1);
+        }
+        if (atomic_load(&_mount_gen) != gen) {
+            /* raced with vfs_mount or vfs_umount, retry with the mutex held */
+            if (mountp != NULL) {
+                atomic_fetch_sub(&mountp->open_files, 1);
             }
-            mountp = it;
+            gen = 1;
+        }
+    }
+    if ((gen & 1) != 0) {
+        mutex_lock(&_mount_mutex);
+        mountp = _lookup_mount(name, name_len);
+        if (mountp != NULL) {
+            atomic_fetch_add(&mountp->open_files, 1);
         }
-    } while (node != _vfs_mounts_list.next);
+        mutex_unlock(&_mount_mutex);
+    }
     if (mountp == NULL) {
         /* not found */
-        mutex_unlock(&_mount_mutex);
         return -ENOENT;
     }
-    /* Increment open files counter for this mount */
-    atomic_fetch_add(&mountp->open_files, 1);
-    mutex_unlock(&_mount_mutex);
     *mountpp = mountp;
     if (rel_path != NULL) {
-        *rel_path = name + longest_match;
+        /* special check for mount_point == "/" */
+        *rel_path = name + ((mountp->mount_point_len > 1) ? mountp->mount_point_len : 0);
     }
     return 0;
 }
 
+inline static int _iov_is_valid(const struct iovec *iov, int iovcnt)
+{
+    if (iovcnt < 0) {
+        return -EINVAL;
+    }
+    if ((iov == NULL) && (iovcnt > 0)) {
+        return -EFAULT;
+    }
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if ((iov[i].iov_base == NULL) && (iov[i].iov_len > 0)) {
+            return -EFAULT;
+        }
+        total += iov[i].iov_len;
+        if ((total < iov[i].iov_len) || ((ssize_t)total < 0)) {
+            /* the sum of the buffer lengths does not fit in the return value */
+            return -EINVAL;
+        }
+    }
+    return 0;
+}
+
+inline static off_t _seek_swap(vfs_file_t *filp, off_t off)
+{
+    if (filp->f_op->lseek == NULL) {
+        /* without lseek, the file is not seekable */
+        return -ESPIPE;
+    }
+    off_t pos = filp->f_op->lseek(filp, 0, SEEK_CUR);
+    if (pos < 0) {
+        return pos;
+    }
+    off_t res = filp->f_op->lseek(filp, off, SEEK_SET);
+    if (res < 0) {
+        return res;
+    }
+    return pos;
+}
+
 inline static int _fd_is_valid(int fd)
 {
     if ((unsigned int)fd >= VFS_MAX_OPEN_FILES) {
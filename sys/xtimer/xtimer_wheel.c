@@ -0,0 +1,606 @@
+/**
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ *
+ * @ingroup xtimer
+ * @{
+ * @file
+ * @brief xtimer core functionality based on a hierarchical timing wheel
+ *
+ * Drop-in replacement for xtimer_core.c. Period and overflow handling of the
+ * low-level timer is the same, but instead of sorted lists the timers are
+ * kept in a hierarchical timing wheel:
+ *
+ * - a timer whose target lies within the same 2^XTIMER_WHEEL_SHIFT ticks as
+ *   the wheel's current time is kept in the sorted "due" list,
+ * - otherwise it is put into the slot of the lowest level whose parent slot
+ *   (one level up) contains both the wheel time and the target,
+ * - timers not fitting into the top level go to the "far" list.
+ *
+ * The low-level timer is armed for the head of the due list or the start of
+ * the next non-empty slot, whichever comes first. When a slot is reached its
+ * timers are re-hashed into the lower levels (cascading). Every timer knows
+ * the link pointing to it, so removal is O(1).
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "board.h"
+#include "periph/timer.h"
+#include "periph_conf.h"
+
+#include "bitarithm.h"
+#include "xtimer.h"
+#include "irq.h"
+
+/* WARNING! enabling this will have side effects and can lead to timer underflows. */
+#define ENABLE_DEBUG 0
+#include "debug.h"
+
+#if XTIMER_WHEEL_BITS > 5
+#error "XTIMER_WHEEL_BITS must not exceed 5"
+#endif
+
+#define WHEEL_SLOTS     (1U << XTIMER_WHEEL_BITS)
+#define WHEEL_SPAN(l)   (XTIMER_WHEEL_SHIFT + ((l) * XTIMER_WHEEL_BITS))
+#define LLTIMER_MASK    ((uint64_t)_xtimer_lltimer_mask(0xFFFFFFFF))
+
+static volatile int _in_handler = 0;
+
+static volatile uint32_t _long_cnt = 0;
+#if XTIMER_MASK
+volatile uint32_t _xtimer_high_cnt = 0;
+#endif
+
+/* what the low-level timer is armed for */
+static uint64_t _armed;
+static int _armed_period_end;
+
+static uint64_t _wheel_time = 0;
+static xtimer_t *_due = NULL;
+static xtimer_t *_far = NULL;
+static xtimer_t *_slots[XTIMER_WHEEL_LEVELS][WHEEL_SLOTS];
+static uint32_t _slots_used[XTIMER_WHEEL_LEVELS];
+
+static inline void xtimer_spin_until(uint32_t value);
+static void _shoot(xtimer_t *timer);
+static void _remove(xtimer_t *timer);
+static inline void _lltimer_set(uint32_t target);
+static uint32_t _time_left(uint32_t target, uint32_t reference);
+
+static void _timer_callback(void);
+static void _periph_timer_callback(void *arg, int chan);
+
+static inline int _is_set(xtimer_t *timer)
+{
+    return (timer->target || timer->long_target);
+}
+
+static inline uint64_t _target64(xtimer_t *timer)
+{
+    return ((uint64_t)timer->long_target << 32) | timer->target;
+}
+
+static inline uint64_t _period_start(void)
+{
+#if XTIMER_MASK
+    return ((uint64_t)_long_cnt << 32) | _xtimer_high_cnt;
+#else
+    return ((uint64_t)_long_cnt << 32);
+#endif
+}
+
+static inline void xtimer_spin_until(uint32_t target) {
+#if XTIMER_MASK
+    target = _xtimer_lltimer_mask(target);
+#endif
+    while (_xtimer_lltimer_now() > target);
+    while (_xtimer_lltimer_now() < target);
+}
+
+void xtimer_init(void)
+{
+    /* initialize low-level timer */
+    timer_init(XTIMER_DEV, XTIMER_HZ, _periph_timer_callback, NULL);
+
+    /* register initial overflow tick */
+    _armed = LLTIMER_MASK;
+    _armed_period_end = 1;
+    _lltimer_set(0xFFFFFFFF);
+}
+
+static void _xtimer_now_internal(uint32_t *short_term, uint32_t *long_term)
+{
+    uint32_t before, after, long_value;
+
+    /* loop to cope with possible overflow of _xtimer_now() */
+    do {
+        before = _xtimer_now();
+        long_value = _long_cnt;
+        after = _xtimer_now();
+
+    } while(before > after);
+
+    *short_term = after;
+    *long_term = long_value;
+}
+
+uint64_t _xtimer_now64(void)
+{
+    uint32_t short_term, long_term;
+    _xtimer_now_internal(&short_term, &long_term);
+
+    return ((uint64_t)long_term<<32) + short_term;
+}
+
+static void _link(xtimer_t **pos, xtimer_t *timer)
+{
+    timer->next = *pos;
+    if (timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = pos;
+    *pos = timer;
+}
+
+static void _unlink(xtimer_t *timer)
+{
+    xtimer_t **pos = timer->pprev;
+    xtimer_t **slots = &_slots[0][0];
+
+    *pos = timer->next;
+    if (timer->next) {
+        timer->next->pprev = pos;
+    }
+    timer->pprev = NULL;
+
+    /* keep the slot usage bitmap in sync if this emptied a wheel slot */
+    if (!*pos && (pos >= slots) && (pos < (slots + (XTIMER_WHEEL_LEVELS * WHEEL_SLOTS)))) {
+        unsigned idx = pos - slots;
+        _slots_used[idx / WHEEL_SLOTS] &= ~(1UL << (idx % WHEEL_SLOTS));
+    }
+}
+
+static inline int _wheel_empty(void)
+{
+    for (unsigned l = 0; l < XTIMER_WHEEL_LEVELS; l++) {
+        if (_slots_used[l]) {
+            return 0;
+        }
+    }
+    return (!_due && !_far);
+}
+
+static void _insert(xtimer_t *timer)
+{
+    uint64_t target = _target64(timer);
+
+    if ((target >> XTIMER_WHEEL_SHIFT) <= (_wheel_time >> XTIMER_WHEEL_SHIFT)) {
+        /* expires within the current granule: keep it sorted */
+        xtimer_t **pos = &_due;
+        while (*pos && (_target64(*pos) <= target)) {
+            pos = &((*pos)->next);
+        }
+        _link(pos, timer);
+        return;
+    }
+
+    for (unsigned l = 0; l < XTIMER_WHEEL_LEVELS; l++) {
+        if ((target >> WHEEL_SPAN(l + 1)) == (_wheel_time >> WHEEL_SPAN(l + 1))) {
+            unsigned idx = (target >> WHEEL_SPAN(l)) & (WHEEL_SLOTS - 1);
+            _link(&_slots[l][idx], timer);
+            _slots_used[l] |= (1UL << idx);
+            return;
+        }
+    }
+
+    _link(&_far, timer);
+}
+
+/**
+ * @brief   get the earliest non-empty wheel slot
+ *
+ * @return  the slot's level, XTIMER_WHEEL_LEVELS for the far list
+ * @return  -1 if there is no timer outside of the due list
+ */
+static int _next_slot(uint64_t *start)
+{
+    int level = -1;
+
+    for (unsigned l = 0; l < XTIMER_WHEEL_LEVELS; l++) {
+        if (_slots_used[l]) {
+            uint64_t slot = ((_wheel_time >> WHEEL_SPAN(l + 1)) << WHEEL_SPAN(l + 1)) +
+                            ((uint64_t)bitarithm_lsb(_slots_used[l]) << WHEEL_SPAN(l));
+            if ((level < 0) || (slot < *start)) {
+                *start = slot;
+                level = l;
+            }
+        }
+    }
+    if (_far) {
+        uint64_t wrap = ((_wheel_time >> WHEEL_SPAN(XTIMER_WHEEL_LEVELS)) + 1) <<
+                        WHEEL_SPAN(XTIMER_WHEEL_LEVELS);
+        if ((level < 0) || (wrap < *start)) {
+            *start = wrap;
+            level = XTIMER_WHEEL_LEVELS;
+        }
+    }
+
+    return level;
+}
+
+static uint64_t _next_event(void)
+{
+    uint64_t start = UINT64_MAX;
+
+    /* due timers always expire before the next slot starts */
+    if (_due) {
+        return _target64(_due);
+    }
+    _next_slot(&start);
+    return start;
+}
+
+/**
+ * @brief advance the wheel through all slots starting until @p limit and
+ *        re-hash their timers
+ */
+static void _cascade(uint64_t limit)
+{
+    uint64_t start;
+    int level;
+
+    while (((level = _next_slot(&start)) >= 0) && (start <= limit)) {
+        xtimer_t *list;
+
+        _wheel_time = start;
+        if (level < (int)XTIMER_WHEEL_LEVELS) {
+            unsigned idx = (start >> WHEEL_SPAN(level)) & (WHEEL_SLOTS - 1);
+            list = _slots[level][idx];
+            _slots[level][idx] = NULL;
+            _slots_used[level] &= ~(1UL << idx);
+        }
+        else {
+            list = _far;
+            _far = NULL;
+        }
+        DEBUG("_cascade(): level %i at %" PRIu32 ":%" PRIu32 "\n", level,
+              (uint32_t)(start >> 32), (uint32_t)start);
+
+        while (list) {
+            xtimer_t *timer = list;
+            list = timer->next;
+            _insert(timer);
+        }
+    }
+}
+
+/**
+ * @brief re-arm the low-level timer if an insertion brought the next event
+ *        forward
+ */
+static void _rearm(void)
+{
+    uint64_t next, min;
+
+    if (_in_handler) {
+        return;
+    }
+    next = _next_event();
+    min = _xtimer_now64() + XTIMER_BACKOFF + XTIMER_OVERHEAD;
+    if (next < min) {
+        next = min;
+    }
+    if (next < _armed) {
+        DEBUG("_rearm(): next event is new earliest. updating lltimer.\n");
+        _armed = next;
+        _armed_period_end = 0;
+        _lltimer_set((uint32_t)next - XTIMER_OVERHEAD);
+    }
+}
+
+static void _add(xtimer_t *timer)
+{
+    if (_wheel_empty()) {
+        _wheel_time = _xtimer_now64() & ~((1ULL << XTIMER_WHEEL_SHIFT) - 1);
+    }
+    _insert(timer);
+    _rearm();
+}
+
+void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
+{
+    DEBUG(" _xtimer_set64() offset=%" PRIu32 " long_offset=%" PRIu32 "\n", offset, long_offset);
+    if (!long_offset) {
+        /* timer fits into the short timer */
+        _xtimer_set(timer, (uint32_t) offset);
+    }
+    else {
+        int state = irq_disable();
+        if (_is_set(timer)) {
+            _remove(timer);
+        }
+
+        _xtimer_now_internal(&timer->target, &timer->long_target);
+        timer->target += offset;
+        timer->long_target += long_offset;
+        if (timer->target < offset) {
+            timer->long_target++;
+        }
+
+        _add(timer);
+        irq_restore(state);
+        DEBUG("xtimer_set64(): added longterm timer (long_target=%" PRIu32 " target=%" PRIu32 ")\n",
+                timer->long_target, timer->target);
+    }
+}
+
+void _xtimer_set(xtimer_t *timer, uint32_t offset)
+{
+    DEBUG("timer_set(): offset=%" PRIu32 " now=%" PRIu32 " (%" PRIu32 ")\n",
+          offset, xtimer_now().ticks32, _xtimer_lltimer_now());
+    if (!timer->callback) {
+        DEBUG("timer_set(): timer has no callback.\n");
+        return;
+    }
+
+    xtimer_remove(timer);
+
+    if (offset < XTIMER_BACKOFF) {
+        _xtimer_spin(offset);
+        _shoot(timer);
+    }
+    else {
+        uint32_t target = _xtimer_now() + offset;
+        _xtimer_set_absolute(timer, target);
+    }
+}
+
+static void _periph_timer_callback(void *arg, int chan)
+{
+    (void)arg;
+    (void)chan;
+    _timer_callback();
+}
+
+static void _shoot(xtimer_t *timer)
+{
+    timer->callback(timer->arg);
+}
+
+static inline void _lltimer_set(uint32_t target)
+{
+    if (_in_handler) {
+        return;
+    }
+    DEBUG("_lltimer_set(): setting %" PRIu32 "\n", _xtimer_lltimer_mask(target));
+    timer_set_absolute(XTIMER_DEV, XTIMER_CHAN, _xtimer_lltimer_mask(target));
+}
+
+int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
+{
+    uint32_t now = _xtimer_now();
+    int res = 0;
+
+    DEBUG("timer_set_absolute(): now=%" PRIu32 " target=%" PRIu32 "\n", now, target);
+
+    timer->next = NULL;
+    if ((target >= now) && ((target - XTIMER_BACKOFF) < now)) {
+        /* backoff */
+        xtimer_spin_until(target + XTIMER_BACKOFF);
+        _shoot(timer);
+        return 0;
+    }
+
+    unsigned state = irq_disable();
+    if (_is_set(timer)) {
+        _remove(timer);
+    }
+
+    timer->target = target;
+    timer->long_target = _long_cnt;
+    if (target < now) {
+        timer->long_target++;
+    }
+
+    _add(timer);
+
+    irq_restore(state);
+
+    return res;
+}
+
+static void _remove(xtimer_t *timer)
+{
+    /* a removed head of the due list leaves a spurious interrupt behind,
+     * _timer_callback() copes with that */
+    _unlink(timer);
+    timer->target = 0;
+    timer->long_target = 0;
+}
+
+void xtimer_remove(xtimer_t *timer)
+{
+    int state = irq_disable();
+    if (_is_set(timer)) {
+        _remove(timer);
+    }
+    irq_restore(state);
+}
+
+static uint32_t _time_left(uint32_t target, uint32_t reference)
+{
+    uint32_t now = _xtimer_lltimer_now();
+
+    if (now < reference) {
+        return 0;
+    }
+
+    if (target > now) {
+        return target - now;
+    }
+    else {
+        return 0;
+    }
+}
+
+/**
+ * @brief check if a due timer is close to expiring
+ */
+static int _expiring(uint64_t target, uint64_t period, uint32_t reference)
+{
+    if (target < period) {
+        /* should have fired in an earlier period already */
+        return 1;
+    }
+    if (target > (period + LLTIMER_MASK)) {
+        return 0;
+    }
+    return (_time_left(_xtimer_lltimer_mask((uint32_t)target), reference) < XTIMER_ISR_BACKOFF);
+}
+
+/**
+ * @brief handle low-level timer overflow, advance to next short timer period
+ */
+static void _next_period(void)
+{
+#if XTIMER_MASK
+    /* advance <32bit mask register */
+    _xtimer_high_cnt += ~XTIMER_MASK + 1;
+    if (_xtimer_high_cnt == 0) {
+        /* high_cnt overflowed, so advance >32bit counter */
+        _long_cnt++;
+    }
+#else
+    /* advance >32bit counter */
+    _long_cnt++;
+#endif
+}
+
+/**
+ * @brief main xtimer callback function
+ */
+static void _timer_callback(void)
+{
+    uint32_t next_target;
+    uint32_t reference;
+    uint32_t now;
+    uint64_t period, next;
+
+    _in_handler = 1;
+
+    DEBUG("_timer_callback() now=%" PRIu32 " (%" PRIu32 ")pleft=%" PRIu32 "\n",
+          xtimer_now().ticks32, _xtimer_lltimer_mask(xtimer_now().ticks32),
+          _xtimer_lltimer_mask(0xffffffff - xtimer_now().ticks32));
+
+    if (_armed_period_end) {
+        DEBUG("_timer_callback(): tick\n");
+        /* the low-level timer was armed for the end of the period, so this
+         * was a timer overflow callback.
+         *
+         * In this case, we advance to the next timer period.
+         */
+        _next_period();
+
+        reference = 0;
+
+        /* make sure the timer counter also arrived
+         * in the next timer period */
+        while (_xtimer_lltimer_now() == _xtimer_lltimer_mask(0xFFFFFFFF));
+    }
+    else {
+        /* we ended up in _timer_callback because of a wheel event
+         * (or a removed timer).
+         */
+        /* set our period reference to the current time. */
+        reference = _xtimer_lltimer_now();
+    }
+
+overflow:
+    while (1) {
+        period = _period_start();
+
+        /* move all timers of reached slots towards the due list */
+        _cascade(period + _xtimer_lltimer_now() + XTIMER_ISR_BACKOFF + XTIMER_OVERHEAD);
+
+        /* check if next timers are close to expiring */
+        if (!_due || !_expiring(_target64(_due), period, reference)) {
+            break;
+        }
+
+        /* pick first timer in list */
+        xtimer_t *timer = _due;
+
+        /* make sure we don't fire too early */
+        if (_target64(timer) >= period) {
+            while (_time_left(_xtimer_lltimer_mask(timer->target), reference));
+        }
+
+        /* make sure timer is recognized as being already fired */
+        _unlink(timer);
+        timer->target = 0;
+        timer->long_target = 0;
+
+        /* fire timer */
+        _shoot(timer);
+    }
+
+    /* possibly executing all callbacks took enough
+     * time to overflow.  In that case we advance to
+     * next timer period and check again for expired
+     * timers.*/
+    if (reference > _xtimer_lltimer_now()) {
+        DEBUG("_timer_callback: overflowed while executing callbacks.\n");
+        _next_period();
+        reference = 0;
+        goto overflow;
+    }
+
+    next = _next_event();
+    now = _xtimer_lltimer_now();
+    if (next < (period + LLTIMER_MASK)) {
+        /* make sure we're not setting a time in the past */
+        if ((next < period) ||
+            (_xtimer_lltimer_mask((uint32_t)next) < (now + XTIMER_ISR_BACKOFF + XTIMER_OVERHEAD))) {
+            goto overflow;
+        }
+
+        /* schedule callback on next event */
+        next_target = (uint32_t)next - XTIMER_OVERHEAD;
+        _armed = next;
+        _armed_period_end = 0;
+    }
+    else {
+        /* there's no event planned for this timer period */
+        /* schedule callback on next overflow */
+        next_target = _xtimer_lltimer_mask(0xFFFFFFFF);
+
+        /* check for overflow again */
+        if (now < reference) {
+            _next_period();
+            reference = 0;
+            goto overflow;
+        }
+        else {
+            /* check if the end of this period is very soon */
+            if (_xtimer_lltimer_mask(now + XTIMER_ISR_BACKOFF) < now) {
+                /* spin until next period, then advance */
+                while (_xtimer_lltimer_now() >= now);
+                _next_period();
+                reference = 0;
+                goto overflow;
+            }
+        }
+        _armed = period + LLTIMER_MASK;
+        _armed_period_end = 1;
+    }
+
+    _in_handler = 0;
+
+    /* set low level timer */
+    _lltimer_set(next_target);
+}
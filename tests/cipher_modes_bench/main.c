@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Throughput benchmark of the AES modes of operation
+ *
+ * Prints the cycles per byte of each mode, or the nanoseconds per byte on
+ * boards that do not define CLOCK_CORECLOCK (e.g. native). Build with
+ * `AES_IMPL=bitslice` or `AES_IMPL=ni` to compare the AES implementations.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "crypto/aes.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/cbc.h"
+#include "crypto/modes/ccm.h"
+#include "crypto/modes/ctr.h"
+#include "crypto/modes/ecb.h"
+#include "periph_conf.h"
+#include "xtimer.h"
+
+#ifndef BENCH_SIZE
+#define BENCH_SIZE      (1024U)
+#endif
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (64U)
+#endif
+
+#define MAC_LEN         (8U)
+#define NONCE_LEN       (13U)
+#define ADATA_LEN       (16U)
+
+static uint8_t _key[AES_KEY_SIZE] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static uint8_t _nonce[NONCE_LEN];
+static uint8_t _adata[ADATA_LEN];
+static uint8_t _in[BENCH_SIZE + MAC_LEN];
+static uint8_t _out[BENCH_SIZE + MAC_LEN];
+static cipher_t _cipher;
+
+static int _ecb_enc(void)
+{
+    return cipher_encrypt_ecb(&_cipher, _in, BENCH_SIZE, _out);
+}
+
+static int _ecb_dec(void)
+{
+    return cipher_decrypt_ecb(&_cipher, _in, BENCH_SIZE, _out);
+}
+
+static int _cbc_enc(void)
+{
+    uint8_t iv[AES_BLOCK_SIZE] = { 0 };
+
+    return cipher_encrypt_cbc(&_cipher, iv, _in, BENCH_SIZE, _out);
+}
+
+static int _cbc_dec(void)
+{
+    uint8_t iv[AES_BLOCK_SIZE] = { 0 };
+
+    return cipher_decrypt_cbc(&_cipher, iv, _in, BENCH_SIZE, _out);
+}
+
+static int _ctr(void)
+{
+    uint8_t ctr[AES_BLOCK_SIZE] = { 0 };
+
+    return cipher_encrypt_ctr(&_cipher, ctr, 0, _in, BENCH_SIZE, _out);
+}
+
+static int _ccm_enc(void)
+{
+    return cipher_encrypt_ccm(&_cipher, _adata, ADATA_LEN, MAC_LEN, 2,
+                              _nonce, NONCE_LEN, _in, BENCH_SIZE, _out);
+}
+
+static int _ccm_dec(void)
+{
+    return cipher_decrypt_ccm(&_cipher, _adata, ADATA_LEN, MAC_LEN, 2,
+                              _nonce, NONCE_LEN, _in, BENCH_SIZE + MAC_LEN, _out);
+}
+
+static void _bench(const char *name, int (*func)(void))
+{
+    uint32_t start = xtimer_now_usec();
+    int res = 0;
+
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        res = func();
+        if (res < 0) {
+            printf("%-8s failed: %d\n", name, res);
+            return;
+        }
+    }
+    uint32_t time = xtimer_now_usec() - start;
+#ifdef CLOCK_CORECLOCK
+    uint64_t cycles = (uint64_t)time * (CLOCK_CORECLOCK / US_PER_SEC);
+    printf("%-8s %6" PRIu32 " us, %4u cycles/byte\n", name, time,
+           (unsigned)(cycles / ((uint64_t)BENCH_RUNS * BENCH_SIZE)));
+#else
+    printf("%-8s %6" PRIu32 " us, %4u ns/byte\n", name, time,
+           (unsigned)(((uint64_t)time * 1000) / ((uint64_t)BENCH_RUNS * BENCH_SIZE)));
+#endif
+}
+
+int main(void)
+{
+    puts("AES modes of operation benchmark");
+    printf("%u bytes, %u runs\n", (unsigned)BENCH_SIZE, (unsigned)BENCH_RUNS);
+
+    for (unsigned i = 0; i < sizeof(_in); i++) {
+        _in[i] = (uint8_t)i;
+    }
+    if (cipher_init(&_cipher, CIPHER_AES_128, _key, AES_KEY_SIZE) < 0) {
+        puts("cipher init failed");
+        return 1;
+    }
+
+    _bench("ECB enc", _ecb_enc);
+    _bench("ECB dec", _ecb_dec);
+    _bench("CBC enc", _cbc_enc);
+    _bench("CBC dec", _cbc_dec);
+    _bench("CTR", _ctr);
+    _bench("CCM enc", _ccm_enc);
+    /* decrypt what was encrypted, so that the MAC check passes */
+    cipher_encrypt_ccm(&_cipher, _adata, ADATA_LEN, MAC_LEN, 2, _nonce,
+                       NONCE_LEN, _in, BENCH_SIZE, _in);
+    _bench("CCM dec", _ccm_dec);
+
+    puts("done");
+    return 0;
+}
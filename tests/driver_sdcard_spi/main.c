@@ -22,6 +22,8 @@
 #include "sdcard_spi_internal.h"
 #include "sdcard_spi_params.h"
 #include "fmt.h"
+#include "xtimer.h"
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -333,6 +335,105 @@ static int _copy(int argc, char **argv)
     return 0;
 }
 
+static void _print_rate(const char *name, int blocks, uint32_t usec)
+{
+    uint32_t kib_s = 0;
+
+    if (usec > 0) {
+        kib_s = (uint32_t)(((uint64_t)blocks * SD_HC_BLOCK_SIZE * US_PER_SEC) / (1024 * usec));
+    }
+    printf("%-8s %5d blocks in %10" PRIu32 " us: %6" PRIu32 " KiB/s\n", name, blocks, usec,
+           kib_s);
+}
+
+static int _bench(int argc, char **argv)
+{
+    int bladdr;
+    int cnt;
+    int done;
+    uint32_t start;
+    sd_rw_response_t state;
+
+    if (argc != 3) {
+        printf("usage: %s blockaddr cnt\n", argv[0]);
+        return -1;
+    }
+    bladdr = atoi(argv[1]);
+    cnt = atoi(argv[2]);
+
+    for (unsigned i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (char)i;
+    }
+
+    /* one CMD24 per block */
+    start = xtimer_now_usec();
+    for (done = 0; done < cnt; done++) {
+        if (sdcard_spi_write_blocks(card, bladdr + done, buffer, SD_HC_BLOCK_SIZE, 1,
+                                    &state) != 1) {
+            printf("single block write error %d (block %d)\n", state, bladdr + done);
+            return -1;
+        }
+    }
+    _print_rate("single", cnt, xtimer_now_usec() - start);
+
+    /* one CMD25 per MAX_BLOCKS_IN_BUFFER blocks */
+    start = xtimer_now_usec();
+    for (done = 0; done < cnt; done += MAX_BLOCKS_IN_BUFFER) {
+        int chunk_blocks = (cnt - done < MAX_BLOCKS_IN_BUFFER) ? cnt - done : MAX_BLOCKS_IN_BUFFER;
+
+        if (sdcard_spi_write_blocks(card, bladdr + done, buffer, SD_HC_BLOCK_SIZE, chunk_blocks,
+                                    &state) != chunk_blocks) {
+            printf("multi block write error %d (blocks %d)\n", state, bladdr + done);
+            return -1;
+        }
+    }
+    _print_rate("multi", cnt, xtimer_now_usec() - start);
+
+    /* one CMD25 session for all blocks */
+    start = xtimer_now_usec();
+    state = sdcard_spi_write_start(card, bladdr, cnt);
+    if (state != SD_RW_OK) {
+        printf("write session start error %d\n", state);
+        return -1;
+    }
+    for (done = 0; done < cnt; done += MAX_BLOCKS_IN_BUFFER) {
+        int chunk_blocks = (cnt - done < MAX_BLOCKS_IN_BUFFER) ? cnt - done : MAX_BLOCKS_IN_BUFFER;
+
+        if (sdcard_spi_write_next(card, buffer, chunk_blocks, &state) != chunk_blocks) {
+            printf("write session error %d (blocks %d)\n", state, bladdr + done);
+            return -1;
+        }
+    }
+    state = sdcard_spi_write_stop(card);
+    if (state != SD_RW_OK) {
+        printf("write session stop error %d\n", state);
+        return -1;
+    }
+    _print_rate("stream", cnt, xtimer_now_usec() - start);
+
+    /* one CMD18 per MAX_BLOCKS_IN_BUFFER blocks */
+    start = xtimer_now_usec();
+    for (done = 0; done < cnt; done += MAX_BLOCKS_IN_BUFFER) {
+        int chunk_blocks = (cnt - done < MAX_BLOCKS_IN_BUFFER) ? cnt - done : MAX_BLOCKS_IN_BUFFER;
+
+        if (sdcard_spi_read_blocks(card, bladdr + done, buffer, SD_HC_BLOCK_SIZE, chunk_blocks,
+                                   &state) != chunk_blocks) {
+            printf("read error %d (blocks %d)\n", state, bladdr + done);
+            return -1;
+        }
+    }
+    _print_rate("read", cnt, xtimer_now_usec() - start);
+
+    for (unsigned i = 0; i < sizeof(buffer); i++) {
+        if (buffer[i] != (char)i) {
+            printf("data mismatch at offset %u\n", i);
+            return -1;
+        }
+    }
+    puts("bench [OK]");
+    return 0;
+}
+
 static int _sector_count(int argc, char **argv)
 {
     printf("available sectors on card: %li\n", sdcard_spi_get_sector_count(card));
@@ -351,6 +452,9 @@ static const shell_command_t shell_commands[] = {
     { "write", "'write n data' writes data to block n. Append -r option to "
                "repeatedly write data to coplete block", _write },
     { "copy", "'copy src dst' copies block src to block dst", _copy },
+    { "bench", "'bench n m' writes m blocks beginning at block n with single block writes, "
+               "multi block writes and one write session, reads them and prints the throughput",
+      _bench },
     { NULL, NULL, NULL }
 };
 
@@ -361,7 +465,7 @@ int main(void)
     card->init_done = false;
 
     puts("insert SD-card and use 'init' command to set card to spi mode");
-    puts("WARNING: using 'write' or 'copy' commands WILL overwrite data on your sd-card and");
+    puts("WARNING: using 'write', 'copy' or 'bench' commands WILL overwrite data on your sd-card and");
     puts("almost for sure corrupt existing filesystems, partitions and contained data!");
     char line_buf[SHELL_DEFAULT_BUFSIZE];
     shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Lookup cost of the IPv6 neighbor cache
+ *
+ * Prints the cost of a hit and of a miss depending on the number of entries
+ * in the cache. Build with `NC_IMPL=linear` to compare the hash index with
+ * the linear search, and with `NC_SIZE=<n>` for another cache size.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "xtimer.h"
+
+#ifndef BENCH_LOOKUPS
+#define BENCH_LOOKUPS   (1000U)
+#endif
+
+#define BENCH_NETIF     (7)
+
+/* n-th of a set of distinct addresses */
+static void _set_nth_addr(ipv6_addr_t *addr, unsigned n)
+{
+    ipv6_addr_from_str(addr, "2001:db8::");
+    addr->u16[6] = byteorder_htons(n * 7);
+    addr->u16[7] = byteorder_htons(n);
+}
+
+/* nanoseconds per lookup */
+static uint32_t _bench_get(const ipv6_addr_t *addr)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+        gnrc_ipv6_nc_get(BENCH_NETIF, addr);
+    }
+    return ((xtimer_now_usec() - start) * 1000U) / BENCH_LOOKUPS;
+}
+
+int main(void)
+{
+    ipv6_addr_t addr;
+    unsigned numof = 0;
+
+    gnrc_ipv6_nc_init();
+#ifdef MODULE_GNRC_IPV6_NC_HASH
+    puts("ipv6_nc lookup cost (hash index)");
+#else
+    puts("ipv6_nc lookup cost (linear search)");
+#endif
+    puts("entries hit[ns] miss[ns]");
+    for (unsigned size = 1; numof < GNRC_IPV6_NC_SIZE; size *= 2) {
+        uint32_t hit, miss;
+
+        for (; (numof < size) && (numof < GNRC_IPV6_NC_SIZE); numof++) {
+            _set_nth_addr(&addr, numof);
+            if (gnrc_ipv6_nc_add(BENCH_NETIF, &addr, NULL, 0, 0) == NULL) {
+                puts("[FAILED] could not fill the neighbor cache");
+                return 1;
+            }
+        }
+        /* the newest entry is the last one a linear search finds */
+        _set_nth_addr(&addr, numof - 1);
+        hit = _bench_get(&addr);
+        _set_nth_addr(&addr, GNRC_IPV6_NC_SIZE);
+        miss = _bench_get(&addr);
+        printf("%7u %7lu %8lu\n", numof, (unsigned long)hit, (unsigned long)miss);
+    }
+    puts("[SUCCESS]");
+
+    return 0;
+}
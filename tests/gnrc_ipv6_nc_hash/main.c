@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Runs the neighbor cache unit tests with the hash index
+ *
+ * @}
+ */
+
+#include "embUnit.h"
+#include "xtimer.h"
+
+#include "tests-ipv6_nc.h"
+
+int main(void)
+{
+#ifdef MODULE_XTIMER
+    /* auto_init is disabled, as in the unittests application */
+    xtimer_init();
+#endif
+
+    TESTS_START();
+    tests_ipv6_nc();
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Test application for the size-class packet buffer
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/pktbuf_slab.h"
+
+#define TEST_NUMOF      (GNRC_PKTBUF_SLAB_SMALL_NUMOF / 4)
+#define TEST_STRING     "Lorem ipsum dolor sit amet"
+
+static gnrc_pktsnip_t *pkts[TEST_NUMOF];
+
+static int _check(int cond, const char *msg)
+{
+    if (!cond) {
+        printf("[FAILED] %s\n", msg);
+        gnrc_pktbuf_stats();
+    }
+    return !cond;
+}
+
+int main(void)
+{
+    gnrc_pktbuf_slab_stats_t stats;
+    gnrc_pktsnip_t *frame, *hdr;
+
+    puts("[START]");
+    if (_check(gnrc_pktbuf_is_empty() && gnrc_pktbuf_is_sane(), "initial state")) {
+        return 1;
+    }
+    /* snip + data of each of these packets fit into the small class */
+    for (unsigned i = 0; i < TEST_NUMOF; i++) {
+        pkts[i] = gnrc_pktbuf_add(NULL, TEST_STRING, sizeof(TEST_STRING),
+                                  GNRC_NETTYPE_UNDEF);
+        if (_check(pkts[i] != NULL, "add small packet")) {
+            return 1;
+        }
+    }
+    gnrc_pktbuf_slab_get_stats(0, &stats);
+    if (_check(stats.used == (2 * TEST_NUMOF), "small class usage")) {
+        return 1;
+    }
+    /* a full 802.15.4 frame goes to the medium class */
+    frame = gnrc_pktbuf_add(NULL, NULL, GNRC_PKTBUF_SLAB_MEDIUM_SIZE,
+                            GNRC_NETTYPE_UNDEF);
+    if (_check(frame != NULL, "add frame")) {
+        return 1;
+    }
+    memset(frame->data, 0xaa, frame->size);
+    hdr = gnrc_pktbuf_mark(frame, 8, GNRC_NETTYPE_UNDEF);
+    if (_check((hdr != NULL) && (hdr->size == 8) &&
+               (frame->size == (GNRC_PKTBUF_SLAB_MEDIUM_SIZE - 8)) &&
+               (((uint8_t *)hdr->data)[7] == 0xaa), "mark header")) {
+        return 1;
+    }
+    /* growing beyond the block moves the data to a larger class */
+    if (_check(gnrc_pktbuf_realloc_data(frame, GNRC_PKTBUF_SLAB_MEDIUM_SIZE + 1) == 0,
+               "grow frame")) {
+        return 1;
+    }
+    gnrc_pktbuf_slab_get_stats(2, &stats);
+    if (_check(stats.used == 1, "large class usage")) {
+        return 1;
+    }
+    if (_check(gnrc_pktbuf_add(NULL, NULL, GNRC_PKTBUF_SLAB_LARGE_SIZE + 1,
+                               GNRC_NETTYPE_UNDEF) == NULL, "oversized packet")) {
+        return 1;
+    }
+    gnrc_pktbuf_release(frame);
+    for (unsigned i = 0; i < TEST_NUMOF; i++) {
+        gnrc_pktbuf_release(pkts[i]);
+    }
+    if (_check(gnrc_pktbuf_is_empty() && gnrc_pktbuf_is_sane(), "final state")) {
+        return 1;
+    }
+    gnrc_pktbuf_stats();
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Bulk transfer throughput benchmark for GNRC TCP
+ *
+ * A client thread sends BENCH_SIZE bytes to TARGET_ADDR. A server thread on
+ * this node receives them and reports the throughput, so with the default
+ * loopback target the benchmark runs without any peer. When TARGET_ADDR is a
+ * peer on the link (e.g. `nc -6 -l 5001 > /dev/null` on the tap interface of
+ * the host), only the time the client needed to hand the data to TCP is
+ * printed.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+
+#include "net/af.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/tcp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define CHUNK_SIZE      (4096U)
+
+static uint8_t _cli_buf[CHUNK_SIZE];
+static uint8_t _srv_buf[CHUNK_SIZE];
+static char _cli_stack[THREAD_STACKSIZE_DEFAULT + THREAD_EXTRA_STACKSIZE_PRINTF];
+static char _srv_stack[THREAD_STACKSIZE_DEFAULT + THREAD_EXTRA_STACKSIZE_PRINTF];
+static gnrc_tcp_tcb_t _cli_tcb;
+static gnrc_tcp_tcb_t _srv_tcb;
+
+static uint32_t _kbits(uint32_t bytes, uint32_t usec)
+{
+    return (usec > 0) ? (uint32_t)(((uint64_t)bytes * 8000LLU) / usec) : 0;
+}
+
+static void *_server(void *arg)
+{
+    uint32_t rcvd = 0;
+    uint32_t start = 0;
+    int res;
+
+    (void)arg;
+    gnrc_tcp_tcb_init(&_srv_tcb);
+    res = gnrc_tcp_open_passive(&_srv_tcb, AF_INET6, NULL, TARGET_PORT);
+    if (res < 0) {
+        printf("[FAILED] server: open: %d\n", res);
+        return NULL;
+    }
+
+    while (rcvd < BENCH_SIZE) {
+        res = gnrc_tcp_recv(&_srv_tcb, _srv_buf, sizeof(_srv_buf),
+                            GNRC_TCP_CONNECTION_TIMEOUT_DURATION);
+        if (res < 0) {
+            printf("[FAILED] server: recv: %d after %" PRIu32 " bytes\n", res, rcvd);
+            gnrc_tcp_close(&_srv_tcb);
+            return NULL;
+        }
+        if (rcvd == 0) {
+            start = xtimer_now_usec();
+        }
+        rcvd += res;
+    }
+    /* the first chunk is not timed */
+    uint32_t time = xtimer_now_usec() - start;
+    printf("server: %" PRIu32 " bytes in %" PRIu32 " us, %" PRIu32 " kbit/s\n",
+           rcvd, time, _kbits(rcvd, time));
+    puts("[SUCCESS]");
+    gnrc_tcp_close(&_srv_tcb);
+    return NULL;
+}
+
+static void *_client(void *arg)
+{
+    ipv6_addr_t target;
+    uint32_t sent = 0;
+    uint32_t start;
+    int res;
+
+    (void)arg;
+    if (ipv6_addr_from_str(&target, TARGET_ADDR) == NULL) {
+        puts("[FAILED] client: invalid TARGET_ADDR");
+        return NULL;
+    }
+    for (unsigned i = 0; i < sizeof(_cli_buf); i++) {
+        _cli_buf[i] = (uint8_t)i;
+    }
+
+    gnrc_tcp_tcb_init(&_cli_tcb);
+    res = gnrc_tcp_open_active(&_cli_tcb, AF_INET6, (uint8_t *)&target, TARGET_PORT, 0);
+    if (res < 0) {
+        printf("[FAILED] client: open: %d\n", res);
+        return NULL;
+    }
+
+    start = xtimer_now_usec();
+    while (sent < BENCH_SIZE) {
+        size_t len = BENCH_SIZE - sent;
+
+        len = (len < sizeof(_cli_buf)) ? len : sizeof(_cli_buf);
+        res = gnrc_tcp_send(&_cli_tcb, _cli_buf, len, 0);
+        if (res < 0) {
+            printf("[FAILED] client: send: %d after %" PRIu32 " bytes\n", res, sent);
+            break;
+        }
+        sent += res;
+    }
+    uint32_t time = xtimer_now_usec() - start;
+    printf("client: %" PRIu32 " bytes in %" PRIu32 " us, %" PRIu32 " kbit/s\n",
+           sent, time, _kbits(sent, time));
+    gnrc_tcp_close(&_cli_tcb);
+    return NULL;
+}
+
+int main(void)
+{
+    puts("[START]");
+    printf("target [%s]:%u, %u bytes, %u segments in flight\n", TARGET_ADDR,
+           (unsigned)TARGET_PORT, (unsigned)BENCH_SIZE,
+           (unsigned)(GNRC_TCP_RETRANSMIT_QUEUE_SIZE - 1));
+
+    /* the server must listen before the client connects */
+    thread_create(_srv_stack, sizeof(_srv_stack), THREAD_PRIORITY_MAIN - 1, 0,
+                  _server, NULL, "tcp server");
+    thread_create(_cli_stack, sizeof(_cli_stack), THREAD_PRIORITY_MAIN - 1, 0,
+                  _client, NULL, "tcp client");
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Cost of the internet checksum
+ *
+ * Prints the time per checksummed buffer of the former byte-wise
+ * implementation and of inet_csum_slice() for aligned and unaligned buffers.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "net/inet_csum.h"
+#include "xtimer.h"
+
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS    (100U)
+#endif
+
+/* largest buffer to benchmark (IPv6 minimum MTU) */
+#define BUF_LEN_MAX     (1280U)
+
+static uint8_t _buf[BUF_LEN_MAX + 1];
+
+/* byte-wise implementation inet_csum_slice() had before */
+static uint16_t _ref_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len,
+                                size_t accum_len)
+{
+    uint32_t csum = sum;
+
+    if (len == 0) {
+        return csum;
+    }
+    if (accum_len & 1) {
+        csum += *buf;
+        buf++;
+        len--;
+        accum_len++;
+    }
+    for (int i = 0; i < (len >> 1); buf += 2, i++) {
+        csum += (uint16_t)(*buf << 8) + *(buf + 1);
+    }
+    if ((accum_len + len) & 1) {
+        csum += (uint16_t)(*buf << 8);
+    }
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+    return csum;
+}
+
+int main(void)
+{
+    static const uint16_t lens[] = { 8, 40, 127, 1280 };
+    volatile uint16_t sink = 0;
+    uint32_t seed = 1;
+
+    for (unsigned i = 0; i < sizeof(_buf); i++) {
+        seed = (seed * 1103515245) + 12345;
+        _buf[i] = seed >> 16;
+    }
+    puts("inet_csum cost per buffer");
+    puts("  len offset ref[ns] csum[ns]");
+    for (unsigned i = 0; i < (sizeof(lens) / sizeof(lens[0])); i++) {
+        for (unsigned offset = 0; offset < 2; offset++) {
+            uint32_t start, ref, res;
+
+            start = xtimer_now_usec();
+            for (unsigned r = 0; r < BENCH_ROUNDS; r++) {
+                sink += _ref_csum_slice(0, &_buf[offset], lens[i], 0);
+            }
+            ref = xtimer_now_usec() - start;
+            start = xtimer_now_usec();
+            for (unsigned r = 0; r < BENCH_ROUNDS; r++) {
+                sink += inet_csum_slice(0, &_buf[offset], lens[i], 0);
+            }
+            res = xtimer_now_usec() - start;
+            printf("%5u %6u %7lu %8lu\n", lens[i], offset,
+                   (unsigned long)((ref * 1000U) / BENCH_ROUNDS),
+                   (unsigned long)((res * 1000U) / BENCH_ROUNDS));
+        }
+    }
+    (void)sink;
+    puts("[SUCCESS]");
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test application measuring the latency of a high priority
+ *              thread waiting for a mutex, with and without priority
+ *              inheritance
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "mutex.h"
+#include "mutex_pi.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define ROUNDS          (10U)
+/* time the low priority thread holds the mutex */
+#define HOLD_US         (2000U)
+/* time into it at which the other threads wake up */
+#define WAKEUP_US       (500U)
+/* CPU time the medium priority thread uses per round */
+#define MEDIUM_US       (20000U)
+
+static char stack_high[THREAD_STACKSIZE_MAIN];
+static char stack_medium[THREAD_STACKSIZE_MAIN];
+
+static mutex_t mutex = MUTEX_INIT;
+static mutex_pi_t mutex_pi = MUTEX_PI_INIT;
+static int use_pi;
+static uint32_t max_latency;
+
+static void _lock(void)
+{
+    if (use_pi) {
+        mutex_pi_lock(&mutex_pi);
+    }
+    else {
+        mutex_lock(&mutex);
+    }
+}
+
+static void _unlock(void)
+{
+    if (use_pi) {
+        mutex_pi_unlock(&mutex_pi);
+    }
+    else {
+        mutex_unlock(&mutex);
+    }
+}
+
+static void *_high(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        thread_sleep();
+
+        uint32_t start = xtimer_now_usec();
+        _lock();
+        uint32_t latency = xtimer_now_usec() - start;
+        _unlock();
+
+        if (latency > max_latency) {
+            max_latency = latency;
+        }
+    }
+
+    return NULL;
+}
+
+static void *_medium(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        thread_sleep();
+        xtimer_spin(xtimer_ticks_from_usec(MEDIUM_US));
+    }
+
+    return NULL;
+}
+
+/* main is the low priority thread, it only runs when the others sleep */
+static uint32_t _measure(int pi, kernel_pid_t high, kernel_pid_t medium)
+{
+    xtimer_t wakeup_high, wakeup_medium;
+
+    use_pi = pi;
+    max_latency = 0;
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        _lock();
+        xtimer_set_wakeup(&wakeup_high, WAKEUP_US, high);
+        xtimer_set_wakeup(&wakeup_medium, WAKEUP_US, medium);
+        xtimer_spin(xtimer_ticks_from_usec(HOLD_US));
+        _unlock();
+    }
+    return max_latency;
+}
+
+int main(void)
+{
+    puts("Priority inheritance mutex latency test");
+
+    kernel_pid_t high = thread_create(stack_high, sizeof(stack_high),
+                                      THREAD_PRIORITY_MAIN - 2, 0,
+                                      _high, NULL, "high");
+    kernel_pid_t medium = thread_create(stack_medium, sizeof(stack_medium),
+                                        THREAD_PRIORITY_MAIN - 1, 0,
+                                        _medium, NULL, "medium");
+
+    uint32_t latency = _measure(0, high, medium);
+    printf("mutex_t: worst-case latency %" PRIu32 " us\n", latency);
+    uint32_t latency_pi = _measure(1, high, medium);
+    printf("mutex_pi_t: worst-case latency %" PRIu32 " us\n", latency_pi);
+
+    /* with priority inheritance, only the rest of the critical section */
+    if (latency_pi < HOLD_US + MEDIUM_US / 2) {
+        puts("[SUCCESS]");
+    }
+    else {
+        puts("[FAILED]");
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Test application for the scheduler profiling module
+ *
+ * A higher priority thread is woken by messages from main, so main is
+ * preempted on every message and the receiver's ready-to-running latency is
+ * recorded.
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "msg.h"
+#include "schedprof.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define MSG_NUMOF       (100U)
+#define TRACE_CHUNK     (16U)
+
+static char _stack[THREAD_STACKSIZE_DEFAULT];
+static schedprof_event_t _trace[TRACE_CHUNK];
+
+static void *_receiver(void *arg)
+{
+    msg_t msg;
+
+    (void)arg;
+    while (1) {
+        msg_receive(&msg);
+    }
+    return NULL;
+}
+
+static int _check(int cond, const char *msg)
+{
+    if (!cond) {
+        printf("[FAILED] %s\n", msg);
+    }
+    return !cond;
+}
+
+int main(void)
+{
+    schedprof_thread_t prof;
+#ifdef SCHEDPROF_ISR
+    schedprof_isr_t isr;
+#endif
+    uint32_t hist_sum = 0;
+    unsigned numof, switches = 0;
+    kernel_pid_t pid;
+    msg_t msg;
+
+    puts("[START]");
+    pid = thread_create(_stack, sizeof(_stack), THREAD_PRIORITY_MAIN - 1,
+                        THREAD_CREATE_STACKTEST, _receiver, NULL, "receiver");
+    schedprof_reset();
+
+    for (unsigned i = 0; i < MSG_NUMOF; i++) {
+        msg_send(&msg, pid);
+    }
+    /* let the timer interrupt once */
+    xtimer_usleep(10 * US_PER_MS);
+
+    schedprof_get(pid, &prof);
+    for (unsigned i = 0; i < SCHEDPROF_HIST_NUMOF; i++) {
+        hist_sum += prof.wait_hist[i];
+    }
+    printf("receiver: %" PRIu32 " schedules, wait max %" PRIu32 " ticks at %"
+           PRIu32 " ticks/s\n", prof.schedules, prof.wait_max, schedprof_hz());
+    if (_check(prof.schedules >= MSG_NUMOF, "receiver schedules") ||
+        _check(hist_sum == prof.schedules, "wait histogram")) {
+        return 1;
+    }
+    schedprof_get(thread_getpid(), &prof);
+    printf("main: %" PRIu32 " preemptions\n", prof.preemptions);
+    if (_check(prof.preemptions >= MSG_NUMOF, "main preemptions")) {
+        return 1;
+    }
+#ifdef SCHEDPROF_ISR
+    schedprof_get_isr(&isr);
+    printf("isr: %" PRIu32 " calls\n", isr.count);
+    if (_check(isr.count > 0, "isr count")) {
+        return 1;
+    }
+#endif
+
+    while ((numof = schedprof_trace_read(_trace, TRACE_CHUNK)) > 0) {
+        for (unsigned i = 0; i < numof; i++) {
+            if (_trace[i].event == SCHEDPROF_EVENT_SWITCH) {
+                switches++;
+            }
+        }
+    }
+    printf("trace: %u switches, %" PRIu32 " records lost\n", switches,
+           schedprof_trace_lost());
+    if (_check(switches > 0, "trace")) {
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
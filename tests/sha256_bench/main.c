@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Throughput benchmark of the SHA-256 functions
+ *
+ * Compares plain hashing, HMAC with and without a precomputed key, hashing
+ * several messages one by one and with sha256_multi(), and hash chains.
+ * Prints the cycles per byte, or the nanoseconds per byte on boards that do
+ * not define CLOCK_CORECLOCK (e.g. native). Build with `SHA256_IMPL=ni` to
+ * use the SHA extensions of x86 hosts.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "hashes/sha256.h"
+#include "periph_conf.h"
+#include "xtimer.h"
+
+#ifndef BENCH_SIZE
+#define BENCH_SIZE      (1024U)
+#endif
+#ifndef BENCH_RUNS
+#define BENCH_RUNS      (64U)
+#endif
+
+/* short messages, where the HMAC key pads dominate */
+#define MSG_SIZE        (64U)
+#define MSG_NUMOF       (BENCH_SIZE / MSG_SIZE)
+#define CHAIN_LEN       (BENCH_SIZE / SHA256_DIGEST_LENGTH)
+
+static const uint8_t _key[] = "benchmark key";
+static uint8_t _in[BENCH_SIZE];
+static uint8_t _digest[MSG_NUMOF][SHA256_DIGEST_LENGTH];
+static hmac_sha256_key_t _key_state;
+
+static void _sha256(void)
+{
+    sha256(_in, BENCH_SIZE, _digest[0]);
+}
+
+static void _sha256_short(void)
+{
+    for (unsigned i = 0; i < MSG_NUMOF; i++) {
+        sha256(&_in[i * MSG_SIZE], MSG_SIZE, _digest[i]);
+    }
+}
+
+static void _sha256_multi(void)
+{
+    const void *data[MSG_NUMOF];
+    void *digest[MSG_NUMOF];
+    size_t len[MSG_NUMOF];
+
+    for (unsigned i = 0; i < MSG_NUMOF; i++) {
+        data[i] = &_in[i * MSG_SIZE];
+        digest[i] = _digest[i];
+        len[i] = MSG_SIZE;
+    }
+    sha256_multi(data, len, digest, MSG_NUMOF);
+}
+
+static void _hmac(void)
+{
+    for (unsigned i = 0; i < MSG_NUMOF; i++) {
+        hmac_sha256(_key, sizeof(_key), &_in[i * MSG_SIZE], MSG_SIZE, _digest[i]);
+    }
+}
+
+static void _hmac_precomputed(void)
+{
+    for (unsigned i = 0; i < MSG_NUMOF; i++) {
+        hmac_sha256_precomputed(&_key_state, &_in[i * MSG_SIZE], MSG_SIZE,
+                                _digest[i]);
+    }
+}
+
+static void _chain(void)
+{
+    sha256_chain(_in, SHA256_DIGEST_LENGTH, CHAIN_LEN, _digest[0]);
+}
+
+static void _bench(const char *name, void (*func)(void))
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < BENCH_RUNS; i++) {
+        func();
+    }
+    uint32_t time = xtimer_now_usec() - start;
+#ifdef CLOCK_CORECLOCK
+    uint64_t cycles = (uint64_t)time * (CLOCK_CORECLOCK / US_PER_SEC);
+    printf("%-14s %6" PRIu32 " us, %4u cycles/byte\n", name, time,
+           (unsigned)(cycles / ((uint64_t)BENCH_RUNS * BENCH_SIZE)));
+#else
+    printf("%-14s %6" PRIu32 " us, %4u ns/byte\n", name, time,
+           (unsigned)(((uint64_t)time * 1000) / ((uint64_t)BENCH_RUNS * BENCH_SIZE)));
+#endif
+}
+
+int main(void)
+{
+    puts("SHA-256 benchmark");
+    printf("%u bytes, %u runs, messages of %u bytes\n", (unsigned)BENCH_SIZE,
+           (unsigned)BENCH_RUNS, (unsigned)MSG_SIZE);
+
+    for (unsigned i = 0; i < sizeof(_in); i++) {
+        _in[i] = (uint8_t)i;
+    }
+    hmac_sha256_precompute(&_key_state, _key, sizeof(_key));
+
+    _bench("sha256", _sha256);
+    _bench("sha256 short", _sha256_short);
+    _bench("sha256 multi", _sha256_multi);
+    _bench("hmac", _hmac);
+    _bench("hmac precomp", _hmac_precomputed);
+    _bench("chain", _chain);
+
+    puts("done");
+    return 0;
+}
@@ -17,7 +17,11 @@
 
 #include "bitarithm.h"
 #include "cbor.h"
+#ifdef MODULE_GNRC_PKTBUF
+#include "net/gnrc/pktbuf.h"
+#endif
 
+#include <errno.h>
 #include <float.h>
 #include <math.h>
 #include <stdio.h>
@@ -753,6 +757,232 @@ static void test_double_invalid(void)
 }
 #endif /* CBOR_NO_FLOAT */
 
+static void test_cursor(void)
+{
+    /* [1, -2, "ab", h'00', true, null, {"k": [0]}] */
+    const uint8_t data[] = {0x87, 0x01, 0x21, 0x62, 0x61, 0x62, 0x41, 0x00,
+                            0xf5, 0xf6, 0xa1, 0x61, 0x6b, 0x81, 0x00};
+    cbor_cursor_t it, arr, map, inner;
+    int64_t val;
+    uint64_t uval;
+    const char *str;
+    const uint8_t *bytes;
+    size_t len;
+    bool b;
+
+    cbor_cursor_init(&it, data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(CBOR_MAJOR_ARRAY, cbor_cursor_type(&it));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, cbor_get_uint(&it, &uval));
+    TEST_ASSERT_EQUAL_INT(0, cbor_cursor_enter(&it, &arr));
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_int(&arr, &val));
+    TEST_ASSERT_EQUAL_INT(1, (int)val);
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_int(&arr, &val));
+    TEST_ASSERT_EQUAL_INT(-2, (int)val);
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_tstr(&arr, &str, &len));
+    TEST_ASSERT_EQUAL_INT(2, len);
+    /* no copy: the string points into the data */
+    TEST_ASSERT((const uint8_t *)str == &data[4]);
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_bstr(&arr, &bytes, &len));
+    TEST_ASSERT_EQUAL_INT(1, len);
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_bool(&arr, &b));
+    TEST_ASSERT(b);
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_null(&arr));
+    TEST_ASSERT_EQUAL_INT(0, cbor_cursor_enter(&arr, &map));
+    TEST_ASSERT_EQUAL_INT(0, cbor_map_find(&map, "k", &inner));
+    TEST_ASSERT_EQUAL_INT(CBOR_MAJOR_ARRAY, cbor_cursor_type(&inner));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, cbor_map_find(&map, "x", &inner));
+    TEST_ASSERT_EQUAL_INT(0, cbor_cursor_leave(&arr, &map));
+    TEST_ASSERT(cbor_cursor_at_end(&arr));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, cbor_get_int(&arr, &val));
+    TEST_ASSERT_EQUAL_INT(0, cbor_cursor_leave(&it, &arr));
+    TEST_ASSERT(cbor_cursor_at_end(&it));
+    TEST_ASSERT_EQUAL_INT(sizeof(data), it.pos);
+}
+
+static void test_cursor_skip(void)
+{
+    /* [_ {1: [_ "a", h'0102']}, 24(h'ff'), [[], {}]], 7 written by the old API */
+    TEST_ASSERT(cbor_serialize_array_indefinite(&stream));
+    TEST_ASSERT(cbor_serialize_map(&stream, 1));
+    TEST_ASSERT(cbor_serialize_int(&stream, 1));
+    TEST_ASSERT(cbor_serialize_array_indefinite(&stream));
+    TEST_ASSERT(cbor_serialize_unicode_string(&stream, "a"));
+    TEST_ASSERT(cbor_serialize_byte_stringl(&stream, "\x01\x02", 2));
+    TEST_ASSERT(cbor_write_break(&stream));
+    stream.data[stream.pos++] = 0xd8;   /* tag 24 */
+    stream.data[stream.pos++] = 24;
+    TEST_ASSERT(cbor_serialize_byte_stringl(&stream, "\xff", 1));
+    TEST_ASSERT(cbor_serialize_array(&stream, 2));
+    TEST_ASSERT(cbor_serialize_array(&stream, 0));
+    TEST_ASSERT(cbor_serialize_map(&stream, 0));
+    TEST_ASSERT(cbor_write_break(&stream));
+    TEST_ASSERT(cbor_serialize_int(&stream, 7));
+
+    cbor_cursor_t it, arr;
+    int64_t val;
+
+    cbor_cursor_init(&it, stream.data, stream.pos);
+    TEST_ASSERT_EQUAL_INT(0, cbor_skip(&it));
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_int(&it, &val));
+    TEST_ASSERT_EQUAL_INT(7, (int)val);
+    TEST_ASSERT(cbor_cursor_at_end(&it));
+
+    /* leaving after the first item skips the rest */
+    cbor_cursor_init(&it, stream.data, stream.pos);
+    TEST_ASSERT_EQUAL_INT(0, cbor_cursor_enter(&it, &arr));
+    TEST_ASSERT_EQUAL_INT(0, cbor_skip(&arr));
+    TEST_ASSERT_EQUAL_INT(CBOR_MAJOR_TAG, cbor_cursor_type(&arr));
+    TEST_ASSERT_EQUAL_INT(0, cbor_cursor_leave(&it, &arr));
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_int(&it, &val));
+    TEST_ASSERT_EQUAL_INT(7, (int)val);
+
+    /* truncated data */
+    for (size_t len = 1; len < stream.pos - 1; len++) {
+        cbor_cursor_init(&it, stream.data, len);
+        TEST_ASSERT_EQUAL_INT(-EBADMSG, cbor_skip(&it));
+    }
+}
+
+static void test_cursor_index(void)
+{
+    /* {1: "one", "two": 2, -3: [3]} */
+    const uint8_t data[] = {0xa3, 0x01, 0x63, 0x6f, 0x6e, 0x65,
+                            0x63, 0x74, 0x77, 0x6f, 0x02,
+                            0x22, 0x81, 0x03};
+    cbor_cursor_t it, value;
+    cbor_index_t idx;
+    size_t offsets[3];
+    int64_t val;
+    const char *str;
+    size_t len;
+
+    cbor_cursor_init(&it, data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, cbor_index_init(&idx, &it, offsets, 2));
+    TEST_ASSERT_EQUAL_INT(0, cbor_index_init(&idx, &it, offsets, 3));
+    TEST_ASSERT_EQUAL_INT(3, idx.numof);
+
+    TEST_ASSERT_EQUAL_INT(0, cbor_index_find(&idx, "two", &value));
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_int(&value, &val));
+    TEST_ASSERT_EQUAL_INT(2, (int)val);
+    TEST_ASSERT(cbor_cursor_at_end(&value));
+    TEST_ASSERT_EQUAL_INT(0, cbor_index_find_int(&idx, 1, &value));
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_tstr(&value, &str, &len));
+    TEST_ASSERT_EQUAL_INT(3, len);
+    TEST_ASSERT_EQUAL_INT(0, cbor_index_find_int(&idx, -3, &value));
+    TEST_ASSERT_EQUAL_INT(CBOR_MAJOR_ARRAY, cbor_cursor_type(&value));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, cbor_index_find_int(&idx, 2, &value));
+
+    /* entries by position, the key comes first */
+    TEST_ASSERT_EQUAL_INT(0, cbor_index_get(&idx, 2, &value));
+    TEST_ASSERT_EQUAL_INT(0, cbor_get_int(&value, &val));
+    TEST_ASSERT_EQUAL_INT(-3, (int)val);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, cbor_index_get(&idx, 3, &value));
+}
+
+static uint8_t _flushed[64];
+static size_t _flushed_len;
+static unsigned _flushes;
+
+static int _flush(void *arg, const uint8_t *data, size_t len)
+{
+    (void)arg;
+
+    if (_flushed_len + len > sizeof(_flushed)) {
+        return -ENOSPC;
+    }
+    memcpy(&_flushed[_flushed_len], data, len);
+    _flushed_len += len;
+    _flushes++;
+    return 0;
+}
+
+static void test_writer(void)
+{
+    uint8_t buf[10];
+    cbor_writer_t w;
+    const char long_str[] = "longer than the buffer";
+
+    /* the same items with the stream API */
+    TEST_ASSERT(cbor_serialize_map(&stream, 2));
+    TEST_ASSERT(cbor_serialize_unicode_string(&stream, "a"));
+    TEST_ASSERT(cbor_serialize_int64_t(&stream, -1000000));
+    TEST_ASSERT(cbor_serialize_int(&stream, 2));
+    TEST_ASSERT(cbor_serialize_array_indefinite(&stream));
+    TEST_ASSERT(cbor_serialize_uint64_t(&stream, 0x100000000ULL));
+    TEST_ASSERT(cbor_serialize_byte_string(&stream, long_str));
+    TEST_ASSERT(cbor_serialize_bool(&stream, false));
+    TEST_ASSERT(cbor_write_break(&stream));
+
+    _flushed_len = 0;
+    _flushes = 0;
+    cbor_writer_init(&w, buf, sizeof(buf), _flush, NULL);
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_map(&w, 2));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_tstr(&w, "a", 1));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_int(&w, -1000000));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_int(&w, 2));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_array(&w, CBOR_CURSOR_INDEFINITE));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_uint(&w, 0x100000000ULL));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_bstr(&w, long_str, strlen(long_str)));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_bool(&w, false));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_break(&w));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_flush(&w));
+    TEST_ASSERT(_flushes > 1);
+    TEST_ASSERT_EQUAL_INT(stream.pos, _flushed_len);
+    TEST_ASSERT_EQUAL_INT(stream.pos, w.flushed);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(stream.data, _flushed, _flushed_len));
+
+    /* without flush function, the buffer is all there is */
+    cbor_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, cbor_writer_bstr(&w, long_str, strlen(long_str)));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, cbor_writer_null(&w));
+
+    /* errors of the flush function stick */
+    _flushed_len = sizeof(_flushed);
+    cbor_writer_init(&w, buf, sizeof(buf), _flush, NULL);
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, cbor_writer_bstr(&w, long_str, strlen(long_str)));
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, cbor_writer_null(&w));
+
+    /* a buffer without room for every head is refused */
+    cbor_writer_init(&w, buf, CBOR_WRITER_BUF_MIN - 1, _flush, NULL);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, cbor_writer_null(&w));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, cbor_writer_flush(&w));
+}
+
+#ifdef MODULE_GNRC_PKTBUF
+static void test_writer_pktbuf(void)
+{
+    uint8_t buf[CBOR_WRITER_BUF_MIN];
+    cbor_writer_t w;
+    cbor_writer_pktbuf_t chain = { NULL, NULL };
+    uint8_t *out = stream.data;
+
+    gnrc_pktbuf_init();
+    TEST_ASSERT(cbor_serialize_array(&stream, 3));
+    TEST_ASSERT(cbor_serialize_uint64_t(&stream, 0x100000000ULL));
+    TEST_ASSERT(cbor_serialize_uint64_t(&stream, 0x100000001ULL));
+    TEST_ASSERT(cbor_serialize_uint64_t(&stream, 0x100000002ULL));
+
+    cbor_writer_init(&w, buf, sizeof(buf), cbor_writer_flush_pktbuf, &chain);
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_array(&w, 3));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_uint(&w, 0x100000000ULL));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_uint(&w, 0x100000001ULL));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_uint(&w, 0x100000002ULL));
+    TEST_ASSERT_EQUAL_INT(0, cbor_writer_flush(&w));
+
+    /* the snips hold the encoding in order */
+    TEST_ASSERT_EQUAL_INT(stream.pos, gnrc_pkt_len(chain.head));
+    for (gnrc_pktsnip_t *snip = chain.head; snip != NULL; snip = snip->next) {
+        TEST_ASSERT_EQUAL_INT(0, memcmp(out, snip->data, snip->size));
+        out += snip->size;
+        if (snip->next == NULL) {
+            TEST_ASSERT(snip == chain.tail);
+        }
+    }
+    gnrc_pktbuf_release(chain.head);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+#endif
+
 #ifndef CBOR_NO_PRINT
 /**
  * Manual test for testing the cbor_stream_decode function
@@ -855,6 +1085,13 @@ TestRef tests_cbor_all(void)
                         new_TestFixture(test_double),
                         new_TestFixture(test_double_invalid),
 #endif /* CBOR_NO_FLOAT */
+                        new_TestFixture(test_cursor),
+                        new_TestFixture(test_cursor_skip),
+                        new_TestFixture(test_cursor_index),
+                        new_TestFixture(test_writer),
+#ifdef MODULE_GNRC_PKTBUF
+                        new_TestFixture(test_writer_pktbuf),
+#endif
     };
 
     EMB_UNIT_TESTCALLER(CborTest, setUp, tearDown, fixtures);
@@ -83,11 +83,43 @@ static void test_crypto_aes_decrypt(void)
     TEST_ASSERT_MESSAGE(1 == compare(TEST_1_INP, data, AES_BLOCK_SIZE), "wrong plaintext");
 }
 
+static void test_crypto_aes_blocks(void)
+{
+    cipher_context_t ctx;
+    int err;
+    uint8_t data[3 * AES_BLOCK_SIZE], block[AES_BLOCK_SIZE];
+
+    err = aes_init(&ctx, TEST_0_KEY, AES_KEY_SIZE);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    /* an odd number of blocks, in place */
+    memcpy(data, TEST_0_INP, AES_BLOCK_SIZE);
+    memcpy(data + AES_BLOCK_SIZE, TEST_1_INP, AES_BLOCK_SIZE);
+    memcpy(data + 2 * AES_BLOCK_SIZE, TEST_0_INP, AES_BLOCK_SIZE);
+    err = aes_encrypt_blocks(&ctx, data, data, 3);
+    TEST_ASSERT_EQUAL_INT(1, err);
+    TEST_ASSERT_MESSAGE(1 == compare(TEST_0_ENC, data, AES_BLOCK_SIZE), "wrong ciphertext");
+    TEST_ASSERT_MESSAGE(1 == compare(TEST_0_ENC, data + 2 * AES_BLOCK_SIZE, AES_BLOCK_SIZE),
+                        "wrong ciphertext");
+    aes_encrypt(&ctx, TEST_1_INP, block);
+    TEST_ASSERT_MESSAGE(1 == compare(block, data + AES_BLOCK_SIZE, AES_BLOCK_SIZE),
+                        "wrong ciphertext");
+
+    err = aes_decrypt_blocks(&ctx, data, data, 3);
+    TEST_ASSERT_EQUAL_INT(1, err);
+    TEST_ASSERT_MESSAGE(1 == compare(TEST_0_INP, data, AES_BLOCK_SIZE), "wrong plaintext");
+    TEST_ASSERT_MESSAGE(1 == compare(TEST_1_INP, data + AES_BLOCK_SIZE, AES_BLOCK_SIZE),
+                        "wrong plaintext");
+    TEST_ASSERT_MESSAGE(1 == compare(TEST_0_INP, data + 2 * AES_BLOCK_SIZE, AES_BLOCK_SIZE),
+                        "wrong plaintext");
+}
+
 Test* tests_crypto_aes_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_aes_encrypt),
                         new_TestFixture(test_crypto_aes_decrypt),
+                        new_TestFixture(test_crypto_aes_blocks),
     };
 
     EMB_UNIT_TESTCALLER(crypto_aes_tests, NULL, NULL, fixtures);
@@ -27,6 +27,17 @@ static fib_table_t test_fib_table = { .data.entries = _entries,
                                       .mtx_access = MUTEX_INIT,
                                       .notify_rp_pos = 0 };
 
+#ifdef MODULE_FIB_TRIE
+static fib_entry_t _trie_entries[TEST_FIB_TABLE_SIZE];
+static fib_trie_node_t _trie_nodes[FIB_TRIE_NODES_NUMOF(TEST_FIB_TABLE_SIZE)];
+static fib_table_t test_fib_trie_table = { .data.entries = _trie_entries,
+                                           .table_type = FIB_TABLE_TYPE_SH,
+                                           .size = TEST_FIB_TABLE_SIZE,
+                                           .mtx_access = MUTEX_INIT,
+                                           .notify_rp_pos = 0,
+                                           .trie.nodes = _trie_nodes };
+#endif
+
 /*
 * @brief helper to fill FIB with unique entries
 */
@@ -978,6 +989,201 @@ static void test_fib_20_replace_prefix(void)
     fib_deinit(&test_fib_table);
 }
 
+#ifdef MODULE_FIB_TRIE
+/*
+* @brief helper to add the same byte aligned prefix (or host route for
+*        prefix_len == 128) to the linear and the indexed table
+*/
+static void _add_both(uint8_t *dst, uint32_t prefix_len, uint8_t nh_id)
+{
+    uint8_t nxt[16];
+
+    memset(nxt, nh_id, sizeof(nxt));
+    fib_add_entry(&test_fib_table, nh_id, dst, sizeof(nxt),
+                  (prefix_len < 128) ? (prefix_len << FIB_FLAG_NET_PREFIX_SHIFT) : 0,
+                  nxt, sizeof(nxt), 0, 100000);
+    fib_add_entry(&test_fib_trie_table, nh_id, dst, sizeof(nxt),
+                  (prefix_len < 128) ? (prefix_len << FIB_FLAG_NET_PREFIX_SHIFT) : 0,
+                  nxt, sizeof(nxt), 0, 100000);
+}
+
+/*
+* @brief testing the trie index against the linear search
+* Both tables hold the same byte aligned prefixes, so all lookups of
+* addresses derived from them are expected to resolve to the same next hop
+*/
+static void test_fib_21_trie_lookup(void)
+{
+    static const uint8_t lens[] = { 0, 16, 32, 64, 64, 96, 128, 128 };
+    uint8_t dsts[sizeof(lens)][16];
+    uint32_t seed = 1;
+
+    fib_init(&test_fib_table);
+    fib_init(&test_fib_trie_table);
+    memset(dsts, 0, sizeof(dsts));
+    for (unsigned i = 1; i < sizeof(lens); i++) {
+        /* each prefix extends the previous one */
+        memcpy(dsts[i], dsts[i - 1], lens[i - 1] >> 3);
+        for (unsigned j = (lens[i - 1] >> 3); j < (lens[i] >> 3); j++) {
+            dsts[i][j] = (uint8_t)(0x20 + i + j);
+        }
+        if (lens[i] == lens[i - 1]) {
+            dsts[i][(lens[i] >> 3) - 1]++;
+        }
+    }
+    for (unsigned i = 0; i < sizeof(lens); i++) {
+        _add_both(dsts[i], lens[i], i + 1);
+    }
+    TEST_ASSERT_EQUAL_INT(sizeof(lens), fib_get_num_used_entries(&test_fib_trie_table));
+
+    for (unsigned k = 0; k < 512; k++) {
+        uint8_t lookup[16], nxt_lin[16], nxt_trie[16];
+        size_t size_lin = sizeof(nxt_lin), size_trie = sizeof(nxt_trie);
+        kernel_pid_t iface_lin = KERNEL_PID_UNDEF, iface_trie = KERNEL_PID_UNDEF;
+        uint32_t flags_lin, flags_trie;
+        int ret_lin, ret_trie;
+
+        /* take one of the prefixes and change a pseudo-random byte */
+        seed = (seed * 1103515245) + 12345;
+        memcpy(lookup, dsts[(seed >> 16) % sizeof(lens)], sizeof(lookup));
+        seed = (seed * 1103515245) + 12345;
+        if ((seed >> 16) & 0x1) {
+            lookup[(seed >> 17) % sizeof(lookup)] ^= (uint8_t)(seed >> 24) | 0x1;
+        }
+        ret_lin = fib_get_next_hop(&test_fib_table, &iface_lin, nxt_lin, &size_lin,
+                                   &flags_lin, lookup, sizeof(lookup), 0);
+        ret_trie = fib_get_next_hop(&test_fib_trie_table, &iface_trie, nxt_trie,
+                                    &size_trie, &flags_trie, lookup, sizeof(lookup), 0);
+        TEST_ASSERT_EQUAL_INT(ret_lin, ret_trie);
+        TEST_ASSERT_EQUAL_INT(iface_lin, iface_trie);
+        if (ret_lin == 0) {
+            TEST_ASSERT_EQUAL_INT(0, memcmp(nxt_lin, nxt_trie, size_lin));
+        }
+    }
+
+    /* removing the /32 lets its addresses fall back to the /16 */
+    fib_remove_entry(&test_fib_trie_table, dsts[2], sizeof(dsts[2]));
+    {
+        uint8_t nxt[16];
+        size_t size = sizeof(nxt);
+        kernel_pid_t iface = KERNEL_PID_UNDEF;
+        uint32_t flags;
+
+        TEST_ASSERT_EQUAL_INT(0, fib_get_next_hop(&test_fib_trie_table, &iface,
+                                                  nxt, &size, &flags, dsts[2],
+                                                  sizeof(dsts[2]), 0));
+        TEST_ASSERT_EQUAL_INT(2, iface);
+    }
+    TEST_ASSERT_EQUAL_INT(sizeof(lens) - 1, fib_get_num_used_entries(&test_fib_trie_table));
+
+    fib_deinit(&test_fib_trie_table);
+    fib_deinit(&test_fib_table);
+}
+
+/*
+* @brief testing lifetime expiry of indexed entries
+*/
+static void test_fib_22_trie_expiry(void)
+{
+    uint8_t dst[16], nxt[16];
+    size_t size = sizeof(nxt);
+    kernel_pid_t iface = KERNEL_PID_UNDEF;
+    uint32_t flags;
+
+    fib_init(&test_fib_trie_table);
+    memset(dst, 0x42, sizeof(dst));
+    memset(nxt, 0x23, sizeof(nxt));
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_trie_table, 42, dst, sizeof(dst),
+                                           0, nxt, sizeof(nxt), 0, 1));
+    dst[0]++;
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_trie_table, 42, dst, sizeof(dst),
+                                           0, nxt, sizeof(nxt), 0,
+                                           (uint32_t)FIB_LIFETIME_NO_EXPIRE));
+    TEST_ASSERT_EQUAL_INT(2, fib_get_num_used_entries(&test_fib_trie_table));
+
+    xtimer_usleep(2 * US_PER_MS);
+
+    TEST_ASSERT_EQUAL_INT(0, fib_get_next_hop(&test_fib_trie_table, &iface, nxt,
+                                              &size, &flags, dst, sizeof(dst), 0));
+    dst[0]--;
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH,
+                          fib_get_next_hop(&test_fib_trie_table, &iface, nxt,
+                                           &size, &flags, dst, sizeof(dst), 0));
+    TEST_ASSERT_EQUAL_INT(1, fib_get_num_used_entries(&test_fib_trie_table));
+
+    fib_deinit(&test_fib_trie_table);
+}
+#endif
+
+/*
+ * @brief equal addresses share one universal address container, found
+ * without adding a reference
+ */
+static void test_fib_23_universal_address_shared(void)
+{
+    uint8_t addr[UNIVERSAL_ADDRESS_SIZE + 1] = { 0x20, 0x01, 0x0d, 0xb8 };
+    uint8_t short_addr[2] = { 0x20, 0x01 };
+
+    TEST_ASSERT_NULL(universal_address_find(addr, UNIVERSAL_ADDRESS_SIZE));
+    universal_address_container_t *entry = universal_address_add(addr, UNIVERSAL_ADDRESS_SIZE);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT(universal_address_add(addr, UNIVERSAL_ADDRESS_SIZE) == entry);
+    TEST_ASSERT(universal_address_find(addr, UNIVERSAL_ADDRESS_SIZE) == entry);
+    TEST_ASSERT_EQUAL_INT(1, universal_address_get_num_used_entries());
+
+    /* same bytes, other size */
+    universal_address_container_t *short_entry = universal_address_add(short_addr,
+                                                                       sizeof(short_addr));
+    TEST_ASSERT_NOT_NULL(short_entry);
+    TEST_ASSERT(short_entry != entry);
+    TEST_ASSERT_EQUAL_INT(sizeof(short_addr), short_entry->address_size);
+    TEST_ASSERT_NULL(universal_address_add(addr, sizeof(addr)));
+
+    universal_address_rem(entry);
+    TEST_ASSERT(universal_address_find(addr, UNIVERSAL_ADDRESS_SIZE) == entry);
+    universal_address_rem(entry);
+    TEST_ASSERT_NULL(universal_address_find(addr, UNIVERSAL_ADDRESS_SIZE));
+    TEST_ASSERT(universal_address_find(short_addr, sizeof(short_addr)) == short_entry);
+    universal_address_rem(short_entry);
+    TEST_ASSERT_EQUAL_INT(0, universal_address_get_num_used_entries());
+}
+
+#ifdef MODULE_FIB_TRIE
+/*
+* @brief testing that all entries of a lifetime wheel slot are purged
+*/
+static void test_fib_24_trie_expiry_same_slot(void)
+{
+    uint8_t dst[16], nxt[16];
+
+    fib_init(&test_fib_trie_table);
+    memset(dst, 0x42, sizeof(dst));
+    memset(nxt, 0x23, sizeof(nxt));
+    /* added within less than a slot, so at least two of them share one */
+    for (unsigned i = 0; i < 4; i++) {
+        dst[0] = 0x42 + i;
+        TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_trie_table, 42, dst, sizeof(dst),
+                                               0, nxt, sizeof(nxt), 0, 1));
+    }
+    dst[0] = 0x23;
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_trie_table, 42, dst, sizeof(dst),
+                                           0, nxt, sizeof(nxt), 0,
+                                           (uint32_t)FIB_LIFETIME_NO_EXPIRE));
+    TEST_ASSERT_EQUAL_INT(5, fib_get_num_used_entries(&test_fib_trie_table));
+
+    xtimer_usleep(2 * (1UL << FIB_TRIE_WHEEL_SHIFT));
+
+    /* changing the table purges the passed slots, no lookup involved */
+    dst[0] = 0x24;
+    TEST_ASSERT_EQUAL_INT(0, fib_add_entry(&test_fib_trie_table, 42, dst, sizeof(dst),
+                                           0, nxt, sizeof(nxt), 0,
+                                           (uint32_t)FIB_LIFETIME_NO_EXPIRE));
+    TEST_ASSERT_EQUAL_INT(2, fib_get_num_used_entries(&test_fib_trie_table));
+
+    fib_deinit(&test_fib_trie_table);
+}
+#endif
+
 Test *tests_fib_tests(void)
 {
     fib_init(&test_fib_table);
@@ -1002,6 +1208,14 @@ Test *tests_fib_tests(void)
                         new_TestFixture(test_fib_18_get_next_hop_invalid_parameters),
                         new_TestFixture(test_fib_19_default_gateway),
                         new_TestFixture(test_fib_20_replace_prefix),
+#ifdef MODULE_FIB_TRIE
+                        new_TestFixture(test_fib_21_trie_lookup),
+                        new_TestFixture(test_fib_22_trie_expiry),
+#endif
+                        new_TestFixture(test_fib_23_universal_address_shared),
+#ifdef MODULE_FIB_TRIE
+                        new_TestFixture(test_fib_24_trie_expiry_same_slot),
+#endif
     };
 
     EMB_UNIT_TESTCALLER(fib_tests, NULL, NULL, fixtures);
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/rpl/srh_tree.h"
+
+#include "tests-gnrc_rpl_srh_tree.h"
+
+#define LIFETIME    (60U)
+
+static ipv6_addr_t _root, _a, _b, _c, _d;
+static uint8_t _buf[GNRC_RPL_SRH_TREE_HDR_MAX];
+static gnrc_rpl_srh_t *_srh = (gnrc_rpl_srh_t *)_buf;
+
+static void _set(ipv6_addr_t *addr, uint8_t iid)
+{
+    ipv6_addr_from_str(addr, "2001:db8::");
+    addr->u8[15] = iid;
+}
+
+static void set_up(void)
+{
+    _set(&_root, 1);
+    _set(&_a, 0xa);
+    _set(&_b, 0xb);
+    _set(&_c, 0xc);
+    _set(&_d, 0xd);
+    gnrc_rpl_srh_tree_init(&_root);
+}
+
+static void test_gnrc_rpl_srh_tree_child(void)
+{
+    ipv6_addr_t hop;
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_tree_build(&_a, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_update(&_a, &_root, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_build(&_a, &hop, NULL, 0));
+    TEST_ASSERT(ipv6_addr_equal(&_a, &hop));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_srh_tree_numof());
+    TEST_ASSERT_EQUAL_INT(-EINVAL, gnrc_rpl_srh_tree_update(&_root, &_a, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, gnrc_rpl_srh_tree_update(&_a, &_a, LIFETIME));
+}
+
+static void test_gnrc_rpl_srh_tree_route(void)
+{
+    ipv6_addr_t hop;
+
+    /* root -> a -> b -> c */
+    gnrc_rpl_srh_tree_update(&_a, &_root, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_c, &_b, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(16, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT(ipv6_addr_equal(&_a, &hop));
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_TYPE, _srh->type);
+    TEST_ASSERT_EQUAL_INT(1, _srh->len);
+    TEST_ASSERT_EQUAL_INT(2, _srh->seg_left);
+    /* all but the last octet elided */
+    TEST_ASSERT_EQUAL_INT(0xff, _srh->compr);
+    TEST_ASSERT_EQUAL_INT(6 << 4, _srh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(0xb, _buf[8]);
+    TEST_ASSERT_EQUAL_INT(0xc, _buf[9]);
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, 8));
+
+    /* a last address of another prefix */
+    ipv6_addr_from_str(&_d, "2001:db8:1::d");
+    gnrc_rpl_srh_tree_update(&_d, &_b, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(24, gnrc_rpl_srh_tree_build(&_d, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT(0xf5, _srh->compr);
+    TEST_ASSERT_EQUAL_INT(2, _srh->len);
+    TEST_ASSERT_EQUAL_INT(4 << 4, _srh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(0xb, _buf[8]);
+    TEST_ASSERT_EQUAL_INT(0x01, _buf[9]);
+    TEST_ASSERT_EQUAL_INT(0xd, _buf[19]);
+}
+
+static void test_gnrc_rpl_srh_tree_change(void)
+{
+    ipv6_addr_t hop;
+
+    gnrc_rpl_srh_tree_update(&_a, &_root, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_c, &_b, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(16, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+
+    /* refreshing keeps the route, moving b changes it */
+    gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(16, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+    gnrc_rpl_srh_tree_update(&_b, &_root, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(8 + 8, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT(ipv6_addr_equal(&_b, &hop));
+    TEST_ASSERT_EQUAL_INT(1, _srh->seg_left);
+    TEST_ASSERT_EQUAL_INT(0xc, _buf[8]);
+
+    /* No-Path DAO for b */
+    gnrc_rpl_srh_tree_update(&_b, &_root, 0);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_tree_build(&_b, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_tree_remove(&_b));
+    TEST_ASSERT_EQUAL_INT(2, gnrc_rpl_srh_tree_numof());
+    gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(16, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT(ipv6_addr_equal(&_a, &hop));
+}
+
+static void test_gnrc_rpl_srh_tree_change__many(void)
+{
+    ipv6_addr_t hop;
+
+    gnrc_rpl_srh_tree_update(&_a, &_root, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(8 + 8, gnrc_rpl_srh_tree_build(&_b, &hop, _srh, sizeof(_buf)));
+    gnrc_rpl_srh_tree_update(&_b, &_root, LIFETIME);
+
+    /* the header built for b before must not come back after 65536 changes */
+    for (unsigned i = 1; i < 0x10000; i++) {
+        gnrc_rpl_srh_tree_update(&_d, (i & 1) ? &_root : &_a, LIFETIME);
+    }
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_build(&_b, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT(ipv6_addr_equal(&_b, &hop));
+}
+
+static void test_gnrc_rpl_srh_tree_placeholder(void)
+{
+    ipv6_addr_t hop;
+
+    /* c is announced before its parent */
+    gnrc_rpl_srh_tree_update(&_c, &_b, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_srh_tree_numof());
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_tree_build(&_b, &hop, _srh, sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+    gnrc_rpl_srh_tree_update(&_b, &_root, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(8 + 8, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+
+    /* placeholders are freed with their last child */
+    ipv6_addr_t addr;
+    for (uint8_t i = 0; i < GNRC_RPL_SRH_TREE_NUMOF - 2; i++) {
+        _set(&addr, 0x20 + i);
+        TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_update(&addr, &_root, LIFETIME));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, gnrc_rpl_srh_tree_update(&_d, &_root, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_remove(&_c));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_update(&_c, &_root, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_remove(&_b));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_update(&_d, &_c, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_TREE_NUMOF, gnrc_rpl_srh_tree_numof());
+}
+
+static void test_gnrc_rpl_srh_tree_expire(void)
+{
+    ipv6_addr_t hop;
+
+    gnrc_rpl_srh_tree_update(&_a, &_root, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_b, &_a, 2 * LIFETIME);
+    gnrc_rpl_srh_tree_update(&_c, &_b, 2 * LIFETIME);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_expire(LIFETIME - 1));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_srh_tree_expire(1));
+    TEST_ASSERT_EQUAL_INT(2, gnrc_rpl_srh_tree_numof());
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, gnrc_rpl_srh_tree_build(&_c, &hop, _srh, sizeof(_buf)));
+
+    /* refreshed routes live on */
+    gnrc_rpl_srh_tree_update(&_c, &_b, 2 * LIFETIME);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_srh_tree_expire(LIFETIME));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_srh_tree_numof());
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_srh_tree_expire(LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_numof());
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_expire(LIFETIME));
+
+    /* all entries are free again */
+    ipv6_addr_t addr;
+    for (uint8_t i = 0; i < GNRC_RPL_SRH_TREE_NUMOF; i++) {
+        _set(&addr, 0x20 + i);
+        TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_tree_update(&addr, &_root, LIFETIME));
+    }
+}
+
+static void test_gnrc_rpl_srh_tree_loop(void)
+{
+    ipv6_addr_t hop, addr, parent = _root;
+
+    /* one hop more than fits */
+    for (uint8_t i = 0; i <= GNRC_RPL_SRH_TREE_MAX_DEPTH; i++) {
+        _set(&addr, 0x20 + i);
+        gnrc_rpl_srh_tree_update(&addr, &parent, LIFETIME);
+        parent = addr;
+    }
+    TEST_ASSERT_EQUAL_INT(-ELOOP, gnrc_rpl_srh_tree_build(&addr, &hop, _srh, sizeof(_buf)));
+    _set(&addr, 0x20 + GNRC_RPL_SRH_TREE_MAX_DEPTH - 1);
+    TEST_ASSERT(gnrc_rpl_srh_tree_build(&addr, &hop, _srh, sizeof(_buf)) > 0);
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_TREE_MAX_DEPTH - 1, _srh->seg_left);
+
+    /* a and b name each other as parent */
+    gnrc_rpl_srh_tree_update(&_a, &_b, LIFETIME);
+    gnrc_rpl_srh_tree_update(&_b, &_a, LIFETIME);
+    TEST_ASSERT_EQUAL_INT(-ELOOP, gnrc_rpl_srh_tree_build(&_a, &hop, _srh, sizeof(_buf)));
+}
+
+Test *tests_gnrc_rpl_srh_tree_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_rpl_srh_tree_child),
+        new_TestFixture(test_gnrc_rpl_srh_tree_route),
+        new_TestFixture(test_gnrc_rpl_srh_tree_change),
+        new_TestFixture(test_gnrc_rpl_srh_tree_change__many),
+        new_TestFixture(test_gnrc_rpl_srh_tree_placeholder),
+        new_TestFixture(test_gnrc_rpl_srh_tree_expire),
+        new_TestFixture(test_gnrc_rpl_srh_tree_loop),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_rpl_srh_tree_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_rpl_srh_tree_tests;
+}
+
+void tests_gnrc_rpl_srh_tree(void)
+{
+    TESTS_RUN(tests_gnrc_rpl_srh_tree_tests());
+}
+/** @} */
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "msg.h"
+#include "thread.h"
+#include "net/eui64.h"
+#include "net/ieee802154.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+
+#include "unittests-constants.h"
+#include "tests-gnrc_sixlowpan_iphc.h"
+
+#define TEST_SRC_L2     { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x01 }
+#define TEST_DST_L2     { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x02 }
+#define TEST_PREFIX     { { \
+            0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 \
+        } \
+    }
+#define TEST_HL         (64U)
+
+/* IPHC dispatch: TF elided, next header inline, hop limit 64 */
+#define TEST_IPHC1      (0x7a)
+/* IPHC, both addresses derived from the link-layer addresses */
+#define TEST_IPHC2_LL   (0x33)
+/* IPHC, both addresses derived from context 0 and the link-layer addresses */
+#define TEST_IPHC2_CTX  (0x77)
+/* IPHC, 64 bits of the source address inline, destination derived */
+#define TEST_IPHC2_64   (0x13)
+
+static uint8_t _src_l2[] = TEST_SRC_L2;
+static uint8_t _dst_l2[] = TEST_DST_L2;
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static kernel_pid_t _netif_pid = KERNEL_PID_UNDEF;
+static eui64_t _netif_iid;
+
+/* interface that only knows its IID */
+static void *_netif_thread(void *arg)
+{
+    msg_t msg, reply;
+
+    (void)arg;
+    while (1) {
+        gnrc_netapi_opt_t *opt;
+
+        msg_receive(&msg);
+        opt = msg.content.ptr;
+        reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+        if ((msg.type == GNRC_NETAPI_MSG_TYPE_GET) &&
+            (opt->opt == NETOPT_IPV6_IID) && (opt->data_len >= sizeof(eui64_t))) {
+            memcpy(opt->data, &_netif_iid, sizeof(eui64_t));
+            reply.content.value = sizeof(eui64_t);
+        }
+        else {
+            reply.content.value = (uint32_t)(-ENOTSUP);
+        }
+        msg_reply(&msg, &reply);
+    }
+    return NULL;
+}
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    if (_netif_pid == KERNEL_PID_UNDEF) {
+        _netif_pid = thread_create(_netif_stack, sizeof(_netif_stack),
+                                   THREAD_PRIORITY_MAIN - 1,
+                                   THREAD_CREATE_STACKTEST,
+                                   _netif_thread, NULL, "iphc_netif");
+    }
+}
+
+static void tear_down(void)
+{
+    gnrc_sixlowpan_ctx_reset();
+}
+
+static void _addr_from_l2(ipv6_addr_t *addr, const ipv6_addr_t *prefix,
+                          const uint8_t *l2addr)
+{
+    eui64_t iid;
+
+    ieee802154_get_iid(&iid, l2addr, IEEE802154_LONG_ADDRESS_LEN);
+    memcpy(&addr->u8[0], prefix, sizeof(ipv6_addr_t) / 2);
+    memcpy(&addr->u8[8], &iid, sizeof(iid));
+}
+
+/* Encodes a packet from src to dst and copies its 6LoWPAN header to buf */
+static void _encode_hdr(const ipv6_addr_t *src, const ipv6_addr_t *dst,
+                        bool with_src_l2, uint8_t *buf, size_t *len)
+{
+    gnrc_pktsnip_t *pkt, *ipv6, *netif;
+    ipv6_hdr_t *hdr;
+
+    *len = 0;
+    pkt = gnrc_pktbuf_add(NULL, TEST_STRING4, sizeof(TEST_STRING4),
+                          GNRC_NETTYPE_UNDEF);
+    TEST_ASSERT_NOT_NULL(pkt);
+    ipv6 = gnrc_ipv6_hdr_build(pkt, src, dst);
+    TEST_ASSERT_NOT_NULL(ipv6);
+    hdr = ipv6->data;
+    hdr->nh = PROTNUM_ICMPV6;
+    hdr->hl = TEST_HL;
+    netif = gnrc_netif_hdr_build(with_src_l2 ? _src_l2 : NULL,
+                                 with_src_l2 ? sizeof(_src_l2) : 0,
+                                 _dst_l2, sizeof(_dst_l2));
+    TEST_ASSERT_NOT_NULL(netif);
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = _netif_pid;
+    netif->next = ipv6;
+
+    TEST_ASSERT(gnrc_sixlowpan_iphc_encode(netif));
+    TEST_ASSERT_NOT_NULL(netif->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_SIXLOWPAN, netif->next->type);
+    *len = netif->next->size;
+    memcpy(buf, netif->next->data, *len);
+    gnrc_pktbuf_release(netif);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_sixlowpan_iphc_encode__same_flow(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, TEST_IPHC2_LL, PROTNUM_ICMPV6 };
+    ipv6_addr_t src, dst;
+    uint8_t first[sizeof(ipv6_hdr_t)], second[sizeof(ipv6_hdr_t)];
+    size_t first_len, second_len;
+
+    _addr_from_l2(&src, &ipv6_addr_link_local_prefix, _src_l2);
+    _addr_from_l2(&dst, &ipv6_addr_link_local_prefix, _dst_l2);
+    _encode_hdr(&src, &dst, true, first, &first_len);
+    _encode_hdr(&src, &dst, true, second, &second_len);
+    TEST_ASSERT_EQUAL_INT(sizeof(exp), first_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, first, sizeof(exp)));
+    TEST_ASSERT_EQUAL_INT(first_len, second_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(first, second, first_len));
+}
+
+static void test_gnrc_sixlowpan_iphc_encode__ctx_update(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, TEST_IPHC2_CTX, PROTNUM_ICMPV6 };
+    ipv6_addr_t prefix = TEST_PREFIX;
+    ipv6_addr_t src, dst;
+    uint8_t before[sizeof(ipv6_hdr_t)], buf[sizeof(ipv6_hdr_t)];
+    size_t before_len, len;
+
+    _addr_from_l2(&src, &prefix, _src_l2);
+    _addr_from_l2(&dst, &prefix, _dst_l2);
+    /* without a context both addresses are carried inline */
+    _encode_hdr(&src, &dst, true, before, &before_len);
+    TEST_ASSERT_EQUAL_INT(3 + (2 * sizeof(ipv6_addr_t)), before_len);
+
+    TEST_ASSERT_NOT_NULL(gnrc_sixlowpan_ctx_update(0, &prefix, 64, TEST_UINT16, true));
+    _encode_hdr(&src, &dst, true, buf, &len);
+    TEST_ASSERT_EQUAL_INT(sizeof(exp), len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, buf, sizeof(exp)));
+
+    gnrc_sixlowpan_ctx_remove(0);
+    _encode_hdr(&src, &dst, true, buf, &len);
+    TEST_ASSERT_EQUAL_INT(before_len, len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(before, buf, before_len));
+}
+
+static void test_gnrc_sixlowpan_iphc_encode__iid_change(void)
+{
+    static const uint8_t exp[] = { TEST_IPHC1, TEST_IPHC2_LL, PROTNUM_ICMPV6 };
+    ipv6_addr_t src, dst;
+    uint8_t buf[sizeof(ipv6_hdr_t)];
+    size_t len;
+
+    /* no source link-layer address, the IID is queried from the interface */
+    _addr_from_l2(&src, &ipv6_addr_link_local_prefix, _src_l2);
+    _addr_from_l2(&dst, &ipv6_addr_link_local_prefix, _dst_l2);
+    memcpy(&_netif_iid, &src.u8[8], sizeof(_netif_iid));
+    _encode_hdr(&src, &dst, false, buf, &len);
+    TEST_ASSERT_EQUAL_INT(sizeof(exp), len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(exp, buf, sizeof(exp)));
+
+    /* the address no longer derives from the IID of the interface */
+    _netif_iid.uint8[7]++;
+    _encode_hdr(&src, &dst, false, buf, &len);
+    TEST_ASSERT_EQUAL_INT(sizeof(exp) + sizeof(eui64_t), len);
+    TEST_ASSERT_EQUAL_INT(TEST_IPHC2_64, buf[1]);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&src.u8[8], &buf[sizeof(exp)], sizeof(eui64_t)));
+}
+
+static Test *tests_gnrc_sixlowpan_iphc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_sixlowpan_iphc_encode__same_flow),
+        new_TestFixture(test_gnrc_sixlowpan_iphc_encode__ctx_update),
+        new_TestFixture(test_gnrc_sixlowpan_iphc_encode__iid_change),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_sixlowpan_iphc_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&gnrc_sixlowpan_iphc_tests;
+}
+
+void tests_gnrc_sixlowpan_iphc(void)
+{
+    TESTS_RUN(tests_gnrc_sixlowpan_iphc_tests());
+}
+/** @} */
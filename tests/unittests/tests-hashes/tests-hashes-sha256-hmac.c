@@ -328,6 +328,33 @@ static void test_hashes_hmac_sha256_ite_hash_PRF6_split(void)
                  "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2", hmac));
 }
 
+static void test_hashes_hmac_sha256_precomputed(void)
+{
+    /* Test Case PRF-2 and PRF-5, the key is reused */
+    const unsigned char strPRF2[] = "what do ya want for nothing?";
+    const unsigned char strPRF5[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+    unsigned char longKey[131];
+    hmac_sha256_key_t key_state;
+    hmac_context_t ctx;
+    static unsigned char hmac[SHA256_DIGEST_LENGTH];
+
+    hmac_sha256_precompute(&key_state, "Jefe", 4);
+    for (unsigned i = 0; i < 2; i++) {
+        hmac_sha256_precomputed(&key_state, strPRF2, strlen((char*)strPRF2), hmac);
+        TEST_ASSERT(compare_str_vs_digest(
+                     "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", hmac));
+    }
+
+    memset(longKey, 0xaa, sizeof(longKey));
+    hmac_sha256_precompute(&key_state, longKey, sizeof(longKey));
+    hmac_sha256_init_precomputed(&ctx, &key_state);
+    hmac_sha256_update(&ctx, strPRF5, 10);
+    hmac_sha256_update(&ctx, &strPRF5[10], strlen((char*)strPRF5) - 10);
+    hmac_sha256_final(&ctx, hmac);
+    TEST_ASSERT(compare_str_vs_digest(
+                 "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", hmac));
+}
+
 Test *tests_hashes_sha256_hmac_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -346,6 +373,7 @@ Test *tests_hashes_sha256_hmac_tests(void)
         new_TestFixture(test_hashes_hmac_sha256_ite_hash_PRF5),
         new_TestFixture(test_hashes_hmac_sha256_ite_hash_PRF6),
         new_TestFixture(test_hashes_hmac_sha256_ite_hash_PRF6_split),
+        new_TestFixture(test_hashes_hmac_sha256_precomputed),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
@@ -212,6 +212,33 @@ static void test_hashes_sha256_hash_long_sequence(void)
                     hlong_sequence));
 }
 
+static void test_hashes_sha256_multi(void)
+{
+    /* lengths around the padding boundaries, more messages than lanes */
+    static const size_t len[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 300, 3 };
+    static unsigned char msg[301];
+    static unsigned char digest[sizeof(len) / sizeof(len[0])][SHA256_DIGEST_LENGTH];
+    const void *data[sizeof(len) / sizeof(len[0])];
+    void *out[sizeof(len) / sizeof(len[0])];
+    unsigned char expected[SHA256_DIGEST_LENGTH];
+
+    for (size_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = i * 7;
+    }
+    for (size_t i = 0; i < sizeof(len) / sizeof(len[0]); i++) {
+        /* each message starts elsewhere to tell them apart */
+        data[i] = &msg[sizeof(msg) - len[i] - (i % 2)];
+        out[i] = digest[i];
+    }
+
+    sha256_multi(data, len, out, sizeof(len) / sizeof(len[0]));
+
+    for (size_t i = 0; i < sizeof(len) / sizeof(len[0]); i++) {
+        sha256(data[i], len[i], expected);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(expected, digest[i], SHA256_DIGEST_LENGTH));
+    }
+}
+
 Test *tests_hashes_sha256_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -227,6 +254,7 @@ Test *tests_hashes_sha256_tests(void)
         new_TestFixture(test_hashes_sha256_hash_sequence_failing_compare),
 
         new_TestFixture(test_hashes_sha256_hash_long_sequence),
+        new_TestFixture(test_hashes_sha256_multi),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
@@ -12,7 +12,9 @@
  * @file
  */
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "embUnit.h"
 
@@ -21,6 +23,62 @@
 #include "unittests-constants.h"
 #include "tests-inet_csum.h"
 
+/* all lengths up to this are compared to the reference implementation */
+#define EQUIV_LEN_MAX       (160U)
+/* all offsets of the buffer up to this are compared */
+#define EQUIV_OFFSET_MAX    (8U)
+/* largest buffer to compare (IPv6 minimum MTU) */
+#define BUF_LEN_MAX         (1280U)
+
+static uint8_t _buf[BUF_LEN_MAX + EQUIV_OFFSET_MAX];
+
+/* byte-wise implementation inet_csum_slice() had before */
+static uint16_t _ref_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len,
+                                size_t accum_len)
+{
+    uint32_t csum = sum;
+
+    if (len == 0) {
+        return csum;
+    }
+    if (accum_len & 1) {
+        csum += *buf;
+        buf++;
+        len--;
+        accum_len++;
+    }
+    for (int i = 0; i < (len >> 1); buf += 2, i++) {
+        csum += (uint16_t)(*buf << 8) + *(buf + 1);
+    }
+    if ((accum_len + len) & 1) {
+        csum += (uint16_t)(*buf << 8);
+    }
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+    return csum;
+}
+
+static void _fill_buf(unsigned pattern)
+{
+    uint32_t seed = 1;
+
+    for (unsigned i = 0; i < sizeof(_buf); i++) {
+        switch (pattern) {
+            case 0:
+                seed = (seed * 1103515245) + 12345;
+                _buf[i] = seed >> 16;
+                break;
+            case 1:
+                _buf[i] = 0xff;     /* provokes the most carries */
+                break;
+            default:
+                _buf[i] = 0x00;
+                break;
+        }
+    }
+}
+
 static void test_inet_csum__rfc_example(void)
 {
     /* source: https://tools.ietf.org/html/rfc1071#section-3 */
@@ -165,6 +223,37 @@ static void test_inet_csum__empty_app_buffer(void)
     TEST_ASSERT_EQUAL_INT(hdr_expected, pyld_sum);
 }
 
+static void test_inet_csum__equiv_reference(void)
+{
+    static const uint16_t sums[] = { 0x0000, 0x0001, 0x1234, 0xffff };
+
+    for (unsigned pattern = 0; pattern < 3; pattern++) {
+        _fill_buf(pattern);
+        for (unsigned offset = 0; offset < EQUIV_OFFSET_MAX; offset++) {
+            for (unsigned len = 0; len <= BUF_LEN_MAX; len++) {
+                if ((len > EQUIV_LEN_MAX) && (len < (BUF_LEN_MAX - 1))) {
+                    continue;
+                }
+                for (unsigned s = 0; s < (sizeof(sums) / sizeof(sums[0])); s++) {
+                    for (size_t accum_len = 0; accum_len < 2; accum_len++) {
+                        uint16_t exp = _ref_csum_slice(sums[s], &_buf[offset], len,
+                                                       accum_len);
+                        uint16_t res = inet_csum_slice(sums[s], &_buf[offset], len,
+                                                       accum_len);
+
+                        if (exp != res) {
+                            printf("\npattern: %u, offset: %u, len: %u, sum: 0x%04x, "
+                                   "accum_len: %u\n", pattern, offset, len,
+                                   (unsigned)sums[s], (unsigned)accum_len);
+                        }
+                        TEST_ASSERT_EQUAL_INT(exp, res);
+                    }
+                }
+            }
+        }
+    }
+}
+
 Test *tests_inet_csum_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -176,6 +265,7 @@ Test *tests_inet_csum_tests(void)
         new_TestFixture(test_inet_csum__odd_len),
         new_TestFixture(test_inet_csum__two_app_snips),
         new_TestFixture(test_inet_csum__empty_app_buffer),
+        new_TestFixture(test_inet_csum__equiv_reference),
     };
 
     EMB_UNIT_TESTCALLER(inet_csum_tests, NULL, NULL, fixtures);
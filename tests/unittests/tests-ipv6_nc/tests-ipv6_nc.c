@@ -245,6 +245,49 @@ static void test_ipv6_nc_get__success_if_global(void)
     TEST_ASSERT_EQUAL_INT(0, entry->flags);
 }
 
+/* n-th of a set of distinct addresses */
+static void _set_nth_addr(ipv6_addr_t *addr, unsigned n)
+{
+    ipv6_addr_t def = DEFAULT_TEST_IPV6_ADDR;
+
+    *addr = def;
+    addr->u16[6] = byteorder_htons(n * 7);
+    addr->u16[7] = byteorder_htons(n);
+}
+
+static void test_ipv6_nc_get__many(void)
+{
+    ipv6_addr_t addr;
+
+    for (unsigned i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        _set_nth_addr(&addr, i);
+        TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, TEST_STRING4,
+                                              sizeof(TEST_STRING4), 0));
+    }
+    /* punch holes into the cache, then check that all remaining entries are
+     * still found and the holes are reused */
+    for (unsigned i = 0; i < GNRC_IPV6_NC_SIZE; i += 3) {
+        _set_nth_addr(&addr, i);
+        gnrc_ipv6_nc_remove(DEFAULT_TEST_NETIF, &addr);
+    }
+    for (unsigned i = 0; i < GNRC_IPV6_NC_SIZE; i++) {
+        gnrc_ipv6_nc_t *entry;
+
+        _set_nth_addr(&addr, i);
+        entry = gnrc_ipv6_nc_get(DEFAULT_TEST_NETIF, &addr);
+        if ((i % 3) == 0) {
+            TEST_ASSERT_NULL(entry);
+            TEST_ASSERT_NOT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, NULL, 0, 0));
+        }
+        else {
+            TEST_ASSERT_NOT_NULL(entry);
+            TEST_ASSERT(ipv6_addr_equal(&(entry->ipv6_addr), &addr));
+        }
+    }
+    _set_nth_addr(&addr, GNRC_IPV6_NC_SIZE);
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_add(DEFAULT_TEST_NETIF, &addr, NULL, 0, 0));
+}
+
 static void test_ipv6_nc_get_next__empty(void)
 {
     TEST_ASSERT_NULL(gnrc_ipv6_nc_get_next(NULL));
@@ -460,6 +503,7 @@ Test *tests_ipv6_nc_tests(void)
         new_TestFixture(test_ipv6_nc_get__different_addr),
         new_TestFixture(test_ipv6_nc_get__success_if_local),
         new_TestFixture(test_ipv6_nc_get__success_if_global),
+        new_TestFixture(test_ipv6_nc_get__many),
         new_TestFixture(test_ipv6_nc_get_next__empty),
         new_TestFixture(test_ipv6_nc_get_next__1_entry),
         new_TestFixture(test_ipv6_nc_get_next__2_entries),
@@ -19,6 +19,10 @@
 #include "mtd.h"
 #include "board.h"
 
+#ifdef MODULE_MTD_NATIVE
+#include "mtd_native.h"
+#endif
+
 #if MODULE_VFS
 #include <fcntl.h>
 #include <stdio.h>
@@ -239,6 +243,77 @@ static void test_mtd_write_read_flash(void)
 }
 #endif
 
+#if defined(MTD_0) && defined(MODULE_MTD_NATIVE)
+static uint32_t _erase_count[2048];
+
+static void test_mtd_native_wear(void)
+{
+    mtd_native_dev_t *native = (mtd_native_dev_t *)dev;
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+    const uint8_t buf[] = {0x00, 0x11, 0x22};
+    uint8_t buf_read[sizeof(buf)];
+
+    if (dev->sector_count > sizeof(_erase_count) / sizeof(_erase_count[0])) {
+        return;
+    }
+    memset(_erase_count, 0, sizeof(_erase_count));
+    native->erase_count = _erase_count;
+    native->erase_limit = 2;
+
+    /* Erase 2nd - 3rd sector, then the 2nd again to wear it out */
+    int ret = mtd_erase(dev, sector_size, sector_size * 2);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    ret = mtd_erase(dev, sector_size, sector_size);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_EQUAL_INT(0, _erase_count[0]);
+    TEST_ASSERT_EQUAL_INT(2, _erase_count[1]);
+    TEST_ASSERT_EQUAL_INT(1, _erase_count[2]);
+
+    /* Worn out sector fails */
+    ret = mtd_erase(dev, sector_size, sector_size);
+    TEST_ASSERT_EQUAL_INT(-EIO, ret);
+    ret = mtd_write(dev, buf, sector_size, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(-EIO, ret);
+    TEST_ASSERT_EQUAL_INT(2, _erase_count[1]);
+
+    /* Others still work */
+    ret = mtd_write(dev, buf, sector_size * 2, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), ret);
+    ret = mtd_read(dev, buf_read, sector_size * 2, sizeof(buf_read));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read), ret);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, buf_read, sizeof(buf)));
+
+    native->erase_count = NULL;
+    native->erase_limit = 0;
+}
+
+static void test_mtd_native_power(void)
+{
+    mtd_native_dev_t *native = (mtd_native_dev_t *)dev;
+    const uint8_t buf[] = {0x33, 0x44, 0x55};
+    uint8_t buf_read[sizeof(buf)];
+
+    int ret = mtd_erase(dev, 0, dev->pages_per_sector * dev->page_size);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    ret = mtd_write(dev, buf, 0, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), ret);
+
+    /* Unmapped while powered down */
+    ret = mtd_power(dev, MTD_POWER_DOWN);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_NULL(native->mem);
+    ret = mtd_read(dev, buf_read, 0, sizeof(buf_read));
+    TEST_ASSERT_EQUAL_INT(-EIO, ret);
+
+    /* Contents are kept in the file */
+    ret = mtd_power(dev, MTD_POWER_UP);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    ret = mtd_read(dev, buf_read, 0, sizeof(buf_read));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read), ret);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, buf_read, sizeof(buf)));
+}
+#endif
+
 #if MODULE_VFS
 static void test_mtd_vfs(void)
 {
@@ -266,6 +341,42 @@ static void test_mtd_vfs(void)
     /* Attempted to write past the device memory */
     TEST_ASSERT(ret < 0);
 }
+
+static void test_mtd_vfs_pread_pwrite(void)
+{
+    int fd;
+    fd = vfs_bind(VFS_ANY_FD, O_RDWR, &mtd_vfs_ops, dev);
+    const char buf[] = "ghijklmn";
+    char buf_read[sizeof(buf) + 4];
+    memset(buf_read, 0, sizeof(buf_read));
+    TEST_ASSERT(fd >= 0);
+
+    int size = vfs_lseek(fd, 0, SEEK_END);
+    TEST_ASSERT(size > (int)sizeof(buf_read));
+    int ret = vfs_lseek(fd, 5, SEEK_SET);
+    TEST_ASSERT_EQUAL_INT(5, ret);
+
+    ret = vfs_pwrite(fd, buf, sizeof(buf), 11);
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), ret);
+    ret = vfs_pread(fd, buf_read, sizeof(buf), 11);
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), ret);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, buf_read, sizeof(buf)));
+    /* The file position is not changed */
+    ret = vfs_lseek(fd, 0, SEEK_CUR);
+    TEST_ASSERT_EQUAL_INT(5, ret);
+
+    /* Short read at the end of the device */
+    ret = vfs_pread(fd, buf_read, sizeof(buf_read), size - 4);
+    TEST_ASSERT_EQUAL_INT(4, ret);
+    ret = vfs_pread(fd, buf_read, sizeof(buf_read), size);
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    ret = vfs_pwrite(fd, buf, sizeof(buf), size);
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, ret);
+    ret = vfs_lseek(fd, 0, SEEK_CUR);
+    TEST_ASSERT_EQUAL_INT(5, ret);
+
+    vfs_close(fd);
+}
 #endif
 
 Test *tests_mtd_tests(void)
@@ -278,8 +389,13 @@ Test *tests_mtd_tests(void)
 #ifdef MTD_0
         new_TestFixture(test_mtd_write_read_flash),
 #endif
+#if defined(MTD_0) && defined(MODULE_MTD_NATIVE)
+        new_TestFixture(test_mtd_native_wear),
+        new_TestFixture(test_mtd_native_power),
+#endif
 #if MODULE_VFS
         new_TestFixture(test_mtd_vfs),
+        new_TestFixture(test_mtd_vfs_pread_pwrite),
 #endif
     };
 
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+#include <errno.h>
+
+#include "embUnit.h"
+
+#include "mtd.h"
+#include "mtd_cache.h"
+
+#include "tests-mtd_cache.h"
+
+#define SECTOR_COUNT    (4U)
+#define PAGE_PER_SECTOR (4U)
+#define PAGE_SIZE       (64U)
+#define SECTOR_SIZE     (PAGE_PER_SECTOR * PAGE_SIZE)
+
+/* NOR flash mock counting the requests */
+static uint8_t _memory[SECTOR_COUNT * SECTOR_SIZE];
+static unsigned _reads, _writes, _erases;
+
+static int _init(mtd_dev_t *dev)
+{
+    (void)dev;
+
+    memset(_memory, 0xff, sizeof(_memory));
+    return 0;
+}
+
+static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+
+    if (addr + size > sizeof(_memory)) {
+        return -EOVERFLOW;
+    }
+    memcpy(buff, _memory + addr, size);
+    _reads++;
+    return size;
+}
+
+static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+
+    if ((addr + size > sizeof(_memory)) || ((addr % PAGE_SIZE) + size > PAGE_SIZE)) {
+        return -EOVERFLOW;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        _memory[addr + i] &= ((const uint8_t *)buff)[i];
+    }
+    _writes++;
+    return size;
+}
+
+static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+
+    if ((addr % SECTOR_SIZE) || (size % SECTOR_SIZE) || (addr + size > sizeof(_memory))) {
+        return -EOVERFLOW;
+    }
+    memset(_memory + addr, 0xff, size);
+    _erases++;
+    return 0;
+}
+
+static const mtd_desc_t _driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+};
+
+static mtd_dev_t _parent = {
+    .driver = &_driver,
+    .sector_count = SECTOR_COUNT,
+    .pages_per_sector = PAGE_PER_SECTOR,
+    .page_size = PAGE_SIZE,
+};
+
+static mtd_cache_t _cache;
+static mtd_dev_t *dev = &_cache.base;
+
+static void set_up(void)
+{
+    mtd_cache_setup(&_cache, &_parent);
+    mtd_init(dev);
+    _reads = 0;
+    _writes = 0;
+    _erases = 0;
+}
+
+static void test_mtd_cache_init(void)
+{
+    TEST_ASSERT_EQUAL_INT(SECTOR_COUNT, dev->sector_count);
+    TEST_ASSERT_EQUAL_INT(PAGE_PER_SECTOR, dev->pages_per_sector);
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, dev->page_size);
+}
+
+static void test_mtd_cache_read_hit(void)
+{
+    uint8_t buf[16];
+
+    _memory[PAGE_SIZE * 5 + 3] = 0x42;
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, PAGE_SIZE * 5, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(1, _reads);
+    TEST_ASSERT_EQUAL_INT(0x42, buf[3]);
+
+    /* other part of the same page */
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, PAGE_SIZE * 5 + 40, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, PAGE_SIZE * 5, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(1, _reads);
+    TEST_ASSERT_EQUAL_INT(0x42, buf[3]);
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.misses);
+    TEST_ASSERT_EQUAL_INT(2, _cache.stats.hits);
+
+    /* out of bounds */
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_read(dev, buf, sizeof(_memory) - 1, 2));
+}
+
+static void test_mtd_cache_read_ahead(void)
+{
+    uint8_t buf[PAGE_SIZE / 2];
+
+    mtd_read(dev, buf, 0, sizeof(buf));
+    mtd_read(dev, buf, sizeof(buf), sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.misses);
+    TEST_ASSERT_EQUAL_INT(MTD_CACHE_READ_AHEAD, _cache.stats.read_ahead);
+    TEST_ASSERT_EQUAL_INT(1 + MTD_CACHE_READ_AHEAD, _reads);
+
+    /* the next page is read from the cache, and the one after it ahead */
+    mtd_read(dev, buf, PAGE_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.misses);
+    TEST_ASSERT_EQUAL_INT(2, _cache.stats.hits);
+    TEST_ASSERT_EQUAL_INT(1 + 2 * MTD_CACHE_READ_AHEAD, _reads);
+}
+
+static void test_mtd_cache_read_pages(void)
+{
+    uint8_t buf[PAGE_SIZE * 3];
+
+    /* complete pages are read at once and not cached */
+    _memory[PAGE_SIZE * 2] = 0x23;
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, 0, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(1, _reads);
+    TEST_ASSERT_EQUAL_INT(0x23, buf[PAGE_SIZE * 2]);
+    mtd_read(dev, buf, PAGE_SIZE * 2, 1);
+    TEST_ASSERT_EQUAL_INT(2, _reads);
+    _memory[PAGE_SIZE * 2] = 0xff;
+}
+
+static void test_mtd_cache_write_back(void)
+{
+    const uint8_t buf1[] = { 0xf0, 0xf0 };
+    const uint8_t buf2[] = { 0x3c, 0x3c, 0x00 };
+    uint8_t buf_read[4];
+
+    /* writes are combined */
+    TEST_ASSERT_EQUAL_INT(sizeof(buf1), mtd_write(dev, buf1, 10, sizeof(buf1)));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf2), mtd_write(dev, buf2, 11, sizeof(buf2)));
+    TEST_ASSERT_EQUAL_INT(0, _writes);
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[10]);
+
+    /* a written page is read from the flash and merged */
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read), mtd_read(dev, buf_read, 10, sizeof(buf_read)));
+    TEST_ASSERT_EQUAL_INT(0xf0, buf_read[0]);
+    TEST_ASSERT_EQUAL_INT(0x30, buf_read[1]);
+    TEST_ASSERT_EQUAL_INT(0x00, buf_read[3]);
+    TEST_ASSERT_EQUAL_INT(1, _writes);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(buf1), mtd_write(dev, buf1, 20, sizeof(buf1)));
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(2, _writes);
+    TEST_ASSERT_EQUAL_INT(0xf0, _memory[10]);
+    TEST_ASSERT_EQUAL_INT(0x30, _memory[11]);
+    TEST_ASSERT_EQUAL_INT(0x00, _memory[13]);
+    TEST_ASSERT_EQUAL_INT(0xf0, _memory[21]);
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[22]);
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(2, _writes);
+}
+
+static void test_mtd_cache_write_sector(void)
+{
+    const uint8_t buf[] = { 0x00 };
+
+    /* pages of one sector stay dirty */
+    mtd_write(dev, buf, 0, sizeof(buf));
+    mtd_write(dev, buf, PAGE_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(0, _writes);
+    TEST_ASSERT_EQUAL_INT(2, _cache.stats.writes);
+
+    /* a write to another sector writes them back */
+    mtd_write(dev, buf, SECTOR_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(2, _writes);
+    TEST_ASSERT_EQUAL_INT(0x00, _memory[0]);
+    TEST_ASSERT_EQUAL_INT(0x00, _memory[PAGE_SIZE]);
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[SECTOR_SIZE]);
+
+    /* erasing drops the pending writes */
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, SECTOR_SIZE, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(2, _writes);
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[SECTOR_SIZE]);
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(dev, PAGE_SIZE, SECTOR_SIZE));
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, 0, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[0]);
+}
+
+static void test_mtd_cache_evict(void)
+{
+    uint8_t buf[1];
+
+    /* not where the previous read ended, to not read ahead */
+    for (unsigned i = 0; i <= MTD_CACHE_NUMOF; i++) {
+        mtd_read(dev, buf, i * PAGE_SIZE + 1, sizeof(buf));
+    }
+    TEST_ASSERT_EQUAL_INT(MTD_CACHE_NUMOF + 1, _reads);
+
+    /* the least recently used page was evicted */
+    mtd_read(dev, buf, 1, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(MTD_CACHE_NUMOF + 2, _reads);
+}
+
+Test *tests_mtd_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_cache_init),
+        new_TestFixture(test_mtd_cache_read_hit),
+        new_TestFixture(test_mtd_cache_read_ahead),
+        new_TestFixture(test_mtd_cache_read_pages),
+        new_TestFixture(test_mtd_cache_write_back),
+        new_TestFixture(test_mtd_cache_write_sector),
+        new_TestFixture(test_mtd_cache_evict),
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_cache_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mtd_cache_tests;
+}
+
+void tests_mtd_cache(void)
+{
+    TESTS_RUN(tests_mtd_cache_tests());
+}
+/** @} */
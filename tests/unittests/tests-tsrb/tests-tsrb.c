@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <limits.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "tsrb.h"
+
+#include "tests-tsrb.h"
+
+#define BUF_SIZE    (16U)
+
+static char _mem[BUF_SIZE];
+static tsrb_t _rb = TSRB_INIT(_mem);
+
+static void set_up(void)
+{
+    tsrb_init(&_rb, _mem, sizeof(_mem));
+}
+
+/* moves the read and write position to pos */
+static void _rotate(unsigned pos)
+{
+    _rb.reads = pos;
+    _rb.writes = pos;
+}
+
+static void test_tsrb_one(void)
+{
+    TEST_ASSERT_EQUAL_INT(-1, tsrb_get_one(&_rb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_add_one(&_rb, 'a'));
+    TEST_ASSERT_EQUAL_INT(1, tsrb_avail(&_rb));
+    TEST_ASSERT_EQUAL_INT('a', tsrb_get_one(&_rb));
+    TEST_ASSERT(tsrb_empty(&_rb));
+}
+
+static void test_tsrb_add_get_wrap(void)
+{
+    const char data[] = "0123456789abcdefXYZ";
+    char buf[sizeof(data)];
+
+    /* wrap in the middle of the data and of the counters */
+    _rotate(UINT_MAX - 5);
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_add(&_rb, data, sizeof(data)));
+    TEST_ASSERT(tsrb_full(&_rb));
+    TEST_ASSERT_EQUAL_INT(-1, tsrb_add_one(&_rb, 'x'));
+    TEST_ASSERT_EQUAL_INT(3, tsrb_get(&_rb, buf, 3));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, data, 3));
+    TEST_ASSERT_EQUAL_INT(3, tsrb_add(&_rb, &data[BUF_SIZE], 3));
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_get(&_rb, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, &data[3], BUF_SIZE));
+    TEST_ASSERT(tsrb_empty(&_rb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_get(&_rb, buf, sizeof(buf)));
+}
+
+static void test_tsrb_reserve_commit(void)
+{
+    char *dst;
+    char buf[BUF_SIZE];
+
+    _rotate(BUF_SIZE - 4);
+    TEST_ASSERT_EQUAL_INT(4, tsrb_reserve(&_rb, &dst));
+    TEST_ASSERT(dst == &_mem[BUF_SIZE - 4]);
+    memcpy(dst, "abc", 3);
+    tsrb_commit(&_rb, 3);
+    TEST_ASSERT_EQUAL_INT(3, tsrb_avail(&_rb));
+
+    TEST_ASSERT_EQUAL_INT(1, tsrb_reserve(&_rb, &dst));
+    *dst = 'd';
+    tsrb_commit(&_rb, 1);
+
+    /* continues at the start of the memory, up to the read position */
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE - 4, tsrb_reserve(&_rb, &dst));
+    TEST_ASSERT(dst == _mem);
+    *dst = 'e';
+    tsrb_commit(&_rb, 1);
+
+    TEST_ASSERT_EQUAL_INT(5, tsrb_get(&_rb, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, "abcde", 5));
+}
+
+static void test_tsrb_peek_consume(void)
+{
+    char *src;
+
+    TEST_ASSERT_EQUAL_INT(0, tsrb_peek(&_rb, &src));
+    _rotate(BUF_SIZE - 2);
+    TEST_ASSERT_EQUAL_INT(5, tsrb_add(&_rb, "hello", 5));
+
+    TEST_ASSERT_EQUAL_INT(2, tsrb_peek(&_rb, &src));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(src, "he", 2));
+    /* peeking does not remove anything */
+    TEST_ASSERT_EQUAL_INT(2, tsrb_peek(&_rb, &src));
+    tsrb_consume(&_rb, 1);
+    TEST_ASSERT_EQUAL_INT(1, tsrb_peek(&_rb, &src));
+    TEST_ASSERT_EQUAL_INT('e', *src);
+    tsrb_consume(&_rb, 1);
+    TEST_ASSERT_EQUAL_INT(3, tsrb_peek(&_rb, &src));
+    TEST_ASSERT(src == _mem);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(src, "llo", 3));
+    tsrb_consume(&_rb, 3);
+    TEST_ASSERT(tsrb_empty(&_rb));
+}
+
+Test *tests_tsrb_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tsrb_one),
+        new_TestFixture(test_tsrb_add_get_wrap),
+        new_TestFixture(test_tsrb_reserve_commit),
+        new_TestFixture(test_tsrb_peek_consume),
+    };
+
+    EMB_UNIT_TESTCALLER(tsrb_tests, set_up, NULL, fixtures);
+
+    return (Test *)&tsrb_tests;
+}
+
+void tests_tsrb(void)
+{
+    TESTS_RUN(tests_tsrb_tests());
+}
+/** @} */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Unittests for the vfs_readv, vfs_writev, vfs_pread and
+ *              vfs_pwrite fallbacks of drivers without these operations
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+
+#include "embUnit/embUnit.h"
+
+#include "vfs.h"
+
+#include "tests-vfs.h"
+
+#define _VFS_TEST_FALLBACK_BUFSIZE 16
+
+static ssize_t _mock_read(vfs_file_t *filp, void *dest, size_t nbytes);
+static ssize_t _mock_write(vfs_file_t *filp, const void *src, size_t nbytes);
+static off_t _mock_lseek(vfs_file_t *filp, off_t off, int whence);
+
+static uint8_t _buf[_VFS_TEST_FALLBACK_BUFSIZE];
+
+/* a fixed size file, with only the basic operations */
+static const vfs_file_ops_t _test_fallback_ops = {
+    .read = _mock_read,
+    .write = _mock_write,
+    .lseek = _mock_lseek,
+};
+
+/* a stream that can not seek */
+static const vfs_file_ops_t _test_fallback_stream_ops = {
+    .read = _mock_read,
+    .write = _mock_write,
+};
+
+static ssize_t _mock_read(vfs_file_t *filp, void *dest, size_t nbytes)
+{
+    if (filp->pos >= (off_t)sizeof(_buf)) {
+        return 0;
+    }
+    if (nbytes > sizeof(_buf) - filp->pos) {
+        nbytes = sizeof(_buf) - filp->pos;
+    }
+    memcpy(dest, &_buf[filp->pos], nbytes);
+    filp->pos += nbytes;
+    return nbytes;
+}
+
+static ssize_t _mock_write(vfs_file_t *filp, const void *src, size_t nbytes)
+{
+    if (filp->pos >= (off_t)sizeof(_buf)) {
+        return -ENOSPC;
+    }
+    if (nbytes > sizeof(_buf) - filp->pos) {
+        nbytes = sizeof(_buf) - filp->pos;
+    }
+    memcpy(&_buf[filp->pos], src, nbytes);
+    filp->pos += nbytes;
+    return nbytes;
+}
+
+static off_t _mock_lseek(vfs_file_t *filp, off_t off, int whence)
+{
+    switch (whence) {
+        case SEEK_SET:
+            break;
+        case SEEK_CUR:
+            off += filp->pos;
+            break;
+        case SEEK_END:
+            off += sizeof(_buf);
+            break;
+        default:
+            return -EINVAL;
+    }
+    if (off < 0) {
+        return -EINVAL;
+    }
+    filp->pos = off;
+    return off;
+}
+
+static int _fd;
+
+static void setup(void)
+{
+    memset(_buf, 0, sizeof(_buf));
+    _fd = vfs_bind(VFS_ANY_FD, O_RDWR, &_test_fallback_ops, NULL);
+}
+
+static void teardown(void)
+{
+    if (_fd >= 0) {
+        vfs_close(_fd);
+    }
+}
+
+static void test_vfs_fallback_writev_readv(void)
+{
+    char a[] = "abc", b[] = "defgh";
+    char ra[4], rb[6];
+    struct iovec wiov[] = {
+        { .iov_base = a, .iov_len = 3 },
+        { .iov_base = NULL, .iov_len = 0 },
+        { .iov_base = b, .iov_len = 5 },
+    };
+    struct iovec riov[] = {
+        { .iov_base = ra, .iov_len = sizeof(ra) },
+        { .iov_base = rb, .iov_len = sizeof(rb) },
+    };
+
+    TEST_ASSERT(_fd >= 0);
+    TEST_ASSERT_EQUAL_INT(8, vfs_writev(_fd, wiov, 3));
+    TEST_ASSERT_EQUAL_INT(8, vfs_lseek(_fd, 0, SEEK_CUR));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("abcdefgh", _buf, 8));
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_lseek(_fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL_INT(10, vfs_readv(_fd, riov, 2));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("abcd", ra, sizeof(ra)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("efgh\0\0", rb, sizeof(rb)));
+}
+
+static void test_vfs_fallback_readv__short(void)
+{
+    char ra[4], rb[4], rc[4];
+    struct iovec riov[] = {
+        { .iov_base = ra, .iov_len = sizeof(ra) },
+        { .iov_base = rb, .iov_len = sizeof(rb) },
+        { .iov_base = rc, .iov_len = sizeof(rc) },
+    };
+
+    TEST_ASSERT(_fd >= 0);
+    memset(_buf, 'x', sizeof(_buf));
+    /* the second buffer is filled partly, the third not at all */
+    TEST_ASSERT_EQUAL_INT(sizeof(_buf) - 6, vfs_lseek(_fd, -6, SEEK_END));
+    memset(rc, 0, sizeof(rc));
+    TEST_ASSERT_EQUAL_INT(6, vfs_readv(_fd, riov, 3));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("xxxx", ra, sizeof(ra)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("xx", rb, 2));
+    TEST_ASSERT_EQUAL_INT(0, rc[0]);
+    /* at the end of the file */
+    TEST_ASSERT_EQUAL_INT(0, vfs_readv(_fd, riov, 3));
+}
+
+static void test_vfs_fallback_writev__short(void)
+{
+    char a[] = "0123456789";
+    struct iovec wiov[] = {
+        { .iov_base = a, .iov_len = 10 },
+        { .iov_base = a, .iov_len = 10 },
+        { .iov_base = a, .iov_len = 10 },
+    };
+
+    TEST_ASSERT(_fd >= 0);
+    /* stops at the first short write */
+    TEST_ASSERT_EQUAL_INT(sizeof(_buf), vfs_writev(_fd, wiov, 3));
+    TEST_ASSERT_EQUAL_INT(0, memcmp("0123456789012345", _buf, sizeof(_buf)));
+    /* the error is reported if nothing was written */
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, vfs_writev(_fd, wiov, 3));
+}
+
+static void test_vfs_fallback_iov__invalid(void)
+{
+    char a[4];
+    struct iovec iov[] = {
+        { .iov_base = a, .iov_len = sizeof(a) },
+        { .iov_base = NULL, .iov_len = 1 },
+    };
+
+    TEST_ASSERT(_fd >= 0);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, vfs_readv(_fd, iov, -1));
+    TEST_ASSERT_EQUAL_INT(-EFAULT, vfs_readv(_fd, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(-EFAULT, vfs_readv(_fd, iov, 2));
+    TEST_ASSERT_EQUAL_INT(-EFAULT, vfs_writev(_fd, iov, 2));
+    TEST_ASSERT_EQUAL_INT(0, vfs_writev(_fd, iov, 0));
+    TEST_ASSERT_EQUAL_INT(0, vfs_lseek(_fd, 0, SEEK_CUR));
+}
+
+static void test_vfs_fallback_pwrite_pread(void)
+{
+    const char str[] = "pqrs";
+    char buf[8];
+
+    TEST_ASSERT(_fd >= 0);
+    TEST_ASSERT_EQUAL_INT(2, vfs_lseek(_fd, 2, SEEK_SET));
+    TEST_ASSERT_EQUAL_INT(4, vfs_pwrite(_fd, str, 4, 10));
+    /* the file position is restored */
+    TEST_ASSERT_EQUAL_INT(2, vfs_lseek(_fd, 0, SEEK_CUR));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(str, &_buf[10], 4));
+
+    memset(buf, 0, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(4, vfs_pread(_fd, buf, 4, 10));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(str, buf, 4));
+    TEST_ASSERT_EQUAL_INT(2, vfs_lseek(_fd, 0, SEEK_CUR));
+
+    /* short read at the end of the file */
+    TEST_ASSERT_EQUAL_INT(2, vfs_pread(_fd, buf, sizeof(buf), sizeof(_buf) - 2));
+    TEST_ASSERT_EQUAL_INT(0, vfs_pread(_fd, buf, sizeof(buf), sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT(2, vfs_lseek(_fd, 0, SEEK_CUR));
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, vfs_pread(_fd, buf, sizeof(buf), -1));
+    TEST_ASSERT_EQUAL_INT(-EFAULT, vfs_pwrite(_fd, NULL, 1, 0));
+}
+
+static void test_vfs_fallback_pread__no_lseek(void)
+{
+    char buf[4];
+    int fd = vfs_bind(VFS_ANY_FD, O_RDWR, &_test_fallback_stream_ops, NULL);
+
+    TEST_ASSERT(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    TEST_ASSERT_EQUAL_INT(-ESPIPE, vfs_pread(fd, buf, sizeof(buf), 0));
+    TEST_ASSERT_EQUAL_INT(-ESPIPE, vfs_pwrite(fd, buf, sizeof(buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+}
+
+Test *tests_vfs_fallback_ops_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vfs_fallback_writev_readv),
+        new_TestFixture(test_vfs_fallback_readv__short),
+        new_TestFixture(test_vfs_fallback_writev__short),
+        new_TestFixture(test_vfs_fallback_iov__invalid),
+        new_TestFixture(test_vfs_fallback_pwrite_pread),
+        new_TestFixture(test_vfs_fallback_pread__no_lseek),
+    };
+
+    EMB_UNIT_TESTCALLER(vfs_fallback_ops_tests, setup, teardown, fixtures);
+
+    return (Test *)&vfs_fallback_ops_tests;
+}
+
+/** @} */
@@ -171,6 +171,55 @@ static void test_vfs_constfs_read_lseek(void)
     TEST_ASSERT_EQUAL_INT(0, res);
 }
 
+static void test_vfs_constfs_readv_pread(void)
+{
+    int res;
+    res = vfs_mount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    int fd = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+
+    uint8_t head[3];
+    uint8_t tail[8];
+    struct iovec iov[] = {
+        { .iov_base = head, .iov_len = sizeof(head) },
+        { .iov_base = NULL, .iov_len = 0 },
+        { .iov_base = tail, .iov_len = sizeof(tail) },
+    };
+    ssize_t nbytes;
+    nbytes = vfs_readv(fd, iov, sizeof(iov) / sizeof(iov[0]));
+    TEST_ASSERT_EQUAL_INT(sizeof(head) + sizeof(tail), nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(head, &bin_data[0], sizeof(head)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(tail, &bin_data[sizeof(head)], sizeof(tail)));
+
+    /* pread neither depends on nor moves the file position */
+    nbytes = vfs_pread(fd, tail, sizeof(tail), 16);
+    TEST_ASSERT_EQUAL_INT(sizeof(tail), nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(tail, &bin_data[16], sizeof(tail)));
+    TEST_ASSERT_EQUAL_INT(sizeof(head) + sizeof(tail), vfs_lseek(fd, 0, SEEK_CUR));
+
+    /* short read at the end of the file */
+    nbytes = vfs_pread(fd, tail, sizeof(tail), sizeof(bin_data) - 2);
+    TEST_ASSERT_EQUAL_INT(2, nbytes);
+    nbytes = vfs_pread(fd, tail, sizeof(tail), sizeof(bin_data));
+    TEST_ASSERT_EQUAL_INT(0, nbytes);
+    nbytes = vfs_pread(fd, tail, sizeof(tail), -1);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, nbytes);
+    nbytes = vfs_readv(fd, iov, -1);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, nbytes);
+
+    /* constfs is read only */
+    nbytes = vfs_pwrite(fd, tail, sizeof(tail), 0);
+    TEST_ASSERT(nbytes < 0);
+
+    res = vfs_close(fd);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
 #if MODULE_NEWLIB || defined(BOARD_NATIVE)
 static void test_vfs_constfs__posix(void)
 {
@@ -210,6 +259,7 @@ Test *tests_vfs_mount_constfs_tests(void)
         new_TestFixture(test_vfs_umount__invalid_mount),
         new_TestFixture(test_vfs_constfs_open),
         new_TestFixture(test_vfs_constfs_read_lseek),
+        new_TestFixture(test_vfs_constfs_readv_pread),
 #if MODULE_NEWLIB || defined(BOARD_NATIVE)
         new_TestFixture(test_vfs_constfs__posix),
 #endif
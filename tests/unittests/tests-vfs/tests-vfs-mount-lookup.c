@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief Unit tests of the dispatching of paths to nested mount points
+ */
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "embUnit/embUnit.h"
+
+#include "vfs.h"
+
+#include "tests-vfs.h"
+
+static vfs_mount_t *_stat_mount;
+static const char *_stat_path;
+
+static int _mock_stat(vfs_mount_t *mountp, const char *restrict rel_path,
+                      struct stat *restrict buf)
+{
+    (void)buf;
+    _stat_mount = mountp;
+    _stat_path = rel_path;
+    return 0;
+}
+
+static const vfs_file_system_ops_t _mock_fs_ops = {
+    .stat = _mock_stat,
+};
+
+static const vfs_file_ops_t _mock_file_ops = {
+    .close = NULL,
+};
+
+static const vfs_file_system_t _mock_file_system = {
+    .f_op  = &_mock_file_ops,
+    .fs_op = &_mock_fs_ops,
+};
+
+static vfs_mount_t _mount_root = {
+    .mount_point = "/",
+    .fs = &_mock_file_system,
+};
+
+static vfs_mount_t _mount_test = {
+    .mount_point = "/test",
+    .fs = &_mock_file_system,
+};
+
+static vfs_mount_t _mount_test_sub = {
+    .mount_point = "/test/sub",
+    .fs = &_mock_file_system,
+};
+
+static vfs_mount_t _mount_testing = {
+    .mount_point = "/testing",
+    .fs = &_mock_file_system,
+};
+
+static vfs_mount_t _mount_many[VFS_MAX_MOUNTS];
+
+static void setup(void)
+{
+    /* mounted in an order that differs from the length order */
+    vfs_mount(&_mount_test);
+    vfs_mount(&_mount_root);
+    vfs_mount(&_mount_testing);
+    vfs_mount(&_mount_test_sub);
+}
+
+static void teardown(void)
+{
+    vfs_umount(&_mount_test_sub);
+    vfs_umount(&_mount_testing);
+    vfs_umount(&_mount_root);
+    vfs_umount(&_mount_test);
+}
+
+static void _assert_stat(const char *path, vfs_mount_t *mountp, const char *rel_path)
+{
+    struct stat buf;
+
+    _stat_mount = NULL;
+    TEST_ASSERT_EQUAL_INT(0, vfs_stat(path, &buf));
+    TEST_ASSERT(_stat_mount == mountp);
+    TEST_ASSERT_EQUAL_STRING(rel_path, _stat_path);
+    /* vfs_stat must release the mount again */
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&mountp->open_files));
+}
+
+static void test_vfs_mount_lookup__longest_prefix(void)
+{
+    _assert_stat("/test/sub/file", &_mount_test_sub, "/file");
+    _assert_stat("/test/sub", &_mount_test_sub, "");
+    _assert_stat("/test/subdir", &_mount_test, "/subdir");
+    _assert_stat("/test/file", &_mount_test, "/file");
+    _assert_stat("/testing/file", &_mount_testing, "/file");
+    _assert_stat("/tes", &_mount_root, "/tes");
+    _assert_stat("/other/file", &_mount_root, "/other/file");
+}
+
+static void test_vfs_mount_lookup__umount(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mount_test_sub));
+    _assert_stat("/test/sub/file", &_mount_test, "/sub/file");
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mount_root));
+    struct stat buf;
+    TEST_ASSERT_EQUAL_INT(-ENOENT, vfs_stat("/other/file", &buf));
+    _assert_stat("/test/file", &_mount_test, "/file");
+}
+
+static void test_vfs_mount_lookup__table_full(void)
+{
+    unsigned mounted = 0;
+    for (const vfs_mount_t *it = vfs_iterate_mounts(NULL); it != NULL;
+         it = vfs_iterate_mounts(it)) {
+        ++mounted;
+    }
+    TEST_ASSERT(mounted <= VFS_MAX_MOUNTS);
+
+    unsigned i;
+    for (i = 0; mounted < VFS_MAX_MOUNTS; ++i, ++mounted) {
+        _mount_many[i].mount_point = "/many";
+        _mount_many[i].fs = &_mock_file_system;
+        TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_mount_many[i]));
+    }
+    _mount_many[i].mount_point = "/many";
+    _mount_many[i].fs = &_mock_file_system;
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, vfs_mount(&_mount_many[i]));
+
+    /* the latest of equal mount points is used */
+    if (i > 0) {
+        _assert_stat("/many/file", &_mount_many[i - 1], "/file");
+    }
+    while (i-- > 0) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mount_many[i]));
+    }
+}
+
+static void test_vfs_mount_lookup__fd_alloc(void)
+{
+    int fds[VFS_MAX_OPEN_FILES];
+    unsigned n;
+
+    /* the fd numbers handed out are unique until the table is full */
+    for (n = 0; n < VFS_MAX_OPEN_FILES; ++n) {
+        fds[n] = vfs_bind(VFS_ANY_FD, 0, &_mock_file_ops, NULL);
+        if (fds[n] < 0) {
+            TEST_ASSERT_EQUAL_INT(-ENFILE, fds[n]);
+            break;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            TEST_ASSERT(fds[i] != fds[n]);
+        }
+    }
+    TEST_ASSERT(n > 0);
+    TEST_ASSERT_EQUAL_INT(-EEXIST, vfs_bind(fds[0], 0, &_mock_file_ops, NULL));
+    while (n-- > 0) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_close(fds[n]));
+    }
+}
+
+Test *tests_vfs_mount_lookup_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vfs_mount_lookup__longest_prefix),
+        new_TestFixture(test_vfs_mount_lookup__umount),
+        new_TestFixture(test_vfs_mount_lookup__table_full),
+        new_TestFixture(test_vfs_mount_lookup__fd_alloc),
+    };
+
+    EMB_UNIT_TESTCALLER(vfs_mount_lookup_tests, setup, teardown, fixtures);
+
+    return (Test *)&vfs_mount_lookup_tests;
+}
+
+/** @} */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   Benchmark of xtimer insertion, removal and expiry with many
+ *          concurrent timers
+ *
+ * Build once with `XTIMER_BACKEND=list` and once with `XTIMER_BACKEND=wheel`
+ * to compare the sorted list core with the timing wheel.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "xtimer.h"
+
+#define TIMERS_MAX      (1000U)
+/* armed timers that must not fire during the measurement */
+#define FAR_OFFSET      (10U * US_PER_SEC)
+#define FAR_SPREAD      (60U * US_PER_SEC)
+/* timers that are left to fire to measure their latency */
+#define FIRE_OFFSET     (100U * US_PER_MS)
+#define FIRE_SPREAD     (200U * US_PER_MS)
+#define RESET_NUMOF     (1000U)
+
+static const unsigned _numof[] = { 10, 100, TIMERS_MAX };
+
+static xtimer_t _timers[TIMERS_MAX];
+static uint32_t _targets[TIMERS_MAX];
+static volatile unsigned _fired;
+static volatile uint32_t _max_late;
+static uint32_t _seed = 1;
+
+static uint32_t _rand(uint32_t max)
+{
+    _seed = (_seed * 1103515245) + 12345;
+    return (_seed >> 8) % max;
+}
+
+static void _cb(void *arg)
+{
+    uint32_t now = xtimer_now_usec();
+    uint32_t late = now - _targets[(uintptr_t)arg];
+
+    if (late > _max_late) {
+        _max_late = late;
+    }
+    _fired++;
+}
+
+/* returns the average duration of an operation in ns */
+static uint32_t _per_op(xtimer_ticks32_t start, unsigned ops)
+{
+    xtimer_ticks32_t diff = xtimer_diff(xtimer_now(), start);
+
+    return (uint32_t)(((uint64_t)xtimer_usec_from_ticks(diff) * NS_PER_US) / ops);
+}
+
+static int _bench(unsigned numof)
+{
+    xtimer_ticks32_t start;
+    uint32_t set, reset, remove;
+
+    for (unsigned i = 0; i < numof; i++) {
+        _timers[i].callback = _cb;
+        _timers[i].arg = (void *)(uintptr_t)i;
+    }
+
+    /* insertion */
+    start = xtimer_now();
+    for (unsigned i = 0; i < numof; i++) {
+        xtimer_set(&_timers[i], FAR_OFFSET + _rand(FAR_SPREAD));
+    }
+    set = _per_op(start, numof);
+
+    /* re-arming of an already set timer, e.g. a retransmission timeout */
+    start = xtimer_now();
+    for (unsigned i = 0; i < RESET_NUMOF; i++) {
+        xtimer_set(&_timers[_rand(numof)], FAR_OFFSET + _rand(FAR_SPREAD));
+    }
+    reset = _per_op(start, RESET_NUMOF);
+
+    /* removal in an order unrelated to the expiry order (7 is coprime to
+     * all entries of _numof, so every timer is visited) */
+    start = xtimer_now();
+    for (unsigned i = 0; i < numof; i++) {
+        xtimer_remove(&_timers[(i * 7) % numof]);
+    }
+    remove = _per_op(start, numof);
+
+    /* expiry */
+    _fired = 0;
+    _max_late = 0;
+    for (unsigned i = 0; i < numof; i++) {
+        uint32_t offset = FIRE_OFFSET + _rand(FIRE_SPREAD);
+
+        _targets[i] = xtimer_now_usec() + offset;
+        xtimer_set(&_timers[i], offset);
+    }
+    xtimer_usleep(FIRE_OFFSET + FIRE_SPREAD + (10 * US_PER_MS));
+    if (_fired != numof) {
+        printf("[FAILED] %u of %u timers fired\n", _fired, numof);
+        return 1;
+    }
+
+    printf("%6u %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+           numof, set, reset, remove, _max_late);
+    return 0;
+}
+
+int main(void)
+{
+    puts("[START]");
+#ifdef MODULE_XTIMER_WHEEL
+    puts("backend: timing wheel");
+#else
+    puts("backend: sorted lists");
+#endif
+    puts("timers set[ns/op] reset[ns/op] rm[ns/op] late[us]");
+    for (unsigned i = 0; i < (sizeof(_numof) / sizeof(_numof[0])); i++) {
+        if (_bench(_numof[i])) {
+            return 1;
+        }
+    }
+    puts("[SUCCESS]");
+    return 0;
+}